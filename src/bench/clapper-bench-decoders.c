@@ -0,0 +1,559 @@
+/* Clapper Playback Library
+ * Copyright (C) 2025 Rafał Dzięgiel <rafostar.github@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Measures video decoders available on this machine.
+ *
+ * For each codec a short clip is encoded with any available encoder,
+ * then decoded as fast as possible with every decoder able to handle it,
+ * measuring decoding speed and CPU time. Results are reported as JSON
+ * together with plugin feature rank overrides (in Clapper app settings
+ * format) that make the fastest working decoder of each codec preferred.
+ * These can be applied to Clapper app settings with "--apply".
+ *
+ * Only decoding is measured (frames are not downloaded from GPU memory),
+ * as that is what decoder selection affects during playback.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <gio/gio.h>
+#include <gst/gst.h>
+
+#ifdef G_OS_UNIX
+#include <sys/resource.h>
+#endif
+
+/* Above any rank Clapper app sets initially */
+#define PREFERRED_RANK (GST_RANK_PRIMARY + 64)
+
+/* Max time of a single step */
+#define STEP_TIMEOUT (120 * GST_SECOND)
+
+typedef struct
+{
+  const gchar *name;
+  const gchar *caps;
+  const gchar *encoders[4]; // descriptions, tried in order
+  const gchar *parser; // nullable
+} BenchCodec;
+
+typedef struct
+{
+  gchar *decoder;
+  guint rank;
+  gboolean working;
+  guint64 frames;
+  gdouble fps;
+  gdouble cpu_percent;
+  gdouble cpu_ms_per_frame;
+} BenchResult;
+
+static const BenchCodec codecs[] = {
+  { "h264", "video/x-h264",
+    { "x264enc speed-preset=ultrafast key-int-max=30", "openh264enc", NULL }, "h264parse" },
+  { "h265", "video/x-h265",
+    { "x265enc speed-preset=ultrafast key-int-max=30", NULL }, "h265parse" },
+  { "vp8", "video/x-vp8",
+    { "vp8enc deadline=1 keyframe-max-dist=30", NULL }, NULL },
+  { "vp9", "video/x-vp9",
+    { "vp9enc deadline=1 cpu-used=8 keyframe-max-dist=30", NULL }, "vp9parse" },
+  { "av1", "video/x-av1",
+    { "svtav1enc", "rav1enc speed-preset=10", "av1enc cpu-used=10", NULL }, "av1parse" },
+};
+
+static gint opt_frames = 240;
+static gint opt_runs = 2;
+static gchar *opt_size = NULL;
+static gchar *opt_codecs = NULL;
+static gchar *opt_output = NULL;
+static gboolean opt_apply = FALSE;
+
+static GOptionEntry option_entries[] =
+{
+  { "codecs", 'c', 0, G_OPTION_ARG_STRING, &opt_codecs, "Comma separated codecs to measure (default: h264,h265,vp8,vp9,av1)", "LIST" },
+  { "frames", 'f', 0, G_OPTION_ARG_INT, &opt_frames, "Number of frames in each clip (default: 240)", "FRAMES" },
+  { "size", 's', 0, G_OPTION_ARG_STRING, &opt_size, "Resolution of clips (default: 1920x1080)", "WxH" },
+  { "runs", 'r', 0, G_OPTION_ARG_INT, &opt_runs, "Decoding runs per decoder, the best one counts (default: 2)", "RUNS" },
+  { "output", 'o', 0, G_OPTION_ARG_FILENAME, &opt_output, "Write JSON to file instead of stdout", "FILE" },
+  { "apply", 'a', 0, G_OPTION_ARG_NONE, &opt_apply, "Store proposed rank overrides in Clapper app settings", NULL },
+  { NULL }
+};
+
+static gint64
+_get_cpu_time (void)
+{
+#ifdef G_OS_UNIX
+  struct rusage usage;
+
+  getrusage (RUSAGE_SELF, &usage);
+
+  return (gint64) usage.ru_utime.tv_sec * G_USEC_PER_SEC + usage.ru_utime.tv_usec
+      + (gint64) usage.ru_stime.tv_sec * G_USEC_PER_SEC + usage.ru_stime.tv_usec;
+#else
+  return -1;
+#endif
+}
+
+/* Runs pipeline until EOS, returns %FALSE on error or timeout */
+static gboolean
+_run_pipeline (GstElement *pipeline, GError **error)
+{
+  GstBus *bus;
+  GstMessage *msg;
+  gboolean success = FALSE;
+
+  if (gst_element_set_state (pipeline, GST_STATE_PLAYING) == GST_STATE_CHANGE_FAILURE) {
+    g_set_error_literal (error, GST_CORE_ERROR, GST_CORE_ERROR_STATE_CHANGE,
+        "Could not start pipeline");
+    goto finish;
+  }
+
+  bus = gst_element_get_bus (pipeline);
+  msg = gst_bus_timed_pop_filtered (bus, STEP_TIMEOUT,
+      GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+  gst_object_unref (bus);
+
+  if (!msg) {
+    g_set_error_literal (error, GST_CORE_ERROR, GST_CORE_ERROR_FAILED, "Timed out");
+  } else if (GST_MESSAGE_TYPE (msg) == GST_MESSAGE_ERROR) {
+    gst_message_parse_error (msg, error, NULL);
+  } else {
+    success = TRUE;
+  }
+
+  if (msg)
+    gst_message_unref (msg);
+
+finish:
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+
+  return success;
+}
+
+static gboolean
+_has_element (const gchar *description)
+{
+  GstElementFactory *factory;
+  gchar *name = g_strndup (description, strcspn (description, " "));
+
+  factory = gst_element_factory_find (name);
+  g_free (name);
+
+  if (factory)
+    gst_object_unref (factory);
+
+  return (factory != NULL);
+}
+
+static gchar *
+_generate_clip (const BenchCodec *codec, const gchar *dir,
+    gint width, gint height, GError **error)
+{
+  GstElement *pipeline;
+  gchar *location, *basename, *desc;
+  const gchar *encoder = NULL;
+  guint i;
+
+  for (i = 0; codec->encoders[i]; ++i) {
+    if (_has_element (codec->encoders[i])) {
+      encoder = codec->encoders[i];
+      break;
+    }
+  }
+
+  if (!encoder || (codec->parser && !_has_element (codec->parser))) {
+    g_set_error (error, GST_CORE_ERROR, GST_CORE_ERROR_MISSING_PLUGIN,
+        "No encoder available for %s", codec->name);
+    return NULL;
+  }
+
+  basename = g_strdup_printf ("%s.mkv", codec->name);
+  location = g_build_filename (dir, basename, NULL);
+  g_free (basename);
+
+  desc = g_strdup_printf (
+      "videotestsrc num-buffers=%i pattern=ball ! video/x-raw,format=I420,width=%i,height=%i,framerate=30/1 "
+      "! %s %s%s ! matroskamux ! filesink location=\"%s\"",
+      opt_frames, width, height, encoder,
+      (codec->parser) ? "! " : "", (codec->parser) ? codec->parser : "", location);
+  pipeline = gst_parse_launch (desc, error);
+  g_free (desc);
+
+  if (!pipeline || !_run_pipeline (pipeline, error)) {
+    g_clear_pointer (&location, g_free);
+  }
+
+  if (pipeline)
+    gst_object_unref (pipeline);
+
+  return location;
+}
+
+static GstPadProbeReturn
+_count_frames_cb (GstPad *pad G_GNUC_UNUSED, GstPadProbeInfo *info G_GNUC_UNUSED, guint64 *frames)
+{
+  (*frames)++;
+
+  return GST_PAD_PROBE_OK;
+}
+
+static void
+_measure_decoder (const BenchCodec *codec, const gchar *location,
+    GstElementFactory *factory, BenchResult *result)
+{
+  gint run;
+
+  result->decoder = g_strdup (gst_plugin_feature_get_name (GST_PLUGIN_FEATURE_CAST (factory)));
+  result->rank = gst_plugin_feature_get_rank (GST_PLUGIN_FEATURE_CAST (factory));
+
+  for (run = 0; run < MAX (opt_runs, 1); ++run) {
+    GstElement *pipeline, *sink;
+    GstPad *pad;
+    GError *error = NULL;
+    gchar *desc;
+    guint64 frames = 0;
+    gint64 start_time, start_cpu, elapsed, cpu;
+    gboolean success;
+
+    desc = g_strdup_printf (
+        "filesrc location=\"%s\" ! matroskademux %s%s ! %s ! fakesink name=sink sync=false",
+        location, (codec->parser) ? "! " : "", (codec->parser) ? codec->parser : "",
+        result->decoder);
+    pipeline = gst_parse_launch (desc, &error);
+    g_free (desc);
+
+    if (!pipeline) {
+      g_printerr ("  %s: %s\n", result->decoder, error->message);
+      g_clear_error (&error);
+      return;
+    }
+
+    sink = gst_bin_get_by_name (GST_BIN_CAST (pipeline), "sink");
+    pad = gst_element_get_static_pad (sink, "sink");
+    gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_BUFFER,
+        (GstPadProbeCallback) _count_frames_cb, &frames, NULL);
+    gst_object_unref (pad);
+    gst_object_unref (sink);
+
+    start_cpu = _get_cpu_time ();
+    start_time = g_get_monotonic_time ();
+
+    success = _run_pipeline (pipeline, &error);
+
+    elapsed = g_get_monotonic_time () - start_time;
+    cpu = (start_cpu >= 0) ? _get_cpu_time () - start_cpu : -1;
+
+    gst_object_unref (pipeline);
+
+    /* Decoder that does not output every frame is not a working one */
+    if (!success || frames < (guint64) opt_frames) {
+      g_printerr ("  %s: failed (%s)\n", result->decoder,
+          (error) ? error->message : "missing frames");
+      g_clear_error (&error);
+      result->working = FALSE;
+
+      return;
+    }
+
+    if (elapsed > 0 && (gdouble) frames * G_USEC_PER_SEC / elapsed > result->fps) {
+      result->working = TRUE;
+      result->frames = frames;
+      result->fps = (gdouble) frames * G_USEC_PER_SEC / elapsed;
+      result->cpu_percent = (cpu >= 0) ? 100.0 * cpu / elapsed : -1;
+      result->cpu_ms_per_frame = (cpu >= 0) ? (gdouble) cpu / 1000 / frames : -1;
+    }
+  }
+
+  g_printerr ("  %s: %.1f fps, %.1f%% CPU\n", result->decoder,
+      result->fps, result->cpu_percent);
+}
+
+static void
+_result_clear (BenchResult *result)
+{
+  g_free (result->decoder);
+}
+
+/* Returns index of the fastest working decoder or -1 */
+static gint
+_find_fastest (GArray *results)
+{
+  gint i, fastest = -1;
+
+  for (i = 0; i < (gint) results->len; ++i) {
+    BenchResult *result = &g_array_index (results, BenchResult, i);
+
+    if (result->working && (fastest < 0
+        || result->fps > g_array_index (results, BenchResult, fastest).fps))
+      fastest = i;
+  }
+
+  return fastest;
+}
+
+static void
+_append_double (GString *json, const gchar *key, gdouble value, gboolean last)
+{
+  gchar buf[G_ASCII_DTOSTR_BUF_SIZE];
+
+  g_string_append_printf (json, "\"%s\": %s%s", key,
+      g_ascii_formatd (buf, sizeof (buf), "%.3f", value), (last) ? "" : ", ");
+}
+
+static void
+_append_codec_result (GString *json, const BenchCodec *codec,
+    GArray *results, gint fastest, const gchar *error_msg)
+{
+  guint i;
+
+  g_string_append_printf (json, "    { \"codec\": \"%s\", ", codec->name);
+
+  if (error_msg) {
+    gchar *escaped = g_strescape (error_msg, NULL);
+
+    g_string_append_printf (json, "\"error\": \"%s\" }", escaped);
+    g_free (escaped);
+
+    return;
+  }
+
+  g_string_append_printf (json, "\"fastest\": %s%s%s, \"decoders\": [",
+      (fastest >= 0) ? "\"" : "",
+      (fastest >= 0) ? g_array_index (results, BenchResult, fastest).decoder : "null",
+      (fastest >= 0) ? "\"" : "");
+
+  for (i = 0; i < results->len; ++i) {
+    BenchResult *result = &g_array_index (results, BenchResult, i);
+
+    g_string_append_printf (json, "%s\n      { \"decoder\": \"%s\", \"rank\": %u, \"working\": %s",
+        (i > 0) ? "," : "", result->decoder, result->rank, (result->working) ? "true" : "false");
+
+    if (result->working) {
+      g_string_append_printf (json, ", \"frames\": %" G_GUINT64_FORMAT ", ", result->frames);
+      _append_double (json, "fps", result->fps, FALSE);
+      _append_double (json, "cpu_percent", result->cpu_percent, FALSE);
+      _append_double (json, "cpu_ms_per_frame", result->cpu_ms_per_frame, TRUE);
+    }
+    g_string_append (json, " }");
+  }
+
+  g_string_append (json, (results->len > 0) ? "\n    ] }" : "] }");
+}
+
+/* Merges proposed overrides into ones already stored by user */
+static gboolean
+_apply_overrides (GHashTable *proposed, GError **error)
+{
+  GSettingsSchemaSource *source = g_settings_schema_source_get_default ();
+  GSettingsSchema *schema;
+  GSettings *settings;
+  GHashTableIter iter;
+  GString *string;
+  gpointer key, value;
+  gchar **split, *stored;
+  guint i;
+
+  if (!source || !(schema = g_settings_schema_source_lookup (source, CLAPPER_APP_ID, TRUE))) {
+    g_set_error_literal (error, G_IO_ERROR, G_IO_ERROR_NOT_FOUND,
+        "Clapper app settings schema is not installed");
+    return FALSE;
+  }
+  g_settings_schema_unref (schema);
+
+  settings = g_settings_new (CLAPPER_APP_ID);
+  stored = g_settings_get_string (settings, "plugin-feature-ranks");
+  string = g_string_new (NULL);
+
+  split = g_strsplit (stored, ",", 0);
+
+  for (i = 0; split[i]; ++i) {
+    gchar *name = g_strstrip (g_strndup (split[i], strcspn (split[i], ":")));
+
+    if (*name != '\0' && !g_hash_table_contains (proposed, name))
+      g_string_append_printf (string, "%s%s", (string->len > 0) ? "," : "", split[i]);
+
+    g_free (name);
+  }
+  g_strfreev (split);
+
+  g_hash_table_iter_init (&iter, proposed);
+  while (g_hash_table_iter_next (&iter, &key, &value)) {
+    g_string_append_printf (string, "%s%s:%i", (string->len > 0) ? "," : "",
+        (const gchar *) key, GPOINTER_TO_INT (value));
+  }
+
+  g_printerr ("Storing rank overrides: %s\n", string->str);
+  g_settings_set_string (settings, "plugin-feature-ranks", string->str);
+  g_settings_sync ();
+
+  g_string_free (string, TRUE);
+  g_free (stored);
+  g_object_unref (settings);
+
+  return TRUE;
+}
+
+gint
+main (gint argc, gchar **argv)
+{
+  GOptionContext *context;
+  GError *error = NULL;
+  GHashTable *proposed;
+  GHashTableIter iter;
+  GString *json, *ranks;
+  gpointer key, value;
+  gchar **selected, *tmp_dir;
+  gint width = 1920, height = 1080;
+  guint i, n_results = 0;
+  gint ret = 0;
+
+  context = g_option_context_new ("- benchmark video decoders and propose their ranks");
+  g_option_context_add_main_entries (context, option_entries, NULL);
+  g_option_context_add_group (context, gst_init_get_option_group ());
+
+  if (!g_option_context_parse (context, &argc, &argv, &error)) {
+    g_printerr ("%s\n", error->message);
+    g_clear_error (&error);
+    g_option_context_free (context);
+
+    return 1;
+  }
+  g_option_context_free (context);
+
+  gst_init (NULL, NULL);
+
+  if (opt_size && sscanf (opt_size, "%ix%i", &width, &height) != 2) {
+    g_printerr ("Invalid size: %s\n", opt_size);
+    return 1;
+  }
+  opt_frames = MAX (opt_frames, 1);
+
+  if (!(tmp_dir = g_dir_make_tmp ("clapper-bench-XXXXXX", &error))) {
+    g_printerr ("Could not create temporary dir: %s\n", error->message);
+    g_clear_error (&error);
+
+    return 1;
+  }
+
+  selected = g_strsplit ((opt_codecs) ? opt_codecs : "h264,h265,vp8,vp9,av1", ",", 0);
+  proposed = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+
+  json = g_string_new ("{\n");
+  g_string_append_printf (json, "  \"benchmark\": \"decoders\",\n");
+  g_string_append_printf (json, "  \"gstreamer_version\": \"%s\",\n", gst_version_string ());
+  g_string_append_printf (json, "  \"config\": { \"frames\": %i, \"width\": %i, \"height\": %i, "
+      "\"runs\": %i, \"n_cpus\": %u },\n", opt_frames, width, height, MAX (opt_runs, 1),
+      g_get_num_processors ());
+  g_string_append (json, "  \"results\": [\n");
+
+  for (i = 0; i < G_N_ELEMENTS (codecs); ++i) {
+    const BenchCodec *codec = &codecs[i];
+    GArray *results;
+    GList *decoders, *filtered, *list;
+    GstCaps *caps;
+    gchar *location;
+    gint fastest = -1;
+
+    if (!g_strv_contains ((const gchar * const *) selected, codec->name))
+      continue;
+
+    g_printerr ("Measuring %s decoders...\n", codec->name);
+
+    if (n_results++ > 0)
+      g_string_append (json, ",\n");
+
+    if (!(location = _generate_clip (codec, tmp_dir, width, height, &error))) {
+      g_printerr ("  skipped: %s\n", error->message);
+      _append_codec_result (json, codec, NULL, -1, error->message);
+      g_clear_error (&error);
+      continue;
+    }
+
+    decoders = gst_element_factory_list_get_elements (
+        GST_ELEMENT_FACTORY_TYPE_DECODER | GST_ELEMENT_FACTORY_TYPE_MEDIA_VIDEO, GST_RANK_NONE);
+    caps = gst_caps_from_string (codec->caps);
+    filtered = gst_element_factory_list_filter (decoders, caps, GST_PAD_SINK, FALSE);
+    gst_caps_unref (caps);
+
+    results = g_array_new (FALSE, TRUE, sizeof (BenchResult));
+    g_array_set_clear_func (results, (GDestroyNotify) _result_clear);
+
+    for (list = filtered; list; list = g_list_next (list)) {
+      BenchResult result = { 0, };
+
+      _measure_decoder (codec, location, GST_ELEMENT_FACTORY_CAST (list->data), &result);
+      g_array_append_val (results, result);
+    }
+
+    gst_plugin_feature_list_free (filtered);
+    gst_plugin_feature_list_free (decoders);
+
+    /* Only worth overriding when there is a choice */
+    if ((fastest = _find_fastest (results)) >= 0 && results->len > 1) {
+      g_hash_table_insert (proposed,
+          g_strdup (g_array_index (results, BenchResult, fastest).decoder),
+          GINT_TO_POINTER (PREFERRED_RANK));
+    }
+
+    _append_codec_result (json, codec, results, fastest, NULL);
+
+    g_array_unref (results);
+    g_remove (location);
+    g_free (location);
+  }
+
+  ranks = g_string_new (NULL);
+
+  g_hash_table_iter_init (&iter, proposed);
+  while (g_hash_table_iter_next (&iter, &key, &value)) {
+    g_string_append_printf (ranks, "%s%s:%i", (ranks->len > 0) ? "," : "",
+        (const gchar *) key, GPOINTER_TO_INT (value));
+  }
+
+  g_string_append_printf (json, "\n  ],\n  \"proposed_ranks\": \"%s\"\n}\n", ranks->str);
+
+  if (opt_output) {
+    if (!g_file_set_contents (opt_output, json->str, json->len, &error)) {
+      g_printerr ("Could not write output: %s\n", error->message);
+      g_clear_error (&error);
+      ret = 1;
+    }
+  } else {
+    fputs (json->str, stdout);
+  }
+
+  if (opt_apply && g_hash_table_size (proposed) > 0
+      && !_apply_overrides (proposed, &error)) {
+    g_printerr ("Could not apply rank overrides: %s\n", error->message);
+    g_clear_error (&error);
+    ret = 1;
+  }
+
+  g_string_free (ranks, TRUE);
+  g_string_free (json, TRUE);
+  g_hash_table_unref (proposed);
+  g_strfreev (selected);
+
+  g_rmdir (tmp_dir);
+  g_free (tmp_dir);
+
+  return ret;
+}
@@ -0,0 +1,352 @@
+/* Clapper Playback Library
+ * Copyright (C) 2025 Rafał Dzięgiel <rafostar.github@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Measures how many queue items per second discoverer processes.
+ *
+ * Compares full discovery with lightweight tag probing of local files.
+ * Each mode gets its own copies of a generated media file, so neither
+ * of them is served from discovery cache, which is kept in a temporary
+ * directory instead of the user one. Results are printed as JSON.
+ */
+
+#include <stdio.h>
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <gst/gst.h>
+#include <clapper/clapper.h>
+
+#define SOURCE_NAME "source.mkv"
+
+typedef struct
+{
+  ClapperDiscoverer *discoverer;
+  GMainLoop *loop;
+  guint n_items;
+  gint64 deadline;
+} BenchState;
+
+static gint opt_items = 100;
+static gint opt_workers = 1;
+static gint opt_timeout = 300;
+static gchar *opt_output = NULL;
+
+static GOptionEntry option_entries[] =
+{
+  { "items", 'n', 0, G_OPTION_ARG_INT, &opt_items, "Number of queue items discovered in each mode (default: 100)", "N" },
+  { "workers", 'w', 0, G_OPTION_ARG_INT, &opt_workers, "Number of discoverer workers (default: 1)", "N" },
+  { "timeout", 't', 0, G_OPTION_ARG_INT, &opt_timeout, "Give up on a mode after this many seconds (default: 300)", "SECONDS" },
+  { "output", 'o', 0, G_OPTION_ARG_FILENAME, &opt_output, "Write JSON to file instead of stdout", "FILE" },
+  { NULL }
+};
+
+static gboolean
+_generate_media (const gchar *location, GError **error)
+{
+  GstElement *pipeline;
+  GstBus *bus;
+  GstMessage *msg;
+  gchar *desc;
+  gboolean success;
+
+  /* Short raw streams, so they are cheap to decode in full discovery */
+  desc = g_strdup_printf (
+      "videotestsrc num-buffers=30 ! video/x-raw,format=I420,width=160,height=120,framerate=30/1 "
+      "! queue ! mux. "
+      "audiotestsrc num-buffers=10 samplesperbuffer=4800 ! audio/x-raw,format=S16LE,rate=48000,channels=2 "
+      "! queue ! mux. "
+      "matroskamux name=mux ! filesink location=\"%s\"", location);
+  pipeline = gst_parse_launch (desc, error);
+  g_free (desc);
+
+  if (!pipeline)
+    return FALSE;
+
+  gst_element_set_state (pipeline, GST_STATE_PLAYING);
+
+  bus = gst_element_get_bus (pipeline);
+  msg = gst_bus_timed_pop_filtered (bus, GST_CLOCK_TIME_NONE,
+      GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+  gst_object_unref (bus);
+
+  if (!(success = (GST_MESSAGE_TYPE (msg) != GST_MESSAGE_ERROR)))
+    gst_message_parse_error (msg, error, NULL);
+
+  gst_message_unref (msg);
+
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (pipeline);
+
+  return success;
+}
+
+/* Each item gets its own file, so discovery results are not shared */
+static gboolean
+_make_copies (const gchar *dir, const gchar *mode_name, guint n_items, GError **error)
+{
+  gchar *source, *contents = NULL;
+  gsize length = 0;
+  guint i;
+  gboolean success;
+
+  source = g_build_filename (dir, SOURCE_NAME, NULL);
+  success = g_file_get_contents (source, &contents, &length, error);
+  g_free (source);
+
+  for (i = 0; success && i < n_items; ++i) {
+    gchar *name = g_strdup_printf ("%s-%u.mkv", mode_name, i);
+    gchar *location = g_build_filename (dir, name, NULL);
+
+    success = g_file_set_contents (location, contents, length, error);
+
+    g_free (location);
+    g_free (name);
+  }
+
+  g_free (contents);
+
+  return success;
+}
+
+static void
+_remove_copies (const gchar *dir, const gchar *mode_name, guint n_items)
+{
+  guint i;
+
+  for (i = 0; i < n_items; ++i) {
+    gchar *name = g_strdup_printf ("%s-%u.mkv", mode_name, i);
+    gchar *location = g_build_filename (dir, name, NULL);
+
+    g_remove (location);
+
+    g_free (location);
+    g_free (name);
+  }
+}
+
+static void
+_remove_dir_recursive (const gchar *path)
+{
+  GDir *dir;
+
+  if ((dir = g_dir_open (path, 0, NULL))) {
+    const gchar *name;
+
+    while ((name = g_dir_read_name (dir))) {
+      gchar *child = g_build_filename (path, name, NULL);
+
+      if (g_file_test (child, G_FILE_TEST_IS_DIR))
+        _remove_dir_recursive (child);
+      else
+        g_remove (child);
+
+      g_free (child);
+    }
+    g_dir_close (dir);
+  }
+
+  g_rmdir (path);
+}
+
+static gboolean
+_check_done_cb (BenchState *state)
+{
+  guint n_discovered = 0;
+
+  G_GNUC_BEGIN_IGNORE_DEPRECATIONS
+  clapper_discoverer_get_stats (state->discoverer, &n_discovered, NULL, NULL, NULL);
+  G_GNUC_END_IGNORE_DEPRECATIONS
+
+  if (n_discovered >= state->n_items || g_get_monotonic_time () >= state->deadline) {
+    g_main_loop_quit (state->loop);
+    return G_SOURCE_REMOVE;
+  }
+
+  return G_SOURCE_CONTINUE;
+}
+
+static void
+_append_double (GString *json, const gchar *key, gdouble value, gboolean last)
+{
+  gchar buf[G_ASCII_DTOSTR_BUF_SIZE];
+
+  g_string_append_printf (json, "\"%s\": %s%s", key,
+      g_ascii_formatd (buf, sizeof (buf), "%.3f", value), (last) ? "" : ", ");
+}
+
+static void
+_run_mode (GString *json, const gchar *dir, const gchar *mode_name, gboolean lightweight, guint n_items)
+{
+  ClapperPlayer *player;
+  ClapperQueue *queue;
+  BenchState state = { 0, };
+  gdouble elapsed, items_per_second, mean_latency, max_latency;
+  guint i, n_discovered = 0;
+  gint64 start;
+
+  player = clapper_player_new ();
+  queue = clapper_player_get_queue (player);
+
+  G_GNUC_BEGIN_IGNORE_DEPRECATIONS
+  state.discoverer = clapper_discoverer_new ();
+  clapper_discoverer_set_discovery_mode (state.discoverer, CLAPPER_DISCOVERER_DISCOVERY_ALWAYS);
+  clapper_discoverer_set_n_workers (state.discoverer, (guint) MAX (opt_workers, 1));
+  clapper_discoverer_set_lightweight (state.discoverer, lightweight);
+  G_GNUC_END_IGNORE_DEPRECATIONS
+
+  clapper_player_add_feature (player, CLAPPER_FEATURE_CAST (state.discoverer));
+
+  state.loop = g_main_loop_new (NULL, FALSE);
+  state.n_items = n_items;
+
+  start = g_get_monotonic_time ();
+  state.deadline = start + (gint64) MAX (opt_timeout, 1) * G_USEC_PER_SEC;
+
+  for (i = 0; i < n_items; ++i) {
+    gchar *name = g_strdup_printf ("%s-%u.mkv", mode_name, i);
+    gchar *location = g_build_filename (dir, name, NULL);
+    gchar *uri = gst_filename_to_uri (location, NULL);
+    ClapperMediaItem *item = clapper_media_item_new (uri);
+
+    clapper_queue_add_item (queue, item);
+
+    gst_object_unref (item);
+    g_free (uri);
+    g_free (location);
+    g_free (name);
+  }
+
+  g_timeout_add (10, (GSourceFunc) _check_done_cb, &state);
+  g_main_loop_run (state.loop);
+
+  elapsed = (gdouble) (g_get_monotonic_time () - start) / G_USEC_PER_SEC;
+  G_GNUC_BEGIN_IGNORE_DEPRECATIONS
+  clapper_discoverer_get_stats (state.discoverer, &n_discovered,
+      &items_per_second, &mean_latency, &max_latency);
+  G_GNUC_END_IGNORE_DEPRECATIONS
+
+  if (n_discovered < n_items)
+    g_printerr ("Timed out with %u of %u items discovered\n", n_discovered, n_items);
+
+  g_string_append_printf (json, "    { \"mode\": \"%s\", \"items\": %u, \"discovered\": %u, ",
+      mode_name, n_items, n_discovered);
+  _append_double (json, "seconds", elapsed, FALSE);
+  _append_double (json, "items_per_sec", n_discovered / elapsed, FALSE);
+  _append_double (json, "busy_items_per_sec", items_per_second, FALSE);
+  _append_double (json, "mean_latency", mean_latency, FALSE);
+  _append_double (json, "max_latency", max_latency, TRUE);
+  g_string_append (json, " }");
+
+  g_main_loop_unref (state.loop);
+  gst_object_unref (state.discoverer);
+
+  clapper_player_stop (player);
+  gst_object_unref (player);
+}
+
+gint
+main (gint argc, gchar **argv)
+{
+  GOptionContext *context;
+  GError *error = NULL;
+  GString *json;
+  gchar *tmp_dir, *cache_dir, *source;
+  guint n_items;
+  gint ret = 0;
+
+  context = g_option_context_new ("- benchmark discoverer throughput");
+  g_option_context_add_main_entries (context, option_entries, NULL);
+  g_option_context_add_group (context, gst_init_get_option_group ());
+
+  if (!g_option_context_parse (context, &argc, &argv, &error)) {
+    g_printerr ("%s\n", error->message);
+    g_clear_error (&error);
+    g_option_context_free (context);
+
+    return 1;
+  }
+  g_option_context_free (context);
+
+  if (!(tmp_dir = g_dir_make_tmp ("clapper-bench-XXXXXX", &error))) {
+    g_printerr ("Could not create temporary directory: %s\n", error->message);
+    g_clear_error (&error);
+
+    return 1;
+  }
+
+  /* Keep discovery cache away from user cache and
+   * make sure that it is empty, before it is first read */
+  cache_dir = g_build_filename (tmp_dir, "cache", NULL);
+  g_setenv ("XDG_CACHE_HOME", cache_dir, TRUE);
+
+  clapper_init (NULL, NULL);
+
+  n_items = (guint) MAX (opt_items, 1);
+  source = g_build_filename (tmp_dir, SOURCE_NAME, NULL);
+
+  if (!_generate_media (source, &error)
+      || !_make_copies (tmp_dir, "full", n_items, &error)
+      || !_make_copies (tmp_dir, "lightweight", n_items, &error)) {
+    g_printerr ("Could not prepare media: %s\n", (error) ? error->message : "unknown error");
+    g_clear_error (&error);
+    ret = 1;
+
+    goto cleanup;
+  }
+
+  json = g_string_new ("{\n");
+  g_string_append_printf (json, "  \"benchmark\": \"discovery\",\n");
+  g_string_append_printf (json, "  \"clapper_version\": \"%s\",\n", CLAPPER_VERSION_S);
+  g_string_append_printf (json, "  \"config\": { \"items\": %u, \"workers\": %i, \"n_cpus\": %u },\n",
+      n_items, MAX (opt_workers, 1), g_get_num_processors ());
+  g_string_append (json, "  \"results\": [\n");
+
+  g_printerr ("Measuring full discovery of %u items...\n", n_items);
+  _run_mode (json, tmp_dir, "full", FALSE, n_items);
+  g_string_append (json, ",\n");
+
+  g_printerr ("Measuring lightweight discovery of %u items...\n", n_items);
+  _run_mode (json, tmp_dir, "lightweight", TRUE, n_items);
+
+  g_string_append (json, "\n  ]\n}\n");
+
+  if (opt_output) {
+    if (!g_file_set_contents (opt_output, json->str, json->len, &error)) {
+      g_printerr ("Could not write output: %s\n", error->message);
+      g_clear_error (&error);
+      ret = 1;
+    }
+  } else {
+    fputs (json->str, stdout);
+  }
+
+  g_string_free (json, TRUE);
+
+cleanup:
+  _remove_copies (tmp_dir, "full", n_items);
+  _remove_copies (tmp_dir, "lightweight", n_items);
+  g_remove (source);
+  _remove_dir_recursive (cache_dir);
+  g_rmdir (tmp_dir);
+
+  g_free (source);
+  g_free (cache_dir);
+  g_free (tmp_dir);
+
+  return ret;
+}
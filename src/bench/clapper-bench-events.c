@@ -0,0 +1,305 @@
+/* Clapper Playback Library
+ * Copyright (C) 2025 Rafał Dzięgiel <rafostar.github@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Measures cost of carrying events between threads.
+ *
+ * Compares typed #ClapperEventRing used by app and features buses with
+ * the previous way of sending a #GstStructure inside a #GstMessage
+ * through a #GstBus. Each step runs given number of producer threads
+ * posting events to a single consumer thread, which also verifies that
+ * events of each producer arrive in order. Results are printed as JSON.
+ */
+
+#include <stdio.h>
+#include <glib.h>
+#include <gst/gst.h>
+
+#include "clapper-event-ring-private.h"
+
+#define EVENT_RING_SIZE 256
+
+typedef enum
+{
+  BENCH_TRANSPORT_RING,
+  BENCH_TRANSPORT_BUS,
+} BenchTransport;
+
+typedef struct
+{
+  BenchTransport transport;
+  GstObject *src;
+  ClapperEventRing *ring;
+  GstBus *bus;
+  guint n_producers;
+  guint n_events;
+  guint n_out_of_order;
+} BenchState;
+
+typedef struct
+{
+  BenchState *state;
+  guint id;
+} BenchProducer;
+
+static gint opt_events = 1000000;
+static gchar *opt_producers = NULL;
+static gchar *opt_output = NULL;
+
+static GOptionEntry option_entries[] =
+{
+  { "events", 'e', 0, G_OPTION_ARG_INT, &opt_events, "Number of events posted by each producer (default: 1000000)", "N" },
+  { "producers", 'n', 0, G_OPTION_ARG_STRING, &opt_producers, "Comma separated numbers of producer threads (default: 1,2,4)", "LIST" },
+  { "output", 'o', 0, G_OPTION_ARG_FILENAME, &opt_output, "Write JSON to file instead of stdout", "FILE" },
+  { NULL }
+};
+
+static GQuark event_quark;
+static GQuark value_quark;
+static GQuark extra_value_quark;
+
+static gpointer
+_producer_func (BenchProducer *producer)
+{
+  BenchState *state = producer->state;
+  guint i;
+
+  for (i = 0; i < state->n_events; ++i) {
+    if (state->transport == BENCH_TRANSPORT_RING) {
+      ClapperEvent event = { 0, };
+
+      /* Same work as done when posting position to app bus */
+      event.type = 1;
+      event.src = gst_object_ref (state->src);
+      event.value.v_uint = i;
+      event.extra_value.v_uint = producer->id;
+
+      clapper_event_ring_push (state->ring, &event);
+    } else {
+      gst_bus_post (state->bus, gst_message_new_application (state->src,
+          gst_structure_new_id (event_quark,
+              value_quark, G_TYPE_UINT, i,
+              extra_value_quark, G_TYPE_UINT, producer->id,
+              NULL)));
+    }
+  }
+
+  return NULL;
+}
+
+static gboolean
+_take_event (BenchState *state, guint *value, guint *producer_id)
+{
+  if (state->transport == BENCH_TRANSPORT_RING) {
+    ClapperEvent event;
+
+    if (!clapper_event_ring_pop (state->ring, &event))
+      return FALSE;
+
+    *value = event.value.v_uint;
+    *producer_id = event.extra_value.v_uint;
+    clapper_event_clear (&event);
+  } else {
+    GstMessage *msg;
+
+    if (!(msg = gst_bus_pop (state->bus)))
+      return FALSE;
+
+    gst_structure_id_get (gst_message_get_structure (msg),
+        value_quark, G_TYPE_UINT, value,
+        extra_value_quark, G_TYPE_UINT, producer_id,
+        NULL);
+    gst_message_unref (msg);
+  }
+
+  return TRUE;
+}
+
+static gdouble
+_run_step (BenchState *state)
+{
+  GPtrArray *threads;
+  BenchProducer *producers;
+  guint *next_values;
+  guint i, n_total, n_taken = 0;
+  gint64 start;
+
+  producers = g_new0 (BenchProducer, state->n_producers);
+  next_values = g_new0 (guint, state->n_producers);
+  threads = g_ptr_array_sized_new (state->n_producers);
+  n_total = state->n_producers * state->n_events;
+
+  state->n_out_of_order = 0;
+
+  start = g_get_monotonic_time ();
+
+  for (i = 0; i < state->n_producers; ++i) {
+    producers[i].state = state;
+    producers[i].id = i;
+    g_ptr_array_add (threads, g_thread_new ("BenchProducer",
+        (GThreadFunc) _producer_func, &producers[i]));
+  }
+
+  /* Consume on this thread, like app or features thread would */
+  while (n_taken < n_total) {
+    guint value, producer_id;
+
+    if (!_take_event (state, &value, &producer_id)) {
+      g_thread_yield ();
+      continue;
+    }
+
+    if (G_UNLIKELY (producer_id >= state->n_producers
+        || value != next_values[producer_id]))
+      state->n_out_of_order++;
+    else
+      next_values[producer_id]++;
+
+    n_taken++;
+  }
+
+  for (i = 0; i < threads->len; ++i)
+    g_thread_join (g_ptr_array_index (threads, i));
+
+  g_ptr_array_unref (threads);
+  g_free (next_values);
+  g_free (producers);
+
+  return (gdouble) (g_get_monotonic_time () - start) / G_USEC_PER_SEC;
+}
+
+static void
+_append_double (GString *json, const gchar *key, gdouble value, gboolean last)
+{
+  gchar buf[G_ASCII_DTOSTR_BUF_SIZE];
+
+  g_string_append_printf (json, "\"%s\": %s%s", key,
+      g_ascii_formatd (buf, sizeof (buf), "%.3f", value), (last) ? "" : ", ");
+}
+
+static void
+_append_step_result (GString *json, BenchState *state, gdouble elapsed)
+{
+  guint n_total = state->n_producers * state->n_events;
+
+  g_string_append_printf (json, "    { \"transport\": \"%s\", \"producers\": %u, \"events\": %u, ",
+      (state->transport == BENCH_TRANSPORT_RING) ? "ring" : "bus", state->n_producers, n_total);
+  _append_double (json, "seconds", elapsed, FALSE);
+  _append_double (json, "events_per_sec", n_total / elapsed, FALSE);
+  _append_double (json, "ns_per_event", (elapsed * 1e9) / n_total, FALSE);
+  g_string_append_printf (json, "\"out_of_order\": %u }", state->n_out_of_order);
+}
+
+gint
+main (gint argc, gchar **argv)
+{
+  GOptionContext *context;
+  GError *error = NULL;
+  BenchState state = { 0, };
+  GString *json;
+  gchar **steps;
+  guint i, n_results = 0;
+  gint ret = 0;
+
+  context = g_option_context_new ("- benchmark cross-thread event transport");
+  g_option_context_add_main_entries (context, option_entries, NULL);
+  g_option_context_add_group (context, gst_init_get_option_group ());
+
+  if (!g_option_context_parse (context, &argc, &argv, &error)) {
+    g_printerr ("%s\n", error->message);
+    g_clear_error (&error);
+    g_option_context_free (context);
+
+    return 1;
+  }
+  g_option_context_free (context);
+
+  gst_init (NULL, NULL);
+
+  event_quark = g_quark_from_static_string ("event");
+  value_quark = g_quark_from_static_string ("value");
+  extra_value_quark = g_quark_from_static_string ("extra-value");
+
+  state.src = gst_object_ref_sink (gst_bin_new ("bench"));
+  state.n_events = (guint) MAX (opt_events, 1);
+
+  steps = g_strsplit ((opt_producers) ? opt_producers : "1,2,4", ",", 0);
+
+  json = g_string_new ("{\n");
+  g_string_append_printf (json, "  \"benchmark\": \"events\",\n");
+  g_string_append_printf (json, "  \"config\": { \"events_per_producer\": %u, \"ring_size\": %u, \"n_cpus\": %u },\n",
+      state.n_events, EVENT_RING_SIZE, g_get_num_processors ());
+  g_string_append (json, "  \"results\": [\n");
+
+  for (i = 0; steps[i]; ++i) {
+    guint n_producers = (guint) g_ascii_strtoull (steps[i], NULL, 10);
+
+    if (n_producers == 0) {
+      g_printerr ("Ignoring invalid step: %s\n", steps[i]);
+      continue;
+    }
+    state.n_producers = n_producers;
+
+    for (state.transport = BENCH_TRANSPORT_RING;
+        state.transport <= BENCH_TRANSPORT_BUS; state.transport++) {
+      gdouble elapsed;
+
+      g_printerr ("Measuring %s with %u producers...\n",
+          (state.transport == BENCH_TRANSPORT_RING) ? "ring" : "bus", n_producers);
+
+      if (state.transport == BENCH_TRANSPORT_RING)
+        state.ring = clapper_event_ring_new (EVENT_RING_SIZE);
+      else
+        state.bus = gst_bus_new ();
+
+      elapsed = _run_step (&state);
+
+      if (state.n_out_of_order > 0) {
+        g_printerr ("Events arrived out of order: %u\n", state.n_out_of_order);
+        ret = 1;
+      }
+
+      if (n_results++ > 0)
+        g_string_append (json, ",\n");
+
+      _append_step_result (json, &state, elapsed);
+
+      g_clear_pointer (&state.ring, clapper_event_ring_free);
+      gst_clear_object (&state.bus);
+    }
+  }
+
+  g_string_append (json, "\n  ]\n}\n");
+
+  g_strfreev (steps);
+
+  if (opt_output) {
+    if (!g_file_set_contents (opt_output, json->str, json->len, &error)) {
+      g_printerr ("Could not write output: %s\n", error->message);
+      g_clear_error (&error);
+      ret = 1;
+    }
+  } else {
+    fputs (json->str, stdout);
+  }
+
+  g_string_free (json, TRUE);
+  gst_object_unref (state.src);
+
+  return ret;
+}
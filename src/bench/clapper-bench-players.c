@@ -0,0 +1,476 @@
+/* Clapper Playback Library
+ * Copyright (C) 2025 Rafał Dzięgiel <rafostar.github@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Measures how Clapper scales with many players in a single process.
+ *
+ * Runs increasing number of headless players (fakesinks) playing either
+ * a generated local file or given URI in a loop and reports CPU usage,
+ * thread count, wakeups, memory and player to main thread event latency
+ * for each step as JSON, so results of different builds can be diffed.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <gst/gst.h>
+#include <clapper/clapper.h>
+
+#ifdef G_OS_UNIX
+#include <unistd.h>
+#include <sys/resource.h>
+#endif
+
+#define PING_MESSAGE_NAME "clapper-bench-ping"
+
+typedef struct
+{
+  gint64 cpu_us;
+  gint64 n_ctx_switches;
+  gint64 rss_kb;
+  gint n_threads;
+  gint64 time_us;
+} BenchSample;
+
+typedef struct
+{
+  GPtrArray *players;
+  GArray *latencies;
+  gchar *uri;
+} BenchState;
+
+static gint opt_duration = 10;
+static gint opt_warmup = 2;
+static gint opt_ping_interval = 100;
+static gchar *opt_players = NULL;
+static gchar *opt_uri = NULL;
+static gchar *opt_output = NULL;
+
+static GOptionEntry option_entries[] =
+{
+  { "players", 'n', 0, G_OPTION_ARG_STRING, &opt_players, "Comma separated numbers of players to run (default: 1,2,4,8,16)", "LIST" },
+  { "duration", 'd', 0, G_OPTION_ARG_INT, &opt_duration, "Measurement duration of each step in seconds (default: 10)", "SECONDS" },
+  { "warmup", 'w', 0, G_OPTION_ARG_INT, &opt_warmup, "Time to settle after adding players in seconds (default: 2)", "SECONDS" },
+  { "ping-interval", 'i', 0, G_OPTION_ARG_INT, &opt_ping_interval, "Latency probe interval per player in milliseconds (default: 100)", "MS" },
+  { "uri", 'u', 0, G_OPTION_ARG_STRING, &opt_uri, "Media to play instead of generated test file", "URI" },
+  { "output", 'o', 0, G_OPTION_ARG_FILENAME, &opt_output, "Write JSON to file instead of stdout", "FILE" },
+  { NULL }
+};
+
+static gint
+_read_proc_status_value (const gchar *key)
+{
+  gchar *contents = NULL;
+  gint value = -1;
+
+  if (g_file_get_contents ("/proc/self/status", &contents, NULL, NULL)) {
+    const gchar *line = strstr (contents, key);
+
+    if (line)
+      value = (gint) g_ascii_strtoll (line + strlen (key), NULL, 10);
+
+    g_free (contents);
+  }
+
+  return value;
+}
+
+static void
+_take_sample (BenchSample *sample)
+{
+#ifdef G_OS_UNIX
+  struct rusage usage;
+
+  getrusage (RUSAGE_SELF, &usage);
+
+  sample->cpu_us = (gint64) usage.ru_utime.tv_sec * G_USEC_PER_SEC + usage.ru_utime.tv_usec
+      + (gint64) usage.ru_stime.tv_sec * G_USEC_PER_SEC + usage.ru_stime.tv_usec;
+  sample->n_ctx_switches = usage.ru_nvcsw + usage.ru_nivcsw;
+#else
+  sample->cpu_us = -1;
+  sample->n_ctx_switches = -1;
+#endif
+
+  /* Linux only, reported as -1 elsewhere */
+  sample->rss_kb = _read_proc_status_value ("VmRSS:");
+  sample->n_threads = _read_proc_status_value ("Threads:");
+  sample->time_us = g_get_monotonic_time ();
+}
+
+static gboolean
+_quit_loop_cb (GMainLoop *loop)
+{
+  g_main_loop_quit (loop);
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+_run_for (guint seconds)
+{
+  GMainLoop *loop = g_main_loop_new (NULL, FALSE);
+
+  g_timeout_add_seconds (seconds, (GSourceFunc) _quit_loop_cb, loop);
+  g_main_loop_run (loop);
+  g_main_loop_unref (loop);
+}
+
+static gchar *
+_generate_media (const gchar *dir, GError **error)
+{
+  GstElement *pipeline;
+  GstBus *bus;
+  GstMessage *msg;
+  gchar *location, *desc, *uri = NULL;
+
+  location = g_build_filename (dir, "bench.mkv", NULL);
+
+  /* Raw streams, so no encoders are needed and decoding is trivial */
+  desc = g_strdup_printf (
+      "videotestsrc num-buffers=300 pattern=ball ! video/x-raw,format=I420,width=160,height=120,framerate=30/1 "
+      "! queue ! mux. "
+      "audiotestsrc num-buffers=100 samplesperbuffer=4800 ! audio/x-raw,format=S16LE,rate=48000,channels=2 "
+      "! queue ! mux. "
+      "matroskamux name=mux ! filesink location=\"%s\"", location);
+  pipeline = gst_parse_launch (desc, error);
+  g_free (desc);
+
+  if (!pipeline)
+    goto finish;
+
+  gst_element_set_state (pipeline, GST_STATE_PLAYING);
+
+  bus = gst_element_get_bus (pipeline);
+  msg = gst_bus_timed_pop_filtered (bus, GST_CLOCK_TIME_NONE,
+      GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+  gst_object_unref (bus);
+
+  if (GST_MESSAGE_TYPE (msg) == GST_MESSAGE_ERROR)
+    gst_message_parse_error (msg, error, NULL);
+  else
+    uri = gst_filename_to_uri (location, error);
+
+  gst_message_unref (msg);
+
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (pipeline);
+
+finish:
+  g_free (location);
+
+  return uri;
+}
+
+static void
+_ping_message_cb (ClapperPlayer *player G_GNUC_UNUSED, GstMessage *msg, BenchState *state)
+{
+  const GstStructure *structure = gst_message_get_structure (msg);
+  gint64 sent;
+
+  if (gst_structure_get_int64 (structure, "sent", &sent)) {
+    gint64 latency = g_get_monotonic_time () - sent;
+    g_array_append_val (state->latencies, latency);
+  }
+}
+
+/* Called from player thread */
+static gboolean
+_ping_on_player_thread_cb (ClapperPlayer *player)
+{
+  GstMessage *msg;
+
+  msg = gst_message_new_application (GST_OBJECT_CAST (player),
+      gst_structure_new (PING_MESSAGE_NAME,
+          "sent", G_TYPE_INT64, g_get_monotonic_time (),
+          NULL));
+  clapper_player_post_message (player, msg, CLAPPER_PLAYER_MESSAGE_DESTINATION_APPLICATION);
+
+  return G_SOURCE_REMOVE;
+}
+
+static gboolean
+_ping_players_cb (BenchState *state)
+{
+  guint i;
+
+  for (i = 0; i < state->players->len; ++i) {
+    ClapperPlayer *player = g_ptr_array_index (state->players, i);
+
+    g_main_context_invoke_full (
+        clapper_threaded_object_get_context (CLAPPER_THREADED_OBJECT_CAST (player)),
+        G_PRIORITY_DEFAULT, (GSourceFunc) _ping_on_player_thread_cb,
+        gst_object_ref (player), (GDestroyNotify) gst_object_unref);
+  }
+
+  return G_SOURCE_CONTINUE;
+}
+
+static ClapperPlayer *
+_make_player (BenchState *state)
+{
+  ClapperPlayer *player = clapper_player_new ();
+  ClapperQueue *queue = clapper_player_get_queue (player);
+  ClapperMediaItem *item;
+  GstElement *sink;
+
+  sink = gst_element_factory_make ("fakesink", NULL);
+  g_object_set (sink, "sync", TRUE, NULL);
+  clapper_player_set_video_sink (player, sink);
+
+  sink = gst_element_factory_make ("fakesink", NULL);
+  g_object_set (sink, "sync", TRUE, NULL);
+  clapper_player_set_audio_sink (player, sink);
+
+  g_signal_connect (player, "message::" PING_MESSAGE_NAME,
+      G_CALLBACK (_ping_message_cb), state);
+
+  clapper_queue_set_progression_mode (queue, CLAPPER_QUEUE_PROGRESSION_REPEAT_ITEM);
+
+  item = clapper_media_item_new (state->uri);
+  clapper_queue_add_item (queue, item);
+  clapper_queue_select_item (queue, item);
+  gst_object_unref (item);
+
+  clapper_player_play (player);
+
+  return player;
+}
+
+static gint
+_compare_int64 (gconstpointer a, gconstpointer b)
+{
+  gint64 val_a = *(const gint64 *) a;
+  gint64 val_b = *(const gint64 *) b;
+
+  return (val_a > val_b) - (val_a < val_b);
+}
+
+static void
+_append_double (GString *json, const gchar *key, gdouble value, gboolean last)
+{
+  gchar buf[G_ASCII_DTOSTR_BUF_SIZE];
+
+  g_string_append_printf (json, "\"%s\": %s%s", key,
+      g_ascii_formatd (buf, sizeof (buf), "%.3f", value), (last) ? "" : ", ");
+}
+
+static void
+_append_latencies (GString *json, GArray *latencies)
+{
+  gint64 *values = (gint64 *) (gpointer) latencies->data;
+  gdouble sum = 0;
+  guint i, n = latencies->len;
+
+  g_string_append_printf (json, "\"latency_us\": { \"samples\": %u", n);
+
+  if (n > 0) {
+    g_array_sort (latencies, _compare_int64);
+
+    for (i = 0; i < n; ++i)
+      sum += values[i];
+
+    g_string_append (json, ", ");
+    _append_double (json, "mean", sum / n, FALSE);
+    g_string_append_printf (json,
+        "\"p50\": %" G_GINT64_FORMAT ", \"p95\": %" G_GINT64_FORMAT
+        ", \"p99\": %" G_GINT64_FORMAT ", \"max\": %" G_GINT64_FORMAT,
+        values[n / 2], values[(n * 95) / 100], values[(n * 99) / 100], values[n - 1]);
+  }
+
+  g_string_append (json, " }");
+}
+
+static void
+_append_step_result (GString *json, BenchState *state,
+    const BenchSample *idle, const BenchSample *start, const BenchSample *end)
+{
+  guint n_players = state->players->len;
+  guint i, n_playing = 0;
+  gdouble elapsed = (gdouble) (end->time_us - start->time_us) / G_USEC_PER_SEC;
+  gdouble cpu = (start->cpu_us >= 0)
+      ? 100.0 * (end->cpu_us - start->cpu_us) / (end->time_us - start->time_us) : -1;
+  gdouble wakeups = (start->n_ctx_switches >= 0)
+      ? (end->n_ctx_switches - start->n_ctx_switches) / elapsed : -1;
+  gint64 rss_kb = (idle->rss_kb >= 0) ? end->rss_kb - idle->rss_kb : -1;
+  gint n_threads = (idle->n_threads >= 0) ? end->n_threads - idle->n_threads : -1;
+
+  for (i = 0; i < n_players; ++i) {
+    ClapperPlayer *player = g_ptr_array_index (state->players, i);
+
+    if (clapper_player_get_state (player) == CLAPPER_PLAYER_STATE_PLAYING)
+      n_playing++;
+  }
+
+  g_string_append_printf (json, "    { \"players\": %u, \"playing\": %u, ", n_players, n_playing);
+  _append_double (json, "cpu_percent", cpu, FALSE);
+  _append_double (json, "cpu_percent_per_player", cpu / n_players, FALSE);
+  g_string_append_printf (json, "\"threads\": %i, ", end->n_threads);
+  _append_double (json, "threads_per_player", (gdouble) n_threads / n_players, FALSE);
+  _append_double (json, "wakeups_per_sec", wakeups, FALSE);
+  _append_double (json, "wakeups_per_sec_per_player", wakeups / n_players, FALSE);
+  g_string_append_printf (json, "\"rss_kb\": %" G_GINT64_FORMAT ", ", end->rss_kb);
+  _append_double (json, "rss_kb_per_player", (gdouble) rss_kb / n_players, FALSE);
+  _append_latencies (json, state->latencies);
+  g_string_append (json, " }");
+}
+
+gint
+main (gint argc, gchar **argv)
+{
+  GOptionContext *context;
+  GError *error = NULL;
+  BenchState state = { 0, };
+  BenchSample idle;
+  GString *json;
+  gchar **steps, *tmp_dir = NULL;
+  const gchar *executor;
+  gchar *executor_str;
+  guint i, ping_id, n_results = 0;
+  gint ret = 0;
+
+  context = g_option_context_new ("- benchmark multiple Clapper players");
+  g_option_context_add_main_entries (context, option_entries, NULL);
+  g_option_context_add_group (context, gst_init_get_option_group ());
+
+  if (!g_option_context_parse (context, &argc, &argv, &error)) {
+    g_printerr ("%s\n", error->message);
+    g_clear_error (&error);
+    g_option_context_free (context);
+
+    return 1;
+  }
+  g_option_context_free (context);
+
+  clapper_init (NULL, NULL);
+
+  if (opt_uri) {
+    state.uri = g_strdup (opt_uri);
+  } else if ((tmp_dir = g_dir_make_tmp ("clapper-bench-XXXXXX", &error))) {
+    state.uri = _generate_media (tmp_dir, &error);
+  }
+
+  if (!state.uri) {
+    g_printerr ("Could not prepare media: %s\n", (error) ? error->message : "unknown error");
+    g_clear_error (&error);
+    ret = 1;
+
+    goto cleanup;
+  }
+
+  state.players = g_ptr_array_new_with_free_func ((GDestroyNotify) gst_object_unref);
+  state.latencies = g_array_new (FALSE, FALSE, sizeof (gint64));
+
+  steps = g_strsplit ((opt_players) ? opt_players : "1,2,4,8,16", ",", 0);
+  executor = g_getenv ("CLAPPER_EXECUTOR_THREADS");
+
+  /* Env is written as number, "auto" or null, never as-is into JSON */
+  if (!executor) {
+    executor_str = g_strdup ("null");
+  } else if (g_str_equal (executor, "auto")) {
+    executor_str = g_strdup ("\"auto\"");
+  } else {
+    guint64 n_threads;
+
+    executor_str = (g_ascii_string_to_unsigned (executor, 10, 0, G_MAXUINT, &n_threads, NULL))
+        ? g_strdup_printf ("%" G_GUINT64_FORMAT, n_threads)
+        : g_strdup ("null");
+  }
+
+  _take_sample (&idle);
+
+  json = g_string_new ("{\n");
+  g_string_append_printf (json, "  \"benchmark\": \"players\",\n");
+  g_string_append_printf (json, "  \"clapper_version\": \"%s\",\n", CLAPPER_VERSION_S);
+  g_string_append_printf (json, "  \"config\": { \"uri\": \"%s\", \"duration\": %i, \"warmup\": %i, "
+      "\"ping_interval_ms\": %i, \"executor_threads\": %s, \"n_cpus\": %u },\n",
+      (opt_uri) ? "custom" : "generated", opt_duration, opt_warmup, opt_ping_interval,
+      executor_str, g_get_num_processors ());
+  g_free (executor_str);
+  g_string_append_printf (json, "  \"idle\": { \"threads\": %i, \"rss_kb\": %" G_GINT64_FORMAT " },\n",
+      idle.n_threads, idle.rss_kb);
+  g_string_append (json, "  \"results\": [\n");
+
+  ping_id = g_timeout_add (MAX (opt_ping_interval, 1), (GSourceFunc) _ping_players_cb, &state);
+
+  for (i = 0; steps[i]; ++i) {
+    BenchSample start, end;
+    guint n_players = (guint) g_ascii_strtoull (steps[i], NULL, 10);
+
+    if (n_players == 0 || n_players < state.players->len) {
+      g_printerr ("Ignoring invalid step: %s\n", steps[i]);
+      continue;
+    }
+
+    g_printerr ("Measuring %u players...\n", n_players);
+
+    while (state.players->len < n_players)
+      g_ptr_array_add (state.players, _make_player (&state));
+
+    _run_for (MAX (opt_warmup, 1));
+
+    g_array_set_size (state.latencies, 0);
+    _take_sample (&start);
+
+    _run_for (MAX (opt_duration, 1));
+
+    _take_sample (&end);
+
+    if (n_results++ > 0)
+      g_string_append (json, ",\n");
+
+    _append_step_result (json, &state, &idle, &start, &end);
+  }
+
+  g_string_append (json, "\n  ]\n}\n");
+
+  g_source_remove (ping_id);
+  g_strfreev (steps);
+
+  if (opt_output) {
+    if (!g_file_set_contents (opt_output, json->str, json->len, &error)) {
+      g_printerr ("Could not write output: %s\n", error->message);
+      g_clear_error (&error);
+      ret = 1;
+    }
+  } else {
+    fputs (json->str, stdout);
+  }
+
+  g_string_free (json, TRUE);
+
+  for (i = 0; i < state.players->len; ++i)
+    clapper_player_stop (g_ptr_array_index (state.players, i));
+
+  g_ptr_array_unref (state.players);
+  g_array_unref (state.latencies);
+
+cleanup:
+  if (tmp_dir) {
+    gchar *location = g_build_filename (tmp_dir, "bench.mkv", NULL);
+
+    g_remove (location);
+    g_rmdir (tmp_dir);
+
+    g_free (location);
+    g_free (tmp_dir);
+  }
+  g_free (state.uri);
+
+  return ret;
+}
@@ -17,11 +17,13 @@
 
 #include "config.h"
 
+#include <math.h>
 #include <gdk/gdk.h>
 
 #include "clapper-app-queue-list.h"
 #include "clapper-app-queue-selection.h"
 #include "clapper-app-media-item-box.h"
+#include "clapper-app-window.h"
 #include "clapper-app-utils.h"
 
 #define GST_CAT_DEFAULT clapper_app_queue_list_debug
@@ -43,6 +45,9 @@ struct _ClapperAppQueueList
 
   GBinding *queue_progression_binding;
 
+  GtkAdjustment *vadjustment;
+  ClapperFeature *discoverer;
+
   GtkWidget *list_target; // store last target
   gboolean drop_after; // if should drop below list_target
 };
@@ -356,6 +361,44 @@ _item_selected_cb (ClapperAppQueueSelection *selection, guint index, ClapperAppQ
     gtk_revealer_set_reveal_child (GTK_REVEALER (list_revealer), FALSE);
 }
 
+/*
+ * Pass range of currently visible rows to discoverer, so their
+ * items get discovered first. Rows in this list have the same height,
+ * so we can calculate range from adjustment alone.
+ */
+static void
+_update_visible_range (ClapperAppQueueList *self)
+{
+#if CLAPPER_HAVE_DISCOVERER
+  GtkSelectionModel *model;
+  gdouble upper, row_height;
+  guint n_items, position, n_visible;
+
+  if (!self->discoverer || !self->vadjustment
+      || !(model = gtk_list_view_get_model (GTK_LIST_VIEW (self->list_view))))
+    return;
+
+  n_items = g_list_model_get_n_items (G_LIST_MODEL (model));
+  upper = gtk_adjustment_get_upper (self->vadjustment);
+
+  if (n_items == 0 || upper <= 0)
+    return;
+
+  row_height = upper / n_items;
+  position = (guint) (gtk_adjustment_get_value (self->vadjustment) / row_height);
+  n_visible = (guint) ceil (gtk_adjustment_get_page_size (self->vadjustment) / row_height) + 1;
+
+  clapper_discoverer_prioritize_range (CLAPPER_DISCOVERER (self->discoverer),
+      position, n_visible);
+#endif
+}
+
+static void
+_vadjustment_changed_cb (GtkAdjustment *adjustment G_GNUC_UNUSED, ClapperAppQueueList *self)
+{
+  _update_visible_range (self);
+}
+
 static gboolean
 _queue_progression_mode_transform_to_func (GBinding *binding, const GValue *from_value,
     GValue *to_value, ClapperAppQueueList *self)
@@ -406,6 +449,22 @@ clapper_app_queue_list_realize (GtkWidget *widget)
         GTK_SELECTION_MODEL (selection));
     g_object_unref (selection);
   }
+
+  if (CLAPPER_APP_IS_WINDOW (gtk_widget_get_root (widget))) {
+    ClapperFeature *discoverer = clapper_app_window_get_discoverer (
+        CLAPPER_APP_WINDOW_CAST (gtk_widget_get_root (widget)));
+
+    if (discoverer) {
+      self->discoverer = gst_object_ref (discoverer);
+      self->vadjustment = g_object_ref (
+          gtk_scrollable_get_vadjustment (GTK_SCROLLABLE (self->list_view)));
+
+      g_signal_connect (self->vadjustment, "value-changed",
+          G_CALLBACK (_vadjustment_changed_cb), self);
+      g_signal_connect (self->vadjustment, "changed",
+          G_CALLBACK (_vadjustment_changed_cb), self);
+    }
+  }
 }
 
 static void
@@ -418,6 +477,12 @@ clapper_app_queue_list_unrealize (GtkWidget *widget)
   g_clear_pointer (&self->queue_progression_binding, g_binding_unbind);
   gtk_list_view_set_model (GTK_LIST_VIEW (self->list_view), NULL);
 
+  if (self->vadjustment) {
+    g_signal_handlers_disconnect_by_func (self->vadjustment, _vadjustment_changed_cb, self);
+    g_clear_object (&self->vadjustment);
+  }
+  gst_clear_object (&self->discoverer);
+
   GTK_WIDGET_CLASS (parent_class)->unrealize (widget);
 }
 
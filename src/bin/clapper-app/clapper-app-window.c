@@ -60,6 +60,7 @@ struct _ClapperAppWindow
   GtkCssProvider *provider;
 
   ClapperMediaItem *current_item;
+  ClapperFeature *discoverer;
 
   GSettings *settings;
 
@@ -1140,6 +1141,13 @@ clapper_app_window_get_player (ClapperAppWindow *self)
   return clapper_gtk_av_get_player (CLAPPER_GTK_AV_CAST (self->video));
 }
 
+/* Returns discoverer feature or %NULL if not used */
+ClapperFeature *
+clapper_app_window_get_discoverer (ClapperAppWindow *self)
+{
+  return self->discoverer;
+}
+
 ClapperAppWindowExtraOptions *
 clapper_app_window_get_extra_options (ClapperAppWindow *self)
 {
@@ -1319,7 +1327,7 @@ clapper_app_window_constructed (GObject *object)
   } else {
     feature = CLAPPER_FEATURE (clapper_discoverer_new ());
     clapper_player_add_feature (player, feature);
-    gst_object_unref (feature);
+    self->discoverer = feature; // take ref
   }
 #endif
 
@@ -1381,6 +1389,7 @@ clapper_app_window_dispose (GObject *object)
   gtk_widget_dispose_template (GTK_WIDGET (object), CLAPPER_APP_TYPE_WINDOW);
 
   gst_clear_object (&self->current_item);
+  gst_clear_object (&self->discoverer);
 
   G_OBJECT_CLASS (parent_class)->dispose (object);
 }
@@ -47,6 +47,9 @@ GtkWidget * clapper_app_window_get_video (ClapperAppWindow *window);
 G_GNUC_INTERNAL
 ClapperPlayer * clapper_app_window_get_player (ClapperAppWindow *window);
 
+G_GNUC_INTERNAL
+ClapperFeature * clapper_app_window_get_discoverer (ClapperAppWindow *window);
+
 G_GNUC_INTERNAL
 ClapperAppWindowExtraOptions * clapper_app_window_get_extra_options (ClapperAppWindow *window);
 
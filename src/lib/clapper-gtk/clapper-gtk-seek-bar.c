@@ -29,9 +29,11 @@
 #include "clapper-gtk-seek-bar.h"
 #include "clapper-gtk-container.h"
 #include "clapper-gtk-utils.h"
+#include "clapper-gtk-thumbnailer-private.h"
 
 #define DEFAULT_REVEAL_LABELS TRUE
 #define DEFAULT_SEEK_METHOD CLAPPER_PLAYER_SEEK_METHOD_NORMAL
+#define DEFAULT_SHOW_THUMBNAILS FALSE
 
 #define GST_CAT_DEFAULT clapper_gtk_seek_bar_debug
 GST_DEBUG_CATEGORY_STATIC (GST_CAT_DEFAULT);
@@ -46,6 +48,7 @@ struct _ClapperGtkSeekBar
   GtkWidget *scale;
 
   GtkPopover *popover;
+  GtkPicture *popover_picture;
   GtkLabel *popover_label;
 
   GtkWidget *duration_revealer;
@@ -64,6 +67,14 @@ struct _ClapperGtkSeekBar
 
   gboolean reveal_labels;
   ClapperPlayerSeekMethod seek_method;
+  gboolean show_thumbnails;
+
+  ClapperGtkThumbnailer *thumbnailer;
+
+  /* Last popover placement, so it can be updated
+   * when thumbnail arrives (negative when hidden) */
+  gdouble popover_x;
+  gdouble popover_val;
 
   ClapperPlayer *player;
   ClapperMediaItem *current_item;
@@ -100,6 +111,7 @@ enum
   PROP_0,
   PROP_REVEAL_LABELS,
   PROP_SEEK_METHOD,
+  PROP_SHOW_THUMBNAILS,
   PROP_LAST
 };
 
@@ -113,8 +125,9 @@ _prepare_popover (ClapperGtkSeekBar *self, gdouble x,
    * (currently set title label remains the same) */
   gboolean found_title = (pointing_val >= self->curr_marker_start
       && pointing_val < self->next_marker_start);
+  gboolean found_thumbnail = FALSE;
 
-  if (!found_title) {
+  if (!found_title && self->has_markers) {
     ClapperTimeline *timeline = clapper_media_item_get_timeline (self->current_item);
     guint i = clapper_timeline_get_n_markers (timeline);
 
@@ -149,10 +162,46 @@ _prepare_popover (ClapperGtkSeekBar *self, gdouble x,
     }
   }
 
+  if (self->thumbnailer) {
+    GdkTexture *thumbnail = clapper_gtk_thumbnailer_get_thumbnail (self->thumbnailer, pointing_val);
+
+    gtk_picture_set_paintable (self->popover_picture, GDK_PAINTABLE (thumbnail));
+
+    if ((found_thumbnail = (thumbnail != NULL)))
+      g_object_unref (thumbnail);
+  }
+
+  gtk_widget_set_visible (GTK_WIDGET (self->popover_label), found_title);
+  gtk_widget_set_visible (GTK_WIDGET (self->popover_picture), found_thumbnail);
+
   gtk_popover_set_pointing_to (self->popover,
       &(const GdkRectangle){ x, 0, 1, 1 });
 
-  return found_title;
+  self->popover_x = x;
+  self->popover_val = pointing_val;
+
+  return (found_title || found_thumbnail);
+}
+
+static void
+_popover_popdown (ClapperGtkSeekBar *self)
+{
+  self->popover_val = -1;
+  gtk_popover_popdown (self->popover);
+}
+
+static void
+_thumbnail_ready_cb (ClapperGtkThumbnailer *thumbnailer G_GNUC_UNUSED, ClapperGtkSeekBar *self)
+{
+  /* Not pointing at seek bar anymore */
+  if (self->popover_val < 0)
+    return;
+
+  GST_LOG_OBJECT (self, "Thumbnail ready, refreshing popover");
+
+  if (_prepare_popover (self, self->popover_x, self->popover_val,
+      gtk_adjustment_get_upper (gtk_range_get_adjustment (GTK_RANGE (self->scale)))))
+    gtk_popover_popup (self->popover);
 }
 
 static inline gboolean
@@ -232,12 +281,17 @@ scale_value_changed_cb (GtkRange *range, ClapperGtkSeekBar *self)
       (self->has_hours) ? position_str : position_str + 3);
   g_free (position_str);
 
-  if (self->dragging && self->has_markers) {
+  /* Player drops outdated requests while scrubbing,
+   * so we can seek on each change to preview position */
+  if (self->dragging && self->player)
+    clapper_player_seek_custom (self->player, value, self->seek_method);
+
+  if (self->dragging && (self->has_markers || self->thumbnailer)) {
     gdouble min_pointing_val, max_pointing_val;
     gdouble x, upper, scaling;
 
     if (!_compute_scale_coords (self, &min_pointing_val, &max_pointing_val)) {
-      gtk_popover_popdown (self->popover);
+      _popover_popdown (self);
       return;
     }
 
@@ -262,6 +316,7 @@ scale_css_classes_changed_cb (GtkWidget *widget,
     GParamSpec *pspec G_GNUC_UNUSED, ClapperGtkSeekBar *self)
 {
   const gboolean dragging = gtk_widget_has_css_class (widget, "dragging");
+  ClapperPlayerSeekMethod seek_method;
   gdouble value;
 
   if (self->dragging == dragging)
@@ -269,6 +324,10 @@ scale_css_classes_changed_cb (GtkWidget *widget,
 
   if ((self->dragging = dragging)) {
     GST_DEBUG_OBJECT (self, "Scale drag started");
+
+    if (self->player)
+      clapper_player_set_scrubbing (self->player, TRUE);
+
     return;
   }
 
@@ -287,11 +346,15 @@ scale_css_classes_changed_cb (GtkWidget *widget,
   if (self->has_markers
       && G_APPROX_VALUE (self->curr_marker_start, value, FLT_EPSILON)) {
     GST_DEBUG ("Seeking to marker");
-    clapper_player_seek_custom (self->player, value,
-        MIN (self->seek_method, CLAPPER_PLAYER_SEEK_METHOD_NORMAL));
+    seek_method = MIN (self->seek_method, CLAPPER_PLAYER_SEEK_METHOD_NORMAL);
   } else {
-    clapper_player_seek_custom (self->player, value, self->seek_method);
+    seek_method = (self->seek_method == CLAPPER_PLAYER_SEEK_METHOD_FAST)
+        ? CLAPPER_PLAYER_SEEK_METHOD_FAST
+        : CLAPPER_PLAYER_SEEK_METHOD_ACCURATE;
   }
+
+  /* Performs single final seek to above position */
+  clapper_player_finish_scrubbing (self->player, value, seek_method);
 }
 
 static void
@@ -333,14 +396,14 @@ motion_cb (GtkEventControllerMotion *motion,
   gdouble min_pointing_val, max_pointing_val, pointing_val;
   gdouble upper, scaling;
 
-  /* If no markers, popover should never popup,
-   * so we do not try to pop it down here */
-  if (!self->has_markers)
+  /* If no markers and thumbnails, popover should never
+   * popup, so we do not try to pop it down here */
+  if (!self->has_markers && !self->thumbnailer)
     return;
 
   if (!_compute_scale_coords (self, &min_pointing_val, &max_pointing_val)
       || (x < min_pointing_val || x > max_pointing_val)) {
-    gtk_popover_popdown (self->popover);
+    _popover_popdown (self);
     return;
   }
 
@@ -364,14 +427,14 @@ motion_cb (GtkEventControllerMotion *motion,
 static void
 motion_leave_cb (GtkEventControllerMotion *motion, ClapperGtkSeekBar *self)
 {
-  gtk_popover_popdown (self->popover);
+  _popover_popdown (self);
 }
 
 static void
 touch_released_cb (GtkGestureClick *click, gint n_press,
     gdouble x, gdouble y, ClapperGtkSeekBar *self)
 {
-  gtk_popover_popdown (self->popover);
+  _popover_popdown (self);
 }
 
 static void
@@ -508,6 +571,31 @@ _update_scale_marks (ClapperGtkSeekBar *self, ClapperTimeline *timeline)
   self->has_markers = TRUE;
 }
 
+static void
+_ensure_thumbnailer (ClapperGtkSeekBar *self)
+{
+  if (self->thumbnailer)
+    return;
+
+  self->thumbnailer = clapper_gtk_thumbnailer_new ();
+  g_signal_connect (self->thumbnailer, "thumbnail-ready",
+      G_CALLBACK (_thumbnail_ready_cb), self);
+
+  clapper_gtk_thumbnailer_set_media_item (self->thumbnailer, self->current_item);
+}
+
+static void
+_clear_thumbnailer (ClapperGtkSeekBar *self)
+{
+  if (!self->thumbnailer)
+    return;
+
+  g_signal_handlers_disconnect_by_func (self->thumbnailer, _thumbnail_ready_cb, self);
+  g_clear_object (&self->thumbnailer);
+
+  _popover_popdown (self);
+}
+
 static void
 _current_item_duration_changed_cb (ClapperMediaItem *current_item,
     GParamSpec *pspec G_GNUC_UNUSED, ClapperGtkSeekBar *self)
@@ -544,6 +632,9 @@ _queue_current_item_changed_cb (ClapperQueue *queue,
   gst_object_replace ((GstObject **) &self->current_item, GST_OBJECT_CAST (current_item));
   gst_clear_object (&current_item);
 
+  if (self->thumbnailer)
+    clapper_gtk_thumbnailer_set_media_item (self->thumbnailer, self->current_item);
+
   /* Reconnect signals to new item */
   if (self->current_item) {
     ClapperTimeline *timeline = clapper_media_item_get_timeline (self->current_item);
@@ -644,6 +735,56 @@ clapper_gtk_seek_bar_get_seek_method (ClapperGtkSeekBar *self)
   return self->seek_method;
 }
 
+/**
+ * clapper_gtk_seek_bar_set_show_thumbnails:
+ * @seek_bar: a #ClapperGtkSeekBar
+ * @show: whether to show thumbnails
+ *
+ * Set whether a video frame preview should be shown above
+ * position that seek bar is hovered at.
+ *
+ * Thumbnails are extracted in the background on demand and
+ * cached on disk, so they appear instantly when hovered again.
+ * This is disabled by default, as extraction opens a second
+ * decoding pipeline for currently played media.
+ *
+ * Since: 0.12
+ */
+void
+clapper_gtk_seek_bar_set_show_thumbnails (ClapperGtkSeekBar *self, gboolean show)
+{
+  g_return_if_fail (CLAPPER_GTK_IS_SEEK_BAR (self));
+
+  if (self->show_thumbnails != show) {
+    self->show_thumbnails = show;
+
+    if (!show)
+      _clear_thumbnailer (self);
+    else if (self->player)
+      _ensure_thumbnailer (self);
+
+    g_object_notify_by_pspec (G_OBJECT (self), param_specs[PROP_SHOW_THUMBNAILS]);
+  }
+}
+
+/**
+ * clapper_gtk_seek_bar_get_show_thumbnails:
+ * @seek_bar: a #ClapperGtkSeekBar
+ *
+ * Get whether video frame preview is shown when seek bar is hovered.
+ *
+ * Returns: %TRUE if thumbnails are shown, %FALSE otherwise.
+ *
+ * Since: 0.12
+ */
+gboolean
+clapper_gtk_seek_bar_get_show_thumbnails (ClapperGtkSeekBar *self)
+{
+  g_return_val_if_fail (CLAPPER_GTK_IS_SEEK_BAR (self), FALSE);
+
+  return self->show_thumbnails;
+}
+
 static void
 clapper_gtk_seek_bar_init (ClapperGtkSeekBar *self)
 {
@@ -651,6 +792,8 @@ clapper_gtk_seek_bar_init (ClapperGtkSeekBar *self)
 
   self->reveal_labels = DEFAULT_REVEAL_LABELS;
   self->seek_method = DEFAULT_SEEK_METHOD;
+  self->show_thumbnails = DEFAULT_SHOW_THUMBNAILS;
+  self->popover_val = -1;
 
   self->curr_marker_start = -1;
   self->next_marker_start = -1;
@@ -697,6 +840,9 @@ clapper_gtk_seek_bar_realize (GtkWidget *widget)
   if ((self->player = clapper_gtk_get_player_from_ancestor (widget))) {
     ClapperQueue *queue = clapper_player_get_queue (self->player);
 
+    if (self->show_thumbnails)
+      _ensure_thumbnailer (self);
+
     g_signal_connect (queue, "notify::current-item",
         G_CALLBACK (_queue_current_item_changed_cb), self);
     _queue_current_item_changed_cb (queue, NULL, self);
@@ -718,6 +864,7 @@ clapper_gtk_seek_bar_unrealize (GtkWidget *widget)
       self->position_signal_id = 0;
     }
     g_signal_handlers_disconnect_by_func (queue, _queue_current_item_changed_cb, self);
+    _clear_thumbnailer (self);
 
     self->player = NULL;
   }
@@ -758,6 +905,9 @@ clapper_gtk_seek_bar_unmap (GtkWidget *widget)
     }
     g_signal_handlers_disconnect_by_func (self->player, _player_state_changed_cb, self);
     g_signal_handlers_disconnect_by_func (self->player, _player_seek_done_cb, self);
+
+    if (self->dragging)
+      clapper_player_set_scrubbing (self->player, FALSE);
   }
 
   GTK_WIDGET_CLASS (parent_class)->unmap (widget);
@@ -809,6 +959,9 @@ clapper_gtk_seek_bar_get_property (GObject *object, guint prop_id,
     case PROP_SEEK_METHOD:
       g_value_set_enum (value, clapper_gtk_seek_bar_get_seek_method (self));
       break;
+    case PROP_SHOW_THUMBNAILS:
+      g_value_set_boolean (value, clapper_gtk_seek_bar_get_show_thumbnails (self));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -828,6 +981,9 @@ clapper_gtk_seek_bar_set_property (GObject *object, guint prop_id,
     case PROP_SEEK_METHOD:
       clapper_gtk_seek_bar_set_seek_method (self, g_value_get_enum (value));
       break;
+    case PROP_SHOW_THUMBNAILS:
+      clapper_gtk_seek_bar_set_show_thumbnails (self, g_value_get_boolean (value));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -873,6 +1029,19 @@ clapper_gtk_seek_bar_class_init (ClapperGtkSeekBarClass *klass)
       NULL, NULL, CLAPPER_TYPE_PLAYER_SEEK_METHOD, DEFAULT_SEEK_METHOD,
       G_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY | G_PARAM_STATIC_STRINGS);
 
+  /**
+   * ClapperGtkSeekBar:show-thumbnails:
+   *
+   * Show video frame preview when hovering seek bar.
+   *
+   * Disabled by default.
+   *
+   * Since: 0.12
+   */
+  param_specs[PROP_SHOW_THUMBNAILS] = g_param_spec_boolean ("show-thumbnails",
+      NULL, NULL, DEFAULT_SHOW_THUMBNAILS,
+      G_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY | G_PARAM_STATIC_STRINGS);
+
   g_object_class_install_properties (gobject_class, PROP_LAST, param_specs);
 
   gtk_widget_class_set_template_from_resource (widget_class,
@@ -882,6 +1051,7 @@ clapper_gtk_seek_bar_class_init (ClapperGtkSeekBarClass *klass)
   gtk_widget_class_bind_template_child (widget_class, ClapperGtkSeekBar, position_label);
   gtk_widget_class_bind_template_child (widget_class, ClapperGtkSeekBar, scale);
   gtk_widget_class_bind_template_child (widget_class, ClapperGtkSeekBar, popover);
+  gtk_widget_class_bind_template_child (widget_class, ClapperGtkSeekBar, popover_picture);
   gtk_widget_class_bind_template_child (widget_class, ClapperGtkSeekBar, popover_label);
   gtk_widget_class_bind_template_child (widget_class, ClapperGtkSeekBar, duration_revealer);
   gtk_widget_class_bind_template_child (widget_class, ClapperGtkSeekBar, duration_label);
@@ -52,4 +52,10 @@ void clapper_gtk_seek_bar_set_seek_method (ClapperGtkSeekBar *seek_bar, ClapperP
 CLAPPER_GTK_API
 ClapperPlayerSeekMethod clapper_gtk_seek_bar_get_seek_method (ClapperGtkSeekBar *seek_bar);
 
+CLAPPER_GTK_API
+void clapper_gtk_seek_bar_set_show_thumbnails (ClapperGtkSeekBar *seek_bar, gboolean show);
+
+CLAPPER_GTK_API
+gboolean clapper_gtk_seek_bar_get_show_thumbnails (ClapperGtkSeekBar *seek_bar);
+
 G_END_DECLS
@@ -70,6 +70,7 @@ enum
   PROP_0,
   PROP_FULLSCREENABLE,
   PROP_SEEK_METHOD,
+  PROP_SHOW_THUMBNAILS,
   PROP_EXTRA_MENU_BUTTON,
   PROP_LAST
 };
@@ -208,6 +209,43 @@ clapper_gtk_simple_controls_get_seek_method (ClapperGtkSimpleControls *self)
   return clapper_gtk_seek_bar_get_seek_method (CLAPPER_GTK_SEEK_BAR (self->seek_bar));
 }
 
+/**
+ * clapper_gtk_simple_controls_set_show_thumbnails:
+ * @controls: a #ClapperGtkSimpleControls
+ * @show: whether to show thumbnails
+ *
+ * Set whether a video frame preview should be shown when hovering progress bar.
+ *
+ * See [method@ClapperGtk.SeekBar.set_show_thumbnails] for details.
+ *
+ * Since: 0.12
+ */
+void
+clapper_gtk_simple_controls_set_show_thumbnails (ClapperGtkSimpleControls *self, gboolean show)
+{
+  g_return_if_fail (CLAPPER_GTK_IS_SIMPLE_CONTROLS (self));
+
+  clapper_gtk_seek_bar_set_show_thumbnails (CLAPPER_GTK_SEEK_BAR (self->seek_bar), show);
+}
+
+/**
+ * clapper_gtk_simple_controls_get_show_thumbnails:
+ * @controls: a #ClapperGtkSimpleControls
+ *
+ * Get whether video frame preview is shown when hovering progress bar.
+ *
+ * Returns: %TRUE if thumbnails are shown, %FALSE otherwise.
+ *
+ * Since: 0.12
+ */
+gboolean
+clapper_gtk_simple_controls_get_show_thumbnails (ClapperGtkSimpleControls *self)
+{
+  g_return_val_if_fail (CLAPPER_GTK_IS_SIMPLE_CONTROLS (self), FALSE);
+
+  return clapper_gtk_seek_bar_get_show_thumbnails (CLAPPER_GTK_SEEK_BAR (self->seek_bar));
+}
+
 /**
  * clapper_gtk_simple_controls_get_extra_menu_button:
  * @controls: a #ClapperGtkSimpleControls
@@ -258,6 +296,9 @@ clapper_gtk_simple_controls_get_property (GObject *object, guint prop_id,
     case PROP_SEEK_METHOD:
       g_value_set_enum (value, clapper_gtk_simple_controls_get_seek_method (self));
       break;
+    case PROP_SHOW_THUMBNAILS:
+      g_value_set_boolean (value, clapper_gtk_simple_controls_get_show_thumbnails (self));
+      break;
     case PROP_EXTRA_MENU_BUTTON:
       g_value_set_object (value, clapper_gtk_simple_controls_get_extra_menu_button (self));
       break;
@@ -280,6 +321,9 @@ clapper_gtk_simple_controls_set_property (GObject *object, guint prop_id,
     case PROP_SEEK_METHOD:
       clapper_gtk_simple_controls_set_seek_method (self, g_value_get_enum (value));
       break;
+    case PROP_SHOW_THUMBNAILS:
+      clapper_gtk_simple_controls_set_show_thumbnails (self, g_value_get_boolean (value));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -317,6 +361,17 @@ clapper_gtk_simple_controls_class_init (ClapperGtkSimpleControlsClass *klass)
       NULL, NULL, CLAPPER_TYPE_PLAYER_SEEK_METHOD, DEFAULT_SEEK_METHOD,
       G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
 
+  /**
+   * ClapperGtkSimpleControls:show-thumbnails:
+   *
+   * Show video frame preview when hovering progress bar.
+   *
+   * Since: 0.12
+   */
+  param_specs[PROP_SHOW_THUMBNAILS] = g_param_spec_boolean ("show-thumbnails",
+      NULL, NULL, FALSE,
+      G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
+
   /**
    * ClapperGtkSimpleControls:extra-menu-button:
    *
@@ -53,6 +53,12 @@ void clapper_gtk_simple_controls_set_seek_method (ClapperGtkSimpleControls *cont
 CLAPPER_GTK_API
 ClapperPlayerSeekMethod clapper_gtk_simple_controls_get_seek_method (ClapperGtkSimpleControls *controls);
 
+CLAPPER_GTK_API
+void clapper_gtk_simple_controls_set_show_thumbnails (ClapperGtkSimpleControls *controls, gboolean show);
+
+CLAPPER_GTK_API
+gboolean clapper_gtk_simple_controls_get_show_thumbnails (ClapperGtkSimpleControls *controls);
+
 CLAPPER_GTK_API
 ClapperGtkExtraMenuButton * clapper_gtk_simple_controls_get_extra_menu_button (ClapperGtkSimpleControls *controls);
 
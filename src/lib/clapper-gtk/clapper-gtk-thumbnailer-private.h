@@ -0,0 +1,43 @@
+/* Clapper GTK Integration Library
+ * Copyright (C) 2025 Rafał Dzięgiel <rafostar.github@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <glib.h>
+#include <glib-object.h>
+#include <gtk/gtk.h>
+
+#include <clapper/clapper.h>
+
+G_BEGIN_DECLS
+
+#define CLAPPER_GTK_TYPE_THUMBNAILER (clapper_gtk_thumbnailer_get_type())
+#define CLAPPER_GTK_THUMBNAILER_CAST(obj) ((ClapperGtkThumbnailer *)(obj))
+
+G_DECLARE_FINAL_TYPE (ClapperGtkThumbnailer, clapper_gtk_thumbnailer, CLAPPER_GTK, THUMBNAILER, GObject)
+
+G_GNUC_INTERNAL
+ClapperGtkThumbnailer * clapper_gtk_thumbnailer_new (void);
+
+G_GNUC_INTERNAL
+void clapper_gtk_thumbnailer_set_media_item (ClapperGtkThumbnailer *thumbnailer, ClapperMediaItem *item);
+
+G_GNUC_INTERNAL
+GdkTexture * clapper_gtk_thumbnailer_get_thumbnail (ClapperGtkThumbnailer *thumbnailer, gdouble position);
+
+G_END_DECLS
@@ -0,0 +1,960 @@
+/* Clapper GTK Integration Library
+ * Copyright (C) 2025 Rafał Dzięgiel <rafostar.github@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Thumbnailer extracts low resolution preview frames of a media item
+ * for seek bar. Frames are decoded on demand in a separate pipeline
+ * running on its own thread using key unit seeks, so only keyframes
+ * are decoded and at most one decode is running at any time.
+ *
+ * Item duration is split into slots, each having one thumbnail. Thumbnails
+ * are stored in a sprite sheet (tiles in rows of SHEET_COLUMNS), that is
+ * kept in memory and saved to disk as PNG when item changes. Tiles that
+ * were not extracted yet stay fully transparent.
+ *
+ * Sheets on disk are keyed by media URI together with what identifies its
+ * content, so a changed file or remote media does not show old thumbnails.
+ * For local files this is their modification time and size, for remote
+ * media ETag or Last-Modified of the response thumbnails pipeline got.
+ * Sheet of remote media is thus loaded (and saved) only after that pipeline
+ * is started and not at all when server sends no validators.
+ *
+ * Sheets on disk are pruned once per process, removing ones not used
+ * for CACHE_MAX_AGE, then least recently used until CACHE_MAX_SIZE fits.
+ */
+
+#include "config.h"
+
+#include <math.h>
+#include <glib/gstdio.h>
+#include <gst/gst.h>
+
+#include "clapper-gtk-thumbnailer-private.h"
+
+#define TILE_WIDTH 160
+#define TILE_HEIGHT 90
+#define TILE_STRIDE (TILE_WIDTH * 4)
+#define SHEET_COLUMNS 10
+#define SHEET_STRIDE (SHEET_COLUMNS * TILE_STRIDE)
+
+#define MAX_SLOTS 100
+#define MIN_SLOT_DURATION 2.0
+#define PREROLL_TIMEOUT (5 * GST_SECOND)
+
+#define CACHE_MAX_AGE (30 * 24 * 60 * 60) // seconds since last use
+#define CACHE_MAX_SIZE (256 * 1024 * 1024)
+
+#define SINK_BIN_DESC \
+    "videoconvertscale ! video/x-raw,format=RGBA,width=160,height=90,pixel-aspect-ratio=1/1 ! " \
+    "fakesink name=sink sync=false enable-last-sample=true"
+
+#define GST_CAT_DEFAULT clapper_gtk_thumbnailer_debug
+GST_DEBUG_CATEGORY_STATIC (GST_CAT_DEFAULT);
+
+struct _ClapperGtkThumbnailer
+{
+  GObject parent;
+
+  GMutex lock;
+  GCond cond;
+  GThread *thread;
+
+  /* Shared with worker thread, protected by lock */
+  gboolean running;
+  gchar *uri;
+  guint serial;
+  guint n_slots;
+  gdouble slot_duration;
+  gint requested_slot;
+  guint8 *sheet;
+  gboolean *filled;
+  gboolean dirty;
+
+  /* Main thread only */
+  ClapperMediaItem *item;
+  gchar *sheet_path;
+  GHashTable *textures;
+  GCancellable *cancellable;
+};
+
+enum
+{
+  SIGNAL_THUMBNAIL_READY,
+  SIGNAL_LAST
+};
+
+#define parent_class clapper_gtk_thumbnailer_parent_class
+G_DEFINE_TYPE (ClapperGtkThumbnailer, clapper_gtk_thumbnailer, G_TYPE_OBJECT);
+
+static guint signals[SIGNAL_LAST] = { 0, };
+
+static inline guint
+_get_n_rows (guint n_slots)
+{
+  return (n_slots + SHEET_COLUMNS - 1) / SHEET_COLUMNS;
+}
+
+static inline guint8 *
+_get_tile_data (guint8 *sheet, guint slot)
+{
+  return sheet + (slot / SHEET_COLUMNS) * TILE_HEIGHT * SHEET_STRIDE
+      + (slot % SHEET_COLUMNS) * TILE_STRIDE;
+}
+
+static gboolean
+_emit_thumbnail_ready_cb (ClapperGtkThumbnailer *self)
+{
+  g_signal_emit (self, signals[SIGNAL_THUMBNAIL_READY], 0);
+
+  return G_SOURCE_REMOVE;
+}
+
+static inline void
+_announce_thumbnail_ready (ClapperGtkThumbnailer *self)
+{
+  g_main_context_invoke_full (NULL, G_PRIORITY_DEFAULT,
+      (GSourceFunc) _emit_thumbnail_ready_cb,
+      g_object_ref (self), (GDestroyNotify) g_object_unref);
+}
+
+static void
+_element_setup_cb (GstElement *playbin G_GNUC_UNUSED, GstElement *element,
+    gpointer user_data G_GNUC_UNUSED)
+{
+  /* Keep CPU usage low while main video is playing */
+  if (g_object_class_find_property (G_OBJECT_GET_CLASS (element), "max-threads"))
+    g_object_set (element, "max-threads", 1, NULL);
+}
+
+static const gchar *
+_find_header (const GstStructure *headers, const gchar *name)
+{
+  guint i, n_fields = gst_structure_n_fields (headers);
+
+  /* Names are as sent by server, so their case varies */
+  for (i = 0; i < n_fields; ++i) {
+    const gchar *field = gst_structure_nth_field_name (headers, i);
+
+    if (g_ascii_strcasecmp (field, name) == 0)
+      return gst_structure_get_string (headers, field);
+  }
+
+  return NULL;
+}
+
+/* Local file is identified by its modification time and size */
+static gchar *
+_get_file_validator (const gchar *uri)
+{
+  gchar *filename, *validator = NULL;
+  GStatBuf buf;
+
+  if (!(filename = g_filename_from_uri (uri, NULL, NULL)))
+    return NULL;
+
+  if (g_stat (filename, &buf) == 0) {
+    validator = g_strdup_printf ("%" G_GINT64_FORMAT "-%" G_GINT64_FORMAT,
+        (gint64) buf.st_mtime, (gint64) buf.st_size);
+  }
+
+  g_free (filename);
+
+  return validator;
+}
+
+/*
+ * Remote media is identified by validators of response to its request.
+ * Bus of pipeline is not watched, so messages posted while it prerolled
+ * are still queued there.
+ */
+static gchar *
+_get_pipeline_validator (GstElement *pipeline)
+{
+  GstBus *bus = gst_element_get_bus (pipeline);
+  GstMessage *msg;
+  gchar *validator = NULL;
+
+  while (!validator && (msg = gst_bus_pop_filtered (bus, GST_MESSAGE_ELEMENT))) {
+    const GstStructure *structure = gst_message_get_structure (msg);
+    const GValue *value;
+
+    if (gst_structure_has_name (structure, "http-headers")
+        && (value = gst_structure_get_value (structure, "response-headers"))
+        && G_VALUE_HOLDS (value, GST_TYPE_STRUCTURE)) {
+      const GstStructure *headers = gst_value_get_structure (value);
+      const gchar *header;
+
+      if ((header = _find_header (headers, "ETag")))
+        validator = g_strdup_printf ("etag:%s", header);
+      else if ((header = _find_header (headers, "Last-Modified")))
+        validator = g_strdup_printf ("modified:%s", header);
+    }
+
+    gst_message_unref (msg);
+  }
+
+  gst_object_unref (bus);
+
+  return validator;
+}
+
+static GstElement *
+_pipeline_create (const gchar *uri, GstElement **sink)
+{
+  GstElement *pipeline, *sink_bin;
+  GError *error = NULL;
+
+  if (!(pipeline = gst_element_factory_make ("playbin3", NULL)))
+    return NULL;
+
+  if (!(sink_bin = gst_parse_bin_from_description (SINK_BIN_DESC, TRUE, &error))) {
+    GST_ERROR ("Could not create thumbnails sink: %s", error->message);
+    g_error_free (error);
+    gst_object_unref (gst_object_ref_sink (pipeline));
+
+    return NULL;
+  }
+
+  *sink = gst_bin_get_by_name (GST_BIN_CAST (sink_bin), "sink");
+
+  gst_util_set_object_arg (G_OBJECT (pipeline), "flags", "video");
+  g_object_set (pipeline,
+      "uri", uri,
+      "video-sink", sink_bin,
+      NULL);
+  g_signal_connect (pipeline, "element-setup", G_CALLBACK (_element_setup_cb), NULL);
+
+  gst_object_ref_sink (pipeline);
+
+  if (gst_element_set_state (pipeline, GST_STATE_PAUSED) == GST_STATE_CHANGE_FAILURE
+      || gst_element_get_state (pipeline, NULL, NULL, PREROLL_TIMEOUT) != GST_STATE_CHANGE_SUCCESS) {
+    GST_WARNING ("Could not preroll thumbnails pipeline for: %s", uri);
+
+    gst_element_set_state (pipeline, GST_STATE_NULL);
+    gst_clear_object (sink);
+    gst_object_unref (pipeline);
+
+    return NULL;
+  }
+
+  return pipeline;
+}
+
+static void
+_pipeline_destroy (GstElement **pipeline, GstElement **sink)
+{
+  if (*pipeline) {
+    gst_element_set_state (*pipeline, GST_STATE_NULL);
+    gst_clear_object (pipeline);
+  }
+  gst_clear_object (sink);
+}
+
+static GstSample *
+_extract_sample (GstElement *pipeline, GstElement *sink, gdouble position)
+{
+  GstSample *sample = NULL;
+
+  GST_LOG ("Extracting thumbnail at: %lf", position);
+
+  /* Key unit seek, so only keyframe needs to be decoded */
+  if (!gst_element_seek_simple (pipeline, GST_FORMAT_TIME,
+      GST_SEEK_FLAG_FLUSH | GST_SEEK_FLAG_KEY_UNIT | GST_SEEK_FLAG_SNAP_BEFORE,
+      (gint64) (position * GST_SECOND))
+      || gst_element_get_state (pipeline, NULL, NULL, PREROLL_TIMEOUT) != GST_STATE_CHANGE_SUCCESS)
+    return NULL;
+
+  g_object_get (sink, "last-sample", &sample, NULL);
+
+  return sample;
+}
+
+static gboolean
+_store_sample_unlocked (ClapperGtkThumbnailer *self, guint slot, GstSample *sample)
+{
+  GstBuffer *buffer = gst_sample_get_buffer (sample);
+  GstCaps *caps = gst_sample_get_caps (sample);
+  GstStructure *structure;
+  GstMapInfo info;
+  guint8 *tile;
+  gint width = 0, height = 0;
+  guint i;
+
+  if (!buffer || !caps)
+    return FALSE;
+
+  structure = gst_caps_get_structure (caps, 0);
+
+  if (!gst_structure_get_int (structure, "width", &width)
+      || !gst_structure_get_int (structure, "height", &height)
+      || width != TILE_WIDTH || height != TILE_HEIGHT)
+    return FALSE;
+
+  if (!gst_buffer_map (buffer, &info, GST_MAP_READ))
+    return FALSE;
+
+  if (info.size < TILE_STRIDE * TILE_HEIGHT) {
+    gst_buffer_unmap (buffer, &info);
+    return FALSE;
+  }
+
+  tile = _get_tile_data (self->sheet, slot);
+
+  for (i = 0; i < TILE_HEIGHT; ++i)
+    memcpy (tile + i * SHEET_STRIDE, info.data + i * TILE_STRIDE, TILE_STRIDE);
+
+  gst_buffer_unmap (buffer, &info);
+
+  self->filled[slot] = TRUE;
+  self->dirty = TRUE;
+
+  return TRUE;
+}
+
+typedef struct
+{
+  ClapperGtkThumbnailer *thumbnailer;
+  guint serial;
+  gchar *validator;
+} ClapperGtkThumbnailerValidatorData;
+
+static void
+_validator_data_free (ClapperGtkThumbnailerValidatorData *data)
+{
+  g_object_unref (data->thumbnailer);
+  g_free (data->validator);
+  g_free (data);
+}
+
+static void _load_sheet (ClapperGtkThumbnailer *self, const gchar *validator);
+
+static gboolean
+_remote_validator_cb (ClapperGtkThumbnailerValidatorData *data)
+{
+  ClapperGtkThumbnailer *self = data->thumbnailer;
+  guint serial;
+
+  g_mutex_lock (&self->lock);
+  serial = self->serial;
+  g_mutex_unlock (&self->lock);
+
+  /* Item might have changed meanwhile */
+  if (serial == data->serial && self->item && !self->sheet_path)
+    _load_sheet (self, data->validator);
+
+  return G_SOURCE_REMOVE;
+}
+
+/* Takes ownership of @validator */
+static void
+_announce_remote_validator (ClapperGtkThumbnailer *self, guint serial, gchar *validator)
+{
+  ClapperGtkThumbnailerValidatorData *data;
+
+  if (!validator) {
+    GST_DEBUG ("No validators in response, thumbnails will not be cached");
+    return;
+  }
+
+  data = g_new (ClapperGtkThumbnailerValidatorData, 1);
+  data->thumbnailer = g_object_ref (self);
+  data->serial = serial;
+  data->validator = validator;
+
+  g_main_context_invoke_full (NULL, G_PRIORITY_DEFAULT,
+      (GSourceFunc) _remote_validator_cb, data,
+      (GDestroyNotify) _validator_data_free);
+}
+
+static gpointer
+_worker_thread_func (ClapperGtkThumbnailer *self)
+{
+  GstElement *pipeline = NULL, *sink = NULL;
+  gchar *uri = NULL;
+  gboolean broken = FALSE;
+
+  GST_DEBUG ("Worker thread started");
+
+  g_mutex_lock (&self->lock);
+
+  while (self->running) {
+    GstSample *sample = NULL;
+    gdouble position;
+    guint serial, slot;
+
+    /* Release pipeline of previous item as soon as possible */
+    if (g_strcmp0 (uri, self->uri) != 0) {
+      g_free (uri);
+      uri = g_strdup (self->uri);
+      broken = FALSE;
+
+      g_mutex_unlock (&self->lock);
+      _pipeline_destroy (&pipeline, &sink);
+      g_mutex_lock (&self->lock);
+      continue; // recheck, item might have changed again
+    }
+
+    if (self->requested_slot < 0) {
+      g_cond_wait (&self->cond, &self->lock);
+      continue;
+    }
+
+    slot = self->requested_slot;
+    self->requested_slot = -1;
+    serial = self->serial;
+    position = (slot + 0.5) * self->slot_duration;
+
+    g_mutex_unlock (&self->lock);
+
+    /* Avoid retrying with URIs that cannot be thumbnailed */
+    if (!pipeline && !broken) {
+      broken = !(pipeline = _pipeline_create (uri, &sink));
+
+      /* Sheet of remote media can be loaded only now */
+      if (pipeline && !gst_uri_has_protocol (uri, "file"))
+        _announce_remote_validator (self, serial, _get_pipeline_validator (pipeline));
+    }
+    if (pipeline)
+      sample = _extract_sample (pipeline, sink, position);
+
+    g_mutex_lock (&self->lock);
+
+    if (sample) {
+      if (serial == self->serial && !self->filled[slot]
+          && _store_sample_unlocked (self, slot, sample))
+        _announce_thumbnail_ready (self);
+
+      gst_sample_unref (sample);
+    }
+  }
+
+  g_mutex_unlock (&self->lock);
+
+  _pipeline_destroy (&pipeline, &sink);
+  g_free (uri);
+
+  GST_DEBUG ("Worker thread stopped");
+
+  return NULL;
+}
+
+static void
+_save_sheet_in_thread (GTask *task, gpointer source G_GNUC_UNUSED,
+    const gchar *path, GCancellable *cancellable G_GNUC_UNUSED)
+{
+  GdkTexture *texture = g_object_get_data (G_OBJECT (task), "texture");
+  gchar *dir = g_path_get_dirname (path);
+
+  if (g_mkdir_with_parents (dir, 0755) == 0 && gdk_texture_save_to_png (texture, path))
+    GST_DEBUG ("Saved thumbnails to: %s", path);
+  else
+    GST_WARNING ("Could not save thumbnails to: %s", path);
+
+  g_free (dir);
+}
+
+/* Writes extracted thumbnails of current item to disk */
+static void
+_save_sheet (ClapperGtkThumbnailer *self)
+{
+  GdkTexture *texture = NULL;
+  GTask *task;
+
+  if (!self->sheet_path)
+    return;
+
+  g_mutex_lock (&self->lock);
+  if (self->dirty) {
+    guint n_rows = _get_n_rows (self->n_slots);
+    GBytes *bytes = g_bytes_new (self->sheet, n_rows * TILE_HEIGHT * SHEET_STRIDE);
+
+    texture = gdk_memory_texture_new (SHEET_COLUMNS * TILE_WIDTH, n_rows * TILE_HEIGHT,
+        GDK_MEMORY_R8G8B8A8, bytes, SHEET_STRIDE);
+    g_bytes_unref (bytes);
+
+    self->dirty = FALSE;
+  }
+  g_mutex_unlock (&self->lock);
+
+  if (!texture)
+    return;
+
+  task = g_task_new (NULL, NULL, NULL, NULL);
+  g_task_set_task_data (task, g_strdup (self->sheet_path), g_free);
+  g_object_set_data_full (G_OBJECT (task), "texture", texture, g_object_unref);
+  g_task_run_in_thread (task, (GTaskThreadFunc) _save_sheet_in_thread);
+  g_object_unref (task);
+}
+
+static void
+_load_sheet_in_thread (GTask *task, gpointer source G_GNUC_UNUSED,
+    const gchar *path, GCancellable *cancellable G_GNUC_UNUSED)
+{
+  GdkTexture *texture;
+  GdkTextureDownloader *downloader;
+  GBytes *bytes;
+  gsize stride = 0;
+
+  if (!(texture = gdk_texture_new_from_filename (path, NULL))) {
+    g_task_return_pointer (task, NULL, NULL);
+    return;
+  }
+
+  if (gdk_texture_get_width (texture) != SHEET_COLUMNS * TILE_WIDTH) {
+    g_object_unref (texture);
+    g_task_return_pointer (task, NULL, NULL);
+    return;
+  }
+
+  downloader = gdk_texture_downloader_new (texture);
+  gdk_texture_downloader_set_format (downloader, GDK_MEMORY_R8G8B8A8);
+  bytes = gdk_texture_downloader_download_bytes (downloader, &stride);
+  gdk_texture_downloader_free (downloader);
+  g_object_unref (texture);
+
+  if (stride != SHEET_STRIDE) {
+    g_bytes_unref (bytes);
+    g_task_return_pointer (task, NULL, NULL);
+    return;
+  }
+
+  /* Modification time of sheet file marks its last use */
+  g_utime (path, NULL);
+
+  g_task_return_pointer (task, bytes, (GDestroyNotify) g_bytes_unref);
+}
+
+static void
+_load_sheet_finish_cb (ClapperGtkThumbnailer *self, GAsyncResult *res,
+    gpointer user_data G_GNUC_UNUSED)
+{
+  GBytes *bytes;
+  const guint8 *data;
+  gsize size;
+  guint slot, n_loaded = 0;
+
+  if (!(bytes = g_task_propagate_pointer (G_TASK (res), NULL)))
+    return;
+
+  data = g_bytes_get_data (bytes, &size);
+
+  g_mutex_lock (&self->lock);
+
+  /* Item is checked with cancellable, so slots are for the same sheet */
+  for (slot = 0; slot < self->n_slots; ++slot) {
+    const guint8 *src = _get_tile_data ((guint8 *) data, slot);
+    guint8 *dest;
+    guint i;
+
+    /* Beyond loaded data or alpha of first pixel is zero (not extracted) */
+    if ((gsize) (src - data) + (TILE_HEIGHT - 1) * SHEET_STRIDE + TILE_STRIDE > size
+        || self->filled[slot] || src[3] == 0)
+      continue;
+
+    dest = _get_tile_data (self->sheet, slot);
+
+    for (i = 0; i < TILE_HEIGHT; ++i)
+      memcpy (dest + i * SHEET_STRIDE, src + i * SHEET_STRIDE, TILE_STRIDE);
+
+    self->filled[slot] = TRUE;
+    n_loaded++;
+  }
+
+  g_mutex_unlock (&self->lock);
+
+  g_bytes_unref (bytes);
+
+  GST_DEBUG_OBJECT (self, "Loaded %u thumbnails from disk", n_loaded);
+
+  if (n_loaded > 0)
+    g_signal_emit (self, signals[SIGNAL_THUMBNAIL_READY], 0);
+}
+
+typedef struct
+{
+  gchar *filename;
+  gint64 mtime;
+  gint64 size;
+} ClapperGtkThumbnailerCacheEntry;
+
+static void
+_cache_entry_clear (ClapperGtkThumbnailerCacheEntry *entry)
+{
+  g_free (entry->filename);
+}
+
+static gint
+_compare_cache_entries (const ClapperGtkThumbnailerCacheEntry *a, const ClapperGtkThumbnailerCacheEntry *b)
+{
+  return (a->mtime > b->mtime) - (a->mtime < b->mtime);
+}
+
+/*
+ * Removes sheets that were not used for a long time,
+ * then least recently used ones until cache fits size limit.
+ */
+static gpointer
+_prune_cache_thread_func (gchar *dirname)
+{
+  GDir *dir;
+  GArray *entries;
+  const gchar *name;
+  gint64 now, total_size = 0;
+  guint i;
+
+  if (!(dir = g_dir_open (dirname, 0, NULL))) {
+    g_free (dirname);
+    return NULL;
+  }
+
+  entries = g_array_new (FALSE, FALSE, sizeof (ClapperGtkThumbnailerCacheEntry));
+  g_array_set_clear_func (entries, (GDestroyNotify) _cache_entry_clear);
+
+  now = g_get_real_time () / G_USEC_PER_SEC;
+
+  while ((name = g_dir_read_name (dir))) {
+    ClapperGtkThumbnailerCacheEntry entry;
+    GStatBuf stat_buf;
+
+    if (!g_str_has_suffix (name, ".png"))
+      continue;
+
+    entry.filename = g_build_filename (dirname, name, NULL);
+
+    if (g_stat (entry.filename, &stat_buf) != 0) {
+      g_free (entry.filename);
+      continue;
+    }
+
+    if (now - (gint64) stat_buf.st_mtime > CACHE_MAX_AGE) {
+      GST_LOG ("Removing expired thumbnails: %s", name);
+      g_remove (entry.filename);
+      g_free (entry.filename);
+      continue;
+    }
+
+    entry.mtime = (gint64) stat_buf.st_mtime;
+    entry.size = (gint64) stat_buf.st_size;
+    total_size += entry.size;
+
+    g_array_append_val (entries, entry);
+  }
+  g_dir_close (dir);
+
+  if (total_size > CACHE_MAX_SIZE) {
+    g_array_sort (entries, (GCompareFunc) _compare_cache_entries);
+
+    for (i = 0; i < entries->len && total_size > CACHE_MAX_SIZE; ++i) {
+      ClapperGtkThumbnailerCacheEntry *entry = &g_array_index (entries, ClapperGtkThumbnailerCacheEntry, i);
+
+      GST_LOG ("Removing least recently used thumbnails: %s", entry->filename);
+      g_remove (entry->filename);
+      total_size -= entry->size;
+    }
+  }
+
+  GST_DEBUG ("Thumbnails cache pruned, size: %" G_GINT64_FORMAT, total_size);
+
+  g_array_unref (entries);
+  g_free (dirname);
+
+  return NULL;
+}
+
+static void
+_prune_cache_once (const gchar *filename)
+{
+  static gsize pruned = 0;
+
+  if (g_once_init_enter (&pruned)) {
+    g_thread_unref (g_thread_new ("ClapperGtkCachePrune",
+        (GThreadFunc) _prune_cache_thread_func, g_path_get_dirname (filename)));
+    g_once_init_leave (&pruned, 1);
+  }
+}
+
+static inline gchar *
+_build_sheet_path (const gchar *uri, const gchar *validator, guint n_slots)
+{
+  gchar *key = g_strdup_printf ("%s\n%s", uri, validator);
+  gchar *checksum = g_compute_checksum_for_string (G_CHECKSUM_SHA1, key, -1);
+  gchar name[64];
+
+  g_snprintf (name, sizeof (name), "%s-%u.png", checksum, n_slots);
+  g_free (checksum);
+  g_free (key);
+
+  return g_build_filename (g_get_user_cache_dir (), CLAPPER_GTK_API_NAME,
+      "thumbnails", name, NULL);
+}
+
+/* Must be called after slots are set */
+static void
+_load_sheet (ClapperGtkThumbnailer *self, const gchar *validator)
+{
+  GTask *task;
+
+  self->sheet_path = _build_sheet_path (clapper_media_item_get_uri (self->item),
+      validator, self->n_slots);
+
+  GST_DEBUG_OBJECT (self, "Using sheet: %s", self->sheet_path);
+
+  _prune_cache_once (self->sheet_path);
+
+  task = g_task_new (self, self->cancellable,
+      (GAsyncReadyCallback) _load_sheet_finish_cb, NULL);
+  g_task_set_task_data (task, g_strdup (self->sheet_path), g_free);
+  g_task_run_in_thread (task, (GTaskThreadFunc) _load_sheet_in_thread);
+  g_object_unref (task);
+}
+
+/* Slots are set once duration is known */
+static gboolean
+_ensure_slots (ClapperGtkThumbnailer *self)
+{
+  const gchar *uri;
+  gdouble duration;
+  guint n_slots;
+
+  /* Only changed from this thread */
+  if (self->n_slots > 0)
+    return TRUE;
+
+  duration = clapper_media_item_get_duration (self->item);
+
+  if (duration <= 0)
+    return FALSE;
+
+  n_slots = CLAMP ((guint) ceil (duration / MIN_SLOT_DURATION), 1, MAX_SLOTS);
+
+  g_mutex_lock (&self->lock);
+  self->n_slots = n_slots;
+  self->slot_duration = duration / n_slots;
+  self->sheet = g_malloc0 (_get_n_rows (n_slots) * TILE_HEIGHT * SHEET_STRIDE);
+  self->filled = g_new0 (gboolean, n_slots);
+  g_mutex_unlock (&self->lock);
+
+  GST_DEBUG_OBJECT (self, "Using %u slots", n_slots);
+
+  /* Remote media sheet is loaded once worker gets response for it */
+  uri = clapper_media_item_get_uri (self->item);
+
+  if (gst_uri_has_protocol (uri, "file")) {
+    gchar *validator;
+
+    if ((validator = _get_file_validator (uri))) {
+      _load_sheet (self, validator);
+      g_free (validator);
+    }
+  }
+
+  return TRUE;
+}
+
+static void
+_reset (ClapperGtkThumbnailer *self)
+{
+  _save_sheet (self);
+
+  g_cancellable_cancel (self->cancellable);
+  g_clear_object (&self->cancellable);
+
+  g_hash_table_remove_all (self->textures);
+  g_clear_pointer (&self->sheet_path, g_free);
+  gst_clear_object (&self->item);
+
+  g_mutex_lock (&self->lock);
+  self->serial++;
+  self->requested_slot = -1;
+  self->n_slots = 0;
+  self->slot_duration = 0;
+  self->dirty = FALSE;
+  g_clear_pointer (&self->uri, g_free);
+  g_clear_pointer (&self->sheet, g_free);
+  g_clear_pointer (&self->filled, g_free);
+  g_cond_signal (&self->cond);
+  g_mutex_unlock (&self->lock);
+}
+
+/*
+ * clapper_gtk_thumbnailer_new:
+ *
+ * Returns: (transfer full): a new #ClapperGtkThumbnailer instance.
+ */
+ClapperGtkThumbnailer *
+clapper_gtk_thumbnailer_new (void)
+{
+  return g_object_new (CLAPPER_GTK_TYPE_THUMBNAILER, NULL);
+}
+
+/*
+ * clapper_gtk_thumbnailer_set_media_item:
+ * @thumbnailer: a #ClapperGtkThumbnailer
+ * @item: (nullable): a #ClapperMediaItem
+ *
+ * Set media item to provide thumbnails of. Thumbnails of
+ * previous media item are saved to disk.
+ */
+void
+clapper_gtk_thumbnailer_set_media_item (ClapperGtkThumbnailer *self, ClapperMediaItem *item)
+{
+  if (self->item == item)
+    return;
+
+  _reset (self);
+
+  if (!item)
+    return;
+
+  self->item = gst_object_ref (item);
+  self->cancellable = g_cancellable_new ();
+
+  g_mutex_lock (&self->lock);
+  self->uri = g_strdup (clapper_media_item_get_uri (item));
+  g_mutex_unlock (&self->lock);
+}
+
+/*
+ * clapper_gtk_thumbnailer_get_thumbnail:
+ * @thumbnailer: a #ClapperGtkThumbnailer
+ * @position: a position in seconds
+ *
+ * Get thumbnail for given position of current media item. When thumbnail
+ * is not available yet, its extraction is requested (replacing previous
+ * pending request) and #ClapperGtkThumbnailer::thumbnail-ready signal
+ * will be emitted once it is done.
+ *
+ * Returns: (transfer full) (nullable): a #GdkTexture with thumbnail.
+ */
+GdkTexture *
+clapper_gtk_thumbnailer_get_thumbnail (ClapperGtkThumbnailer *self, gdouble position)
+{
+  GdkTexture *texture;
+  guint slot;
+
+  if (!self->item || !_ensure_slots (self))
+    return NULL;
+
+  slot = MIN ((guint) (MAX (position, 0) / self->slot_duration), self->n_slots - 1);
+
+  if ((texture = g_hash_table_lookup (self->textures, GUINT_TO_POINTER (slot))))
+    return g_object_ref (texture);
+
+  g_mutex_lock (&self->lock);
+
+  if (self->filled[slot]) {
+    const guint8 *tile = _get_tile_data (self->sheet, slot);
+    guint8 *data = g_malloc (TILE_STRIDE * TILE_HEIGHT);
+    GBytes *bytes;
+    guint i;
+
+    for (i = 0; i < TILE_HEIGHT; ++i)
+      memcpy (data + i * TILE_STRIDE, tile + i * SHEET_STRIDE, TILE_STRIDE);
+
+    bytes = g_bytes_new_take (data, TILE_STRIDE * TILE_HEIGHT);
+    texture = gdk_memory_texture_new (TILE_WIDTH, TILE_HEIGHT,
+        GDK_MEMORY_R8G8B8A8, bytes, TILE_STRIDE);
+    g_bytes_unref (bytes);
+  } else {
+    self->requested_slot = slot;
+
+    if (!self->thread) {
+      self->running = TRUE;
+      self->thread = g_thread_new ("ClapperGtkThumbnailer",
+          (GThreadFunc) _worker_thread_func, self);
+    }
+    g_cond_signal (&self->cond);
+  }
+
+  g_mutex_unlock (&self->lock);
+
+  if (texture) {
+    g_hash_table_insert (self->textures, GUINT_TO_POINTER (slot), texture);
+    g_object_ref (texture);
+  }
+
+  return texture;
+}
+
+static void
+clapper_gtk_thumbnailer_init (ClapperGtkThumbnailer *self)
+{
+  g_mutex_init (&self->lock);
+  g_cond_init (&self->cond);
+
+  self->requested_slot = -1;
+  self->textures = g_hash_table_new_full (g_direct_hash, g_direct_equal,
+      NULL, (GDestroyNotify) g_object_unref);
+}
+
+static void
+clapper_gtk_thumbnailer_dispose (GObject *object)
+{
+  ClapperGtkThumbnailer *self = CLAPPER_GTK_THUMBNAILER_CAST (object);
+
+  if (self->thread) {
+    g_mutex_lock (&self->lock);
+    self->running = FALSE;
+    g_cond_signal (&self->cond);
+    g_mutex_unlock (&self->lock);
+
+    g_thread_join (self->thread);
+    self->thread = NULL;
+  }
+
+  _reset (self);
+
+  G_OBJECT_CLASS (parent_class)->dispose (object);
+}
+
+static void
+clapper_gtk_thumbnailer_finalize (GObject *object)
+{
+  ClapperGtkThumbnailer *self = CLAPPER_GTK_THUMBNAILER_CAST (object);
+
+  GST_TRACE_OBJECT (self, "Finalize");
+
+  g_hash_table_unref (self->textures);
+
+  g_mutex_clear (&self->lock);
+  g_cond_clear (&self->cond);
+
+  G_OBJECT_CLASS (parent_class)->finalize (object);
+}
+
+static void
+clapper_gtk_thumbnailer_class_init (ClapperGtkThumbnailerClass *klass)
+{
+  GObjectClass *gobject_class = (GObjectClass *) klass;
+
+  GST_DEBUG_CATEGORY_INIT (GST_CAT_DEFAULT, "clappergtkthumbnailer", 0,
+      "Clapper GTK Thumbnailer");
+
+  gobject_class->dispose = clapper_gtk_thumbnailer_dispose;
+  gobject_class->finalize = clapper_gtk_thumbnailer_finalize;
+
+  /*
+   * ClapperGtkThumbnailer::thumbnail-ready:
+   * @thumbnailer: a #ClapperGtkThumbnailer
+   *
+   * New thumbnails of current media item are available.
+   */
+  signals[SIGNAL_THUMBNAIL_READY] = g_signal_new ("thumbnail-ready",
+      G_TYPE_FROM_CLASS (klass), G_SIGNAL_RUN_LAST,
+      0, NULL, NULL, NULL, G_TYPE_NONE, 0);
+}
@@ -40,6 +40,8 @@ void clapper_app_bus_forward_message (ClapperAppBus *app_bus, GstMessage *msg);
 
 void clapper_app_bus_post_prop_notify (ClapperAppBus *app_bus, GstObject *src, GParamSpec *pspec);
 
+void clapper_app_bus_get_notify_counts (ClapperAppBus *app_bus, guint64 *n_posted, guint64 *n_coalesced);
+
 void clapper_app_bus_post_refresh_streams (ClapperAppBus *app_bus, GstObject *src);
 
 void clapper_app_bus_post_refresh_timeline (ClapperAppBus *app_bus, GstObject *src);
@@ -48,6 +50,8 @@ void clapper_app_bus_post_insert_playlist (ClapperAppBus *app_bus, GstObject *sr
 
 void clapper_app_bus_post_simple_signal (ClapperAppBus *app_bus, GstObject *src, guint signal_id);
 
+void clapper_app_bus_post_object_signal (ClapperAppBus *app_bus, GstObject *src, guint signal_id, GstObject *object);
+
 void clapper_app_bus_post_object_desc_signal (ClapperAppBus *app_bus, GstObject *src, guint signal_id, GstObject *object, const gchar *desc);
 
 void clapper_app_bus_post_desc_with_details_signal (ClapperAppBus *app_bus, GstObject *src, guint signal_id, const gchar *desc, const gchar *details);
@@ -20,6 +20,7 @@
 
 #include "clapper-bus-private.h"
 #include "clapper-app-bus-private.h"
+#include "clapper-event-ring-private.h"
 #include "clapper-player-private.h"
 #include "clapper-queue-private.h"
 #include "clapper-media-item-private.h"
@@ -28,49 +29,69 @@
 #define GST_CAT_DEFAULT clapper_app_bus_debug
 GST_DEBUG_CATEGORY_STATIC (GST_CAT_DEFAULT);
 
+#define EVENT_RING_SIZE 256
+
+/* Pointers are only compared, queued event itself keeps source alive */
+typedef struct
+{
+  GstObject *src;
+  GParamSpec *pspec;
+} ClapperAppBusNotifyKey;
+
+/* Events are carried in ring buffer, bus is only used
+ * to wake up app thread when there are new ones */
 struct _ClapperAppBus
 {
   GstBus parent;
+
+  ClapperEventRing *ring;
+  GstMessage *wakeup_msg;
+
+  /* Properties that have notify event already queued */
+  GMutex notify_lock;
+  GHashTable *pending_notifies;
+  GPtrArray *free_keys;
+
+  guint64 n_notifies_posted;
+  guint64 n_notifies_coalesced;
 };
 
 #define parent_class clapper_app_bus_parent_class
 G_DEFINE_TYPE (ClapperAppBus, clapper_app_bus, GST_TYPE_BUS);
 
+enum
+{
+  CLAPPER_APP_BUS_EVENT_UNKNOWN = 0,
+  CLAPPER_APP_BUS_EVENT_PROP_NOTIFY,
+  CLAPPER_APP_BUS_EVENT_REFRESH_STREAMS,
+  CLAPPER_APP_BUS_EVENT_REFRESH_TIMELINE,
+  CLAPPER_APP_BUS_EVENT_INSERT_PLAYLIST,
+  CLAPPER_APP_BUS_EVENT_SIMPLE_SIGNAL,
+  CLAPPER_APP_BUS_EVENT_OBJECT_SIGNAL,
+  CLAPPER_APP_BUS_EVENT_OBJECT_DESC_SIGNAL,
+  CLAPPER_APP_BUS_EVENT_DESC_WITH_DETAILS_SIGNAL,
+  CLAPPER_APP_BUS_EVENT_MESSAGE_SIGNAL,
+  CLAPPER_APP_BUS_EVENT_ERROR_SIGNAL
+};
+
 enum
 {
   CLAPPER_APP_BUS_STRUCTURE_UNKNOWN = 0,
-  CLAPPER_APP_BUS_STRUCTURE_PROP_NOTIFY,
-  CLAPPER_APP_BUS_STRUCTURE_REFRESH_STREAMS,
-  CLAPPER_APP_BUS_STRUCTURE_REFRESH_TIMELINE,
-  CLAPPER_APP_BUS_STRUCTURE_INSERT_PLAYLIST,
-  CLAPPER_APP_BUS_STRUCTURE_SIMPLE_SIGNAL,
-  CLAPPER_APP_BUS_STRUCTURE_OBJECT_DESC_SIGNAL,
-  CLAPPER_APP_BUS_STRUCTURE_DESC_WITH_DETAILS_SIGNAL,
-  CLAPPER_APP_BUS_STRUCTURE_MESSAGE_SIGNAL,
-  CLAPPER_APP_BUS_STRUCTURE_ERROR_SIGNAL
+  CLAPPER_APP_BUS_STRUCTURE_WAKEUP,
+  CLAPPER_APP_BUS_STRUCTURE_PAYLOAD
 };
 
 static ClapperBusQuark _structure_quarks[] = {
   {"unknown", 0},
-  {"prop-notify", 0},
-  {"refresh-streams", 0},
-  {"refresh-timeline", 0},
-  {"insert-playlist", 0},
-  {"simple-signal", 0},
-  {"object-desc-signal", 0},
-  {"desc-with-details-signal", 0},
-  {"message", 0},
-  {"error-signal", 0},
+  {"wakeup", 0},
+  {"payload", 0},
   {NULL, 0}
 };
 
 enum
 {
   CLAPPER_APP_BUS_FIELD_UNKNOWN = 0,
-  CLAPPER_APP_BUS_FIELD_PSPEC,
-  CLAPPER_APP_BUS_FIELD_SIGNAL_ID,
-  CLAPPER_APP_BUS_FIELD_OBJECT,
-  CLAPPER_APP_BUS_FIELD_OTHER_OBJECT,
+  CLAPPER_APP_BUS_FIELD_MESSAGE,
   CLAPPER_APP_BUS_FIELD_DESC,
   CLAPPER_APP_BUS_FIELD_DETAILS,
   CLAPPER_APP_BUS_FIELD_ERROR,
@@ -79,10 +100,7 @@ enum
 
 static ClapperBusQuark _field_quarks[] = {
   {"unknown", 0},
-  {"pspec", 0},
-  {"signal-id", 0},
-  {"object", 0},
-  {"other-object", 0},
+  {"message", 0},
   {"desc", 0},
   {"details", 0},
   {"error", 0},
@@ -92,7 +110,7 @@ static ClapperBusQuark _field_quarks[] = {
 
 #define _STRUCTURE_QUARK(q) (_structure_quarks[CLAPPER_APP_BUS_STRUCTURE_##q].quark)
 #define _FIELD_QUARK(q) (_field_quarks[CLAPPER_APP_BUS_FIELD_##q].quark)
-#define _MESSAGE_SRC_GOBJECT(msg) ((GObject *) GST_MESSAGE_SRC (msg))
+#define _EVENT_SRC_GOBJECT(event) ((GObject *) (event)->src)
 
 void
 clapper_app_bus_initialize (void)
@@ -111,6 +129,27 @@ clapper_app_bus_forward_message (ClapperAppBus *self, GstMessage *msg)
   gst_bus_post (GST_BUS_CAST (self), gst_message_ref (msg));
 }
 
+static inline void
+_post_event (ClapperAppBus *self, GstObject *src, ClapperEvent *event)
+{
+  event->src = gst_object_ref (src);
+
+  if (clapper_event_ring_push (self->ring, event))
+    gst_bus_post (GST_BUS_CAST (self), gst_message_ref (self->wakeup_msg));
+}
+
+static guint
+_notify_key_hash (const ClapperAppBusNotifyKey *key)
+{
+  return g_direct_hash (key->src) ^ g_direct_hash (key->pspec);
+}
+
+static gboolean
+_notify_key_equal (const ClapperAppBusNotifyKey *key_a, const ClapperAppBusNotifyKey *key_b)
+{
+  return (key_a->src == key_b->src && key_a->pspec == key_b->pspec);
+}
+
 /* FIXME: It should be faster to wait for gst_message_new_property_notify() from
  * playbin bus and forward them to app bus instead of connecting to notify
  * signals of playbin, so change into using gst_message_new_property_notify() here too */
@@ -118,50 +157,87 @@ void
 clapper_app_bus_post_prop_notify (ClapperAppBus *self,
     GstObject *src, GParamSpec *pspec)
 {
-  GstStructure *structure = gst_structure_new_id (_STRUCTURE_QUARK (PROP_NOTIFY),
-      _FIELD_QUARK (PSPEC), G_TYPE_PARAM, pspec,
-      NULL);
-  gst_bus_post (GST_BUS_CAST (self), gst_message_new_application (src, structure));
+  ClapperAppBusNotifyKey lookup_key = { src, pspec };
+  ClapperEvent event = { 0, };
+
+  g_mutex_lock (&self->notify_lock);
+
+  /* Property value is read when notify is emitted, so if we
+   * still did not handle previous event, this one is redundant */
+  if (g_hash_table_contains (self->pending_notifies, &lookup_key)) {
+    self->n_notifies_coalesced++;
+    g_mutex_unlock (&self->notify_lock);
+
+    GST_LOG_OBJECT (self, "Coalesced %s notify of %" GST_PTR_FORMAT,
+        pspec->name, src);
+    return;
+  } else {
+    ClapperAppBusNotifyKey *key = (self->free_keys->len > 0)
+        ? g_ptr_array_steal_index_fast (self->free_keys, self->free_keys->len - 1)
+        : g_new (ClapperAppBusNotifyKey, 1);
+
+    key->src = src;
+    key->pspec = pspec;
+
+    g_hash_table_add (self->pending_notifies, key);
+    self->n_notifies_posted++;
+  }
+
+  g_mutex_unlock (&self->notify_lock);
+
+  /* Param spec is owned by object class, so no need to ref it */
+  event.type = CLAPPER_APP_BUS_EVENT_PROP_NOTIFY;
+  event.value.v_pointer = pspec;
+
+  _post_event (self, src, &event);
 }
 
 static inline void
-_handle_prop_notify_msg (GstMessage *msg, const GstStructure *structure)
+_handle_prop_notify_event (ClapperAppBus *self, const ClapperEvent *event)
 {
-  GParamSpec *pspec = NULL;
-
-  gst_structure_id_get (structure,
-      _FIELD_QUARK (PSPEC), G_TYPE_PARAM, &pspec,
-      NULL);
-  g_object_notify_by_pspec (_MESSAGE_SRC_GOBJECT (msg), pspec);
-
-  g_param_spec_unref (pspec);
+  GParamSpec *pspec = (GParamSpec *) event->value.v_pointer;
+  ClapperAppBusNotifyKey lookup_key = { event->src, pspec };
+  gpointer key = NULL;
+
+  /* Remove before notifying, so changes done from
+   * within notify handlers are posted again */
+  g_mutex_lock (&self->notify_lock);
+  if (g_hash_table_steal_extended (self->pending_notifies, &lookup_key, &key, NULL))
+    g_ptr_array_add (self->free_keys, key);
+  g_mutex_unlock (&self->notify_lock);
+
+  g_object_notify_by_pspec (_EVENT_SRC_GOBJECT (event), pspec);
 }
 
 void
 clapper_app_bus_post_refresh_streams (ClapperAppBus *self, GstObject *src)
 {
-  GstStructure *structure = gst_structure_new_id_empty (_STRUCTURE_QUARK (REFRESH_STREAMS));
-  gst_bus_post (GST_BUS_CAST (self), gst_message_new_application (src, structure));
+  ClapperEvent event = { 0, };
+
+  event.type = CLAPPER_APP_BUS_EVENT_REFRESH_STREAMS;
+  _post_event (self, src, &event);
 }
 
 static inline void
-_handle_refresh_streams_msg (GstMessage *msg, const GstStructure *structure)
+_handle_refresh_streams_event (const ClapperEvent *event)
 {
-  ClapperPlayer *player = CLAPPER_PLAYER_CAST (GST_MESSAGE_SRC (msg));
+  ClapperPlayer *player = CLAPPER_PLAYER_CAST (event->src);
   clapper_player_refresh_streams (player);
 }
 
 void
 clapper_app_bus_post_refresh_timeline (ClapperAppBus *self, GstObject *src)
 {
-  GstStructure *structure = gst_structure_new_id_empty (_STRUCTURE_QUARK (REFRESH_TIMELINE));
-  gst_bus_post (GST_BUS_CAST (self), gst_message_new_application (src, structure));
+  ClapperEvent event = { 0, };
+
+  event.type = CLAPPER_APP_BUS_EVENT_REFRESH_TIMELINE;
+  _post_event (self, src, &event);
 }
 
 static inline void
-_handle_refresh_timeline_msg (GstMessage *msg, const GstStructure *structure)
+_handle_refresh_timeline_event (const ClapperEvent *event)
 {
-  ClapperMediaItem *item = CLAPPER_MEDIA_ITEM_CAST (GST_MESSAGE_SRC (msg));
+  ClapperMediaItem *item = CLAPPER_MEDIA_ITEM_CAST (event->src);
   ClapperTimeline *timeline = clapper_media_item_get_timeline (item);
 
   clapper_timeline_refresh (timeline);
@@ -171,50 +247,59 @@ void
 clapper_app_bus_post_insert_playlist (ClapperAppBus *self, GstObject *src,
     GstObject *playlist_item, GObject *playlist)
 {
-  GstStructure *structure = gst_structure_new_id (_STRUCTURE_QUARK (INSERT_PLAYLIST),
-      _FIELD_QUARK (OBJECT), GST_TYPE_OBJECT, playlist_item,
-      _FIELD_QUARK (OTHER_OBJECT), G_TYPE_OBJECT, playlist,
-      NULL);
-  gst_bus_post (GST_BUS_CAST (self), gst_message_new_application (src, structure));
+  ClapperEvent event = { 0, };
+
+  event.type = CLAPPER_APP_BUS_EVENT_INSERT_PLAYLIST;
+  event.object = g_object_ref (G_OBJECT (playlist_item));
+  event.extra_object = g_object_ref (playlist);
+
+  _post_event (self, src, &event);
 }
 
 static inline void
-_handle_insert_playlist_msg (GstMessage *msg, const GstStructure *structure)
+_handle_insert_playlist_event (const ClapperEvent *event)
 {
-  ClapperPlayer *player = CLAPPER_PLAYER_CAST (GST_MESSAGE_SRC (msg));
+  ClapperPlayer *player = CLAPPER_PLAYER_CAST (event->src);
   ClapperQueue *queue = clapper_player_get_queue (player);
-  GstObject *playlist_item;
-  GObject *playlist;
 
-  gst_structure_id_get (structure,
-      _FIELD_QUARK (OBJECT), GST_TYPE_OBJECT, &playlist_item,
-      _FIELD_QUARK (OTHER_OBJECT), G_TYPE_OBJECT, &playlist,
-      NULL);
   clapper_queue_handle_playlist (queue,
-      CLAPPER_MEDIA_ITEM (playlist_item), G_LIST_STORE (playlist));
-
-  gst_object_unref (playlist_item);
-  g_object_unref (playlist);
+      CLAPPER_MEDIA_ITEM (event->object), G_LIST_STORE (event->extra_object));
 }
 
 void
 clapper_app_bus_post_simple_signal (ClapperAppBus *self, GstObject *src, guint signal_id)
 {
-  GstStructure *structure = gst_structure_new_id (_STRUCTURE_QUARK (SIMPLE_SIGNAL),
-      _FIELD_QUARK (SIGNAL_ID), G_TYPE_UINT, signal_id,
-      NULL);
-  gst_bus_post (GST_BUS_CAST (self), gst_message_new_application (src, structure));
+  ClapperEvent event = { 0, };
+
+  event.type = CLAPPER_APP_BUS_EVENT_SIMPLE_SIGNAL;
+  event.value.v_uint = signal_id;
+
+  _post_event (self, src, &event);
 }
 
 static inline void
-_handle_simple_signal_msg (GstMessage *msg, const GstStructure *structure)
+_handle_simple_signal_event (const ClapperEvent *event)
 {
-  guint signal_id = 0;
+  g_signal_emit (_EVENT_SRC_GOBJECT (event), event->value.v_uint, 0);
+}
 
-  gst_structure_id_get (structure,
-      _FIELD_QUARK (SIGNAL_ID), G_TYPE_UINT, &signal_id,
-      NULL);
-  g_signal_emit (_MESSAGE_SRC_GOBJECT (msg), signal_id, 0);
+void
+clapper_app_bus_post_object_signal (ClapperAppBus *self,
+    GstObject *src, guint signal_id, GstObject *object)
+{
+  ClapperEvent event = { 0, };
+
+  event.type = CLAPPER_APP_BUS_EVENT_OBJECT_SIGNAL;
+  event.value.v_uint = signal_id;
+  event.object = g_object_ref (G_OBJECT (object));
+
+  _post_event (self, src, &event);
+}
+
+static inline void
+_handle_object_signal_event (const ClapperEvent *event)
+{
+  g_signal_emit (_EVENT_SRC_GOBJECT (event), event->value.v_uint, 0, event->object);
 }
 
 void
@@ -222,30 +307,25 @@ clapper_app_bus_post_object_desc_signal (ClapperAppBus *self,
     GstObject *src, guint signal_id,
     GstObject *object, const gchar *desc)
 {
-  GstStructure *structure = gst_structure_new_id (_STRUCTURE_QUARK (OBJECT_DESC_SIGNAL),
-      _FIELD_QUARK (SIGNAL_ID), G_TYPE_UINT, signal_id,
-      _FIELD_QUARK (OBJECT), GST_TYPE_OBJECT, object,
+  ClapperEvent event = { 0, };
+
+  event.type = CLAPPER_APP_BUS_EVENT_OBJECT_DESC_SIGNAL;
+  event.value.v_uint = signal_id;
+  event.object = (object) ? g_object_ref (G_OBJECT (object)) : NULL;
+  event.structure = gst_structure_new_id (_STRUCTURE_QUARK (PAYLOAD),
       _FIELD_QUARK (DESC), G_TYPE_STRING, desc,
       NULL);
-  gst_bus_post (GST_BUS_CAST (self), gst_message_new_application (src, structure));
+
+  _post_event (self, src, &event);
 }
 
 static inline void
-_handle_object_desc_signal_msg (GstMessage *msg, const GstStructure *structure)
+_handle_object_desc_signal_event (const ClapperEvent *event)
 {
-  guint signal_id = 0;
-  GstObject *object = NULL;
-  gchar *desc = NULL;
-
-  gst_structure_id_get (structure,
-      _FIELD_QUARK (SIGNAL_ID), G_TYPE_UINT, &signal_id,
-      _FIELD_QUARK (OBJECT), GST_TYPE_OBJECT, &object,
-      _FIELD_QUARK (DESC), G_TYPE_STRING, &desc,
-      NULL);
-  g_signal_emit (_MESSAGE_SRC_GOBJECT (msg), signal_id, 0, object, desc);
+  const gchar *desc = g_value_get_string (
+      gst_structure_id_get_value (event->structure, _FIELD_QUARK (DESC)));
 
-  gst_object_unref (object);
-  g_free (desc);
+  g_signal_emit (_EVENT_SRC_GOBJECT (event), event->value.v_uint, 0, event->object, desc);
 }
 
 void
@@ -253,29 +333,27 @@ clapper_app_bus_post_desc_with_details_signal (ClapperAppBus *self,
     GstObject *src, guint signal_id,
     const gchar *desc, const gchar *details)
 {
-  GstStructure *structure = gst_structure_new_id (_STRUCTURE_QUARK (DESC_WITH_DETAILS_SIGNAL),
-      _FIELD_QUARK (SIGNAL_ID), G_TYPE_UINT, signal_id,
+  ClapperEvent event = { 0, };
+
+  event.type = CLAPPER_APP_BUS_EVENT_DESC_WITH_DETAILS_SIGNAL;
+  event.value.v_uint = signal_id;
+  event.structure = gst_structure_new_id (_STRUCTURE_QUARK (PAYLOAD),
       _FIELD_QUARK (DESC), G_TYPE_STRING, desc,
       _FIELD_QUARK (DETAILS), G_TYPE_STRING, details,
       NULL);
-  gst_bus_post (GST_BUS_CAST (self), gst_message_new_application (src, structure));
+
+  _post_event (self, src, &event);
 }
 
 static inline void
-_handle_desc_with_details_signal_msg (GstMessage *msg, const GstStructure *structure)
+_handle_desc_with_details_signal_event (const ClapperEvent *event)
 {
-  guint signal_id = 0;
-  gchar *desc = NULL, *details = NULL;
-
-  gst_structure_id_get (structure,
-      _FIELD_QUARK (SIGNAL_ID), G_TYPE_UINT, &signal_id,
-      _FIELD_QUARK (DESC), G_TYPE_STRING, &desc,
-      _FIELD_QUARK (DETAILS), G_TYPE_STRING, &details,
-      NULL);
-  g_signal_emit (_MESSAGE_SRC_GOBJECT (msg), signal_id, 0, desc, details);
+  const gchar *desc = g_value_get_string (
+      gst_structure_id_get_value (event->structure, _FIELD_QUARK (DESC)));
+  const gchar *details = g_value_get_string (
+      gst_structure_id_get_value (event->structure, _FIELD_QUARK (DETAILS)));
 
-  g_free (desc);
-  g_free (details);
+  g_signal_emit (_EVENT_SRC_GOBJECT (event), event->value.v_uint, 0, desc, details);
 }
 
 void
@@ -298,29 +376,30 @@ clapper_app_bus_post_message_signal (ClapperAppBus *self,
         signal_id, detail, NULL, NULL, NULL) != 0
         || g_signal_handler_find (src, G_SIGNAL_MATCH_ID | G_SIGNAL_MATCH_DETAIL,
         signal_id, 0, NULL, NULL, NULL) != 0) {
-      GstStructure *structure = gst_structure_new_id (_STRUCTURE_QUARK (MESSAGE_SIGNAL),
-          _FIELD_QUARK (SIGNAL_ID), G_TYPE_UINT, signal_id,
-          _FIELD_QUARK (DETAILS), G_TYPE_UINT, detail,
-          _FIELD_QUARK (OBJECT), GST_TYPE_MESSAGE, msg,
+      ClapperEvent event = { 0, };
+
+      event.type = CLAPPER_APP_BUS_EVENT_MESSAGE_SIGNAL;
+      event.value.v_uint = signal_id;
+      event.extra_value.v_uint = detail;
+      event.structure = gst_structure_new_id (_STRUCTURE_QUARK (PAYLOAD),
+          _FIELD_QUARK (MESSAGE), GST_TYPE_MESSAGE, msg,
           NULL);
-      gst_bus_post (GST_BUS_CAST (self), gst_message_new_application (src, structure));
+
+      _post_event (self, src, &event);
     }
   }
 }
 
 static inline void
-_handle_message_signal_msg (GstMessage *msg, const GstStructure *structure)
+_handle_message_signal_event (const ClapperEvent *event)
 {
-  guint signal_id = 0;
-  GQuark detail = 0;
   GstMessage *fwd_message = NULL;
 
-  gst_structure_id_get (structure,
-      _FIELD_QUARK (SIGNAL_ID), G_TYPE_UINT, &signal_id,
-      _FIELD_QUARK (DETAILS), G_TYPE_UINT, &detail,
-      _FIELD_QUARK (OBJECT), GST_TYPE_MESSAGE, &fwd_message,
+  gst_structure_id_get (event->structure,
+      _FIELD_QUARK (MESSAGE), GST_TYPE_MESSAGE, &fwd_message,
       NULL);
-  g_signal_emit (_MESSAGE_SRC_GOBJECT (msg), signal_id, detail, fwd_message);
+  g_signal_emit (_EVENT_SRC_GOBJECT (event), event->value.v_uint,
+      (GQuark) event->extra_value.v_uint, fwd_message);
 
   gst_message_unref (fwd_message);
 }
@@ -330,32 +409,80 @@ clapper_app_bus_post_error_signal (ClapperAppBus *self,
     GstObject *src, guint signal_id,
     GError *error, const gchar *debug_info)
 {
-  GstStructure *structure = gst_structure_new_id (_STRUCTURE_QUARK (ERROR_SIGNAL),
-      _FIELD_QUARK (SIGNAL_ID), G_TYPE_UINT, signal_id,
+  ClapperEvent event = { 0, };
+
+  event.type = CLAPPER_APP_BUS_EVENT_ERROR_SIGNAL;
+  event.value.v_uint = signal_id;
+  event.structure = gst_structure_new_id (_STRUCTURE_QUARK (PAYLOAD),
       _FIELD_QUARK (ERROR), G_TYPE_ERROR, error,
       _FIELD_QUARK (DEBUG_INFO), G_TYPE_STRING, debug_info,
       NULL);
-  gst_bus_post (GST_BUS_CAST (self), gst_message_new_application (src, structure));
+
+  _post_event (self, src, &event);
 }
 
 static inline void
-_handle_error_signal_msg (GstMessage *msg, const GstStructure *structure)
+_handle_error_signal_event (const ClapperEvent *event)
 {
-  guint signal_id = 0;
   GError *error = NULL;
   gchar *debug_info = NULL;
 
-  gst_structure_id_get (structure,
-      _FIELD_QUARK (SIGNAL_ID), G_TYPE_UINT, &signal_id,
+  gst_structure_id_get (event->structure,
       _FIELD_QUARK (ERROR), G_TYPE_ERROR, &error,
       _FIELD_QUARK (DEBUG_INFO), G_TYPE_STRING, &debug_info,
       NULL);
-  g_signal_emit (_MESSAGE_SRC_GOBJECT (msg), signal_id, 0, error, debug_info);
+  g_signal_emit (_EVENT_SRC_GOBJECT (event), event->value.v_uint, 0, error, debug_info);
 
   g_clear_error (&error);
   g_free (debug_info);
 }
 
+static inline void
+_handle_wakeup_msg (ClapperAppBus *self)
+{
+  ClapperEvent event;
+
+  clapper_event_ring_begin_consume (self->ring);
+
+  while (clapper_event_ring_pop (self->ring, &event)) {
+    switch (event.type) {
+      case CLAPPER_APP_BUS_EVENT_PROP_NOTIFY:
+        _handle_prop_notify_event (self, &event);
+        break;
+      case CLAPPER_APP_BUS_EVENT_REFRESH_STREAMS:
+        _handle_refresh_streams_event (&event);
+        break;
+      case CLAPPER_APP_BUS_EVENT_REFRESH_TIMELINE:
+        _handle_refresh_timeline_event (&event);
+        break;
+      case CLAPPER_APP_BUS_EVENT_INSERT_PLAYLIST:
+        _handle_insert_playlist_event (&event);
+        break;
+      case CLAPPER_APP_BUS_EVENT_SIMPLE_SIGNAL:
+        _handle_simple_signal_event (&event);
+        break;
+      case CLAPPER_APP_BUS_EVENT_OBJECT_SIGNAL:
+        _handle_object_signal_event (&event);
+        break;
+      case CLAPPER_APP_BUS_EVENT_OBJECT_DESC_SIGNAL:
+        _handle_object_desc_signal_event (&event);
+        break;
+      case CLAPPER_APP_BUS_EVENT_MESSAGE_SIGNAL:
+        _handle_message_signal_event (&event);
+        break;
+      case CLAPPER_APP_BUS_EVENT_ERROR_SIGNAL:
+        _handle_error_signal_event (&event);
+        break;
+      case CLAPPER_APP_BUS_EVENT_DESC_WITH_DETAILS_SIGNAL:
+        _handle_desc_with_details_signal_event (&event);
+        break;
+      default:
+        break;
+    }
+    clapper_event_clear (&event);
+  }
+}
+
 static gboolean
 clapper_app_bus_message_func (GstBus *bus, GstMessage *msg, gpointer user_data G_GNUC_UNUSED)
 {
@@ -363,24 +490,8 @@ clapper_app_bus_message_func (GstBus *bus, GstMessage *msg, gpointer user_data G
     const GstStructure *structure = gst_message_get_structure (msg);
     GQuark quark = gst_structure_get_name_id (structure);
 
-    if (quark == _STRUCTURE_QUARK (PROP_NOTIFY))
-      _handle_prop_notify_msg (msg, structure);
-    else if (quark == _STRUCTURE_QUARK (REFRESH_STREAMS))
-      _handle_refresh_streams_msg (msg, structure);
-    else if (quark == _STRUCTURE_QUARK (REFRESH_TIMELINE))
-      _handle_refresh_timeline_msg (msg, structure);
-    else if (quark == _STRUCTURE_QUARK (INSERT_PLAYLIST))
-      _handle_insert_playlist_msg (msg, structure);
-    else if (quark == _STRUCTURE_QUARK (SIMPLE_SIGNAL))
-      _handle_simple_signal_msg (msg, structure);
-    else if (quark == _STRUCTURE_QUARK (OBJECT_DESC_SIGNAL))
-      _handle_object_desc_signal_msg (msg, structure);
-    else if (quark == _STRUCTURE_QUARK (MESSAGE_SIGNAL))
-      _handle_message_signal_msg (msg, structure);
-    else if (quark == _STRUCTURE_QUARK (ERROR_SIGNAL))
-      _handle_error_signal_msg (msg, structure);
-    else if (quark == _STRUCTURE_QUARK (DESC_WITH_DETAILS_SIGNAL))
-      _handle_desc_with_details_signal_msg (msg, structure);
+    if (quark == _STRUCTURE_QUARK (WAKEUP))
+      _handle_wakeup_msg (CLAPPER_APP_BUS_CAST (bus));
   }
 
   return G_SOURCE_CONTINUE;
@@ -407,6 +518,29 @@ clapper_app_bus_new (void)
 static void
 clapper_app_bus_init (ClapperAppBus *self)
 {
+  self->ring = clapper_event_ring_new (EVENT_RING_SIZE);
+  self->wakeup_msg = gst_message_new_application (NULL,
+      gst_structure_new_id_empty (_STRUCTURE_QUARK (WAKEUP)));
+
+  g_mutex_init (&self->notify_lock);
+  self->pending_notifies = g_hash_table_new_full (
+      (GHashFunc) _notify_key_hash, (GEqualFunc) _notify_key_equal,
+      g_free, NULL);
+  self->free_keys = g_ptr_array_new_with_free_func (g_free);
+}
+
+/*
+ * Get numbers of property notifications posted to app thread
+ * and ones skipped, as the same notify was still pending.
+ */
+void
+clapper_app_bus_get_notify_counts (ClapperAppBus *self,
+    guint64 *n_posted, guint64 *n_coalesced)
+{
+  g_mutex_lock (&self->notify_lock);
+  *n_posted = self->n_notifies_posted;
+  *n_coalesced = self->n_notifies_coalesced;
+  g_mutex_unlock (&self->notify_lock);
 }
 
 static void
@@ -416,6 +550,16 @@ clapper_app_bus_finalize (GObject *object)
 
   GST_TRACE_OBJECT (self, "Finalize");
 
+  GST_DEBUG_OBJECT (self, "Property notifications posted: %" G_GUINT64_FORMAT
+      ", coalesced: %" G_GUINT64_FORMAT, self->n_notifies_posted, self->n_notifies_coalesced);
+
+  clapper_event_ring_free (self->ring);
+  gst_message_unref (self->wakeup_msg);
+
+  g_hash_table_unref (self->pending_notifies);
+  g_ptr_array_unref (self->free_keys);
+  g_mutex_clear (&self->notify_lock);
+
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
 
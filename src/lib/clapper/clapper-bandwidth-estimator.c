@@ -0,0 +1,252 @@
+/* Clapper Playback Library
+ * Copyright (C) 2025 Rafał Dzięgiel <rafostar.github@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Bandwidth estimator keeps a smoothed measured bandwidth per each host
+ * that adaptive streams were played from. It is shared by all players
+ * and persisted in cache, so new adaptive streams can start with
+ * a variant that fits the network instead of a static guess.
+ */
+
+#include "config.h"
+
+#include <gst/gst.h>
+
+#include "clapper-bandwidth-estimator-private.h"
+#include "clapper-cache-private.h"
+
+#define GST_CAT_DEFAULT clapper_bandwidth_estimator_debug
+GST_DEBUG_CATEGORY_STATIC (GST_CAT_DEFAULT);
+
+/* Weight of the newest sample */
+#define SMOOTHING_FACTOR 0.25
+
+/* Networks change, do not trust old measurements forever */
+#define MAX_ENTRY_AGE (7 * 24 * 60 * 60)
+#define MAX_ENTRIES 64
+
+typedef struct
+{
+  gdouble estimate; // bits per second
+  gint64 updated; // epoch in seconds
+} ClapperBandwidthEntry;
+
+static GHashTable *entries = NULL;
+static gboolean loaded = FALSE;
+static gboolean dirty = FALSE;
+static GMutex entries_lock;
+
+void
+clapper_bandwidth_estimator_initialize (void)
+{
+  GST_DEBUG_CATEGORY_INIT (GST_CAT_DEFAULT, "clapperbandwidthestimator", 0,
+      "Clapper Bandwidth Estimator");
+
+  entries = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+}
+
+static inline gchar *
+_build_cache_filename (void)
+{
+  return g_build_filename (g_get_user_cache_dir (), CLAPPER_API_NAME,
+      "bandwidth.bin", NULL);
+}
+
+/* Must be called with lock held */
+static void
+_ensure_loaded (void)
+{
+  GMappedFile *mapped_file;
+  GError *error = NULL;
+  gchar *filename;
+  const gchar *data;
+  gint64 now;
+  guint i, n_entries;
+
+  if (loaded)
+    return;
+
+  loaded = TRUE;
+
+  filename = _build_cache_filename ();
+  mapped_file = clapper_cache_open (filename, &data, &error);
+  g_free (filename);
+
+  if (!mapped_file) {
+    if (error) {
+      if (error->domain == G_FILE_ERROR && error->code == G_FILE_ERROR_NOENT)
+        GST_DEBUG ("No cached bandwidth estimates found");
+      else
+        GST_ERROR ("Could not read bandwidth estimates, reason: %s", error->message);
+
+      g_error_free (error);
+    }
+    return;
+  }
+
+  now = g_get_real_time () / G_USEC_PER_SEC;
+  n_entries = MIN (clapper_cache_read_uint (&data), MAX_ENTRIES);
+
+  for (i = 0; i < n_entries; ++i) {
+    ClapperBandwidthEntry *entry;
+    const gchar *host = clapper_cache_read_string (&data);
+    gdouble estimate = clapper_cache_read_double (&data);
+    gint64 updated = clapper_cache_read_int64 (&data);
+
+    if (!host || estimate <= 0 || now - updated > MAX_ENTRY_AGE)
+      continue;
+
+    entry = g_new (ClapperBandwidthEntry, 1);
+    entry->estimate = estimate;
+    entry->updated = updated;
+
+    g_hash_table_insert (entries, g_strdup (host), entry);
+  }
+
+  GST_DEBUG ("Loaded %u bandwidth estimates", g_hash_table_size (entries));
+
+  g_mapped_file_unref (mapped_file);
+}
+
+/*
+ * clapper_bandwidth_estimator_lookup:
+ * @host: a host name
+ *
+ * Returns: estimated bandwidth of @host in bits per second, zero if unknown.
+ */
+guint
+clapper_bandwidth_estimator_lookup (const gchar *host)
+{
+  ClapperBandwidthEntry *entry;
+  guint bandwidth = 0;
+
+  g_mutex_lock (&entries_lock);
+
+  _ensure_loaded ();
+
+  if ((entry = g_hash_table_lookup (entries, host))
+      && g_get_real_time () / G_USEC_PER_SEC - entry->updated <= MAX_ENTRY_AGE)
+    bandwidth = (guint) MIN (entry->estimate, G_MAXUINT);
+
+  g_mutex_unlock (&entries_lock);
+
+  GST_LOG ("Bandwidth estimate of %s: %u", host, bandwidth);
+
+  return bandwidth;
+}
+
+void
+clapper_bandwidth_estimator_update (const gchar *host, guint bandwidth)
+{
+  ClapperBandwidthEntry *entry;
+
+  /* Zero means not measured (yet), it would only drag estimate down */
+  if (bandwidth == 0)
+    return;
+
+  g_mutex_lock (&entries_lock);
+
+  _ensure_loaded ();
+
+  if ((entry = g_hash_table_lookup (entries, host))) {
+    entry->estimate += SMOOTHING_FACTOR * ((gdouble) bandwidth - entry->estimate);
+  } else {
+    entry = g_new (ClapperBandwidthEntry, 1);
+    entry->estimate = bandwidth;
+    g_hash_table_insert (entries, g_strdup (host), entry);
+  }
+  entry->updated = g_get_real_time () / G_USEC_PER_SEC;
+  dirty = TRUE;
+
+  g_mutex_unlock (&entries_lock);
+}
+
+static gint
+_compare_entries_by_age (gconstpointer a, gconstpointer b)
+{
+  const ClapperBandwidthEntry *entry_a = g_hash_table_lookup (entries, *(const gchar **) a);
+  const ClapperBandwidthEntry *entry_b = g_hash_table_lookup (entries, *(const gchar **) b);
+
+  /* Newest first */
+  return (entry_a->updated < entry_b->updated) - (entry_a->updated > entry_b->updated);
+}
+
+/*
+ * clapper_bandwidth_estimator_save:
+ *
+ * Write estimates to cache if any of them changed since last save.
+ * Only most recently updated hosts are kept.
+ */
+void
+clapper_bandwidth_estimator_save (void)
+{
+  GByteArray *bytes;
+  GPtrArray *hosts;
+  GHashTableIter iter;
+  gpointer key;
+  gchar *filename;
+  GError *error = NULL;
+  guint i, n_entries;
+
+  g_mutex_lock (&entries_lock);
+
+  if (!dirty || !(bytes = clapper_cache_create ())) {
+    g_mutex_unlock (&entries_lock);
+    return;
+  }
+
+  dirty = FALSE;
+
+  hosts = g_ptr_array_sized_new (g_hash_table_size (entries));
+  g_hash_table_iter_init (&iter, entries);
+  while (g_hash_table_iter_next (&iter, &key, NULL))
+    g_ptr_array_add (hosts, key);
+
+  g_ptr_array_sort (hosts, (GCompareFunc) _compare_entries_by_age);
+  n_entries = MIN (hosts->len, MAX_ENTRIES);
+
+  clapper_cache_store_uint (bytes, n_entries);
+
+  for (i = 0; i < n_entries; ++i) {
+    const gchar *host = g_ptr_array_index (hosts, i);
+    ClapperBandwidthEntry *entry = g_hash_table_lookup (entries, host);
+
+    clapper_cache_store_string (bytes, host);
+    clapper_cache_store_double (bytes, entry->estimate);
+    clapper_cache_store_int64 (bytes, entry->updated);
+  }
+
+  /* Drop the ones that did not fit from memory too */
+  for (; i < hosts->len; ++i)
+    g_hash_table_remove (entries, g_ptr_array_index (hosts, i));
+
+  g_ptr_array_unref (hosts);
+
+  g_mutex_unlock (&entries_lock);
+
+  filename = _build_cache_filename ();
+  GST_DEBUG ("Saving %u bandwidth estimates to: \"%s\"", n_entries, filename);
+
+  if (!clapper_cache_write (filename, bytes, &error)) {
+    GST_ERROR ("Could not save bandwidth estimates, reason: %s", error->message);
+    g_error_free (error);
+  }
+
+  g_free (filename);
+  g_byte_array_free (bytes, TRUE);
+}
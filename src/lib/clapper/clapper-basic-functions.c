@@ -23,10 +23,14 @@
 
 #include "clapper-basic-functions.h"
 #include "clapper-cache-private.h"
+#include "clapper-executor-private.h"
 #include "clapper-utils-private.h"
 #include "clapper-playbin-bus-private.h"
 #include "clapper-app-bus-private.h"
 #include "clapper-features-bus-private.h"
+#include "clapper-bandwidth-estimator-private.h"
+#include "clapper-media-cache-private.h"
+#include "clapper-http-context-private.h"
 #include "clapper-enhancer-proxy-list-private.h"
 #include "clapper-reactables-manager-private.h"
 #include "gst/clapper-plugin-private.h"
@@ -52,6 +56,10 @@ clapper_init_check_internal (int *argc, char **argv[])
   gst_pb_utils_init ();
 
   clapper_cache_initialize ();
+  clapper_bandwidth_estimator_initialize ();
+  clapper_media_cache_initialize ();
+  clapper_http_context_initialize ();
+  clapper_executor_initialize ();
   clapper_utils_initialize ();
   clapper_playbin_bus_initialize ();
   clapper_app_bus_initialize ();
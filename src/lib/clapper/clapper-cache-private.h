@@ -29,9 +29,18 @@ void clapper_cache_initialize (void);
 G_GNUC_INTERNAL
 gboolean clapper_cache_is_disabled (void);
 
+G_GNUC_INTERNAL
+GMappedFile * clapper_cache_map_file (const gchar *filename, const gchar **data, GError **error);
+
 G_GNUC_INTERNAL
 GMappedFile * clapper_cache_open (const gchar *filename, const gchar **data, GError **error);
 
+G_GNUC_INTERNAL
+gboolean clapper_cache_can_read (const gchar *data, const gchar *end, gsize size);
+
+G_GNUC_INTERNAL
+gboolean clapper_cache_can_read_string (const gchar *data, const gchar *end);
+
 G_GNUC_INTERNAL
 gboolean clapper_cache_read_boolean (const gchar **data);
 
@@ -65,6 +74,9 @@ GType clapper_cache_read_iface (const gchar **data);
 G_GNUC_INTERNAL
 GParamSpec * clapper_cache_read_pspec (const gchar **data);
 
+G_GNUC_INTERNAL
+GByteArray * clapper_cache_create_data (void);
+
 G_GNUC_INTERNAL
 GByteArray * clapper_cache_create (void);
 
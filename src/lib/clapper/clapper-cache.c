@@ -24,6 +24,7 @@
 #include "clapper-reactable.h"
 
 #define CLAPPER_CACHE_HEADER "CLAPPER"
+#define CLAPPER_CACHE_HEADER_SIZE (8 + sizeof (guint)) // name + version
 
 typedef enum
 {
@@ -55,28 +56,29 @@ clapper_cache_is_disabled (void)
   return cache_disabled;
 }
 
+/*
+ * Maps file in cache format regardless of CLAPPER_DISABLE_CACHE env,
+ * for files at paths given by user that are not a cache.
+ */
 GMappedFile *
-clapper_cache_open (const gchar *filename, const gchar **data, GError **error)
+clapper_cache_map_file (const gchar *filename, const gchar **data, GError **error)
 {
   GMappedFile *file;
 
-  if (G_UNLIKELY (cache_disabled))
-    return NULL;
-
   if (!(file = g_mapped_file_new (filename, FALSE, error)))
     return NULL;
 
-  if (G_UNLIKELY (g_mapped_file_get_length (file) == 0)) {
+  if (G_UNLIKELY (g_mapped_file_get_length (file) < CLAPPER_CACHE_HEADER_SIZE)) {
     g_mapped_file_unref (file);
     g_set_error (error, G_FILE_ERROR, G_FILE_ERROR_FAILED,
-        "File is empty");
+        "File is empty or truncated");
     return NULL;
   }
 
   *data = g_mapped_file_get_contents (file);
 
   /* Header name check */
-  if (G_UNLIKELY (g_strcmp0 (*data, CLAPPER_CACHE_HEADER) != 0)) {
+  if (G_UNLIKELY (memcmp (*data, CLAPPER_CACHE_HEADER, 8) != 0)) {
     g_mapped_file_unref (file);
     g_set_error (error, G_FILE_ERROR, G_FILE_ERROR_FAILED,
         "Invalid file header");
@@ -94,6 +96,44 @@ clapper_cache_open (const gchar *filename, const gchar **data, GError **error)
   return file;
 }
 
+GMappedFile *
+clapper_cache_open (const gchar *filename, const gchar **data, GError **error)
+{
+  if (G_UNLIKELY (cache_disabled))
+    return NULL;
+
+  return clapper_cache_map_file (filename, data, error);
+}
+
+/*
+ * Checks whether @size bytes can be read from @data
+ * without going past @end of the mapped file.
+ */
+inline gboolean
+clapper_cache_can_read (const gchar *data, const gchar *end, gsize size)
+{
+  return (data <= end && (gsize) (end - data) >= size);
+}
+
+/*
+ * Checks whether a string stored with clapper_cache_store_string()
+ * can be read from @data without going past @end of the mapped file.
+ */
+gboolean
+clapper_cache_can_read_string (const gchar *data, const gchar *end)
+{
+  if (!clapper_cache_can_read (data, end, sizeof (gboolean)))
+    return FALSE;
+
+  /* Stored NULL string */
+  if (*(const gboolean *) data)
+    return TRUE;
+
+  data += sizeof (gboolean);
+
+  return (memchr (data, '\0', end - data) != NULL);
+}
+
 inline gboolean
 clapper_cache_read_boolean (const gchar **data)
 {
@@ -336,15 +376,14 @@ clapper_cache_read_pspec (const gchar **data)
   return g_param_spec_ref_sink (pspec);
 }
 
+/*
+ * Creates data in cache format regardless of CLAPPER_DISABLE_CACHE env,
+ * see clapper_cache_map_file().
+ */
 GByteArray *
-clapper_cache_create (void)
+clapper_cache_create_data (void)
 {
-  GByteArray *bytes;
-
-  if (G_UNLIKELY (cache_disabled))
-    return NULL;
-
-  bytes = g_byte_array_new ();
+  GByteArray *bytes = g_byte_array_new ();
 
   /* NOTE: We do not store whether string is NULL here, since it never is */
   g_byte_array_append (bytes, (const guint8 *) CLAPPER_CACHE_HEADER, 8); // 7 + 1
@@ -353,6 +392,15 @@ clapper_cache_create (void)
   return bytes;
 }
 
+GByteArray *
+clapper_cache_create (void)
+{
+  if (G_UNLIKELY (cache_disabled))
+    return NULL;
+
+  return clapper_cache_create_data ();
+}
+
 inline void
 clapper_cache_store_boolean (GByteArray *bytes, gboolean val)
 {
@@ -190,4 +190,68 @@ typedef enum
   CLAPPER_REACTABLE_ITEM_UPDATED_CACHE_LOCATION = 1 << 5,
 } ClapperReactableItemUpdatedFlags;
 
+/**
+ * ClapperStartupPhase:
+ * @CLAPPER_STARTUP_PHASE_SELECTION: Media item was selected for playback
+ *   (with gapless playback, its stream started).
+ * @CLAPPER_STARTUP_PHASE_EXTRACTION_START: Enhancer extraction of media item URI started.
+ * @CLAPPER_STARTUP_PHASE_EXTRACTION_END: Enhancer extraction of media item URI finished.
+ * @CLAPPER_STARTUP_PHASE_TYPEFIND: Container type of media was detected.
+ * @CLAPPER_STARTUP_PHASE_STREAM_COLLECTION: Streams available within media were collected.
+ * @CLAPPER_STARTUP_PHASE_PREROLL: Pipeline finished prerolling.
+ * @CLAPPER_STARTUP_PHASE_FIRST_FRAME: First video frame was shown by the video sink.
+ *
+ * Since: 0.12
+ */
+typedef enum
+{
+  CLAPPER_STARTUP_PHASE_SELECTION = 0,
+  CLAPPER_STARTUP_PHASE_EXTRACTION_START,
+  CLAPPER_STARTUP_PHASE_EXTRACTION_END,
+  CLAPPER_STARTUP_PHASE_TYPEFIND,
+  CLAPPER_STARTUP_PHASE_STREAM_COLLECTION,
+  CLAPPER_STARTUP_PHASE_PREROLL,
+  CLAPPER_STARTUP_PHASE_FIRST_FRAME,
+} ClapperStartupPhase;
+
+/**
+ * ClapperBufferingProfile:
+ * @CLAPPER_BUFFERING_PROFILE_DEFAULT: Balanced buffering suited for on demand content.
+ * @CLAPPER_BUFFERING_PROFILE_LOW_LATENCY: Minimal buffering to stay close to the live edge.
+ * @CLAPPER_BUFFERING_PROFILE_PREFETCH: Aggressively buffer far ahead to survive unstable networks.
+ * @CLAPPER_BUFFERING_PROFILE_CUSTOM: Use custom watermarks set by application.
+ *
+ * Since: 0.12
+ */
+typedef enum
+{
+  CLAPPER_BUFFERING_PROFILE_DEFAULT = 0,
+  CLAPPER_BUFFERING_PROFILE_LOW_LATENCY,
+  CLAPPER_BUFFERING_PROFILE_PREFETCH,
+  CLAPPER_BUFFERING_PROFILE_CUSTOM,
+} ClapperBufferingProfile;
+
+/**
+ * ClapperQueueWarmupFlags:
+ * @CLAPPER_QUEUE_WARMUP_DISABLED: Never warm up connection for next item.
+ * @CLAPPER_QUEUE_WARMUP_PROGRESSION_NONE: Warm up when progression mode is [enum@Clapper.QueueProgressionMode.NONE]
+ *   (next item is likely to be selected manually).
+ * @CLAPPER_QUEUE_WARMUP_PROGRESSION_CONSECUTIVE: Warm up when progression mode is [enum@Clapper.QueueProgressionMode.CONSECUTIVE].
+ * @CLAPPER_QUEUE_WARMUP_PROGRESSION_CAROUSEL: Warm up when progression mode is [enum@Clapper.QueueProgressionMode.CAROUSEL].
+ *
+ * Flags selecting in which queue progression modes connection
+ * to the next media item should be warmed up in advance.
+ *
+ * Other progression modes do not have a known next item.
+ *
+ * Since: 0.12
+ */
+typedef enum
+{
+  CLAPPER_QUEUE_WARMUP_DISABLED = 0,
+  CLAPPER_QUEUE_WARMUP_PROGRESSION_NONE = 1 << 0,
+  CLAPPER_QUEUE_WARMUP_PROGRESSION_CONSECUTIVE = 1 << 1,
+  CLAPPER_QUEUE_WARMUP_PROGRESSION_CAROUSEL = 1 << 2,
+} ClapperQueueWarmupFlags;
+
 G_END_DECLS
@@ -0,0 +1,72 @@
+/* Clapper Playback Library
+ * Copyright (C) 2025 Rafał Dzięgiel <rafostar.github@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <glib.h>
+#include <glib-object.h>
+#include <gst/gst.h>
+
+G_BEGIN_DECLS
+
+typedef struct _ClapperEventRing ClapperEventRing;
+
+typedef union
+{
+  gint v_int;
+  guint v_uint;
+  gdouble v_double;
+  gboolean v_boolean;
+  gpointer v_pointer;
+} ClapperEventValue;
+
+/*
+ * Fixed size record carried through #ClapperEventRing.
+ * Meaning of "type" and values is up to the user,
+ * while all non-NULL objects and structure are owned by event.
+ */
+typedef struct
+{
+  guint type;
+  GstObject *src;
+  GObject *object;
+  GObject *extra_object;
+  GstStructure *structure;
+  ClapperEventValue value;
+  ClapperEventValue extra_value;
+} ClapperEvent;
+
+G_GNUC_INTERNAL
+void clapper_event_clear (ClapperEvent *event);
+
+G_GNUC_INTERNAL
+ClapperEventRing * clapper_event_ring_new (guint size);
+
+G_GNUC_INTERNAL
+void clapper_event_ring_free (ClapperEventRing *ring);
+
+G_GNUC_INTERNAL
+gboolean clapper_event_ring_push (ClapperEventRing *ring, ClapperEvent *event);
+
+G_GNUC_INTERNAL
+void clapper_event_ring_begin_consume (ClapperEventRing *ring);
+
+G_GNUC_INTERNAL
+gboolean clapper_event_ring_pop (ClapperEventRing *ring, ClapperEvent *event);
+
+G_END_DECLS
@@ -0,0 +1,227 @@
+/* Clapper Playback Library
+ * Copyright (C) 2025 Rafał Dzięgiel <rafostar.github@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Bounded multi-producer, single-consumer queue of fixed size events.
+ *
+ * Each cell carries a sequence number telling whether it is free to be
+ * written at given enqueue position or ready to be read at given dequeue
+ * position, so producers only need to atomically claim a position and
+ * nothing is allocated after creation.
+ *
+ * When ring is full, events go into a locked overflow queue instead. To keep
+ * order of events posted by each producer, new events keep going there until
+ * consumer takes all of them (consumer always empties ring first, waiting
+ * for claimed positions to be published).
+ *
+ * Consumer is woken up only once per batch of events. Push returns %TRUE
+ * when caller should wake it up, while consumer calls begin_consume()
+ * before taking events, so anything pushed later triggers another wakeup.
+ */
+
+#include "clapper-event-ring-private.h"
+
+typedef struct
+{
+  gint sequence; // atomic integer
+  ClapperEvent event;
+} ClapperEventRingCell;
+
+struct _ClapperEventRing
+{
+  ClapperEventRingCell *cells;
+  guint mask;
+
+  gint enqueue_pos; // atomic integer
+  guint dequeue_pos; // consumer only
+
+  GMutex overflow_lock;
+  GQueue overflow;
+  gint n_overflow; // atomic integer
+
+  gint wakeup_pending; // atomic integer
+};
+
+void
+clapper_event_clear (ClapperEvent *event)
+{
+  gst_clear_object (&event->src);
+  g_clear_object (&event->object);
+  g_clear_object (&event->extra_object);
+  g_clear_pointer (&event->structure, gst_structure_free);
+}
+
+/*
+ * clapper_event_ring_new:
+ * @size: minimal number of events that fit without overflowing
+ *
+ * Returns: (transfer full): a new #ClapperEventRing.
+ */
+ClapperEventRing *
+clapper_event_ring_new (guint size)
+{
+  ClapperEventRing *ring = g_new0 (ClapperEventRing, 1);
+  guint i, n_cells = 2;
+
+  while (n_cells < size)
+    n_cells <<= 1;
+
+  ring->cells = g_new0 (ClapperEventRingCell, n_cells);
+  ring->mask = n_cells - 1;
+
+  for (i = 0; i < n_cells; ++i)
+    ring->cells[i].sequence = (gint) i;
+
+  g_mutex_init (&ring->overflow_lock);
+  g_queue_init (&ring->overflow);
+
+  return ring;
+}
+
+void
+clapper_event_ring_free (ClapperEventRing *ring)
+{
+  ClapperEvent event;
+
+  while (clapper_event_ring_pop (ring, &event))
+    clapper_event_clear (&event);
+
+  g_mutex_clear (&ring->overflow_lock);
+
+  g_free (ring->cells);
+  g_free (ring);
+}
+
+static inline gboolean
+_try_push_to_ring (ClapperEventRing *ring, ClapperEvent *event)
+{
+  guint pos = (guint) g_atomic_int_get (&ring->enqueue_pos);
+
+  while (TRUE) {
+    ClapperEventRingCell *cell = &ring->cells[pos & ring->mask];
+    gint diff = (gint) ((guint) g_atomic_int_get (&cell->sequence) - pos);
+
+    if (diff == 0) {
+      if (g_atomic_int_compare_and_exchange (&ring->enqueue_pos, (gint) pos, (gint) (pos + 1))) {
+        cell->event = *event;
+
+        /* Publish to consumer */
+        g_atomic_int_set (&cell->sequence, (gint) (pos + 1));
+        return TRUE;
+      }
+    } else if (diff < 0) {
+      /* Full, consumer did not free this cell yet */
+      return FALSE;
+    }
+
+    /* Other producer took this position */
+    pos = (guint) g_atomic_int_get (&ring->enqueue_pos);
+  }
+}
+
+/*
+ * clapper_event_ring_push:
+ * @ring: a #ClapperEventRing
+ * @event: (transfer full): a #ClapperEvent to push
+ *
+ * Can be called from any thread. Ownership of @event contents is moved
+ * into @ring, so passed struct can be discarded afterwards.
+ *
+ * Returns: whether consumer should be woken up.
+ */
+gboolean
+clapper_event_ring_push (ClapperEventRing *ring, ClapperEvent *event)
+{
+  if (g_atomic_int_get (&ring->n_overflow) > 0
+      || !_try_push_to_ring (ring, event)) {
+    g_mutex_lock (&ring->overflow_lock);
+    g_queue_push_tail (&ring->overflow, g_memdup2 (event, sizeof (ClapperEvent)));
+    g_atomic_int_inc (&ring->n_overflow);
+    g_mutex_unlock (&ring->overflow_lock);
+  }
+
+  return g_atomic_int_compare_and_exchange (&ring->wakeup_pending, FALSE, TRUE);
+}
+
+/*
+ * clapper_event_ring_begin_consume:
+ * @ring: a #ClapperEventRing
+ *
+ * Must be called by consumer after wakeup, before popping events.
+ */
+void
+clapper_event_ring_begin_consume (ClapperEventRing *ring)
+{
+  g_atomic_int_set (&ring->wakeup_pending, FALSE);
+}
+
+/*
+ * clapper_event_ring_pop:
+ * @ring: a #ClapperEventRing
+ * @event: (out caller-allocates): a #ClapperEvent to fill
+ *
+ * Must be only called from consumer thread. Ownership of @event contents
+ * is moved to the caller, which should clear it after use.
+ *
+ * Returns: %TRUE if @event was filled, %FALSE when empty.
+ */
+gboolean
+clapper_event_ring_pop (ClapperEventRing *ring, ClapperEvent *event)
+{
+  ClapperEventRingCell *cell = &ring->cells[ring->dequeue_pos & ring->mask];
+
+  while (TRUE) {
+    gint diff = (gint) ((guint) g_atomic_int_get (&cell->sequence) - (ring->dequeue_pos + 1));
+
+    if (diff == 0) {
+      *event = cell->event;
+
+      /* Free cell for the producer that will wrap around to it */
+      g_atomic_int_set (&cell->sequence, (gint) (ring->dequeue_pos + ring->mask + 1));
+      ring->dequeue_pos++;
+
+      return TRUE;
+    }
+
+    /* Nothing claimed at this position, so ring is empty */
+    if ((guint) g_atomic_int_get (&ring->enqueue_pos) == ring->dequeue_pos)
+      break;
+
+    /* Position was claimed, but producer did not publish its event yet.
+     * Events after it in the ring and in overflow queue might come from
+     * producers that pushed them later, so we must not take them first.
+     * Producer only copies the event before publishing, so wait is short. */
+    g_thread_yield ();
+  }
+
+  if (g_atomic_int_get (&ring->n_overflow) > 0) {
+    ClapperEvent *overflow_event;
+
+    g_mutex_lock (&ring->overflow_lock);
+    overflow_event = g_queue_pop_head (&ring->overflow);
+    g_atomic_int_add (&ring->n_overflow, -1);
+    g_mutex_unlock (&ring->overflow_lock);
+
+    *event = *overflow_event;
+    g_free (overflow_event);
+
+    return TRUE;
+  }
+
+  return FALSE;
+}
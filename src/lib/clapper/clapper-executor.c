@@ -0,0 +1,340 @@
+/* Clapper Playback Library
+ * Copyright (C) 2025 Rafał Dzięgiel <rafostar.github@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Shared executor multiplexes main contexts of threaded objects onto
+ * a small pool of event loop threads. Each object still owns its own
+ * #GMainContext, which is acquired by a single pool thread and iterated
+ * from within a source attached to that thread context, so all events
+ * of a single object keep being dispatched serially in order.
+ *
+ * Enabled by setting "CLAPPER_EXECUTOR_THREADS" env to either a number
+ * of threads to use or "auto" to use one per CPU core.
+ */
+
+#include <gst/gst.h>
+
+#include "clapper-executor-private.h"
+
+#define MAX_WORKERS 64
+#define MAX_AUTO_WORKERS 8
+
+#define GST_CAT_DEFAULT clapper_executor_debug
+GST_DEBUG_CATEGORY_STATIC (GST_CAT_DEFAULT);
+
+typedef struct
+{
+  GThread *thread;
+  GMainContext *context;
+  gint n_contexts; // atomic
+} ClapperExecutorWorker;
+
+typedef struct
+{
+  GSource source;
+
+  GMainContext *context;
+  ClapperExecutorWorker *worker;
+
+  gboolean acquired;
+  gboolean detached;
+  guint dispatch_depth;
+  gint max_priority;
+
+  GPollFD *fds; // registered in this source
+  gint n_fds;
+
+  GPollFD *query_fds; // filled by child context query
+  gint n_alloc;
+} ClapperExecutorSource;
+
+static ClapperExecutorWorker *workers = NULL;
+static guint n_workers = 0;
+static GMutex workers_lock;
+static GPrivate current_worker;
+
+void
+clapper_executor_initialize (void)
+{
+  const gchar *env;
+
+  GST_DEBUG_CATEGORY_INIT (GST_CAT_DEFAULT, "clapperexecutor", 0,
+      "Clapper Executor");
+
+  if (!(env = g_getenv ("CLAPPER_EXECUTOR_THREADS")))
+    return;
+
+  if (g_str_equal (env, "auto"))
+    n_workers = CLAMP (g_get_num_processors (), 1, MAX_AUTO_WORKERS);
+  else
+    n_workers = (guint) MIN (g_ascii_strtoull (env, NULL, 10), MAX_WORKERS);
+
+  if (n_workers > 0)
+    GST_INFO ("Using shared executor with %u threads", n_workers);
+}
+
+gboolean
+clapper_executor_is_enabled (void)
+{
+  return (n_workers > 0);
+}
+
+gboolean
+clapper_executor_is_executor_thread (void)
+{
+  return (g_private_get (&current_worker) != NULL);
+}
+
+static gpointer
+_worker_main (ClapperExecutorWorker *worker)
+{
+  GMainLoop *loop = g_main_loop_new (worker->context, FALSE);
+
+  GST_DEBUG ("Executor thread: %p", g_thread_self ());
+
+  g_private_set (&current_worker, worker);
+
+  /* Workers are shared by all objects during whole process lifetime */
+  g_main_loop_run (loop);
+  g_main_loop_unref (loop);
+
+  return NULL;
+}
+
+static ClapperExecutorWorker *
+_obtain_worker (void)
+{
+  ClapperExecutorWorker *worker;
+  guint i;
+
+  /* Keep objects created from within executor on the same thread */
+  if ((worker = g_private_get (&current_worker))) {
+    g_atomic_int_inc (&worker->n_contexts);
+    return worker;
+  }
+
+  g_mutex_lock (&workers_lock);
+
+  if (G_UNLIKELY (workers == NULL)) {
+    workers = g_new0 (ClapperExecutorWorker, n_workers);
+
+    for (i = 0; i < n_workers; ++i) {
+      gchar *name = g_strdup_printf ("ClapperExecutor%u", i);
+
+      workers[i].context = g_main_context_new ();
+      workers[i].thread = g_thread_new (name, (GThreadFunc) _worker_main, &workers[i]);
+      g_free (name);
+    }
+  }
+
+  /* Pick the least loaded one */
+  for (i = 0; i < n_workers; ++i) {
+    if (!worker || g_atomic_int_get (&workers[i].n_contexts)
+        < g_atomic_int_get (&worker->n_contexts))
+      worker = &workers[i];
+  }
+  g_atomic_int_inc (&worker->n_contexts);
+
+  g_mutex_unlock (&workers_lock);
+
+  return worker;
+}
+
+/* Updates polls of this source to match child context, only when they changed,
+ * as adding polls wakes up worker context which would otherwise never sleep */
+static void
+_update_polls (ClapperExecutorSource *src, gint n_fds)
+{
+  GSource *source = (GSource *) src;
+  gboolean changed = (n_fds != src->n_fds);
+  gint i;
+
+  for (i = 0; !changed && i < n_fds; ++i) {
+    changed = (src->fds[i].fd != src->query_fds[i].fd
+        || src->fds[i].events != src->query_fds[i].events);
+  }
+
+  if (changed) {
+    for (i = 0; i < src->n_fds; ++i)
+      g_source_remove_poll (source, &src->fds[i]);
+
+    src->fds = g_renew (GPollFD, src->fds, n_fds);
+    src->n_fds = n_fds;
+
+    for (i = 0; i < n_fds; ++i) {
+      src->fds[i] = src->query_fds[i];
+      g_source_add_poll (source, &src->fds[i]);
+    }
+  }
+
+  for (i = 0; i < n_fds; ++i)
+    src->fds[i].revents = 0;
+}
+
+static void
+_release (ClapperExecutorSource *src)
+{
+  gint i;
+
+  for (i = 0; i < src->n_fds; ++i)
+    g_source_remove_poll ((GSource *) src, &src->fds[i]);
+  src->n_fds = 0;
+
+  if (src->acquired) {
+    g_main_context_release (src->context);
+    src->acquired = FALSE;
+  }
+
+  g_atomic_int_add (&src->worker->n_contexts, -1);
+}
+
+static gboolean
+_source_prepare (GSource *source, gint *timeout)
+{
+  ClapperExecutorSource *src = (ClapperExecutorSource *) source;
+  gint n_fds;
+
+  *timeout = -1;
+
+  if (G_UNLIKELY (!src->acquired)
+      && !(src->acquired = g_main_context_acquire (src->context))) {
+    GST_ERROR ("Could not acquire context %p", src->context);
+    return FALSE;
+  }
+
+  g_main_context_prepare (src->context, &src->max_priority);
+
+  while ((n_fds = g_main_context_query (src->context, src->max_priority,
+      timeout, src->query_fds, src->n_alloc)) > src->n_alloc) {
+    src->n_alloc = n_fds;
+    src->query_fds = g_renew (GPollFD, src->query_fds, src->n_alloc);
+  }
+
+  _update_polls (src, n_fds);
+
+  /* Never ready here, as child context needs to collect sources
+   * to dispatch in its check. Timeout is zero when any is ready. */
+  return FALSE;
+}
+
+static gboolean
+_source_check (GSource *source)
+{
+  ClapperExecutorSource *src = (ClapperExecutorSource *) source;
+
+  if (G_UNLIKELY (!src->acquired))
+    return FALSE;
+
+  return g_main_context_check (src->context, src->max_priority, src->fds, src->n_fds);
+}
+
+static gboolean
+_source_dispatch (GSource *source, GSourceFunc callback G_GNUC_UNUSED,
+    gpointer user_data G_GNUC_UNUSED)
+{
+  ClapperExecutorSource *src = (ClapperExecutorSource *) source;
+
+  src->dispatch_depth++;
+
+  g_main_context_push_thread_default (src->context);
+  g_main_context_dispatch (src->context);
+  g_main_context_pop_thread_default (src->context);
+
+  src->dispatch_depth--;
+
+  if (src->detached) {
+    _release (src);
+    return G_SOURCE_REMOVE;
+  }
+
+  return G_SOURCE_CONTINUE;
+}
+
+static void
+_source_finalize (GSource *source)
+{
+  ClapperExecutorSource *src = (ClapperExecutorSource *) source;
+
+  g_free (src->fds);
+  g_free (src->query_fds);
+  g_main_context_unref (src->context);
+}
+
+static GSourceFuncs executor_source_funcs = {
+  _source_prepare,
+  _source_check,
+  _source_dispatch,
+  _source_finalize,
+  NULL,
+  NULL
+};
+
+/*
+ * clapper_executor_attach_context:
+ * @context: a #GMainContext
+ *
+ * Start iterating @context on one of the shared executor threads.
+ *
+ * Returns: (transfer full): a #GSource to later detach @context with.
+ */
+GSource *
+clapper_executor_attach_context (GMainContext *context)
+{
+  ClapperExecutorSource *src;
+  GSource *source;
+
+  source = g_source_new (&executor_source_funcs, sizeof (ClapperExecutorSource));
+  g_source_set_static_name (source, "ClapperExecutorSource");
+
+  src = (ClapperExecutorSource *) source;
+  src->context = g_main_context_ref (context);
+  src->worker = _obtain_worker ();
+
+  GST_DEBUG ("Attaching context %p to executor thread %p",
+      context, src->worker->thread);
+
+  g_source_attach (source, src->worker->context);
+
+  return source;
+}
+
+/*
+ * clapper_executor_detach_context:
+ * @source: a #GSource obtained from clapper_executor_attach_context()
+ *
+ * Stop iterating context. Must be called from within executor
+ * thread that iterates it (e.g. from one of context callbacks).
+ */
+void
+clapper_executor_detach_context (GSource *source)
+{
+  ClapperExecutorSource *src = (ClapperExecutorSource *) source;
+
+  g_return_if_fail (g_main_context_is_owner (src->context));
+
+  GST_DEBUG ("Detaching context %p from executor thread %p",
+      src->context, src->worker->thread);
+
+  src->detached = TRUE;
+
+  /* When within this context dispatch, it will be released afterwards */
+  if (src->dispatch_depth == 0) {
+    _release (src);
+    g_source_destroy (source);
+  }
+}
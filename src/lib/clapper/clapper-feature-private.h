@@ -23,6 +23,9 @@
 
 G_BEGIN_DECLS
 
+G_GNUC_INTERNAL
+guint clapper_feature_get_event_mask (ClapperFeature *feature);
+
 G_GNUC_INTERNAL
 void clapper_feature_call_prepare (ClapperFeature *feature);
 
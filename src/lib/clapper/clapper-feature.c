@@ -35,6 +35,7 @@
 
 #include "clapper-feature.h"
 #include "clapper-feature-private.h"
+#include "clapper-enums-private.h"
 #include "clapper-player-private.h"
 
 #define GST_CAT_DEFAULT clapper_feature_debug
@@ -64,6 +65,42 @@ G_DEFINE_TYPE_WITH_PRIVATE (ClapperFeature, clapper_feature, GST_TYPE_OBJECT);
     if (feature_class->_vfunc)                                                   \
       feature_class->_vfunc (_feature); }
 
+#define _EVENT_BIT(e) (1u << G_PASTE (CLAPPER_FEATURES_MANAGER_EVENT_, e))
+#define _MASK_ADD_IF_SET(_class,_vfunc,_event) \
+  if (_class->_vfunc) mask |= _EVENT_BIT (_event)
+
+/*
+ * clapper_feature_get_event_mask:
+ * @feature: a #ClapperFeature
+ *
+ * Get a mask of features manager events that given feature
+ * is interested in, derived from which vfuncs its class implements.
+ *
+ * Returns: a bitmask of (1 << #ClapperFeaturesManagerEvent) values.
+ */
+guint
+clapper_feature_get_event_mask (ClapperFeature *self)
+{
+  ClapperFeatureClass *feature_class = CLAPPER_FEATURE_GET_CLASS (self);
+  guint mask = 0;
+
+  _MASK_ADD_IF_SET (feature_class, property_changed, FEATURE_PROPERTY_CHANGED);
+  _MASK_ADD_IF_SET (feature_class, state_changed, STATE_CHANGED);
+  _MASK_ADD_IF_SET (feature_class, position_changed, POSITION_CHANGED);
+  _MASK_ADD_IF_SET (feature_class, speed_changed, SPEED_CHANGED);
+  _MASK_ADD_IF_SET (feature_class, volume_changed, VOLUME_CHANGED);
+  _MASK_ADD_IF_SET (feature_class, mute_changed, MUTE_CHANGED);
+  _MASK_ADD_IF_SET (feature_class, played_item_changed, PLAYED_ITEM_CHANGED);
+  _MASK_ADD_IF_SET (feature_class, item_updated, ITEM_UPDATED);
+  _MASK_ADD_IF_SET (feature_class, queue_item_added, QUEUE_ITEM_ADDED);
+  _MASK_ADD_IF_SET (feature_class, queue_item_removed, QUEUE_ITEM_REMOVED);
+  _MASK_ADD_IF_SET (feature_class, queue_item_repositioned, QUEUE_ITEM_REPOSITIONED);
+  _MASK_ADD_IF_SET (feature_class, queue_cleared, QUEUE_CLEARED);
+  _MASK_ADD_IF_SET (feature_class, queue_progression_changed, QUEUE_PROGRESSION_CHANGED);
+
+  return mask;
+}
+
 void
 clapper_feature_call_prepare (ClapperFeature *self)
 {
@@ -22,6 +22,7 @@
 #include <glib-object.h>
 
 #include "clapper-features-manager-private.h"
+#include "clapper-event-ring-private.h"
 #include "clapper-enums-private.h"
 
 G_BEGIN_DECLS
@@ -38,6 +39,6 @@ void clapper_features_bus_initialize (void);
 
 ClapperFeaturesBus * clapper_features_bus_new (void);
 
-void clapper_features_bus_post_event (ClapperFeaturesBus *features_bus, ClapperFeaturesManager *src, ClapperFeaturesManagerEvent event, GValue *value, GValue *extra_value);
+void clapper_features_bus_post_event (ClapperFeaturesBus *features_bus, ClapperEvent *event);
 
 G_END_DECLS
@@ -23,9 +23,16 @@
 #define GST_CAT_DEFAULT clapper_features_bus_debug
 GST_DEBUG_CATEGORY_STATIC (GST_CAT_DEFAULT);
 
+#define EVENT_RING_SIZE 256
+
+/* Events are carried in ring buffer, bus is only used
+ * to wake up features thread when there are new ones */
 struct _ClapperFeaturesBus
 {
   GstBus parent;
+
+  ClapperEventRing *ring;
+  GstMessage *wakeup_msg;
 };
 
 #define parent_class clapper_features_bus_parent_class
@@ -34,34 +41,16 @@ G_DEFINE_TYPE (ClapperFeaturesBus, clapper_features_bus, GST_TYPE_BUS);
 enum
 {
   CLAPPER_FEATURES_BUS_STRUCTURE_UNKNOWN = 0,
-  CLAPPER_FEATURES_BUS_STRUCTURE_EVENT
+  CLAPPER_FEATURES_BUS_STRUCTURE_WAKEUP
 };
 
 static ClapperBusQuark _structure_quarks[] = {
   {"unknown", 0},
-  {"event", 0},
-  {NULL, 0}
-};
-
-enum
-{
-  CLAPPER_FEATURES_BUS_FIELD_UNKNOWN = 0,
-  CLAPPER_FEATURES_BUS_FIELD_EVENT,
-  CLAPPER_FEATURES_BUS_FIELD_VALUE,
-  CLAPPER_FEATURES_BUS_FIELD_EXTRA_VALUE
-};
-
-static ClapperBusQuark _field_quarks[] = {
-  {"unknown", 0},
-  {"event", 0},
-  {"value", 0},
-  {"extra-value", 0},
+  {"wakeup", 0},
   {NULL, 0}
 };
 
 #define _STRUCTURE_QUARK(q) (_structure_quarks[CLAPPER_FEATURES_BUS_STRUCTURE_##q].quark)
-#define _FIELD_QUARK(q) (_field_quarks[CLAPPER_FEATURES_BUS_FIELD_##q].quark)
-#define _MESSAGE_SRC_CLAPPER_FEATURES_MANAGER(msg) ((ClapperFeaturesManager *) GST_MESSAGE_SRC (msg))
 
 void
 clapper_features_bus_initialize (void)
@@ -70,53 +59,42 @@ clapper_features_bus_initialize (void)
 
   for (i = 0; _structure_quarks[i].name; ++i)
     _structure_quarks[i].quark = g_quark_from_static_string (_structure_quarks[i].name);
-  for (i = 0; _field_quarks[i].name; ++i)
-    _field_quarks[i].quark = g_quark_from_static_string (_field_quarks[i].name);
 }
 
+/*
+ * clapper_features_bus_post_event:
+ * @event: (transfer full): a #ClapperEvent with #ClapperFeaturesManager as its source
+ */
 void
-clapper_features_bus_post_event (ClapperFeaturesBus *self,
-    ClapperFeaturesManager *src, ClapperFeaturesManagerEvent event,
-    GValue *value, GValue *extra_value)
+clapper_features_bus_post_event (ClapperFeaturesBus *self, ClapperEvent *event)
 {
-  GstStructure *structure = gst_structure_new_id (_STRUCTURE_QUARK (EVENT),
-      _FIELD_QUARK (EVENT), G_TYPE_ENUM, event,
-      NULL);
-
-  if (value)
-    gst_structure_id_take_value (structure, _FIELD_QUARK (VALUE), value);
-  if (extra_value)
-    gst_structure_id_take_value (structure, _FIELD_QUARK (EXTRA_VALUE), extra_value);
-
-  gst_bus_post (GST_BUS_CAST (self), gst_message_new_application (
-      GST_OBJECT_CAST (src), structure));
+  if (clapper_event_ring_push (self->ring, event))
+    gst_bus_post (GST_BUS_CAST (self), gst_message_ref (self->wakeup_msg));
 }
 
 static inline void
-_handle_event_msg (GstMessage *msg, const GstStructure *structure,
-    ClapperFeaturesManager *features_manager)
+_handle_wakeup_msg (ClapperFeaturesBus *self)
 {
-  ClapperFeaturesManagerEvent event = CLAPPER_FEATURES_MANAGER_EVENT_UNKNOWN;
-  const GValue *value = gst_structure_id_get_value (structure, _FIELD_QUARK (VALUE));
-  const GValue *extra_value = gst_structure_id_get_value (structure, _FIELD_QUARK (EXTRA_VALUE));
+  ClapperEvent event;
 
-  gst_structure_id_get (structure,
-      _FIELD_QUARK (EVENT), G_TYPE_ENUM, &event,
-      NULL);
+  clapper_event_ring_begin_consume (self->ring);
 
-  clapper_features_manager_handle_event (features_manager, event, value, extra_value);
+  while (clapper_event_ring_pop (self->ring, &event)) {
+    clapper_features_manager_handle_event (
+        CLAPPER_FEATURES_MANAGER_CAST (event.src), &event);
+    clapper_event_clear (&event);
+  }
 }
 
 static gboolean
 clapper_features_bus_message_func (GstBus *bus, GstMessage *msg, gpointer user_data G_GNUC_UNUSED)
 {
   if (G_LIKELY (GST_MESSAGE_TYPE (msg) == GST_MESSAGE_APPLICATION)) {
-    ClapperFeaturesManager *features_manager = _MESSAGE_SRC_CLAPPER_FEATURES_MANAGER (msg);
     const GstStructure *structure = gst_message_get_structure (msg);
     GQuark quark = gst_structure_get_name_id (structure);
 
-    if (quark == _STRUCTURE_QUARK (EVENT))
-      _handle_event_msg (msg, structure, features_manager);
+    if (quark == _STRUCTURE_QUARK (WAKEUP))
+      _handle_wakeup_msg (CLAPPER_FEATURES_BUS_CAST (bus));
   }
 
   return G_SOURCE_CONTINUE;
@@ -143,6 +121,9 @@ clapper_features_bus_new (void)
 static void
 clapper_features_bus_init (ClapperFeaturesBus *self)
 {
+  self->ring = clapper_event_ring_new (EVENT_RING_SIZE);
+  self->wakeup_msg = gst_message_new_application (NULL,
+      gst_structure_new_id_empty (_STRUCTURE_QUARK (WAKEUP)));
 }
 
 static void
@@ -152,6 +133,9 @@ clapper_features_bus_finalize (GObject *object)
 
   GST_TRACE_OBJECT (self, "Finalize");
 
+  clapper_event_ring_free (self->ring);
+  gst_message_unref (self->wakeup_msg);
+
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
 
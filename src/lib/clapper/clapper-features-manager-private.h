@@ -21,6 +21,7 @@
 #include "clapper-enums-private.h"
 #include "clapper-threaded-object.h"
 #include "clapper-feature.h"
+#include "clapper-event-ring-private.h"
 
 G_BEGIN_DECLS
 
@@ -35,6 +36,9 @@ ClapperFeaturesManager * clapper_features_manager_new (void);
 G_GNUC_INTERNAL
 void clapper_features_manager_add_feature (ClapperFeaturesManager *features, ClapperFeature *feature, GstObject *parent);
 
+G_GNUC_INTERNAL
+gboolean clapper_features_manager_has_position_interest (ClapperFeaturesManager *features);
+
 G_GNUC_INTERNAL
 void clapper_features_manager_trigger_property_changed (ClapperFeaturesManager *self, ClapperFeature *feature, GParamSpec *pspec);
 
@@ -75,6 +79,6 @@ G_GNUC_INTERNAL
 void clapper_features_manager_trigger_queue_progression_changed (ClapperFeaturesManager *features, ClapperQueueProgressionMode mode);
 
 G_GNUC_INTERNAL
-void clapper_features_manager_handle_event (ClapperFeaturesManager *features, ClapperFeaturesManagerEvent event, const GValue *value, const GValue *extra_value);
+void clapper_features_manager_handle_event (ClapperFeaturesManager *features, const ClapperEvent *event);
 
 G_END_DECLS
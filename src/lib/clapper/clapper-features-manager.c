@@ -29,85 +29,91 @@ struct _ClapperFeaturesManager
 
   GPtrArray *features;
   ClapperFeaturesBus *bus;
+
+  /* Union of event masks of added features (atomic) */
+  guint event_mask;
 };
 
 #define parent_class clapper_features_manager_parent_class
 G_DEFINE_TYPE (ClapperFeaturesManager, clapper_features_manager, CLAPPER_TYPE_THREADED_OBJECT);
 
+#define _HAS_INTEREST(self,event) \
+  ((g_atomic_int_get (&self->event_mask) & (1u << (event))) != 0)
+
 static inline void
-_post_object (ClapperFeaturesManager *self, ClapperFeaturesManagerEvent event, GObject *data)
+_post_event (ClapperFeaturesManager *self, ClapperEvent *event)
 {
-  GValue value = G_VALUE_INIT;
+  event->src = gst_object_ref (GST_OBJECT_CAST (self));
+  clapper_features_bus_post_event (self->bus, event);
+}
 
-  g_value_init (&value, G_TYPE_OBJECT);
-  g_value_set_object (&value, data);
+static inline void
+_post_object (ClapperFeaturesManager *self, ClapperFeaturesManagerEvent type, GObject *data)
+{
+  ClapperEvent event = { 0, };
+
+  event.type = type;
+  event.object = (data) ? g_object_ref (data) : NULL;
 
-  clapper_features_bus_post_event (self->bus, self, event, &value, NULL);
+  _post_event (self, &event);
 }
 
 static inline void
-_post_int (ClapperFeaturesManager *self, ClapperFeaturesManagerEvent event, gint data)
+_post_int (ClapperFeaturesManager *self, ClapperFeaturesManagerEvent type, gint data)
 {
-  GValue value = G_VALUE_INIT;
+  ClapperEvent event = { 0, };
 
-  g_value_init (&value, G_TYPE_INT);
-  g_value_set_int (&value, data);
+  event.type = type;
+  event.value.v_int = data;
 
-  clapper_features_bus_post_event (self->bus, self, event, &value, NULL);
+  _post_event (self, &event);
 }
 
 static inline void
-_post_double (ClapperFeaturesManager *self, ClapperFeaturesManagerEvent event, gdouble data)
+_post_double (ClapperFeaturesManager *self, ClapperFeaturesManagerEvent type, gdouble data)
 {
-  GValue value = G_VALUE_INIT;
+  ClapperEvent event = { 0, };
 
-  g_value_init (&value, G_TYPE_DOUBLE);
-  g_value_set_double (&value, data);
+  event.type = type;
+  event.value.v_double = data;
 
-  clapper_features_bus_post_event (self->bus, self, event, &value, NULL);
+  _post_event (self, &event);
 }
 
 static inline void
-_post_boolean (ClapperFeaturesManager *self, ClapperFeaturesManagerEvent event, gboolean data)
+_post_boolean (ClapperFeaturesManager *self, ClapperFeaturesManagerEvent type, gboolean data)
 {
-  GValue value = G_VALUE_INIT;
+  ClapperEvent event = { 0, };
 
-  g_value_init (&value, G_TYPE_BOOLEAN);
-  g_value_set_boolean (&value, data);
+  event.type = type;
+  event.value.v_boolean = data;
 
-  clapper_features_bus_post_event (self->bus, self, event, &value, NULL);
+  _post_event (self, &event);
 }
 
 static inline void
-_post_item_added_or_removed (ClapperFeaturesManager *self, ClapperFeaturesManagerEvent event,
+_post_item_added_or_removed (ClapperFeaturesManager *self, ClapperFeaturesManagerEvent type,
     ClapperMediaItem *item, guint index)
 {
-  GValue value = G_VALUE_INIT;
-  GValue extra_value = G_VALUE_INIT;
-
-  g_value_init (&value, G_TYPE_OBJECT);
-  g_value_set_object (&value, (GObject *) item);
+  ClapperEvent event = { 0, };
 
-  g_value_init (&extra_value, G_TYPE_UINT);
-  g_value_set_uint (&extra_value, index);
+  event.type = type;
+  event.object = g_object_ref (G_OBJECT (item));
+  event.value.v_uint = index;
 
-  clapper_features_bus_post_event (self->bus, self, event, &value, &extra_value);
+  _post_event (self, &event);
 }
 
 static inline void
 _post_item_reposition (ClapperFeaturesManager *self, guint data_1, guint data_2)
 {
-  GValue value = G_VALUE_INIT;
-  GValue extra_value = G_VALUE_INIT;
+  ClapperEvent event = { 0, };
 
-  g_value_init (&value, G_TYPE_UINT);
-  g_value_set_uint (&value, data_1);
+  event.type = CLAPPER_FEATURES_MANAGER_EVENT_QUEUE_ITEM_REPOSITIONED;
+  event.value.v_uint = data_1;
+  event.extra_value.v_uint = data_2;
 
-  g_value_init (&extra_value, G_TYPE_UINT);
-  g_value_set_uint (&extra_value, data_2);
-
-  clapper_features_bus_post_event (self->bus, self,
-      CLAPPER_FEATURES_MANAGER_EVENT_QUEUE_ITEM_REPOSITIONED, &value, &extra_value);
+  _post_event (self, &event);
 }
 
 /*
@@ -129,117 +135,165 @@ clapper_features_manager_new (void)
 void
 clapper_features_manager_add_feature (ClapperFeaturesManager *self, ClapperFeature *feature, GstObject *parent)
 {
-  GValue value = G_VALUE_INIT;
-  GValue extra_value = G_VALUE_INIT;
+  ClapperEvent event = { 0, };
+
+  /* Features are never removed, so mask can only grow. Set it before
+   * posting, so no event meant for this feature will be skipped. */
+  g_atomic_int_or (&self->event_mask, clapper_feature_get_event_mask (feature));
 
-  g_value_init (&value, G_TYPE_OBJECT);
-  g_value_set_object (&value, G_OBJECT (feature));
+  event.type = CLAPPER_FEATURES_MANAGER_EVENT_FEATURE_ADDED;
+  event.object = g_object_ref (G_OBJECT (feature));
+  event.extra_object = g_object_ref (G_OBJECT (parent));
 
-  g_value_init (&extra_value, G_TYPE_OBJECT);
-  g_value_set_object (&extra_value, G_OBJECT (parent));
+  _post_event (self, &event);
+}
 
-  clapper_features_bus_post_event (self->bus, self,
-      CLAPPER_FEATURES_MANAGER_EVENT_FEATURE_ADDED, &value, &extra_value);
+gboolean
+clapper_features_manager_has_position_interest (ClapperFeaturesManager *self)
+{
+  return _HAS_INTEREST (self, CLAPPER_FEATURES_MANAGER_EVENT_POSITION_CHANGED);
 }
 
 void
 clapper_features_manager_trigger_property_changed (ClapperFeaturesManager *self, ClapperFeature *feature, GParamSpec *pspec)
 {
-  GValue value = G_VALUE_INIT;
-  GValue extra_value = G_VALUE_INIT;
+  ClapperEvent event = { 0, };
 
-  g_value_init (&value, G_TYPE_OBJECT);
-  g_value_set_object (&value, G_OBJECT (feature));
+  if (!(clapper_feature_get_event_mask (feature)
+      & (1u << CLAPPER_FEATURES_MANAGER_EVENT_FEATURE_PROPERTY_CHANGED)))
+    return;
 
-  g_value_init (&extra_value, G_TYPE_PARAM);
-  g_value_set_param (&extra_value, pspec);
+  /* Param spec is owned by feature class, so no need to ref it */
+  event.type = CLAPPER_FEATURES_MANAGER_EVENT_FEATURE_PROPERTY_CHANGED;
+  event.object = g_object_ref (G_OBJECT (feature));
+  event.value.v_pointer = pspec;
 
-  clapper_features_bus_post_event (self->bus, self,
-      CLAPPER_FEATURES_MANAGER_EVENT_FEATURE_PROPERTY_CHANGED, &value, &extra_value);
+  _post_event (self, &event);
 }
 
 void
 clapper_features_manager_trigger_state_changed (ClapperFeaturesManager *self, ClapperPlayerState state)
 {
+  if (!_HAS_INTEREST (self, CLAPPER_FEATURES_MANAGER_EVENT_STATE_CHANGED))
+    return;
+
   _post_int (self, CLAPPER_FEATURES_MANAGER_EVENT_STATE_CHANGED, state);
 }
 
 void
 clapper_features_manager_trigger_position_changed (ClapperFeaturesManager *self, gdouble position)
 {
+  if (!_HAS_INTEREST (self, CLAPPER_FEATURES_MANAGER_EVENT_POSITION_CHANGED))
+    return;
+
   _post_double (self, CLAPPER_FEATURES_MANAGER_EVENT_POSITION_CHANGED, position);
 }
 
 void
 clapper_features_manager_trigger_speed_changed (ClapperFeaturesManager *self, gdouble speed)
 {
+  if (!_HAS_INTEREST (self, CLAPPER_FEATURES_MANAGER_EVENT_SPEED_CHANGED))
+    return;
+
   _post_double (self, CLAPPER_FEATURES_MANAGER_EVENT_SPEED_CHANGED, speed);
 }
 
 void
 clapper_features_manager_trigger_volume_changed (ClapperFeaturesManager *self, gdouble volume)
 {
+  if (!_HAS_INTEREST (self, CLAPPER_FEATURES_MANAGER_EVENT_VOLUME_CHANGED))
+    return;
+
   _post_double (self, CLAPPER_FEATURES_MANAGER_EVENT_VOLUME_CHANGED, volume);
 }
 
 void
 clapper_features_manager_trigger_mute_changed (ClapperFeaturesManager *self, gboolean mute)
 {
+  if (!_HAS_INTEREST (self, CLAPPER_FEATURES_MANAGER_EVENT_MUTE_CHANGED))
+    return;
+
   _post_boolean (self, CLAPPER_FEATURES_MANAGER_EVENT_MUTE_CHANGED, mute);
 }
 
 void
 clapper_features_manager_trigger_played_item_changed (ClapperFeaturesManager *self, ClapperMediaItem *item)
 {
+  if (!_HAS_INTEREST (self, CLAPPER_FEATURES_MANAGER_EVENT_PLAYED_ITEM_CHANGED))
+    return;
+
   _post_object (self, CLAPPER_FEATURES_MANAGER_EVENT_PLAYED_ITEM_CHANGED, (GObject *) item);
 }
 
 void
 clapper_features_manager_trigger_item_updated (ClapperFeaturesManager *self, ClapperMediaItem *item)
 {
+  if (!_HAS_INTEREST (self, CLAPPER_FEATURES_MANAGER_EVENT_ITEM_UPDATED))
+    return;
+
   _post_object (self, CLAPPER_FEATURES_MANAGER_EVENT_ITEM_UPDATED, (GObject *) item);
 }
 
 void
 clapper_features_manager_trigger_queue_item_added (ClapperFeaturesManager *self, ClapperMediaItem *item, guint index)
 {
+  if (!_HAS_INTEREST (self, CLAPPER_FEATURES_MANAGER_EVENT_QUEUE_ITEM_ADDED))
+    return;
+
   _post_item_added_or_removed (self, CLAPPER_FEATURES_MANAGER_EVENT_QUEUE_ITEM_ADDED, item, index);
 }
 
 void
 clapper_features_manager_trigger_queue_item_removed (ClapperFeaturesManager *self, ClapperMediaItem *item, guint index)
 {
+  if (!_HAS_INTEREST (self, CLAPPER_FEATURES_MANAGER_EVENT_QUEUE_ITEM_REMOVED))
+    return;
+
   _post_item_added_or_removed (self, CLAPPER_FEATURES_MANAGER_EVENT_QUEUE_ITEM_REMOVED, item, index);
 }
 
 void
 clapper_features_manager_trigger_queue_item_repositioned (ClapperFeaturesManager *self, guint before, guint after)
 {
+  if (!_HAS_INTEREST (self, CLAPPER_FEATURES_MANAGER_EVENT_QUEUE_ITEM_REPOSITIONED))
+    return;
+
   _post_item_reposition (self, before, after);
 }
 
 void
 clapper_features_manager_trigger_queue_cleared (ClapperFeaturesManager *self)
 {
-  clapper_features_bus_post_event (self->bus, self, CLAPPER_FEATURES_MANAGER_EVENT_QUEUE_CLEARED, NULL, NULL);
+  ClapperEvent event = { 0, };
+
+  if (!_HAS_INTEREST (self, CLAPPER_FEATURES_MANAGER_EVENT_QUEUE_CLEARED))
+    return;
+
+  event.type = CLAPPER_FEATURES_MANAGER_EVENT_QUEUE_CLEARED;
+
+  _post_event (self, &event);
 }
 
 void
 clapper_features_manager_trigger_queue_progression_changed (ClapperFeaturesManager *self, ClapperQueueProgressionMode mode)
 {
+  if (!_HAS_INTEREST (self, CLAPPER_FEATURES_MANAGER_EVENT_QUEUE_PROGRESSION_CHANGED))
+    return;
+
   _post_int (self, CLAPPER_FEATURES_MANAGER_EVENT_QUEUE_PROGRESSION_CHANGED, mode);
 }
 
 void
-clapper_features_manager_handle_event (ClapperFeaturesManager *self, ClapperFeaturesManagerEvent event,
-    const GValue *value, const GValue *extra_value)
+clapper_features_manager_handle_event (ClapperFeaturesManager *self, const ClapperEvent *event)
 {
+  const ClapperEventValue *value = &event->value;
+  const ClapperEventValue *extra_value = &event->extra_value;
   guint i;
 
-  switch (event) {
+  switch (event->type) {
     case CLAPPER_FEATURES_MANAGER_EVENT_FEATURE_ADDED:{
-      ClapperFeature *feature = g_value_get_object (value);
-      GstObject *parent = g_value_get_object (extra_value);
+      ClapperFeature *feature = CLAPPER_FEATURE_CAST (event->object);
+      GstObject *parent = GST_OBJECT_CAST (event->extra_object);
 
       if (!g_ptr_array_find (self->features, feature, NULL)) {
         g_ptr_array_add (self->features, gst_object_ref (feature));
@@ -258,59 +312,59 @@ clapper_features_manager_handle_event (ClapperFeaturesManager *self, ClapperFeat
   for (i = 0; i < self->features->len; ++i) {
     ClapperFeature *feature = g_ptr_array_index (self->features, i);
 
-    switch (event) {
+    switch (event->type) {
       case CLAPPER_FEATURES_MANAGER_EVENT_FEATURE_PROPERTY_CHANGED:{
-        ClapperFeature *event_feature = g_value_get_object (value);
+        ClapperFeature *event_feature = CLAPPER_FEATURE_CAST (event->object);
 
         if (feature == event_feature) {
           clapper_feature_call_property_changed (feature,
-              g_value_get_param (extra_value));
+              (GParamSpec *) value->v_pointer);
         }
         break;
       }
       case CLAPPER_FEATURES_MANAGER_EVENT_STATE_CHANGED:
-        clapper_feature_call_state_changed (feature, g_value_get_int (value));
+        clapper_feature_call_state_changed (feature, value->v_int);
         break;
       case CLAPPER_FEATURES_MANAGER_EVENT_POSITION_CHANGED:
-        clapper_feature_call_position_changed (feature, g_value_get_double (value));
+        clapper_feature_call_position_changed (feature, value->v_double);
         break;
       case CLAPPER_FEATURES_MANAGER_EVENT_SPEED_CHANGED:
-        clapper_feature_call_speed_changed (feature, g_value_get_double (value));
+        clapper_feature_call_speed_changed (feature, value->v_double);
         break;
       case CLAPPER_FEATURES_MANAGER_EVENT_VOLUME_CHANGED:
-        clapper_feature_call_volume_changed (feature, g_value_get_double (value));
+        clapper_feature_call_volume_changed (feature, value->v_double);
         break;
       case CLAPPER_FEATURES_MANAGER_EVENT_MUTE_CHANGED:
-        clapper_feature_call_mute_changed (feature, g_value_get_boolean (value));
+        clapper_feature_call_mute_changed (feature, value->v_boolean);
         break;
       case CLAPPER_FEATURES_MANAGER_EVENT_PLAYED_ITEM_CHANGED:
         clapper_feature_call_played_item_changed (feature,
-            CLAPPER_MEDIA_ITEM_CAST (g_value_get_object (value)));
+            CLAPPER_MEDIA_ITEM_CAST (event->object));
         break;
       case CLAPPER_FEATURES_MANAGER_EVENT_ITEM_UPDATED:
         clapper_feature_call_item_updated (feature,
-            CLAPPER_MEDIA_ITEM_CAST (g_value_get_object (value)));
+            CLAPPER_MEDIA_ITEM_CAST (event->object));
         break;
       case CLAPPER_FEATURES_MANAGER_EVENT_QUEUE_ITEM_ADDED:
         clapper_feature_call_queue_item_added (feature,
-            CLAPPER_MEDIA_ITEM_CAST (g_value_get_object (value)),
-            g_value_get_uint (extra_value));
+            CLAPPER_MEDIA_ITEM_CAST (event->object),
+            value->v_uint);
         break;
       case CLAPPER_FEATURES_MANAGER_EVENT_QUEUE_ITEM_REMOVED:
         clapper_feature_call_queue_item_removed (feature,
-            CLAPPER_MEDIA_ITEM_CAST (g_value_get_object (value)),
-            g_value_get_uint (extra_value));
+            CLAPPER_MEDIA_ITEM_CAST (event->object),
+            value->v_uint);
         break;
       case CLAPPER_FEATURES_MANAGER_EVENT_QUEUE_ITEM_REPOSITIONED:
         clapper_feature_call_queue_item_repositioned (feature,
-            g_value_get_uint (value),
-            g_value_get_uint (extra_value));
+            value->v_uint,
+            extra_value->v_uint);
         break;
       case CLAPPER_FEATURES_MANAGER_EVENT_QUEUE_CLEARED:
         clapper_feature_call_queue_cleared (feature);
         break;
       case CLAPPER_FEATURES_MANAGER_EVENT_QUEUE_PROGRESSION_CHANGED:
-        clapper_feature_call_queue_progression_changed (feature, g_value_get_int (value));
+        clapper_feature_call_queue_progression_changed (feature, value->v_int);
         break;
       default:
         break;
@@ -38,6 +38,9 @@ gboolean clapper_harvest_unpack (ClapperHarvest *harvest, GstBuffer **buffer, gs
 G_GNUC_INTERNAL
 gboolean clapper_harvest_fill_from_cache (ClapperHarvest *harvest, ClapperEnhancerProxy *proxy, const GstStructure *config, GUri *uri);
 
+G_GNUC_INTERNAL
+gboolean clapper_harvest_is_from_cache (ClapperHarvest *harvest);
+
 G_GNUC_INTERNAL
 void clapper_harvest_export_to_cache (ClapperHarvest *harvest, ClapperEnhancerProxy *proxy, const GstStructure *config, GUri *uri);
 
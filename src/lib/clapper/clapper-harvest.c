@@ -55,6 +55,8 @@ struct _ClapperHarvest
   guint16 n_tracks;
 
   gint64 exp_epoch;
+
+  gboolean from_cache;
 };
 
 #define parent_class clapper_harvest_parent_class
@@ -326,7 +328,7 @@ clapper_harvest_fill_from_cache (ClapperHarvest *self, ClapperEnhancerProxy *pro
   if (read_str && (self->headers = gst_structure_from_string (read_str, NULL)))
     GST_LOG_OBJECT (self, "Read %s", read_str);
 
-  read_ok = TRUE;
+  read_ok = self->from_cache = TRUE;
 
 finish:
   g_mapped_file_unref (mapped_file);
@@ -338,6 +340,12 @@ finish:
   return TRUE;
 }
 
+gboolean
+clapper_harvest_is_from_cache (ClapperHarvest *self)
+{
+  return self->from_cache;
+}
+
 void
 clapper_harvest_export_to_cache (ClapperHarvest *self, ClapperEnhancerProxy *proxy,
     const GstStructure *config, GUri *uri)
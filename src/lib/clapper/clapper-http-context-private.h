@@ -0,0 +1,37 @@
+/* Clapper Playback Library
+ * Copyright (C) 2025 Rafał Dzięgiel <rafostar.github@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <glib.h>
+#include <gst/gst.h>
+
+G_BEGIN_DECLS
+
+#define CLAPPER_HTTP_CONTEXT_TYPE "gst.soup.session"
+
+G_GNUC_INTERNAL
+void clapper_http_context_initialize (void);
+
+G_GNUC_INTERNAL
+GstContext * clapper_http_context_get (void);
+
+G_GNUC_INTERNAL
+void clapper_http_context_offer (GstContext *context);
+
+G_END_DECLS
@@ -0,0 +1,87 @@
+/* Clapper Playback Library
+ * Copyright (C) 2025 Rafał Dzięgiel <rafostar.github@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * HTTP context holds a session that `souphttpsrc` elements can share.
+ * Sources of a single pipeline already share session through their bin,
+ * this makes it live for as long as the process does and be given to
+ * sources of every player, so items from the same host reuse warm
+ * connections (no new DNS lookups and TLS handshakes).
+ *
+ * Session is not created here (its type belongs to the soup plugin),
+ * instead the first one that a source announced as shareable is kept.
+ */
+
+#include "config.h"
+
+#include "clapper-http-context-private.h"
+
+#define GST_CAT_DEFAULT clapper_http_context_debug
+GST_DEBUG_CATEGORY_STATIC (GST_CAT_DEFAULT);
+
+static GstContext *shared_context = NULL;
+static GMutex context_lock;
+
+void
+clapper_http_context_initialize (void)
+{
+  GST_DEBUG_CATEGORY_INIT (GST_CAT_DEFAULT, "clapperhttpcontext", 0,
+      "Clapper HTTP Context");
+}
+
+/*
+ * clapper_http_context_get:
+ *
+ * Returns: (transfer full) (nullable): a shared HTTP session context.
+ */
+GstContext *
+clapper_http_context_get (void)
+{
+  GstContext *context = NULL;
+
+  g_mutex_lock (&context_lock);
+
+  if (shared_context)
+    context = gst_context_ref (shared_context);
+
+  g_mutex_unlock (&context_lock);
+
+  return context;
+}
+
+/*
+ * clapper_http_context_offer:
+ * @context: a #GstContext posted by HTTP source
+ *
+ * Keeps @context for sharing, unless one is already kept.
+ */
+void
+clapper_http_context_offer (GstContext *context)
+{
+  if (!gst_context_has_context_type (context, CLAPPER_HTTP_CONTEXT_TYPE))
+    return;
+
+  g_mutex_lock (&context_lock);
+
+  if (!shared_context) {
+    GST_DEBUG ("Keeping shared HTTP session context: %" GST_PTR_FORMAT, context);
+    shared_context = gst_context_ref (context);
+  }
+
+  g_mutex_unlock (&context_lock);
+}
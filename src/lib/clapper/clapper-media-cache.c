@@ -0,0 +1,881 @@
+/* Clapper Playback Library
+ * Copyright (C) 2025 Rafał Dzięgiel <rafostar.github@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Media cache keeps fully downloaded network media in user cache dir,
+ * so items played again can be read from disk instead of downloading
+ * (and possibly extracting) them once more. Entries are addressed by
+ * a checksum of media item URI and evicted in least recently used order
+ * once their total size exceeds limit set by player.
+ *
+ * Validators (ETag, Last-Modified and length) of the response media was
+ * downloaded from are stored with it. Any later response for the same URI
+ * (from playback, preload or warm-up) is checked against them, confirming
+ * the cached copy or removing it once media has changed. Copy that was not
+ * confirmed for a while is not played, so media is streamed (and downloaded
+ * again) instead.
+ *
+ * Index is shared by all processes using the same cache dir. It is merged
+ * with entries written by others under a file lock before each write.
+ */
+
+#include "config.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <glib/gstdio.h>
+#include <gst/gst.h>
+
+#ifdef G_OS_UNIX
+#include <sys/file.h>
+#endif
+
+#ifdef G_OS_WIN32
+#include <windows.h>
+#include <io.h>
+#endif
+
+#include "clapper-media-cache-private.h"
+#include "clapper-cache-private.h"
+#include "clapper-utils-private.h"
+
+#define GST_CAT_DEFAULT clapper_media_cache_debug
+GST_DEBUG_CATEGORY_STATIC (GST_CAT_DEFAULT);
+
+/* Unfinished downloads left behind (e.g. by a crash)
+ * are removed after this time (in seconds) */
+#define MAX_PARTIAL_AGE (24 * 60 * 60)
+
+/* Only updated usage times are not worth writing index more often
+ * than that (in seconds), they only affect order of eviction */
+#define USAGE_SAVE_INTERVAL (10 * 60)
+
+/* Cached copy is played only if source was seen unchanged
+ * within this time (in seconds), otherwise it is streamed */
+#define MAX_VALIDATED_AGE (60 * 60)
+
+/* Responses waiting for their downloads to complete, more
+ * than that means most of them were never downloaded */
+#define MAX_PENDING_RESPONSES 16
+
+typedef struct
+{
+  gchar *filename; // relative to media dir, NULL for pending response
+  guint64 size; // zero when unknown
+  gint64 last_used; // epoch in seconds
+  gint64 validated; // epoch in seconds, when source was last seen unchanged
+  gchar *etag;
+  gchar *last_modified;
+} ClapperMediaCacheEntry;
+
+typedef enum
+{
+  CLAPPER_MEDIA_CACHE_MATCH_UNKNOWN = 0,
+  CLAPPER_MEDIA_CACHE_MATCH_SAME,
+  CLAPPER_MEDIA_CACHE_MATCH_CHANGED
+} ClapperMediaCacheMatch;
+
+static GHashTable *entries = NULL;
+static GHashTable *pending = NULL; // validators of not yet stored downloads
+static GHashTable *added_keys = NULL; // stored since last write
+static GHashTable *removed_files = NULL; // removed since last write
+static gchar *media_dir = NULL;
+static gboolean loaded = FALSE;
+static gboolean dirty = FALSE;
+static gboolean touched = FALSE;
+static gint64 last_save = 0;
+static gint64 index_mtime = 0;
+static gint64 index_size = -1;
+static GMutex entries_lock;
+
+static void
+_entry_free (ClapperMediaCacheEntry *entry)
+{
+  g_free (entry->filename);
+  g_free (entry->etag);
+  g_free (entry->last_modified);
+  g_free (entry);
+}
+
+static inline GHashTable *
+_entries_table_new (void)
+{
+  return g_hash_table_new_full (g_str_hash, g_str_equal,
+      g_free, (GDestroyNotify) _entry_free);
+}
+
+void
+clapper_media_cache_initialize (void)
+{
+  GST_DEBUG_CATEGORY_INIT (GST_CAT_DEFAULT, "clappermediacache", 0,
+      "Clapper Media Cache");
+
+  entries = _entries_table_new ();
+  pending = _entries_table_new ();
+  added_keys = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+  removed_files = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+  media_dir = g_build_filename (g_get_user_cache_dir (), CLAPPER_API_NAME,
+      "media", NULL);
+}
+
+static inline gchar *
+_build_cache_filename (void)
+{
+  return g_build_filename (g_get_user_cache_dir (), CLAPPER_API_NAME,
+      "media-cache.bin", NULL);
+}
+
+static inline gchar *
+_make_key (const gchar *uri)
+{
+  return g_compute_checksum_for_string (G_CHECKSUM_SHA256, uri, -1);
+}
+
+/*
+ * Takes exclusive lock shared with other processes using the same cache dir.
+ * Returns a descriptor to release it with, or -1 when locking is not possible,
+ * in which case index is still written, but might lose changes of others.
+ */
+static gint
+_lock_index (void)
+{
+  gchar *dirname, *filename;
+  gint fd = -1;
+
+  dirname = g_build_filename (g_get_user_cache_dir (), CLAPPER_API_NAME, NULL);
+  filename = g_build_filename (dirname, "media-cache.lock", NULL);
+
+  if (g_mkdir_with_parents (dirname, 0755) != 0
+      || (fd = g_open (filename, O_RDWR | O_CREAT, 0644)) < 0) {
+    GST_WARNING ("Could not open media cache lock file: \"%s\"", filename);
+    goto finish;
+  }
+
+#ifdef G_OS_UNIX
+  while (flock (fd, LOCK_EX) != 0) {
+    if (errno != EINTR) {
+      GST_WARNING ("Could not lock media cache index");
+      g_close (fd, NULL);
+      fd = -1;
+      break;
+    }
+  }
+#elif defined (G_OS_WIN32)
+  {
+    OVERLAPPED overlapped = { 0, };
+
+    if (!LockFileEx ((HANDLE) _get_osfhandle (fd), LOCKFILE_EXCLUSIVE_LOCK,
+        0, 1, 0, &overlapped)) {
+      GST_WARNING ("Could not lock media cache index");
+      g_close (fd, NULL);
+      fd = -1;
+    }
+  }
+#endif
+
+finish:
+  g_free (dirname);
+  g_free (filename);
+
+  return fd;
+}
+
+static void
+_unlock_index (gint fd)
+{
+  if (fd < 0)
+    return;
+
+#ifdef G_OS_UNIX
+  flock (fd, LOCK_UN);
+#elif defined (G_OS_WIN32)
+  {
+    OVERLAPPED overlapped = { 0, };
+
+    UnlockFileEx ((HANDLE) _get_osfhandle (fd), 0, 1, 0, &overlapped);
+  }
+#endif
+
+  g_close (fd, NULL);
+}
+
+/* Must be called with lock held */
+static void
+_update_index_stamp (void)
+{
+  gchar *filename = _build_cache_filename ();
+  GStatBuf buf;
+
+  if (g_stat (filename, &buf) == 0) {
+    index_mtime = buf.st_mtime;
+    index_size = buf.st_size;
+  } else {
+    index_mtime = 0;
+    index_size = -1;
+  }
+
+  g_free (filename);
+}
+
+/* Must be called with lock held */
+static gboolean
+_index_changed (void)
+{
+  gchar *filename = _build_cache_filename ();
+  GStatBuf buf;
+  gboolean changed;
+
+  if (g_stat (filename, &buf) == 0)
+    changed = (buf.st_mtime != index_mtime || buf.st_size != index_size);
+  else
+    changed = (index_size >= 0);
+
+  g_free (filename);
+
+  return changed;
+}
+
+static void
+_remove_entry_file (ClapperMediaCacheEntry *entry)
+{
+  gchar *location = g_build_filename (media_dir, entry->filename, NULL);
+
+  GST_DEBUG ("Removing cached media: %s", entry->filename);
+
+  if (g_unlink (location) != 0 && errno != ENOENT)
+    GST_ERROR ("Could not remove cached media: \"%s\"", location);
+
+  g_free (location);
+}
+
+/* Must be called with lock held */
+static void
+_remove_entry (const gchar *key)
+{
+  ClapperMediaCacheEntry *entry = g_hash_table_lookup (entries, key);
+
+  _remove_entry_file (entry);
+
+  /* Remembered, so merging index does not bring it back */
+  g_hash_table_add (removed_files, g_strdup (entry->filename));
+  g_hash_table_remove (added_keys, key);
+  g_hash_table_remove (entries, key);
+
+  dirty = TRUE;
+}
+
+/* Must be called with lock held */
+static gboolean
+_is_file_referenced (const gchar *filename)
+{
+  GHashTableIter iter;
+  gpointer value;
+
+  g_hash_table_iter_init (&iter, entries);
+  while (g_hash_table_iter_next (&iter, NULL, &value)) {
+    ClapperMediaCacheEntry *entry = (ClapperMediaCacheEntry *) value;
+
+    if (strcmp (entry->filename, filename) == 0)
+      return TRUE;
+  }
+
+  return FALSE;
+}
+
+/* Must be called with lock held and index merged */
+static void
+_remove_stale_partials (void)
+{
+  GDir *dir;
+  const gchar *filename;
+  gint64 now;
+
+  if (!(dir = g_dir_open (media_dir, 0, NULL)))
+    return;
+
+  now = g_get_real_time () / G_USEC_PER_SEC;
+
+  while ((filename = g_dir_read_name (dir))) {
+    gchar *location;
+    GStatBuf buf;
+
+    if (_is_file_referenced (filename))
+      continue;
+
+    location = g_build_filename (media_dir, filename, NULL);
+
+    /* Another player might still be downloading it, so only remove old ones */
+    if (g_stat (location, &buf) == 0 && now - buf.st_mtime > MAX_PARTIAL_AGE) {
+      GST_DEBUG ("Removing stale partial download: %s", filename);
+      g_unlink (location);
+    }
+
+    g_free (location);
+  }
+
+  g_dir_close (dir);
+}
+
+/*
+ * Returns: (transfer full) (nullable): entries from index file, empty when
+ *   there is no index yet or %NULL when it could not be read.
+ */
+static GHashTable *
+_read_index (void)
+{
+  GHashTable *disk_entries;
+  GMappedFile *mapped_file;
+  GError *error = NULL;
+  gchar *filename;
+  const gchar *data;
+  guint i, n_entries;
+
+  if (clapper_cache_is_disabled ())
+    return NULL;
+
+  filename = _build_cache_filename ();
+  mapped_file = clapper_cache_open (filename, &data, &error);
+  g_free (filename);
+
+  if (!mapped_file) {
+    if (!error) // different version, will be replaced
+      return _entries_table_new ();
+
+    if (error->domain == G_FILE_ERROR && error->code == G_FILE_ERROR_NOENT) {
+      GST_DEBUG ("No media cache index found");
+      g_error_free (error);
+
+      return _entries_table_new ();
+    }
+
+    GST_ERROR ("Could not read media cache index, reason: %s", error->message);
+    g_error_free (error);
+
+    return NULL;
+  }
+
+  disk_entries = _entries_table_new ();
+  n_entries = clapper_cache_read_uint (&data);
+
+  for (i = 0; i < n_entries; ++i) {
+    ClapperMediaCacheEntry *entry;
+    const gchar *key = clapper_cache_read_string (&data);
+    const gchar *entry_filename = clapper_cache_read_string (&data);
+    guint64 size = (guint64) clapper_cache_read_int64 (&data);
+    gint64 last_used = clapper_cache_read_int64 (&data);
+    gint64 validated = clapper_cache_read_int64 (&data);
+    const gchar *etag = clapper_cache_read_string (&data);
+    const gchar *last_modified = clapper_cache_read_string (&data);
+
+    if (!key || !entry_filename)
+      continue;
+
+    entry = g_new (ClapperMediaCacheEntry, 1);
+    entry->filename = g_strdup (entry_filename);
+    entry->size = size;
+    entry->last_used = last_used;
+    entry->validated = validated;
+    entry->etag = g_strdup (etag);
+    entry->last_modified = g_strdup (last_modified);
+
+    g_hash_table_insert (disk_entries, g_strdup (key), entry);
+  }
+
+  g_mapped_file_unref (mapped_file);
+
+  return disk_entries;
+}
+
+/*
+ * Must be called with lock held. Replaces entries with the ones from
+ * index (possibly written by another process), keeping only own changes
+ * done since last write on top of them. Entries missing from index without
+ * being added here were removed by others, so they are dropped too.
+ */
+static void
+_merge_index (void)
+{
+  GHashTable *disk_entries;
+  GHashTableIter iter;
+  gpointer key, value;
+
+  if (!(disk_entries = _read_index ()))
+    return;
+
+  _update_index_stamp ();
+
+  g_hash_table_iter_init (&iter, entries);
+  while (g_hash_table_iter_next (&iter, &key, &value)) {
+    ClapperMediaCacheEntry *entry = (ClapperMediaCacheEntry *) value;
+    ClapperMediaCacheEntry *disk_entry = g_hash_table_lookup (disk_entries, key);
+
+    if (g_hash_table_contains (added_keys, key)) {
+      /* Stored here, so it replaces copy of the same media from elsewhere */
+      if (disk_entry && strcmp (disk_entry->filename, entry->filename) != 0)
+        _remove_entry_file (disk_entry);
+
+      g_hash_table_iter_steal (&iter);
+      g_hash_table_replace (disk_entries, key, entry);
+    } else if (disk_entry && strcmp (disk_entry->filename, entry->filename) == 0) {
+      disk_entry->last_used = MAX (disk_entry->last_used, entry->last_used);
+      disk_entry->validated = MAX (disk_entry->validated, entry->validated);
+    }
+  }
+
+  g_hash_table_iter_init (&iter, disk_entries);
+  while (g_hash_table_iter_next (&iter, NULL, &value)) {
+    ClapperMediaCacheEntry *entry = (ClapperMediaCacheEntry *) value;
+
+    if (g_hash_table_contains (removed_files, entry->filename))
+      g_hash_table_iter_remove (&iter);
+  }
+
+  g_hash_table_unref (entries);
+  entries = disk_entries;
+
+  GST_DEBUG ("Merged media cache index, entries: %u", g_hash_table_size (entries));
+}
+
+/* Must be called with lock held */
+static void
+_ensure_synced (void)
+{
+  gint lock_fd;
+
+  if (loaded) {
+    /* Another process wrote index since it was last read */
+    if (_index_changed ())
+      _merge_index ();
+
+    return;
+  }
+
+  loaded = TRUE;
+
+  if (clapper_cache_is_disabled ())
+    return;
+
+  /* Files of entries stored by others are referenced only after merge */
+  lock_fd = _lock_index ();
+  _merge_index ();
+  _remove_stale_partials ();
+  _unlock_index (lock_fd);
+}
+
+/*
+ * Fills validators of @entry from "http-headers" message @structure.
+ * Returns %FALSE if it is not a successful media response.
+ */
+static gboolean
+_read_response (const GstStructure *structure, ClapperMediaCacheEntry *entry)
+{
+  const GValue *value;
+  const GstStructure *headers;
+  const gchar *length_str;
+  guint status = 0;
+
+  gst_structure_get_uint (structure, "http-status-code", &status);
+
+  if (status != 200 && status != 206)
+    return FALSE;
+
+  if (!(value = gst_structure_get_value (structure, "response-headers"))
+      || !G_VALUE_HOLDS (value, GST_TYPE_STRUCTURE))
+    return FALSE;
+
+  headers = gst_value_get_structure (value);
+
+  entry->etag = g_strdup (clapper_utils_find_http_header (headers, "ETag"));
+  entry->last_modified = g_strdup (clapper_utils_find_http_header (headers, "Last-Modified"));
+
+  /* Partial response has full length after a slash of its range */
+  if (status == 206) {
+    if ((length_str = clapper_utils_find_http_header (headers, "Content-Range"))
+        && (length_str = strrchr (length_str, '/')))
+      length_str++;
+  } else {
+    length_str = clapper_utils_find_http_header (headers, "Content-Length");
+  }
+
+  if (!length_str || !g_ascii_string_to_unsigned (length_str, 10, 0,
+      G_MAXUINT64, &entry->size, NULL))
+    entry->size = 0;
+
+  return TRUE;
+}
+
+static ClapperMediaCacheMatch
+_match_response (const ClapperMediaCacheEntry *entry, const ClapperMediaCacheEntry *response)
+{
+  gboolean confirmed = FALSE;
+
+  if (response->size > 0 && response->size != entry->size)
+    return CLAPPER_MEDIA_CACHE_MATCH_CHANGED;
+
+  if (entry->etag && response->etag) {
+    if (strcmp (entry->etag, response->etag) != 0)
+      return CLAPPER_MEDIA_CACHE_MATCH_CHANGED;
+    confirmed = TRUE;
+  }
+  if (entry->last_modified && response->last_modified) {
+    if (strcmp (entry->last_modified, response->last_modified) != 0)
+      return CLAPPER_MEDIA_CACHE_MATCH_CHANGED;
+    confirmed = TRUE;
+  }
+
+  /* Same length alone does not prove that content is the same */
+  return (confirmed) ? CLAPPER_MEDIA_CACHE_MATCH_SAME : CLAPPER_MEDIA_CACHE_MATCH_UNKNOWN;
+}
+
+/*
+ * clapper_media_cache_handle_http_headers:
+ * @structure: a structure of "http-headers" element message
+ *
+ * Checks response for media against its cached copy, confirming that copy
+ * or removing it when media has changed. Validators of response are also
+ * kept, so they can be stored together with media once it is downloaded.
+ */
+void
+clapper_media_cache_handle_http_headers (const GstStructure *structure)
+{
+  ClapperMediaCacheEntry *response, *entry;
+  const gchar *uri;
+  gchar *key;
+
+  if (!(uri = gst_structure_get_string (structure, "uri")))
+    return;
+
+  response = g_new0 (ClapperMediaCacheEntry, 1);
+
+  if (!_read_response (structure, response)) {
+    _entry_free (response);
+    return;
+  }
+
+  key = _make_key (uri);
+
+  g_mutex_lock (&entries_lock);
+
+  _ensure_synced ();
+
+  if ((entry = g_hash_table_lookup (entries, key))) {
+    switch (_match_response (entry, response)) {
+      case CLAPPER_MEDIA_CACHE_MATCH_SAME:
+        GST_LOG ("Cached media of %s confirmed", uri);
+        entry->validated = g_get_real_time () / G_USEC_PER_SEC;
+        touched = TRUE;
+        break;
+      case CLAPPER_MEDIA_CACHE_MATCH_CHANGED:
+        GST_DEBUG ("Media at %s changed, dropping its cached copy", uri);
+        _remove_entry (key);
+        break;
+      default:
+        break;
+    }
+  }
+
+  if (g_hash_table_size (pending) >= MAX_PENDING_RESPONSES)
+    g_hash_table_remove_all (pending);
+
+  g_hash_table_replace (pending, key, response);
+
+  g_mutex_unlock (&entries_lock);
+}
+
+/*
+ * clapper_media_cache_lookup:
+ * @uri: a media item URI
+ *
+ * Returns: (transfer full) (nullable): URI of a complete cached copy of media at @uri.
+ */
+gchar *
+clapper_media_cache_lookup (const gchar *uri)
+{
+  ClapperMediaCacheEntry *entry;
+  gchar *key, *cached_uri = NULL;
+
+  key = _make_key (uri);
+
+  g_mutex_lock (&entries_lock);
+
+  _ensure_synced ();
+
+  if ((entry = g_hash_table_lookup (entries, key))) {
+    gchar *location = g_build_filename (media_dir, entry->filename, NULL);
+    gint64 now = g_get_real_time () / G_USEC_PER_SEC;
+    GStatBuf buf;
+
+    if (g_stat (location, &buf) != 0 || (guint64) buf.st_size != entry->size) {
+      GST_DEBUG ("Cached media file of %s is gone or was modified", uri);
+      _remove_entry (key);
+    } else if (now - entry->validated > MAX_VALIDATED_AGE) {
+      /* Kept, response of next request for media will tell if it still can be used */
+      GST_DEBUG ("Cached media of %s was not validated recently", uri);
+    } else {
+      cached_uri = g_filename_to_uri (location, NULL, NULL);
+      entry->last_used = now;
+      touched = TRUE;
+    }
+
+    g_free (location);
+  }
+
+  g_mutex_unlock (&entries_lock);
+
+  GST_LOG ("Cached media of %s: %s", uri, GST_STR_NULL (cached_uri));
+
+  g_free (key);
+
+  return cached_uri;
+}
+
+/*
+ * clapper_media_cache_make_template:
+ * @uri: a media item URI
+ *
+ * Returns: (transfer full) (nullable): a template for a `downloadbuffer`
+ *   to download media at @uri into.
+ */
+gchar *
+clapper_media_cache_make_template (const gchar *uri)
+{
+  gchar *key, *basename, *download_template;
+
+  if (g_mkdir_with_parents (media_dir, 0755) != 0) {
+    GST_ERROR ("Could not create media cache dir: \"%s\"", media_dir);
+    return NULL;
+  }
+
+  key = _make_key (uri);
+  basename = g_strdup_printf ("%s-XXXXXX", key);
+  download_template = g_build_filename (media_dir, basename, NULL);
+
+  g_free (key);
+  g_free (basename);
+
+  return download_template;
+}
+
+static gint
+_compare_entries_by_last_used (gconstpointer a, gconstpointer b)
+{
+  const ClapperMediaCacheEntry *entry_a = g_hash_table_lookup (entries, *(const gchar **) a);
+  const ClapperMediaCacheEntry *entry_b = g_hash_table_lookup (entries, *(const gchar **) b);
+
+  /* Least recently used first */
+  return (entry_a->last_used > entry_b->last_used) - (entry_a->last_used < entry_b->last_used);
+}
+
+/* Must be called with lock held */
+static void
+_evict (const gchar *keep_key, guint64 max_size)
+{
+  GPtrArray *keys;
+  GHashTableIter iter;
+  gpointer key, value;
+  guint64 total_size = 0;
+  guint i;
+
+  keys = g_ptr_array_sized_new (g_hash_table_size (entries));
+
+  g_hash_table_iter_init (&iter, entries);
+  while (g_hash_table_iter_next (&iter, &key, &value)) {
+    total_size += ((ClapperMediaCacheEntry *) value)->size;
+    g_ptr_array_add (keys, key);
+  }
+
+  g_ptr_array_sort (keys, (GCompareFunc) _compare_entries_by_last_used);
+
+  for (i = 0; i < keys->len && total_size > max_size; ++i) {
+    const gchar *evict_key = g_ptr_array_index (keys, i);
+    ClapperMediaCacheEntry *entry;
+
+    /* Just stored media is kept even when alone over the limit */
+    if (strcmp (evict_key, keep_key) == 0)
+      continue;
+
+    entry = g_hash_table_lookup (entries, evict_key);
+    total_size -= entry->size;
+
+    _remove_entry (evict_key);
+  }
+
+  g_ptr_array_unref (keys);
+
+  GST_DEBUG ("Media cache size after eviction: %" G_GUINT64_FORMAT, total_size);
+}
+
+/*
+ * Must be called with lock held. Merges index under file lock, so entries
+ * written meanwhile by other processes are kept, evicts if @keep_key
+ * is given and writes the result.
+ */
+static void
+_write_index (const gchar *keep_key, guint64 max_size)
+{
+  GByteArray *bytes;
+  GHashTableIter iter;
+  gpointer key, value;
+  gchar *filename;
+  GError *error = NULL;
+  gint lock_fd;
+  guint n_entries;
+
+  if (clapper_cache_is_disabled ()) {
+    if (keep_key)
+      _evict (keep_key, max_size);
+
+    return;
+  }
+
+  lock_fd = _lock_index ();
+
+  _merge_index ();
+
+  if (keep_key)
+    _evict (keep_key, max_size);
+
+  bytes = clapper_cache_create ();
+  n_entries = g_hash_table_size (entries);
+
+  clapper_cache_store_uint (bytes, n_entries);
+
+  g_hash_table_iter_init (&iter, entries);
+  while (g_hash_table_iter_next (&iter, &key, &value)) {
+    ClapperMediaCacheEntry *entry = (ClapperMediaCacheEntry *) value;
+
+    clapper_cache_store_string (bytes, (const gchar *) key);
+    clapper_cache_store_string (bytes, entry->filename);
+    clapper_cache_store_int64 (bytes, (gint64) entry->size);
+    clapper_cache_store_int64 (bytes, entry->last_used);
+    clapper_cache_store_int64 (bytes, entry->validated);
+    clapper_cache_store_string (bytes, entry->etag);
+    clapper_cache_store_string (bytes, entry->last_modified);
+  }
+
+  filename = _build_cache_filename ();
+  GST_DEBUG ("Saving %u media cache entries to: \"%s\"", n_entries, filename);
+
+  if (clapper_cache_write (filename, bytes, &error)) {
+    g_hash_table_remove_all (added_keys);
+    g_hash_table_remove_all (removed_files);
+    dirty = FALSE;
+    touched = FALSE;
+    last_save = g_get_real_time () / G_USEC_PER_SEC;
+
+    _update_index_stamp ();
+  } else {
+    GST_ERROR ("Could not save media cache index, reason: %s", error->message);
+    g_error_free (error);
+  }
+
+  _unlock_index (lock_fd);
+
+  g_free (filename);
+  g_byte_array_free (bytes, TRUE);
+}
+
+/*
+ * clapper_media_cache_store:
+ * @uri: a media item URI
+ * @location: a path to completely downloaded media
+ * @max_size: total size limit of cached media in bytes
+ *
+ * Adds downloaded file to cache and evicts least recently used
+ * entries that no longer fit. Does nothing if @location is not
+ * a media cache download (e.g. when it was saved to download dir).
+ */
+void
+clapper_media_cache_store (const gchar *uri, const gchar *location, guint64 max_size)
+{
+  ClapperMediaCacheEntry *entry, *old_entry, *response;
+  gchar *dirname, *key;
+  GStatBuf buf;
+  gboolean is_ours;
+
+  dirname = g_path_get_dirname (location);
+  is_ours = (strcmp (dirname, media_dir) == 0);
+  g_free (dirname);
+
+  if (!is_ours)
+    return;
+
+  if (g_stat (location, &buf) != 0) {
+    GST_ERROR ("Could not stat downloaded media: \"%s\"", location);
+    return;
+  }
+
+  key = _make_key (uri);
+
+  entry = g_new0 (ClapperMediaCacheEntry, 1);
+  entry->filename = g_path_get_basename (location);
+  entry->size = buf.st_size;
+  entry->last_used = g_get_real_time () / G_USEC_PER_SEC;
+  entry->validated = entry->last_used;
+
+  GST_INFO ("Storing cached media of %s, size: %" G_GUINT64_FORMAT,
+      uri, entry->size);
+
+  g_mutex_lock (&entries_lock);
+
+  _ensure_synced ();
+
+  /* Without validators (e.g. extracted media), copy is
+   * used only until it is no longer considered recent */
+  if ((response = g_hash_table_lookup (pending, key))) {
+    entry->etag = g_strdup (response->etag);
+    entry->last_modified = g_strdup (response->last_modified);
+    g_hash_table_remove (pending, key);
+  }
+
+  /* Replace previous copy (if any) of the same media */
+  if ((old_entry = g_hash_table_lookup (entries, key))
+      && strcmp (old_entry->filename, entry->filename) != 0) {
+    _remove_entry_file (old_entry);
+    g_hash_table_add (removed_files, g_strdup (old_entry->filename));
+  }
+
+  /* Replace key too, so the one passed for eviction stays valid */
+  g_hash_table_replace (entries, key, entry);
+  g_hash_table_add (added_keys, g_strdup (key));
+  dirty = TRUE;
+
+  _write_index (key, max_size);
+
+  g_mutex_unlock (&entries_lock);
+}
+
+/*
+ * clapper_media_cache_save:
+ *
+ * Write cache index if it changed since last save. Changes of usage
+ * times alone are written at most once per %USAGE_SAVE_INTERVAL.
+ */
+void
+clapper_media_cache_save (void)
+{
+  gint64 now = g_get_real_time () / G_USEC_PER_SEC;
+
+  g_mutex_lock (&entries_lock);
+
+  if (dirty || (touched && now - last_save >= USAGE_SAVE_INTERVAL))
+    _write_index (NULL, 0);
+
+  g_mutex_unlock (&entries_lock);
+}
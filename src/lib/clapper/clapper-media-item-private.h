@@ -31,7 +31,7 @@ G_GNUC_INTERNAL
 void clapper_media_item_update_from_tag_list (ClapperMediaItem *item, const GstTagList *tags, gboolean allow_overwrite, ClapperPlayer *player);
 
 G_GNUC_INTERNAL
-void clapper_media_item_update_from_discoverer_info (ClapperMediaItem *self, GstDiscovererInfo *info);
+void clapper_media_item_update_from_discovery (ClapperMediaItem *self, const GstTagList *tags, gdouble duration);
 
 G_GNUC_INTERNAL
 gboolean clapper_media_item_update_from_parsed_playlist (ClapperMediaItem *item, GListStore *playlist, GstObject *playlist_src, ClapperPlayer *player);
@@ -48,6 +48,27 @@ const gchar * clapper_media_item_get_playback_uri (ClapperMediaItem *item);
 G_GNUC_INTERNAL
 void clapper_media_item_set_used (ClapperMediaItem *item, gboolean used);
 
+G_GNUC_INTERNAL
+void clapper_media_item_store_to_cache (ClapperMediaItem *item, GByteArray *bytes);
+
+G_GNUC_INTERNAL
+ClapperMediaItem * clapper_media_item_new_from_cache (const gchar **data, const gchar *end);
+
+G_GNUC_INTERNAL
+void clapper_media_item_store_lazy_to_cache (GByteArray *bytes, const gchar *uri, const gchar *title, gdouble duration);
+
+G_GNUC_INTERNAL
+guint clapper_media_item_reserve_id (void);
+
+G_GNUC_INTERNAL
+ClapperMediaItem * clapper_media_item_new_lazy (const gchar *uri, guint id, const gchar *title, gdouble duration);
+
+G_GNUC_INTERNAL
+ClapperMediaItem * clapper_media_item_new_lazy_from_cache (guint id, const gchar *title, GBytes *state);
+
+G_GNUC_INTERNAL
+gboolean clapper_media_item_is_lazy (ClapperMediaItem *item);
+
 G_GNUC_INTERNAL
 gboolean clapper_media_item_get_used (ClapperMediaItem *item);
 
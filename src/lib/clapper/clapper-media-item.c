@@ -32,6 +32,7 @@
 #include "clapper-reactables-manager-private.h"
 #include "clapper-features-manager-private.h"
 #include "clapper-utils-private.h"
+#include "clapper-cache-private.h"
 
 #define GST_CAT_DEFAULT clapper_media_item_debug
 GST_DEBUG_CATEGORY_STATIC (GST_CAT_DEFAULT);
@@ -60,6 +61,9 @@ struct _ClapperMediaItem
 
   /* For shuffle */
   gboolean used;
+
+  /* Created for lazy queue entry */
+  gboolean lazy;
 };
 
 typedef struct
@@ -667,40 +671,25 @@ clapper_media_item_update_from_tag_list (ClapperMediaItem *self, const GstTagLis
   }
 }
 
+/*
+ * Updates item with results of discovery, either from
+ * discoverer info or ones that were cached earlier.
+ */
 void
-clapper_media_item_update_from_discoverer_info (ClapperMediaItem *self, GstDiscovererInfo *info)
+clapper_media_item_update_from_discovery (ClapperMediaItem *self,
+    const GstTagList *tags, gdouble duration)
 {
   ClapperPlayer *player;
-  GstDiscovererStreamInfo *sinfo;
-  GstClockTime duration;
   ClapperReactableItemUpdatedFlags flags = 0;
-  gdouble val_dbl;
   gboolean changed = FALSE;
 
   if (!(player = clapper_player_get_from_ancestor (GST_OBJECT_CAST (self))))
     return;
 
-  for (sinfo = gst_discoverer_info_get_stream_info (info);
-      sinfo != NULL;
-      sinfo = gst_discoverer_stream_info_get_next (sinfo)) {
-    const GstTagList *tags;
-
-    if (GST_IS_DISCOVERER_CONTAINER_INFO (sinfo)) {
-      GstDiscovererContainerInfo *cinfo = (GstDiscovererContainerInfo *) sinfo;
-
-      if ((tags = gst_discoverer_container_info_get_tags (cinfo)))
-        changed |= clapper_media_item_insert_tags_internal (self, tags, player->app_bus, TRUE, &flags);
-    }
-    gst_discoverer_stream_info_unref (sinfo);
-  }
-
-  duration = gst_discoverer_info_get_duration (info);
-
-  if (G_UNLIKELY (duration == GST_CLOCK_TIME_NONE))
-    duration = 0;
+  if (tags)
+    changed |= clapper_media_item_insert_tags_internal (self, tags, player->app_bus, TRUE, &flags);
 
-  val_dbl = (gdouble) duration / GST_SECOND;
-  if (clapper_media_item_set_duration (self, val_dbl, player->app_bus)) {
+  if (clapper_media_item_set_duration (self, duration, player->app_bus)) {
     changed = TRUE;
     flags |= CLAPPER_REACTABLE_ITEM_UPDATED_DURATION;
   }
@@ -896,6 +885,220 @@ clapper_media_item_get_used (ClapperMediaItem *self)
   return used;
 }
 
+void
+clapper_media_item_store_to_cache (ClapperMediaItem *self, GByteArray *bytes)
+{
+  gchar *tags_str = NULL;
+
+  GST_OBJECT_LOCK (self);
+
+  clapper_cache_store_string (bytes, self->uri);
+  clapper_cache_store_string (bytes, self->suburi);
+  clapper_cache_store_string (bytes, self->cache_uri);
+
+  if (!gst_tag_list_is_empty (self->tags))
+    tags_str = gst_tag_list_to_string (self->tags);
+  clapper_cache_store_string (bytes, tags_str); // NULL when no tags
+
+  clapper_cache_store_double (bytes, self->duration);
+
+  GST_OBJECT_UNLOCK (self);
+
+  g_free (tags_str);
+
+  clapper_timeline_store_to_cache (self->timeline, bytes);
+}
+
+/*
+ * Creates media item that takes already reserved ID. Item is not
+ * shared with anything yet, so its ID can be replaced here.
+ */
+static ClapperMediaItem *
+_new_with_reserved_id (const gchar *uri, guint id)
+{
+  ClapperMediaItem *self;
+
+  self = g_object_new (CLAPPER_TYPE_MEDIA_ITEM, "uri", uri, NULL);
+  gst_object_ref_sink (self);
+
+  self->id = id;
+  self->lazy = TRUE;
+
+  return self;
+}
+
+static ClapperMediaItem *
+_new_from_cache_internal (const gchar **data, const gchar *end,
+    gboolean has_id, guint id)
+{
+  ClapperMediaItem *self;
+  const gchar *uri, *suburi, *cache_uri, *tags_str;
+  gdouble duration;
+
+  if (!clapper_cache_can_read_string (*data, end))
+    return NULL;
+
+  uri = clapper_cache_read_string (data);
+
+  if (!uri || *uri == '\0')
+    return NULL;
+
+  if (!clapper_cache_can_read_string (*data, end))
+    return NULL;
+  suburi = clapper_cache_read_string (data);
+
+  if (!clapper_cache_can_read_string (*data, end))
+    return NULL;
+  cache_uri = clapper_cache_read_string (data);
+
+  if (!clapper_cache_can_read_string (*data, end))
+    return NULL;
+  tags_str = clapper_cache_read_string (data);
+
+  if (!clapper_cache_can_read (*data, end, sizeof (gdouble)))
+    return NULL;
+  duration = clapper_cache_read_double (data);
+
+  if (has_id) {
+    self = _new_with_reserved_id (uri, id);
+  } else {
+    self = g_object_new (CLAPPER_TYPE_MEDIA_ITEM, "uri", uri, NULL);
+    gst_object_ref_sink (self);
+  }
+
+  self->suburi = g_strdup (suburi);
+  self->cache_uri = g_strdup (cache_uri);
+
+  if (tags_str) {
+    GstTagList *tags;
+
+    if (G_LIKELY ((tags = gst_tag_list_new_from_string (tags_str)) != NULL)) {
+      gst_tag_list_set_scope (tags, GST_TAG_SCOPE_GLOBAL);
+      gst_tag_list_unref (self->tags);
+      self->tags = tags;
+
+      if (_refresh_tag_prop_unlocked (self, GST_TAG_TITLE, TRUE, &self->title))
+        self->title_is_parsed = FALSE;
+      _refresh_tag_prop_unlocked (self, GST_TAG_CONTAINER_FORMAT, TRUE, &self->container_format);
+    } else {
+      GST_WARNING_OBJECT (self, "Could not restore tags from cache");
+    }
+  }
+
+  self->duration = duration;
+
+  if (!clapper_timeline_fill_from_cache (self->timeline, data, end)) {
+    gst_object_unref (self);
+    return NULL;
+  }
+
+  GST_TRACE_OBJECT (self, "Restored from cache, title: \"%s\", duration: %lf",
+      GST_STR_NULL (self->title), self->duration);
+
+  return self;
+}
+
+/*
+ * Creates new media item from data stored with clapper_media_item_store_to_cache().
+ * Item is not in queue yet, so its fields are filled without any notifications.
+ *
+ * Data is never read past @end. Returns %NULL if it is truncated or malformed.
+ */
+ClapperMediaItem *
+clapper_media_item_new_from_cache (const gchar **data, const gchar *end)
+{
+  return _new_from_cache_internal (data, end, FALSE, 0);
+}
+
+/*
+ * Recreates media item of a lazy queue entry from its state
+ * stored with clapper_media_item_store_to_cache() on eviction.
+ * Entry title is used when state did not have one in tags.
+ */
+ClapperMediaItem *
+clapper_media_item_new_lazy_from_cache (guint id, const gchar *title, GBytes *state)
+{
+  ClapperMediaItem *self;
+  gsize size;
+  const gchar *data = g_bytes_get_data (state, &size);
+
+  if (!(self = _new_from_cache_internal (&data, data + size, TRUE, id)))
+    return NULL;
+
+  if (title && self->title_is_parsed)
+    g_set_str (&self->title, title);
+
+  return self;
+}
+
+/*
+ * Stores data in the same format as clapper_media_item_store_to_cache(),
+ * but for a lazy queue entry that does not have media item created.
+ */
+void
+clapper_media_item_store_lazy_to_cache (GByteArray *bytes, const gchar *uri,
+    const gchar *title, gdouble duration)
+{
+  gchar *tags_str = NULL;
+
+  clapper_cache_store_string (bytes, uri);
+  clapper_cache_store_string (bytes, NULL); // suburi
+  clapper_cache_store_string (bytes, NULL); // cache URI
+
+  if (title) {
+    GstTagList *tags = gst_tag_list_new (GST_TAG_TITLE, title, NULL);
+
+    tags_str = gst_tag_list_to_string (tags);
+    gst_tag_list_unref (tags);
+  }
+  clapper_cache_store_string (bytes, tags_str);
+  g_free (tags_str);
+
+  clapper_cache_store_double (bytes, duration);
+  clapper_cache_store_uint (bytes, 0); // no timeline markers
+}
+
+/*
+ * Reserves an ID for lazy queue entry, so media item
+ * materialized from it always keeps the same ID.
+ */
+guint
+clapper_media_item_reserve_id (void)
+{
+  return (guint) g_atomic_int_add (&_item_id, 1);
+}
+
+/*
+ * Creates media item for a lazy queue entry. When title is given
+ * it behaves like a parsed one, so media tags can replace it.
+ */
+ClapperMediaItem *
+clapper_media_item_new_lazy (const gchar *uri, guint id,
+    const gchar *title, gdouble duration)
+{
+  ClapperMediaItem *self;
+
+  self = _new_with_reserved_id (uri, id);
+  self->duration = duration;
+
+  if (title)
+    g_set_str (&self->title, title);
+
+  GST_TRACE_OBJECT (self, "Materialized lazy item, ID: %u", self->id);
+
+  return self;
+}
+
+/*
+ * Whether item was created for a lazy queue entry. Such items
+ * can be dropped by queue and created again when needed.
+ */
+gboolean
+clapper_media_item_is_lazy (ClapperMediaItem *self)
+{
+  return self->lazy;
+}
+
 static void
 clapper_media_item_init (ClapperMediaItem *self)
 {
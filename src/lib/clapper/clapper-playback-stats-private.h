@@ -0,0 +1,67 @@
+/* Clapper Playback Library
+ * Copyright (C) 2025 Rafał Dzięgiel <rafostar.github@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <glib.h>
+#include <gst/gst.h>
+
+#include "clapper-playback-stats.h"
+
+G_BEGIN_DECLS
+
+/* Accumulated by player from bus messages, must be accessed with its lock */
+typedef struct
+{
+  guint64 decoder_dropped_frames;
+
+  gdouble jitter_sum; // seconds
+  guint n_jitter;
+  gdouble max_jitter;
+
+  guint audio_underruns;
+
+  gint buffer_fill;
+  guint rebuffer_count;
+  gint64 rebuffer_time; // total usec of finished stalls
+  gint64 rebuffer_start; // monotonic time of current stall, zero when none
+
+  guint http_sources;
+  guint http_shared_sources;
+
+  /* Read from app bus when snapshot is taken */
+  guint64 notifies_posted;
+  guint64 notifies_coalesced;
+} ClapperPlaybackStatsCounters;
+
+G_GNUC_INTERNAL
+void clapper_playback_stats_counters_reset (ClapperPlaybackStatsCounters *counters);
+
+G_GNUC_INTERNAL
+void clapper_playback_stats_counters_add_qos (ClapperPlaybackStatsCounters *counters, GstMessage *msg);
+
+G_GNUC_INTERNAL
+void clapper_playback_stats_counters_set_buffering (ClapperPlaybackStatsCounters *counters, gint percent, gboolean playing);
+
+G_GNUC_INTERNAL
+void clapper_playback_stats_counters_add_http_source (ClapperPlaybackStatsCounters *counters, gboolean shared);
+
+G_GNUC_INTERNAL
+ClapperPlaybackStats * clapper_playback_stats_new (const ClapperPlaybackStatsCounters *counters, GstElement *video_sink);
+
+G_END_DECLS
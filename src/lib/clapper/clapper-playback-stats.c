@@ -0,0 +1,443 @@
+/* Clapper Playback Library
+ * Copyright (C) 2025 Rafał Dzięgiel <rafostar.github@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * ClapperPlaybackStats:
+ *
+ * A snapshot of playback health statistics.
+ *
+ * Statistics are collected by [class@Clapper.Player] in the background from
+ * messages that the pipeline posts anyway (QoS and buffering), while frame
+ * counters are read from video sink when snapshot is taken, so obtaining
+ * them with [method@Clapper.Player.get_playback_stats] is cheap and does
+ * not send any queries through the pipeline.
+ *
+ * Counters cover the current playback session and are reset each time
+ * playback is stopped, including when a new item is started in a
+ * non-gapless way.
+ *
+ * Since: 0.12
+ */
+
+#include <string.h>
+
+#include "clapper-playback-stats-private.h"
+
+#define GST_CAT_DEFAULT clapper_playback_stats_debug
+GST_DEBUG_CATEGORY_STATIC (GST_CAT_DEFAULT);
+
+struct _ClapperPlaybackStats
+{
+  GstObject parent;
+
+  guint64 rendered_frames;
+  guint64 dropped_frames;
+  gdouble jitter;
+  gdouble max_jitter;
+  guint audio_underruns;
+  gint buffer_fill;
+  guint rebuffer_count;
+  gdouble rebuffer_duration;
+  guint http_sources;
+  guint http_shared_sources;
+  guint64 notifies_posted;
+  guint64 notifies_coalesced;
+};
+
+#define parent_class clapper_playback_stats_parent_class
+G_DEFINE_TYPE (ClapperPlaybackStats, clapper_playback_stats, GST_TYPE_OBJECT);
+
+void
+clapper_playback_stats_counters_reset (ClapperPlaybackStatsCounters *counters)
+{
+  memset (counters, 0, sizeof (ClapperPlaybackStatsCounters));
+  counters->buffer_fill = 100;
+}
+
+void
+clapper_playback_stats_counters_add_qos (ClapperPlaybackStatsCounters *counters, GstMessage *msg)
+{
+  GstObject *src = GST_MESSAGE_SRC (msg);
+  const gchar *klass;
+  gint64 jitter = 0;
+
+  if (!src || !GST_IS_ELEMENT (src))
+    return;
+
+  klass = gst_element_get_metadata (GST_ELEMENT_CAST (src), GST_ELEMENT_METADATA_KLASS);
+  if (G_UNLIKELY (klass == NULL))
+    return;
+
+  /* GStreamer has no generic underrun message, audio elements
+   * only post QoS when they had to drop late samples */
+  if (strstr (klass, "Audio")) {
+    counters->audio_underruns++;
+    return;
+  }
+
+  if (!strstr (klass, "Video"))
+    return;
+
+  /* Positive jitter means data arrived too late */
+  gst_message_parse_qos_values (msg, &jitter, NULL, NULL);
+
+  if (jitter > 0) {
+    gdouble jitter_secs = (gdouble) jitter / GST_SECOND;
+
+    counters->jitter_sum += jitter_secs;
+    counters->n_jitter++;
+    counters->max_jitter = MAX (counters->max_jitter, jitter_secs);
+  }
+
+  /* Sink drops are read from its stats, elements upstream
+   * (like decoders) post QoS once per each dropped frame */
+  if (!GST_OBJECT_FLAG_IS_SET (src, GST_ELEMENT_FLAG_SINK))
+    counters->decoder_dropped_frames++;
+}
+
+void
+clapper_playback_stats_counters_set_buffering (ClapperPlaybackStatsCounters *counters,
+    gint percent, gboolean playing)
+{
+  counters->buffer_fill = percent;
+
+  /* Only running out of data while playing is a stall */
+  if (percent < 100 && playing && counters->rebuffer_start == 0) {
+    counters->rebuffer_start = g_get_monotonic_time ();
+    counters->rebuffer_count++;
+  } else if (percent >= 100 && counters->rebuffer_start != 0) {
+    counters->rebuffer_time += g_get_monotonic_time () - counters->rebuffer_start;
+    counters->rebuffer_start = 0;
+  }
+}
+
+void
+clapper_playback_stats_counters_add_http_source (ClapperPlaybackStatsCounters *counters,
+    gboolean shared)
+{
+  counters->http_sources++;
+
+  if (shared)
+    counters->http_shared_sources++;
+}
+
+static inline void
+_read_sink_stats (GstElement *sink, guint64 *rendered, guint64 *dropped)
+{
+  GstStructure *stats = NULL;
+
+  /* Sink only takes its own lock to make these */
+  g_object_get (sink, "stats", &stats, NULL);
+
+  if (stats) {
+    gst_structure_get_uint64 (stats, "rendered", rendered);
+    gst_structure_get_uint64 (stats, "dropped", dropped);
+    gst_structure_free (stats);
+  }
+}
+
+ClapperPlaybackStats *
+clapper_playback_stats_new (const ClapperPlaybackStatsCounters *counters,
+    GstElement *video_sink)
+{
+  ClapperPlaybackStats *stats;
+  guint64 rendered = 0, dropped = 0;
+  gint64 rebuffer_time;
+
+  stats = g_object_new (CLAPPER_TYPE_PLAYBACK_STATS, NULL);
+  gst_object_ref_sink (stats);
+
+  if (video_sink)
+    _read_sink_stats (video_sink, &rendered, &dropped);
+
+  stats->rendered_frames = rendered;
+  stats->dropped_frames = dropped + counters->decoder_dropped_frames;
+
+  if (counters->n_jitter > 0)
+    stats->jitter = counters->jitter_sum / counters->n_jitter;
+  stats->max_jitter = counters->max_jitter;
+
+  stats->audio_underruns = counters->audio_underruns;
+
+  stats->buffer_fill = counters->buffer_fill;
+  stats->rebuffer_count = counters->rebuffer_count;
+
+  rebuffer_time = counters->rebuffer_time;
+  if (counters->rebuffer_start != 0)
+    rebuffer_time += g_get_monotonic_time () - counters->rebuffer_start;
+
+  stats->rebuffer_duration = (gdouble) rebuffer_time / G_USEC_PER_SEC;
+
+  stats->http_sources = counters->http_sources;
+  stats->http_shared_sources = counters->http_shared_sources;
+
+  stats->notifies_posted = counters->notifies_posted;
+  stats->notifies_coalesced = counters->notifies_coalesced;
+
+  return stats;
+}
+
+/**
+ * clapper_playback_stats_get_rendered_frames:
+ * @stats: a #ClapperPlaybackStats
+ *
+ * Get number of video frames rendered by video sink.
+ *
+ * Returns: number of rendered frames.
+ *
+ * Since: 0.12
+ */
+guint64
+clapper_playback_stats_get_rendered_frames (ClapperPlaybackStats *self)
+{
+  g_return_val_if_fail (CLAPPER_IS_PLAYBACK_STATS (self), 0);
+
+  return self->rendered_frames;
+}
+
+/**
+ * clapper_playback_stats_get_dropped_frames:
+ * @stats: a #ClapperPlaybackStats
+ *
+ * Get number of video frames dropped either by decoders
+ * or by video sink, because they were too late to be shown.
+ *
+ * Returns: number of dropped frames.
+ *
+ * Since: 0.12
+ */
+guint64
+clapper_playback_stats_get_dropped_frames (ClapperPlaybackStats *self)
+{
+  g_return_val_if_fail (CLAPPER_IS_PLAYBACK_STATS (self), 0);
+
+  return self->dropped_frames;
+}
+
+/**
+ * clapper_playback_stats_get_jitter:
+ * @stats: a #ClapperPlaybackStats
+ *
+ * Get average lateness (in seconds) of video frames
+ * that were reported as late by decoders or video sink.
+ *
+ * Returns: average jitter of late frames or 0 if none were late.
+ *
+ * Since: 0.12
+ */
+gdouble
+clapper_playback_stats_get_jitter (ClapperPlaybackStats *self)
+{
+  g_return_val_if_fail (CLAPPER_IS_PLAYBACK_STATS (self), 0);
+
+  return self->jitter;
+}
+
+/**
+ * clapper_playback_stats_get_max_jitter:
+ * @stats: a #ClapperPlaybackStats
+ *
+ * Get highest lateness (in seconds) of a single video frame.
+ *
+ * Returns: maximal jitter or 0 if no frame was late.
+ *
+ * Since: 0.12
+ */
+gdouble
+clapper_playback_stats_get_max_jitter (ClapperPlaybackStats *self)
+{
+  g_return_val_if_fail (CLAPPER_IS_PLAYBACK_STATS (self), 0);
+
+  return self->max_jitter;
+}
+
+/**
+ * clapper_playback_stats_get_audio_underruns:
+ * @stats: a #ClapperPlaybackStats
+ *
+ * Get number of times audio output could not keep up
+ * and late samples had to be dropped.
+ *
+ * Returns: number of audio underruns.
+ *
+ * Since: 0.12
+ */
+guint
+clapper_playback_stats_get_audio_underruns (ClapperPlaybackStats *self)
+{
+  g_return_val_if_fail (CLAPPER_IS_PLAYBACK_STATS (self), 0);
+
+  return self->audio_underruns;
+}
+
+/**
+ * clapper_playback_stats_get_buffer_fill:
+ * @stats: a #ClapperPlaybackStats
+ *
+ * Get the last reported fill level of buffering queues
+ * (for network streams), where 100 means fully buffered.
+ *
+ * Returns: buffer fill level in percents.
+ *
+ * Since: 0.12
+ */
+gint
+clapper_playback_stats_get_buffer_fill (ClapperPlaybackStats *self)
+{
+  g_return_val_if_fail (CLAPPER_IS_PLAYBACK_STATS (self), 0);
+
+  return self->buffer_fill;
+}
+
+/**
+ * clapper_playback_stats_get_rebuffer_count:
+ * @stats: a #ClapperPlaybackStats
+ *
+ * Get number of times playback stalled to buffer more data.
+ *
+ * Buffering done initially and after seeking is not
+ * counted, as it is not an interruption of playback.
+ *
+ * Returns: number of rebuffers.
+ *
+ * Since: 0.12
+ */
+guint
+clapper_playback_stats_get_rebuffer_count (ClapperPlaybackStats *self)
+{
+  g_return_val_if_fail (CLAPPER_IS_PLAYBACK_STATS (self), 0);
+
+  return self->rebuffer_count;
+}
+
+/**
+ * clapper_playback_stats_get_rebuffer_duration:
+ * @stats: a #ClapperPlaybackStats
+ *
+ * Get total time (in seconds) playback spent stalled
+ * due to rebuffering, including stall that is still ongoing.
+ *
+ * Returns: total rebuffering duration.
+ *
+ * Since: 0.12
+ */
+gdouble
+clapper_playback_stats_get_rebuffer_duration (ClapperPlaybackStats *self)
+{
+  g_return_val_if_fail (CLAPPER_IS_PLAYBACK_STATS (self), 0);
+
+  return self->rebuffer_duration;
+}
+
+/**
+ * clapper_playback_stats_get_http_sources:
+ * @stats: a #ClapperPlaybackStats
+ *
+ * Get number of HTTP source elements that were created.
+ *
+ * Returns: number of HTTP sources.
+ *
+ * Since: 0.12
+ */
+guint
+clapper_playback_stats_get_http_sources (ClapperPlaybackStats *self)
+{
+  g_return_val_if_fail (CLAPPER_IS_PLAYBACK_STATS (self), 0);
+
+  return self->http_sources;
+}
+
+/**
+ * clapper_playback_stats_get_http_shared_sources:
+ * @stats: a #ClapperPlaybackStats
+ *
+ * Get number of HTTP source elements that were given an already
+ * established HTTP session, so they could reuse its open connections
+ * instead of doing DNS lookups and TLS handshakes again.
+ *
+ * Sources that need their own session (e.g. with custom cookies
+ * or proxy) ignore shared one, but are still counted here.
+ *
+ * Returns: number of HTTP sources given a shared session.
+ *
+ * Since: 0.12
+ */
+guint
+clapper_playback_stats_get_http_shared_sources (ClapperPlaybackStats *self)
+{
+  g_return_val_if_fail (CLAPPER_IS_PLAYBACK_STATS (self), 0);
+
+  return self->http_shared_sources;
+}
+
+/**
+ * clapper_playback_stats_get_notifies_posted:
+ * @stats: a #ClapperPlaybackStats
+ *
+ * Get number of property change notifications that player
+ * posted to the application thread.
+ *
+ * Unlike other statistics, this one is counted since
+ * player creation and is never reset.
+ *
+ * Returns: number of posted property notifications.
+ *
+ * Since: 0.12
+ */
+guint64
+clapper_playback_stats_get_notifies_posted (ClapperPlaybackStats *self)
+{
+  g_return_val_if_fail (CLAPPER_IS_PLAYBACK_STATS (self), 0);
+
+  return self->notifies_posted;
+}
+
+/**
+ * clapper_playback_stats_get_notifies_coalesced:
+ * @stats: a #ClapperPlaybackStats
+ *
+ * Get number of property change notifications that were not
+ * posted to the application thread, because the same notification
+ * was still waiting there to be emitted.
+ *
+ * Unlike other statistics, this one is counted since
+ * player creation and is never reset.
+ *
+ * Returns: number of coalesced property notifications.
+ *
+ * Since: 0.12
+ */
+guint64
+clapper_playback_stats_get_notifies_coalesced (ClapperPlaybackStats *self)
+{
+  g_return_val_if_fail (CLAPPER_IS_PLAYBACK_STATS (self), 0);
+
+  return self->notifies_coalesced;
+}
+
+static void
+clapper_playback_stats_init (ClapperPlaybackStats *self)
+{
+}
+
+static void
+clapper_playback_stats_class_init (ClapperPlaybackStatsClass *klass)
+{
+  GST_DEBUG_CATEGORY_INIT (GST_CAT_DEFAULT, "clapperplaybackstats", 0,
+      "Clapper Playback Stats");
+}
@@ -0,0 +1,75 @@
+/* Clapper Playback Library
+ * Copyright (C) 2025 Rafał Dzięgiel <rafostar.github@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#if !defined(__CLAPPER_INSIDE__) && !defined(CLAPPER_COMPILATION)
+#error "Only <clapper/clapper.h> can be included directly."
+#endif
+
+#include <glib.h>
+#include <glib-object.h>
+#include <gst/gst.h>
+
+#include <clapper/clapper-visibility.h>
+
+G_BEGIN_DECLS
+
+#define CLAPPER_TYPE_PLAYBACK_STATS (clapper_playback_stats_get_type())
+#define CLAPPER_PLAYBACK_STATS_CAST(obj) ((ClapperPlaybackStats *)(obj))
+
+CLAPPER_API
+G_DECLARE_FINAL_TYPE (ClapperPlaybackStats, clapper_playback_stats, CLAPPER, PLAYBACK_STATS, GstObject)
+
+CLAPPER_API
+guint64 clapper_playback_stats_get_rendered_frames (ClapperPlaybackStats *stats);
+
+CLAPPER_API
+guint64 clapper_playback_stats_get_dropped_frames (ClapperPlaybackStats *stats);
+
+CLAPPER_API
+gdouble clapper_playback_stats_get_jitter (ClapperPlaybackStats *stats);
+
+CLAPPER_API
+gdouble clapper_playback_stats_get_max_jitter (ClapperPlaybackStats *stats);
+
+CLAPPER_API
+guint clapper_playback_stats_get_audio_underruns (ClapperPlaybackStats *stats);
+
+CLAPPER_API
+gint clapper_playback_stats_get_buffer_fill (ClapperPlaybackStats *stats);
+
+CLAPPER_API
+guint clapper_playback_stats_get_rebuffer_count (ClapperPlaybackStats *stats);
+
+CLAPPER_API
+gdouble clapper_playback_stats_get_rebuffer_duration (ClapperPlaybackStats *stats);
+
+CLAPPER_API
+guint clapper_playback_stats_get_http_sources (ClapperPlaybackStats *stats);
+
+CLAPPER_API
+guint clapper_playback_stats_get_http_shared_sources (ClapperPlaybackStats *stats);
+
+CLAPPER_API
+guint64 clapper_playback_stats_get_notifies_posted (ClapperPlaybackStats *stats);
+
+CLAPPER_API
+guint64 clapper_playback_stats_get_notifies_coalesced (ClapperPlaybackStats *stats);
+
+G_END_DECLS
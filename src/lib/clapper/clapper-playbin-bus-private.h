@@ -41,13 +41,15 @@ void clapper_playbin_bus_post_request_state (GstBus *bus, ClapperPlayer *player,
 
 void clapper_playbin_bus_post_seek (GstBus *bus, gdouble position, ClapperPlayerSeekMethod flags);
 
+void clapper_playbin_bus_post_scrub (GstBus *bus, gboolean scrubbing, gdouble position, ClapperPlayerSeekMethod seek_method);
+
 void clapper_playbin_bus_post_rate_change (GstBus *bus, gdouble rate);
 
 void clapper_playbin_bus_post_advance_frame (GstBus *bus);
 
 void clapper_playbin_bus_post_stream_change (GstBus *bus);
 
-void clapper_playbin_bus_post_current_item_change (GstBus *bus, ClapperMediaItem *current_item, ClapperQueueItemChangeMode mode);
+void clapper_playbin_bus_post_current_item_change (GstBus *bus, ClapperMediaItem *current_item, ClapperQueueItemChangeMode mode, gdouble start_position);
 
 void clapper_playbin_bus_post_item_suburi_change (GstBus *bus, ClapperMediaItem *item);
 
@@ -25,6 +25,8 @@
 #include "clapper-player-private.h"
 #include "clapper-queue-private.h"
 #include "clapper-media-item-private.h"
+#include "clapper-media-cache-private.h"
+#include "clapper-http-context-private.h"
 #include "clapper-timeline-private.h"
 #include "clapper-stream-private.h"
 #include "clapper-stream-list-private.h"
@@ -40,6 +42,7 @@ enum
   CLAPPER_PLAYBIN_BUS_STRUCTURE_SET_PROP,
   CLAPPER_PLAYBIN_BUS_STRUCTURE_SET_PLAY_FLAG,
   CLAPPER_PLAYBIN_BUS_STRUCTURE_SEEK,
+  CLAPPER_PLAYBIN_BUS_STRUCTURE_SCRUB,
   CLAPPER_PLAYBIN_BUS_STRUCTURE_RATE_CHANGE,
   CLAPPER_PLAYBIN_BUS_STRUCTURE_ADVANCE_FRAME,
   CLAPPER_PLAYBIN_BUS_STRUCTURE_STREAM_CHANGE,
@@ -53,6 +56,7 @@ static ClapperBusQuark _structure_quarks[] = {
   {"set-prop", 0},
   {"set-play-flag", 0},
   {"seek", 0},
+  {"scrub", 0},
   {"rate-change", 0},
   {"advance-frame", 0},
   {"stream-change", 0},
@@ -177,6 +181,8 @@ _update_current_duration (ClapperPlayer *player)
     if (clapper_media_item_set_duration (player->played_item, duration_dbl, player->app_bus)) {
       ClapperFeaturesManager *features_manager;
 
+      clapper_player_update_snapshot_item (player, player->played_item);
+
       if (player->reactables_manager) {
         clapper_reactables_manager_trigger_item_updated (player->reactables_manager, player->played_item,
             CLAPPER_REACTABLE_ITEM_UPDATED_DURATION);
@@ -243,11 +249,22 @@ static inline void
 _handle_buffering_msg (GstMessage *msg, ClapperPlayer *player)
 {
   gint percent;
-  gboolean is_buffering;
+  guint n_rebuffers;
+  gboolean is_buffering, rebuffered;
 
   gst_message_parse_buffering (msg, &percent);
   GST_LOG_OBJECT (player, "Buffering: %i%%", percent);
 
+  GST_OBJECT_LOCK (player);
+  n_rebuffers = player->stats_counters.rebuffer_count;
+  clapper_playback_stats_counters_set_buffering (&player->stats_counters, percent,
+      (player->current_state == GST_STATE_PLAYING && !player->seeking));
+  rebuffered = (player->stats_counters.rebuffer_count > n_rebuffers);
+  GST_OBJECT_UNLOCK (player);
+
+  if (rebuffered)
+    clapper_player_handle_rebuffer (player);
+
   is_buffering = (percent < 100);
 
   /* If no change return */
@@ -412,30 +429,13 @@ clapper_playbin_bus_post_seek (GstBus *bus, gdouble position, ClapperPlayerSeekM
   gst_bus_post (bus, gst_message_new_application (NULL, structure));
 }
 
-static inline void
-_handle_seek_msg (GstMessage *msg, const GstStructure *structure, ClapperPlayer *player)
+static void
+_perform_seek (ClapperPlayer *player, gint64 position, ClapperPlayerSeekMethod seek_method)
 {
   GstEvent *seek_event;
-  gint64 position = 0;
   gdouble rate;
-  ClapperPlayerSeekMethod seek_method = CLAPPER_PLAYER_SEEK_METHOD_NORMAL;
   GstSeekFlags flags = GST_SEEK_FLAG_FLUSH;
 
-  /* We should ignore seek if pipeline is going to be stopped */
-  if (player->target_state < GST_STATE_PAUSED)
-    return;
-
-  gst_structure_id_get (structure,
-      _FIELD_QUARK (POSITION), G_TYPE_INT64, &position,
-      _FIELD_QUARK (SEEK_METHOD), G_TYPE_INT, &seek_method,
-      NULL);
-
-  /* If we are starting playback, do a seek after preroll */
-  if (player->current_state < GST_STATE_PAUSED) {
-    player->pending_position = (gdouble) position / GST_SECOND;
-    return;
-  }
-
   switch (seek_method) {
     case CLAPPER_PLAYER_SEEK_METHOD_FAST:
       flags |= (GST_SEEK_FLAG_KEY_UNIT | GST_SEEK_FLAG_SNAP_NEAREST);
@@ -468,13 +468,125 @@ _handle_seek_msg (GstMessage *msg, const GstStructure *structure, ClapperPlayer
 
   clapper_player_remove_tick_source (player);
 
-  if (!(player->seeking = gst_element_send_event (player->playbin, seek_event))) {
+  if ((player->seeking = gst_element_send_event (player->playbin, seek_event))) {
+    player->seek_start_time = g_get_monotonic_time ();
+  } else {
     /* FIXME: Should we maybe call _handle_error_msg with
      * some error here? Or will playbin post such message for us? */
     GST_ERROR ("Could not seek");
   }
 }
 
+static inline void
+_handle_seek_msg (GstMessage *msg, const GstStructure *structure, ClapperPlayer *player)
+{
+  gint64 position = 0;
+  ClapperPlayerSeekMethod seek_method = CLAPPER_PLAYER_SEEK_METHOD_NORMAL;
+
+  /* We should ignore seek if pipeline is going to be stopped */
+  if (player->target_state < GST_STATE_PAUSED)
+    return;
+
+  gst_structure_id_get (structure,
+      _FIELD_QUARK (POSITION), G_TYPE_INT64, &position,
+      _FIELD_QUARK (SEEK_METHOD), G_TYPE_INT, &seek_method,
+      NULL);
+
+  /* If we are starting playback, do a seek after preroll */
+  if (player->current_state < GST_STATE_PAUSED) {
+    player->pending_position = (gdouble) position / GST_SECOND;
+    return;
+  }
+
+  /* Follow user input with key unit seeks while scrubbing,
+   * remembering target for the final seek afterwards */
+  if (player->scrub_active) {
+    player->scrub_position = position;
+    player->scrub_method = seek_method;
+    seek_method = CLAPPER_PLAYER_SEEK_METHOD_FAST;
+  }
+
+  /* Do not flush pipeline again while previous seek is still in progress,
+   * just replace queued request, so only the latest one is performed */
+  if (player->seeking && (player->scrub_active || player->pending_seek_position >= 0)) {
+    GST_LOG_OBJECT (player, "Seek in progress, queuing: %" GST_TIME_FORMAT,
+        GST_TIME_ARGS (position));
+    player->pending_seek_position = position;
+    player->pending_seek_method = seek_method;
+    return;
+  }
+
+  _perform_seek (player, position, seek_method);
+}
+
+void
+clapper_playbin_bus_post_scrub (GstBus *bus, gboolean scrubbing,
+    gdouble position, ClapperPlayerSeekMethod seek_method)
+{
+  GstStructure *structure = gst_structure_new_id (_STRUCTURE_QUARK (SCRUB),
+      _FIELD_QUARK (VALUE), G_TYPE_BOOLEAN, scrubbing,
+      _FIELD_QUARK (POSITION), G_TYPE_INT64, (position >= 0)
+          ? (gint64) (position * GST_SECOND) : G_GINT64_CONSTANT (-1),
+      _FIELD_QUARK (SEEK_METHOD), G_TYPE_INT, seek_method,
+      NULL);
+  gst_bus_post (bus, gst_message_new_application (NULL, structure));
+}
+
+static inline void
+_handle_scrub_msg (GstMessage *msg, const GstStructure *structure, ClapperPlayer *player)
+{
+  gboolean scrubbing = FALSE;
+  ClapperPlayerSeekMethod seek_method = CLAPPER_PLAYER_SEEK_METHOD_NORMAL;
+  gint64 position = -1;
+
+  gst_structure_id_get (structure,
+      _FIELD_QUARK (VALUE), G_TYPE_BOOLEAN, &scrubbing,
+      _FIELD_QUARK (POSITION), G_TYPE_INT64, &position,
+      _FIELD_QUARK (SEEK_METHOD), G_TYPE_INT, &seek_method,
+      NULL);
+
+  if (player->scrub_active == scrubbing)
+    return;
+
+  GST_DEBUG_OBJECT (player, "Scrubbing %s", (scrubbing) ? "started" : "finished");
+
+  player->scrub_active = scrubbing;
+
+  if (scrubbing) {
+    player->scrub_position = -1;
+    return;
+  }
+
+  /* Without explicit final target, finish at last position
+   * requested while scrubbing with an accurate seek */
+  if (position < 0) {
+    position = player->scrub_position;
+    seek_method = (player->scrub_method == CLAPPER_PLAYER_SEEK_METHOD_FAST)
+        ? CLAPPER_PLAYER_SEEK_METHOD_FAST
+        : CLAPPER_PLAYER_SEEK_METHOD_ACCURATE;
+  }
+  player->scrub_position = -1;
+
+  /* Nothing to finish if there were no seeks while scrubbing */
+  if (position < 0)
+    return;
+
+  /* Finishing before preroll, do a seek after it like regular seek does */
+  if (player->current_state < GST_STATE_PAUSED) {
+    if (player->target_state >= GST_STATE_PAUSED)
+      player->pending_position = (gdouble) position / GST_SECOND;
+    return;
+  }
+
+  /* Final seek replaces whatever is still queued */
+  if (player->seeking) {
+    player->pending_seek_position = position;
+    player->pending_seek_method = seek_method;
+  } else if (player->target_state >= GST_STATE_PAUSED) {
+    _perform_seek (player, position, seek_method);
+  }
+}
+
 void
 clapper_playbin_bus_post_rate_change (GstBus *bus, gdouble rate)
 {
@@ -683,11 +795,12 @@ _handle_state_changed_msg (GstMessage *msg, ClapperPlayer *player)
 
 void
 clapper_playbin_bus_post_current_item_change (GstBus *bus, ClapperMediaItem *current_item,
-    ClapperQueueItemChangeMode mode)
+    ClapperQueueItemChangeMode mode, gdouble start_position)
 {
   GstStructure *structure = gst_structure_new_id (_STRUCTURE_QUARK (CURRENT_ITEM_CHANGE),
       _FIELD_QUARK (MEDIA_ITEM), CLAPPER_TYPE_MEDIA_ITEM, current_item,
       _FIELD_QUARK (ITEM_CHANGE_MODE), G_TYPE_INT, mode,
+      _FIELD_QUARK (POSITION), G_TYPE_DOUBLE, start_position,
       NULL);
   gst_bus_post (bus, gst_message_new_application (NULL, structure));
 }
@@ -697,13 +810,17 @@ _handle_current_item_change_msg (GstMessage *msg, const GstStructure *structure,
 {
   ClapperMediaItem *current_item = NULL;
   ClapperQueueItemChangeMode mode = CLAPPER_QUEUE_ITEM_CHANGE_NORMAL;
+  gdouble start_position = 0;
 
   gst_structure_id_get (structure,
       _FIELD_QUARK (MEDIA_ITEM), CLAPPER_TYPE_MEDIA_ITEM, &current_item,
       _FIELD_QUARK (ITEM_CHANGE_MODE), G_TYPE_INT, &mode,
+      _FIELD_QUARK (POSITION), G_TYPE_DOUBLE, &start_position,
       NULL);
 
-  player->pending_position = 0; // We store pending position for played item, so reset
+  /* We store pending position for played item, so reset
+   * it or use the one requested together with item change */
+  player->pending_position = start_position;
 
   if (player->current_state < GST_STATE_READY || mode == CLAPPER_QUEUE_ITEM_CHANGE_NORMAL)
     gst_element_set_state (player->playbin, GST_STATE_READY);
@@ -940,6 +1057,8 @@ _handle_app_msg (GstMessage *msg, ClapperPlayer *player)
     _handle_set_play_flag_msg (msg, structure, player);
   else if (quark == _STRUCTURE_QUARK (SEEK))
     _handle_seek_msg (msg, structure, player);
+  else if (quark == _STRUCTURE_QUARK (SCRUB))
+    _handle_scrub_msg (msg, structure, player);
   else if (quark == _STRUCTURE_QUARK (RATE_CHANGE))
     _handle_rate_change_msg (msg, structure, player);
   else if (quark == _STRUCTURE_QUARK (ADVANCE_FRAME))
@@ -954,6 +1073,18 @@ _handle_app_msg (GstMessage *msg, ClapperPlayer *player)
     _handle_user_message_msg (msg, structure, player);
 }
 
+static inline void
+_on_startup_phase_msg (GstMessage *msg, ClapperPlayer *player, ClapperStartupPhase phase)
+{
+  gint64 timestamp = 0;
+
+  /* Time when element posted this, not when we got to handle it */
+  if (!gst_structure_get_int64 (gst_message_get_structure (msg), "timestamp", &timestamp))
+    timestamp = g_get_monotonic_time ();
+
+  clapper_player_mark_startup_phase (player, phase, timestamp);
+}
+
 static inline void
 _handle_element_msg (GstMessage *msg, ClapperPlayer *player)
 {
@@ -972,14 +1103,33 @@ _handle_element_msg (GstMessage *msg, ClapperPlayer *player)
     g_free (details);
   } else if (gst_message_has_name (msg, "ClapperPlaylistParsed")) {
     _on_playlist_parsed_msg (msg, player);
+  } else if (gst_message_has_name (msg, "ClapperExtractionStarted")) {
+    _on_startup_phase_msg (msg, player, CLAPPER_STARTUP_PHASE_EXTRACTION_START);
+  } else if (gst_message_has_name (msg, "ClapperExtractionFinished")) {
+    gboolean cached = FALSE;
+
+    gst_structure_get_boolean (gst_message_get_structure (msg), "cached", &cached);
+    clapper_player_mark_startup_harvest_cached (player, cached);
+
+    _on_startup_phase_msg (msg, player, CLAPPER_STARTUP_PHASE_EXTRACTION_END);
+  } else if (gst_message_has_name (msg, "ClapperSinkFirstFrame")) {
+    _on_startup_phase_msg (msg, player, CLAPPER_STARTUP_PHASE_FIRST_FRAME);
+
+    /* Already playing means a gapless switch which does not preroll,
+     * otherwise report is finished after pipeline prerolls */
+    if (player->current_state == GST_STATE_PLAYING)
+      clapper_player_finish_startup_report (player);
   } else if (gst_message_has_name (msg, "GstCacheDownloadComplete")) {
     ClapperMediaItem *downloaded_item = NULL;
     const GstStructure *structure;
     const gchar *location;
+    guint64 media_cache_max_size;
     guint signal_id;
 
     GST_OBJECT_LOCK (player);
 
+    media_cache_max_size = player->media_cache_max_size;
+
     /* Short video might be fully downloaded before playback starts */
     if (player->pending_item)
       downloaded_item = gst_object_ref (player->pending_item);
@@ -1001,6 +1151,10 @@ _handle_element_msg (GstMessage *msg, ClapperPlayer *player)
      * so it can also be read directly from item */
     GST_INFO_OBJECT (player, "Download of %" GST_PTR_FORMAT
         " complete: %s", downloaded_item, location);
+    if (location) {
+      clapper_media_cache_store (clapper_media_item_get_uri (downloaded_item),
+          location, media_cache_max_size);
+    }
     clapper_media_item_set_cache_location (downloaded_item, location);
 
     clapper_app_bus_post_object_desc_signal (player->app_bus,
@@ -1011,6 +1165,11 @@ _handle_element_msg (GstMessage *msg, ClapperPlayer *player)
   } else {
     guint signal_id = g_signal_lookup ("message", CLAPPER_TYPE_PLAYER);
 
+    /* Validators of media that might be downloaded into cache,
+     * message is still passed to app afterwards */
+    if (gst_message_has_name (msg, "http-headers"))
+      clapper_media_cache_handle_http_headers (gst_message_get_structure (msg));
+
     clapper_app_bus_post_message_signal (player->app_bus,
         GST_OBJECT_CAST (player), signal_id, msg);
   }
@@ -1122,6 +1281,9 @@ _handle_stream_collection_msg (GstMessage *msg, ClapperPlayer *player)
 
   GST_INFO_OBJECT (player, "Stream collection");
 
+  clapper_player_mark_startup_phase (player,
+      CLAPPER_STARTUP_PHASE_STREAM_COLLECTION, g_get_monotonic_time ());
+
   gst_message_parse_stream_collection (msg, &collection);
   n_streams = gst_stream_collection_get_size (collection);
 
@@ -1215,6 +1377,8 @@ _handle_stream_start_msg (GstMessage *msg, ClapperPlayer *player)
   GST_OBJECT_UNLOCK (player);
 
   if (G_LIKELY (changed)) {
+    clapper_player_handle_startup_stream_start (player);
+    clapper_player_update_snapshot_item (player, player->played_item);
     clapper_queue_handle_played_item_changed (player->queue, player->played_item, player->app_bus);
 
     if (player->reactables_manager)
@@ -1264,18 +1428,43 @@ _handle_duration_changed_msg (GstMessage *msg G_GNUC_UNUSED, ClapperPlayer *play
 static inline void
 _handle_async_done_msg (GstMessage *msg G_GNUC_UNUSED, ClapperPlayer *player)
 {
+  /* Seeks, frame steps and speed changes also finish with async done,
+   * otherwise it is a no-op after first preroll of current item,
+   * as report is already gone */
+  if (!player->seeking && !player->stepping && !player->speed_changing) {
+    clapper_player_mark_startup_phase (player,
+        CLAPPER_STARTUP_PHASE_PREROLL, g_get_monotonic_time ());
+    clapper_player_finish_startup_report (player);
+  }
+
   if (player->seeking) {
     guint signal_id;
 
     player->seeking = FALSE;
 
-    GST_DEBUG_OBJECT (player, "Seek done");
-    signal_id = g_signal_lookup ("seek-done", CLAPPER_TYPE_PLAYER);
+    clapper_player_handle_seek_latency (player,
+        (gdouble) (g_get_monotonic_time () - player->seek_start_time) / G_USEC_PER_SEC);
 
-    /* Update current position first, then announce seek done */
-    clapper_player_refresh_position (player);
-    clapper_app_bus_post_simple_signal (player->app_bus,
-        GST_OBJECT_CAST (player), signal_id);
+    /* Perform the latest seek request that came in the meantime */
+    if (player->pending_seek_position >= 0) {
+      gint64 position = player->pending_seek_position;
+
+      player->pending_seek_position = -1;
+      _perform_seek (player, position, player->pending_seek_method);
+    }
+
+    if (!player->seeking) {
+      GST_DEBUG_OBJECT (player, "Seek done");
+      signal_id = g_signal_lookup ("seek-done", CLAPPER_TYPE_PLAYER);
+
+      /* Update current position first, then announce seek done */
+      clapper_player_refresh_position (player);
+      clapper_app_bus_post_simple_signal (player->app_bus,
+          GST_OBJECT_CAST (player), signal_id);
+
+      /* Time left until next item warm-up changed */
+      clapper_preloader_schedule_refresh (player->preloader);
+    }
   }
   if (player->stepping) {
     player->stepping = FALSE;
@@ -1296,6 +1485,16 @@ _handle_async_done_msg (GstMessage *msg G_GNUC_UNUSED, ClapperPlayer *player)
   }
 }
 
+static inline void
+_handle_qos_msg (GstMessage *msg, ClapperPlayer *player)
+{
+  GST_LOG_OBJECT (player, "QoS from %" GST_PTR_FORMAT, GST_MESSAGE_SRC (msg));
+
+  GST_OBJECT_LOCK (player);
+  clapper_playback_stats_counters_add_qos (&player->stats_counters, msg);
+  GST_OBJECT_UNLOCK (player);
+}
+
 static inline void
 _handle_latency_msg (GstMessage *msg G_GNUC_UNUSED, ClapperPlayer *player)
 {
@@ -1358,6 +1557,19 @@ _handle_eos_msg (GstMessage *msg G_GNUC_UNUSED, ClapperPlayer *player)
   }
 }
 
+static inline void
+_handle_have_context_msg (GstMessage *msg, ClapperPlayer *player)
+{
+  GstContext *context;
+
+  gst_message_parse_have_context (msg, &context);
+
+  GST_DEBUG_OBJECT (player, "Have context: %s", gst_context_get_context_type (context));
+  clapper_http_context_offer (context);
+
+  gst_context_unref (context);
+}
+
 gboolean
 clapper_playbin_bus_message_func (GstBus *bus, GstMessage *msg, ClapperPlayer *player)
 {
@@ -1404,6 +1616,12 @@ clapper_playbin_bus_message_func (GstBus *bus, GstMessage *msg, ClapperPlayer *p
     case GST_MESSAGE_LATENCY:
       _handle_latency_msg (msg, player);
       break;
+    case GST_MESSAGE_QOS:
+      _handle_qos_msg (msg, player);
+      break;
+    case GST_MESSAGE_HAVE_CONTEXT:
+      _handle_have_context_msg (msg, player);
+      break;
     case GST_MESSAGE_CLOCK_LOST:
       _handle_clock_lost_msg (msg, player);
       break;
@@ -27,6 +27,9 @@
 #include "clapper-app-bus-private.h"
 #include "clapper-features-manager-private.h"
 #include "clapper-reactables-manager-private.h"
+#include "clapper-preloader-private.h"
+#include "clapper-startup-report-private.h"
+#include "clapper-playback-stats-private.h"
 
 G_BEGIN_DECLS
 
@@ -49,6 +52,8 @@ struct _ClapperPlayer
 
   ClapperReactablesManager *reactables_manager;
 
+  ClapperPreloader *preloader;
+
   ClapperEnhancerProxyList *enhancer_proxies;
 
   /* This is different from queue current item as it is used/changed only
@@ -59,6 +64,12 @@ struct _ClapperPlayer
    * different thread, thus needs a lock */
   ClapperMediaItem *pending_item;
 
+  /* Startup timings of pending item, phases can be marked
+   * from different threads, thus needs a lock */
+  ClapperStartupReport *startup_report;
+  ClapperStartupHistogram *startup_histogram;
+  gboolean startup_on_stream_start; // gapless item, report starts with its stream
+
   /* Pending tags/toc that arrive before stream start.
    * To be applied to "played_item", thus no lock needed. */
   gboolean stream_tags_allowed;
@@ -73,6 +84,16 @@ struct _ClapperPlayer
   GSource *tick_source;
   GstQuery *position_query;
 
+  /* Base for position interpolation between queries, set while playing */
+  GstClock *position_clock;
+  GstClockTime position_clock_time;
+
+  /* Seqlock protected copy of props for lock-free reading.
+   * Only modified with object lock held (by a single writer at a time). */
+  gint snapshot_seq; // atomic integer
+  ClapperPlayerSnapshot snapshot;
+  gint64 snapshot_position_time; // monotonic time of position, 0 when not advancing
+
   /* Must only be used from player thread */
   GstState current_state; // reported from playbin
   GstState target_state;  // state requested by user
@@ -88,14 +109,25 @@ struct _ClapperPlayer
   gboolean use_playbin3; // when using playbin3
   gboolean had_error; // so we do not do stuff after error
   gboolean seeking; // during seek operation
+  gint64 seek_start_time; // monotonic time when current seek was sent
+  gint64 pending_seek_position; // replaced while seek is in progress, -1 when none
+  ClapperPlayerSeekMethod pending_seek_method;
+  gboolean scrub_active; // scrubbing as seen by player thread
+  gint64 scrub_position; // last seek requested while scrubbing, -1 when none
+  ClapperPlayerSeekMethod scrub_method;
   gboolean stepping; // during frame step operation
   gboolean speed_changing; // during rate change operation
   gboolean pending_eos; // when pausing due to EOS
   gboolean pending_flush; // after another stream selection
   gint eos; // atomic integer
 
+  /* Playback health, updated from bus messages with lock held */
+  ClapperPlaybackStatsCounters stats_counters;
+  GstElement *stats_video_sink;
+
   /* Set adaptive props immediately */
   GstElement *adaptive_demuxer;
+  gchar *adaptive_host; // for bandwidth estimation
 
   /* Playbin2 compat */
   gint n_video, n_audio, n_text;
@@ -114,18 +146,33 @@ struct _ClapperPlayer
   gboolean subtitles_enabled;
   gchar *download_dir;
   gboolean download_enabled;
+  gboolean media_cache_enabled;
+  guint64 media_cache_max_size;
   guint start_bitrate;
+  gboolean start_bitrate_set; // by user, estimate is not used then
   guint min_bitrate;
   guint max_bitrate;
   guint bandwidth;
   gdouble audio_offset;
   gdouble subtitle_offset;
+  guint position_update_interval;
+  gboolean scrubbing;
+  gdouble seek_latency;
+  ClapperBufferingProfile buffering_profile;
+  gdouble buffering_low_watermark;
+  gdouble buffering_high_watermark;
+  gboolean adaptive_buffering;
+
+  /* Watermarks multiplier adjusted to rebuffer rate */
+  gdouble buffering_scale;
 };
 
 ClapperPlayer * clapper_player_get_from_ancestor (GstObject *object);
 
 gboolean clapper_player_refresh_position (ClapperPlayer *player);
 
+void clapper_player_update_snapshot_item (ClapperPlayer *player, ClapperMediaItem *item);
+
 void clapper_player_add_tick_source (ClapperPlayer *player);
 
 void clapper_player_remove_tick_source (ClapperPlayer *player);
@@ -142,6 +189,18 @@ void clapper_player_handle_playbin_av_offset_changed (ClapperPlayer *player, con
 
 void clapper_player_handle_playbin_text_offset_changed (ClapperPlayer *player, const GValue *value);
 
+void clapper_player_handle_seek_latency (ClapperPlayer *player, gdouble latency);
+
+void clapper_player_handle_rebuffer (ClapperPlayer *player);
+
+void clapper_player_mark_startup_phase (ClapperPlayer *player, ClapperStartupPhase phase, gint64 time);
+
+void clapper_player_mark_startup_harvest_cached (ClapperPlayer *player, gboolean cached);
+
+void clapper_player_finish_startup_report (ClapperPlayer *player);
+
+void clapper_player_handle_startup_stream_start (ClapperPlayer *player);
+
 void clapper_player_handle_playbin_common_prop_changed (ClapperPlayer *player, const gchar *prop_name);
 
 void clapper_player_handle_playbin_rate_changed (ClapperPlayer *player, gdouble speed);
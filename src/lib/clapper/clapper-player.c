@@ -36,6 +36,7 @@
  */
 
 #include <gst/audio/streamvolume.h>
+#include <gst/base/gstbasesink.h>
 
 #include "clapper-player.h"
 #include "clapper-player-private.h"
@@ -49,6 +50,9 @@
 #include "clapper-audio-stream-private.h"
 #include "clapper-subtitle-stream-private.h"
 #include "clapper-enhancer-proxy-list-private.h"
+#include "clapper-bandwidth-estimator-private.h"
+#include "clapper-media-cache-private.h"
+#include "clapper-http-context-private.h"
 #include "clapper-reactable.h"
 #include "clapper-enums-private.h"
 #include "clapper-utils-private.h"
@@ -63,7 +67,38 @@
 #define DEFAULT_AUDIO_ENABLED TRUE
 #define DEFAULT_SUBTITLES_ENABLED TRUE
 #define DEFAULT_DOWNLOAD_ENABLED FALSE
+#define DEFAULT_MEDIA_CACHE_ENABLED FALSE
+#define DEFAULT_MEDIA_CACHE_MAX_SIZE (2 * 1024 * 1024 * (guint64) 1024)
 #define DEFAULT_ADAPTIVE_START_BITRATE 1600000
+#define DEFAULT_POSITION_UPDATE_INTERVAL 0
+#define DEFAULT_SCRUBBING FALSE
+#define DEFAULT_BUFFERING_PROFILE CLAPPER_BUFFERING_PROFILE_DEFAULT
+#define DEFAULT_ADAPTIVE_BUFFERING FALSE
+
+/* Low and high buffering watermarks (in seconds) of each profile */
+static const gdouble buffering_presets[][2] = {
+  [CLAPPER_BUFFERING_PROFILE_DEFAULT] = { 3, 10 },
+  [CLAPPER_BUFFERING_PROFILE_LOW_LATENCY] = { 0.5, 2 },
+  [CLAPPER_BUFFERING_PROFILE_PREFETCH] = { 10, 60 },
+};
+
+/* How much adaptive buffering widens watermarks after each rebuffer,
+ * narrows them after smooth playback and up to how many times */
+#define BUFFERING_SCALE_WIDEN 1.5
+#define BUFFERING_SCALE_NARROW 0.8
+#define BUFFERING_SCALE_MAX 4.0
+
+/* Playback needs to go on at least that long (in seconds)
+ * without rebuffering to consider network stable */
+#define BUFFERING_STABLE_TIME 60
+
+/* Position update intervals (in milliseconds) used when set to automatic
+ * and when nothing is observing position changes respectively */
+#define POSITION_AUTO_INTERVAL 100
+#define POSITION_IDLE_INTERVAL 1000
+
+/* Lock-free snapshot reads attempted before falling back to object lock */
+#define SNAPSHOT_READ_TRIES 4
 
 #define GST_CAT_DEFAULT clapper_player_debug
 GST_DEBUG_CATEGORY_STATIC (GST_CAT_DEFAULT);
@@ -96,6 +131,8 @@ enum
   PROP_SUBTITLES_ENABLED,
   PROP_DOWNLOAD_DIR,
   PROP_DOWNLOAD_ENABLED,
+  PROP_MEDIA_CACHE_ENABLED,
+  PROP_MEDIA_CACHE_MAX_SIZE,
   PROP_ADAPTIVE_START_BITRATE,
   PROP_ADAPTIVE_MIN_BITRATE,
   PROP_ADAPTIVE_MAX_BITRATE,
@@ -103,6 +140,13 @@ enum
   PROP_AUDIO_OFFSET,
   PROP_SUBTITLE_OFFSET,
   PROP_SUBTITLE_FONT_DESC,
+  PROP_POSITION_UPDATE_INTERVAL,
+  PROP_SCRUBBING,
+  PROP_SEEK_LATENCY,
+  PROP_BUFFERING_PROFILE,
+  PROP_BUFFERING_LOW_WATERMARK,
+  PROP_BUFFERING_HIGH_WATERMARK,
+  PROP_ADAPTIVE_BUFFERING,
   PROP_LAST
 };
 
@@ -110,6 +154,7 @@ enum
 {
   SIGNAL_SEEK_DONE,
   SIGNAL_DOWNLOAD_COMPLETE,
+  SIGNAL_STARTUP_REPORT,
   SIGNAL_MISSING_PLUGIN,
   SIGNAL_MESSAGE,
   SIGNAL_WARNING,
@@ -119,6 +164,7 @@ enum
 
 static GParamSpec *param_specs[PROP_LAST] = { NULL, };
 static guint signals[SIGNAL_LAST] = { 0, };
+static guint notify_signal_id = 0;
 
 /* Properties we expose through API, thus we want to emit notify signals for them */
 static const gchar *playbin_watchlist[] = {
@@ -134,9 +180,51 @@ static const gchar *playbin_watchlist[] = {
   NULL
 };
 
+/* Must be called with object lock held */
+static void
+_publish_snapshot_unlocked (ClapperPlayer *self, gint64 position_time)
+{
+  /* Odd sequence tells readers that write is in progress */
+  g_atomic_int_inc (&self->snapshot_seq);
+
+  self->snapshot.position = self->position;
+  self->snapshot.state = self->state;
+  self->snapshot.speed = self->speed;
+  self->snapshot.volume = self->volume;
+  self->snapshot.mute = self->mute;
+  self->snapshot_position_time = position_time;
+
+  g_atomic_int_inc (&self->snapshot_seq);
+}
+
+void
+clapper_player_update_snapshot_item (ClapperPlayer *self, ClapperMediaItem *item)
+{
+  gdouble duration = 0;
+  guint item_id = 0;
+
+  if (item) {
+    item_id = clapper_media_item_get_id (item);
+    duration = clapper_media_item_get_duration (item);
+  }
+
+  GST_OBJECT_LOCK (self);
+
+  g_atomic_int_inc (&self->snapshot_seq);
+
+  self->snapshot.item_id = item_id;
+  self->snapshot.duration = duration;
+
+  g_atomic_int_inc (&self->snapshot_seq);
+
+  GST_OBJECT_UNLOCK (self);
+}
+
 gboolean
 clapper_player_refresh_position (ClapperPlayer *self)
 {
+  GstClock *clock;
+  GstClockTime clock_time = GST_CLOCK_TIME_NONE;
   gint64 position = GST_CLOCK_TIME_NONE;
   gdouble position_dbl;
   gboolean changed;
@@ -144,16 +232,34 @@ clapper_player_refresh_position (ClapperPlayer *self)
   if (gst_element_query (self->playbin, self->position_query))
     gst_query_parse_position (self->position_query, NULL, &position);
 
+  if ((clock = gst_element_get_clock (self->playbin)))
+    clock_time = gst_clock_get_time (clock);
+
   if (position < 0)
     position = 0;
 
   position_dbl = (gdouble) position / GST_SECOND;
 
   GST_OBJECT_LOCK (self);
+
   if ((changed = !G_APPROX_VALUE (self->position, position_dbl, FLT_EPSILON)))
     self->position = position_dbl;
+
+  /* Only interpolate while ticking (playing) */
+  if (self->tick_source && clock) {
+    gst_object_replace ((GstObject **) &self->position_clock, GST_OBJECT_CAST (clock));
+    self->position_clock_time = clock_time;
+  } else {
+    gst_clear_object (&self->position_clock);
+  }
+
+  _publish_snapshot_unlocked (self,
+      (self->position_clock) ? g_get_monotonic_time () : 0);
+
   GST_OBJECT_UNLOCK (self);
 
+  gst_clear_object (&clock);
+
   if (changed) {
     GST_LOG_OBJECT (self, "Position: %" CLAPPER_TIME_MS_FORMAT,
         CLAPPER_TIME_MS_ARGS (position_dbl));
@@ -169,16 +275,101 @@ clapper_player_refresh_position (ClapperPlayer *self)
   return G_SOURCE_CONTINUE;
 }
 
+static inline gboolean
+_have_position_interest (ClapperPlayer *self)
+{
+  return ((self->reactables_manager
+      && clapper_reactables_manager_has_position_interest (self->reactables_manager))
+      || (clapper_player_get_have_features (self)
+      && clapper_features_manager_has_position_interest (self->features_manager))
+      || g_signal_has_handler_pending (self, notify_signal_id,
+          g_param_spec_get_name_quark (param_specs[PROP_POSITION]), FALSE));
+}
+
+/*
+ * Returns delay in milliseconds until next position query. When something
+ * observes position, we wake up right after it crosses next multiple of
+ * update interval, so consumers showing e.g. whole seconds are updated on
+ * time with a single query per second. Otherwise ticks are rare, as getter
+ * interpolates position from pipeline clock anyway.
+ */
+static guint
+_get_next_tick_delay (ClapperPlayer *self, gdouble prev_position)
+{
+  guint64 position_ms;
+  gdouble position, speed;
+  guint interval;
+
+  GST_OBJECT_LOCK (self);
+  position = self->position;
+  speed = self->speed;
+  interval = self->position_update_interval;
+  GST_OBJECT_UNLOCK (self);
+
+  if (!_have_position_interest (self))
+    return MAX (interval, POSITION_IDLE_INTERVAL);
+
+  if (interval == 0)
+    interval = POSITION_AUTO_INTERVAL;
+
+  /* Position is not advancing (e.g. stalled), avoid short wakeups */
+  if (speed <= 0 || position <= prev_position)
+    return interval;
+
+  position_ms = (guint64) (position * 1000);
+
+  return (guint) (((position_ms / interval + 1) * interval - position_ms) / speed) + 1;
+}
+
+static gboolean _tick_cb (ClapperPlayer *self);
+
+static void
+_add_tick_source_unlocked (ClapperPlayer *self, guint delay)
+{
+  self->tick_source = clapper_shared_utils_context_timeout_add_full (
+      clapper_threaded_object_get_context (CLAPPER_THREADED_OBJECT_CAST (self)),
+      G_PRIORITY_DEFAULT_IDLE, delay,
+      (GSourceFunc) _tick_cb,
+      self, NULL);
+}
+
+static gboolean
+_tick_cb (ClapperPlayer *self)
+{
+  gdouble prev_position;
+  guint delay;
+
+  GST_OBJECT_LOCK (self);
+  prev_position = self->position;
+  GST_OBJECT_UNLOCK (self);
+
+  clapper_player_refresh_position (self);
+  delay = _get_next_tick_delay (self, prev_position);
+
+  GST_OBJECT_LOCK (self);
+
+  /* Reschedule unless removed in the meantime */
+  if (self->tick_source) {
+    g_source_unref (self->tick_source);
+    _add_tick_source_unlocked (self, delay);
+  }
+
+  GST_OBJECT_UNLOCK (self);
+
+  GST_TRACE_OBJECT (self, "Next tick in %ums", delay);
+
+  return G_SOURCE_REMOVE;
+}
+
 void
 clapper_player_add_tick_source (ClapperPlayer *self)
 {
   GST_OBJECT_LOCK (self);
   if (!self->tick_source) {
-    self->tick_source = clapper_shared_utils_context_timeout_add_full (
-        clapper_threaded_object_get_context (CLAPPER_THREADED_OBJECT_CAST (self)),
-        G_PRIORITY_DEFAULT_IDLE, 100,
-        (GSourceFunc) clapper_player_refresh_position,
-        self, NULL);
+    guint interval = (self->position_update_interval > 0)
+        ? self->position_update_interval : POSITION_AUTO_INTERVAL;
+
+    _add_tick_source_unlocked (self, interval);
     GST_TRACE_OBJECT (self, "Added tick source");
   }
   GST_OBJECT_UNLOCK (self);
@@ -193,6 +384,10 @@ clapper_player_remove_tick_source (ClapperPlayer *self)
     g_clear_pointer (&self->tick_source, g_source_unref);
     GST_TRACE_OBJECT (self, "Removed tick source");
   }
+  if (self->position_clock) {
+    gst_clear_object (&self->position_clock);
+    _publish_snapshot_unlocked (self, 0);
+  }
   GST_OBJECT_UNLOCK (self);
 }
 
@@ -219,8 +414,10 @@ clapper_player_handle_playbin_state_changed (ClapperPlayer *self)
   }
 
   GST_OBJECT_LOCK (self);
-  if ((changed = self->state != state))
+  if ((changed = self->state != state)) {
     self->state = state;
+    _publish_snapshot_unlocked (self, self->snapshot_position_time);
+  }
   GST_OBJECT_UNLOCK (self);
 
   if (changed) {
@@ -232,6 +429,9 @@ clapper_player_handle_playbin_state_changed (ClapperPlayer *self)
       clapper_reactables_manager_trigger_state_changed (self->reactables_manager, state);
     if (clapper_player_get_have_features (self))
       clapper_features_manager_trigger_state_changed (self->features_manager, state);
+
+    /* Upcoming items are preloaded only after current one started */
+    clapper_preloader_schedule_refresh (self->preloader);
   }
 }
 
@@ -252,8 +452,10 @@ clapper_player_handle_playbin_volume_changed (ClapperPlayer *self, const GValue
       volume_linear);
 
   GST_OBJECT_LOCK (self);
-  if ((changed = !G_APPROX_VALUE (self->volume, volume, FLT_EPSILON)))
+  if ((changed = !G_APPROX_VALUE (self->volume, volume, FLT_EPSILON))) {
     self->volume = volume;
+    _publish_snapshot_unlocked (self, self->snapshot_position_time);
+  }
   GST_OBJECT_UNLOCK (self);
 
   if (changed) {
@@ -278,8 +480,10 @@ clapper_player_handle_playbin_mute_changed (ClapperPlayer *self, const GValue *v
   GST_DEBUG_OBJECT (self, "Playbin mute changed");
 
   GST_OBJECT_LOCK (self);
-  if ((changed = self->mute != mute))
+  if ((changed = self->mute != mute)) {
     self->mute = mute;
+    _publish_snapshot_unlocked (self, self->snapshot_position_time);
+  }
   GST_OBJECT_UNLOCK (self);
 
   if (changed) {
@@ -381,6 +585,190 @@ clapper_player_handle_playbin_text_offset_changed (ClapperPlayer *self, const GV
   }
 }
 
+void
+clapper_player_handle_seek_latency (ClapperPlayer *self, gdouble latency)
+{
+  GST_INFO_OBJECT (self, "Seek completed in %.3lf seconds", latency);
+
+  GST_OBJECT_LOCK (self);
+  self->seek_latency = latency;
+  GST_OBJECT_UNLOCK (self);
+
+  clapper_app_bus_post_prop_notify (self->app_bus,
+      GST_OBJECT_CAST (self), param_specs[PROP_SEEK_LATENCY]);
+}
+
+/* Must be called with object lock held */
+static inline void
+_get_buffering_watermarks_unlocked (ClapperPlayer *self,
+    GstClockTime *low, GstClockTime *high)
+{
+  gdouble scale = (self->adaptive_buffering) ? self->buffering_scale : 1.0;
+
+  *high = (GstClockTime) (self->buffering_high_watermark * scale * GST_SECOND);
+  *low = MIN ((GstClockTime) (self->buffering_low_watermark * scale * GST_SECOND), *high);
+}
+
+/* Default profile keeps default sizes of elements other than adaptive
+ * demuxers (which use its watermarks), so returns %FALSE then */
+static gboolean
+_get_buffering_override (ClapperPlayer *self, GstClockTime *low, GstClockTime *high)
+{
+  gboolean override;
+
+  GST_OBJECT_LOCK (self);
+
+  override = (self->buffering_profile != CLAPPER_BUFFERING_PROFILE_DEFAULT
+      || (self->adaptive_buffering && self->buffering_scale > 1.0));
+
+  if (override)
+    _get_buffering_watermarks_unlocked (self, low, high);
+
+  GST_OBJECT_UNLOCK (self);
+
+  return (override && *high > 0);
+}
+
+/*
+ * Buffering elements are created by urisourcebin, which sets their
+ * limits from its own properties, so duration is set through playbin
+ * (passed down to it) before changing URI. Watermarks are set on
+ * urisourcebin itself when it is created (see element setup).
+ */
+static void
+_apply_buffering_limits (ClapperPlayer *self)
+{
+  GstClockTime low, high;
+
+  if (_get_buffering_override (self, &low, &high)) {
+    /* Only duration limits buffering then */
+    g_object_set (self->playbin,
+        "buffer-duration", (gint64) high,
+        "buffer-size", 0,
+        NULL);
+  } else {
+    g_object_set (self->playbin,
+        "buffer-duration", G_GINT64_CONSTANT (-1),
+        "buffer-size", -1,
+        NULL);
+  }
+}
+
+void
+clapper_player_handle_rebuffer (ClapperPlayer *self)
+{
+  GstElement *element = NULL;
+  GstClockTime low, high;
+
+  GST_OBJECT_LOCK (self);
+
+  if (!self->adaptive_buffering
+      || self->buffering_scale >= BUFFERING_SCALE_MAX) {
+    GST_OBJECT_UNLOCK (self);
+    return;
+  }
+
+  self->buffering_scale = MIN (self->buffering_scale * BUFFERING_SCALE_WIDEN,
+      BUFFERING_SCALE_MAX);
+  _get_buffering_watermarks_unlocked (self, &low, &high);
+
+  if (self->adaptive_demuxer)
+    element = gst_object_ref (self->adaptive_demuxer);
+
+  GST_OBJECT_UNLOCK (self);
+
+  GST_INFO_OBJECT (self, "Rebuffered, widening buffering watermarks to: %"
+      GST_TIME_FORMAT " - %" GST_TIME_FORMAT, GST_TIME_ARGS (low), GST_TIME_ARGS (high));
+
+  /* Other buffering elements will use new values with next item */
+  if (element) {
+    g_free (host);
+
+    g_object_set (element,
+        "low-watermark-time", low,
+        "high-watermark-time", high,
+        NULL);
+    gst_object_unref (element);
+  }
+}
+
+void
+clapper_player_mark_startup_phase (ClapperPlayer *self, ClapperStartupPhase phase, gint64 time)
+{
+  ClapperStartupReport *report = NULL;
+
+  GST_OBJECT_LOCK (self);
+  if (self->startup_report)
+    report = gst_object_ref (self->startup_report);
+  GST_OBJECT_UNLOCK (self);
+
+  if (report) {
+    clapper_startup_report_mark_phase (report, phase, time);
+    gst_object_unref (report);
+  }
+}
+
+void
+clapper_player_mark_startup_harvest_cached (ClapperPlayer *self, gboolean cached)
+{
+  GST_OBJECT_LOCK (self);
+  if (self->startup_report)
+    clapper_startup_report_set_harvest_cached (self->startup_report, cached);
+  GST_OBJECT_UNLOCK (self);
+}
+
+static void
+_post_startup_report (ClapperPlayer *self, ClapperStartupReport *report)
+{
+  GST_INFO_OBJECT (self, "Startup of %" GST_PTR_FORMAT " finished, preroll: %.3lf"
+      ", first frame: %.3lf", clapper_startup_report_get_media_item (report),
+      clapper_startup_report_get_phase_time (report, CLAPPER_STARTUP_PHASE_PREROLL),
+      clapper_startup_report_get_phase_time (report, CLAPPER_STARTUP_PHASE_FIRST_FRAME));
+
+  GST_OBJECT_LOCK (self);
+  clapper_startup_histogram_add_report (self->startup_histogram, report);
+  GST_OBJECT_UNLOCK (self);
+
+  clapper_app_bus_post_object_signal (self->app_bus,
+      GST_OBJECT_CAST (self), signals[SIGNAL_STARTUP_REPORT],
+      GST_OBJECT_CAST (report));
+}
+
+/* In gapless mode item is set in "about-to-finish", way before
+ * it starts playing, so its startup is measured from stream start */
+void
+clapper_player_handle_startup_stream_start (ClapperPlayer *self)
+{
+  ClapperStartupReport *report = NULL;
+
+  GST_OBJECT_LOCK (self);
+  if (self->startup_report && self->startup_on_stream_start)
+    report = gst_object_ref (self->startup_report);
+  self->startup_on_stream_start = FALSE;
+  GST_OBJECT_UNLOCK (self);
+
+  if (report) {
+    clapper_startup_report_restart (report, g_get_monotonic_time ());
+    gst_object_unref (report);
+  }
+}
+
+/* Each report is posted only once, further phases are ignored */
+void
+clapper_player_finish_startup_report (ClapperPlayer *self)
+{
+  ClapperStartupReport *report;
+
+  GST_OBJECT_LOCK (self);
+  report = g_steal_pointer (&self->startup_report);
+  GST_OBJECT_UNLOCK (self);
+
+  if (report) {
+    _post_startup_report (self, report);
+    gst_object_unref (report);
+  }
+}
+
 void
 clapper_player_handle_playbin_common_prop_changed (ClapperPlayer *self, const gchar *prop_name)
 {
@@ -400,8 +788,10 @@ clapper_player_handle_playbin_rate_changed (ClapperPlayer *self, gdouble speed)
   gboolean changed;
 
   GST_OBJECT_LOCK (self);
-  if ((changed = !G_APPROX_VALUE (self->speed, speed, FLT_EPSILON)))
+  if ((changed = !G_APPROX_VALUE (self->speed, speed, FLT_EPSILON))) {
     self->speed = speed;
+    _publish_snapshot_unlocked (self, self->snapshot_position_time);
+  }
   GST_OBJECT_UNLOCK (self);
 
   if (changed) {
@@ -452,8 +842,9 @@ void
 clapper_player_set_pending_item (ClapperPlayer *self, ClapperMediaItem *pending_item,
     ClapperQueueItemChangeMode mode)
 {
+  ClapperStartupReport *report = NULL, *prev_report;
   const gchar *uri = NULL;
-  gchar *suburi = NULL;
+  gchar *suburi = NULL, *cached_uri = NULL;
 
   /* We cannot do gapless/instant with pending suburi in place,
    * do a check and if necessary use normal mode instead */
@@ -468,8 +859,23 @@ clapper_player_set_pending_item (ClapperPlayer *self, ClapperMediaItem *pending_
 
   /* Might be NULL (e.g. after queue is cleared) */
   if (pending_item) {
+    gboolean media_cache_enabled;
+
     uri = clapper_media_item_get_playback_uri (pending_item);
     suburi = clapper_media_item_get_suburi (pending_item);
+    report = clapper_startup_report_new (pending_item);
+    clapper_startup_report_set_warmup_request_latency (report,
+        clapper_preloader_take_warmup_request_latency (self->preloader, pending_item));
+
+    GST_OBJECT_LOCK (self);
+    media_cache_enabled = self->media_cache_enabled;
+    GST_OBJECT_UNLOCK (self);
+
+    /* Play previously downloaded copy instead, unless item
+     * already points to a local file (e.g. own cache location) */
+    if (media_cache_enabled && !gst_uri_has_protocol (uri, "file")
+        && (cached_uri = clapper_media_cache_lookup (clapper_media_item_get_uri (pending_item))))
+      uri = cached_uri;
   }
 
   GST_INFO_OBJECT (self, "Changing item with mode %u, URI: \"%s\", SUBURI: \"%s\"",
@@ -480,13 +886,25 @@ clapper_player_set_pending_item (ClapperPlayer *self, ClapperMediaItem *pending_
    * so we cannot schedule an invoke of another thread there */
   GST_OBJECT_LOCK (self);
   gst_object_replace ((GstObject **) &self->pending_item, GST_OBJECT_CAST (pending_item));
+  prev_report = self->startup_report;
+  self->startup_report = report;
+  self->startup_on_stream_start = (report && mode == CLAPPER_QUEUE_ITEM_CHANGE_GAPLESS);
   GST_OBJECT_UNLOCK (self);
 
+  /* Item that did not finish starting still gets a report,
+   * with phases that were not reached left unset */
+  if (prev_report) {
+    _post_startup_report (self, prev_report);
+    gst_object_unref (prev_report);
+  }
+
   /* GStreamer does not support changing suburi in gapless/instant mode */
   if (mode == CLAPPER_QUEUE_ITEM_CHANGE_NORMAL)
     g_object_set (self->playbin, "suburi", suburi, NULL);
 
   if (uri) {
+    _apply_buffering_limits (self);
+
     if (mode == CLAPPER_QUEUE_ITEM_CHANGE_INSTANT)
       g_object_set (self->playbin, "instant-uri", TRUE, NULL);
 
@@ -497,6 +915,10 @@ clapper_player_set_pending_item (ClapperPlayer *self, ClapperMediaItem *pending_
   }
 
   g_free (suburi);
+  g_free (cached_uri);
+
+  /* Upcoming items change together with current one */
+  clapper_preloader_schedule_refresh (self->preloader);
 }
 
 static void
@@ -734,6 +1156,7 @@ static void
 _adaptive_demuxer_bandwidth_changed_cb (GstElement *adaptive_demuxer,
     GParamSpec *pspec G_GNUC_UNUSED, ClapperPlayer *self)
 {
+  gchar *host;
   guint bandwidth = 0;
   gboolean changed;
 
@@ -747,8 +1170,15 @@ _adaptive_demuxer_bandwidth_changed_cb (GstElement *adaptive_demuxer,
   GST_OBJECT_LOCK (self);
   if ((changed = bandwidth != self->bandwidth))
     self->bandwidth = bandwidth;
+  host = g_strdup (self->adaptive_host);
   GST_OBJECT_UNLOCK (self);
 
+  /* Remember for the next streams from the same host */
+  if (host) {
+    clapper_bandwidth_estimator_update (host, bandwidth);
+    g_free (host);
+  }
+
   if (changed) {
     GST_LOG_OBJECT (self, "Adaptive bandwidth: %u", bandwidth);
     clapper_app_bus_post_prop_notify (self->app_bus,
@@ -759,27 +1189,57 @@ _adaptive_demuxer_bandwidth_changed_cb (GstElement *adaptive_demuxer,
 void
 clapper_player_reset (ClapperPlayer *self, gboolean pending_dispose)
 {
+  gboolean had_adaptive, media_cache_enabled;
+
   GST_OBJECT_LOCK (self);
 
   GST_DEBUG_OBJECT (self, "Reset");
 
+  /* Network kept up with playback, so try buffering less next time */
+  if (self->adaptive_buffering && self->buffering_scale > 1.0
+      && self->stats_counters.rebuffer_count == 0
+      && self->position >= BUFFERING_STABLE_TIME) {
+    self->buffering_scale = MAX (self->buffering_scale * BUFFERING_SCALE_NARROW, 1.0);
+    GST_INFO_OBJECT (self, "No rebuffers, narrowing buffering scale to: %.2lf",
+        self->buffering_scale);
+  }
+
   self->had_error = FALSE;
   self->pending_flush = FALSE;
+  self->pending_seek_position = -1;
+  self->scrub_position = -1;
   gst_clear_object (&self->played_item);
 
+  /* Sink also resets its stats when stopped */
+  clapper_playback_stats_counters_reset (&self->stats_counters);
+
   if (pending_dispose) {
     gst_clear_object (&self->video_decoder);
     gst_clear_object (&self->audio_decoder);
+    gst_clear_object (&self->stats_video_sink);
   }
 
-  if (self->adaptive_demuxer) {
+  if ((had_adaptive = (self->adaptive_demuxer != NULL))) {
     g_signal_handlers_disconnect_by_func (self->adaptive_demuxer,
         _adaptive_demuxer_bandwidth_changed_cb, self);
     gst_clear_object (&self->adaptive_demuxer);
   }
+  g_clear_pointer (&self->adaptive_host, g_free);
+
+  media_cache_enabled = self->media_cache_enabled;
 
   GST_OBJECT_UNLOCK (self);
 
+  /* Persist updated estimates once adaptive playback ends */
+  if (had_adaptive)
+    clapper_bandwidth_estimator_save ();
+
+  /* Persist usage of cached media */
+  if (media_cache_enabled)
+    clapper_media_cache_save ();
+
+  clapper_player_update_snapshot_item (self, NULL);
+
   self->stream_tags_allowed = FALSE;
   gst_clear_tag_list (&self->pending_tags);
 
@@ -799,10 +1259,28 @@ clapper_player_reset (ClapperPlayer *self, gboolean pending_dispose)
 static inline gchar *
 _make_download_template (ClapperPlayer *self)
 {
-  gchar *download_template = NULL;
+  gchar *download_template = NULL, *cache_uri = NULL;
 
   GST_OBJECT_LOCK (self);
 
+  /* Media cache takes precedence over download dir */
+  if (self->download_enabled && self->media_cache_enabled) {
+    /* Download is created for item that is about to be played */
+    ClapperMediaItem *item = (self->pending_item) ? self->pending_item : self->played_item;
+
+    if (item)
+      cache_uri = g_strdup (clapper_media_item_get_uri (item));
+  }
+
+  if (cache_uri) {
+    GST_OBJECT_UNLOCK (self);
+
+    download_template = clapper_media_cache_make_template (cache_uri);
+    g_free (cache_uri);
+
+    return download_template;
+  }
+
   if (self->download_enabled && self->download_dir) {
     if (g_mkdir_with_parents (self->download_dir, 0755) == 0) {
       download_template = g_build_filename (self->download_dir, "XXXXXX", NULL);
@@ -816,6 +1294,14 @@ _make_download_template (ClapperPlayer *self)
   return download_template;
 }
 
+static void
+_typefind_have_type_cb (GstElement *typefind, guint probability,
+    GstCaps *caps, ClapperPlayer *self)
+{
+  clapper_player_mark_startup_phase (self,
+      CLAPPER_STARTUP_PHASE_TYPEFIND, g_get_monotonic_time ());
+}
+
 static void
 _element_setup_cb (GstElement *playbin, GstElement *element, ClapperPlayer *self)
 {
@@ -833,6 +1319,9 @@ _element_setup_cb (GstElement *playbin, GstElement *element, ClapperPlayer *self
     g_object_set (element,
         "enhancer-proxies", self->enhancer_proxies,
         NULL);
+  } else if (factory_name == g_intern_static_string ("typefind")) {
+    g_signal_connect (element, "have-type",
+        G_CALLBACK (_typefind_have_type_cb), self);
   } else if (factory_name == g_intern_static_string ("downloadbuffer")) {
     gchar *download_template;
 
@@ -844,15 +1333,63 @@ _element_setup_cb (GstElement *playbin, GstElement *element, ClapperPlayer *self
           NULL);
       g_free (download_template);
     }
+
+  } else if (factory_name == g_intern_static_string ("souphttpsrc")) {
+    GstContext *context;
+    gboolean shared;
+
+    /* Keep connections open to reuse them for subsequent requests */
+    g_object_set (element, "keep-alive", TRUE, NULL);
+
+    /* Share session of sources set up earlier (also by other players) */
+    if ((shared = (context = clapper_http_context_get ()) != NULL)) {
+      gst_element_set_context (element, context);
+      gst_context_unref (context);
+    }
+
+    GST_OBJECT_LOCK (self);
+    clapper_playback_stats_counters_add_http_source (&self->stats_counters, shared);
+    GST_OBJECT_UNLOCK (self);
+  } else if (factory_name == g_intern_static_string ("urisourcebin")) {
+    GstClockTime low, high;
+
+    /* Set before it creates its buffering element, which gets these
+     * values (anything set on that element directly is overwritten) */
+    if (_get_buffering_override (self, &low, &high)) {
+      g_object_set (element,
+          "low-watermark", CLAMP ((gdouble) low / high, 0.0, 1.0),
+          "high-watermark", 1.0,
+          NULL);
+    }
   } else if (factory_name == g_intern_static_string ("dashdemux2")
       || factory_name == g_intern_static_string ("hlsdemux2")) {
-    guint start_bitrate, min_bitrate, max_bitrate;
+    ClapperMediaItem *item;
+    gchar *host;
+    guint start_bitrate, min_bitrate, max_bitrate, estimate = 0;
+    gboolean start_bitrate_set;
+    GstClockTime low, high;
 
     GST_OBJECT_LOCK (self);
 
     start_bitrate = self->start_bitrate;
+    start_bitrate_set = self->start_bitrate_set;
     min_bitrate = self->min_bitrate;
     max_bitrate = self->max_bitrate;
+    _get_buffering_watermarks_unlocked (self, &low, &high);
+
+    /* Demuxer is created for item that is about to be played */
+    item = (self->pending_item) ? self->pending_item : self->played_item;
+
+    g_clear_pointer (&self->adaptive_host, g_free);
+    if (item) {
+      GUri *guri = g_uri_parse (clapper_media_item_get_playback_uri (item),
+          G_URI_FLAGS_ENCODED, NULL);
+
+      if (guri) {
+        self->adaptive_host = g_strdup (g_uri_get_host (guri));
+        g_uri_unref (guri);
+      }
+    }
 
     if (self->adaptive_demuxer) {
       g_signal_handlers_disconnect_by_func (self->adaptive_demuxer,
@@ -866,16 +1403,44 @@ _element_setup_cb (GstElement *playbin, GstElement *element, ClapperPlayer *self
           G_CALLBACK (_adaptive_demuxer_bandwidth_changed_cb), self);
     }
 
+    host = g_strdup (self->adaptive_host);
+
     GST_OBJECT_UNLOCK (self);
 
+    /* Might need to read cache on first use, so not under lock.
+     * Bitrate explicitly chosen by user always takes precedence. */
+    if (host && !start_bitrate_set)
+      estimate = clapper_bandwidth_estimator_lookup (host);
+
+    /* Start from variant that fits previously measured bandwidth,
+     * leaving some headroom as it fluctuates over time */
+    if (estimate > 0) {
+      start_bitrate = MAX (estimate / 10 * 8, min_bitrate);
+      if (max_bitrate > 0)
+        start_bitrate = MIN (start_bitrate, max_bitrate);
+
+      GST_DEBUG_OBJECT (self, "Using estimated start bitrate: %u", start_bitrate);
+    }
+
     g_object_set (element,
-        "low-watermark-time", 3 * GST_SECOND,
-        "high-watermark-time", 10 * GST_SECOND,
+        "low-watermark-time", low,
+        "high-watermark-time", high,
         "start-bitrate", start_bitrate,
         "min-bitrate", min_bitrate,
         "max-bitrate", max_bitrate,
         NULL);
   }
+
+  /* Actual video sink (might be inside of a sink bin) to read stats from */
+  if (GST_IS_BASE_SINK (element)) {
+    const gchar *klass = gst_element_get_metadata (element, GST_ELEMENT_METADATA_KLASS);
+
+    if (klass && strstr (klass, "Video")) {
+      GST_OBJECT_LOCK (self);
+      gst_object_replace ((GstObject **) &self->stats_video_sink, GST_OBJECT_CAST (element));
+      GST_OBJECT_UNLOCK (self);
+    }
+  }
 }
 
 static void
@@ -1225,19 +1790,40 @@ clapper_player_get_autoplay (ClapperPlayer *self)
  *
  * The returned value is in seconds as a decimal number.
  *
+ * During playback, position is interpolated from the pipeline clock since
+ * its last update, so this function can be called from e.g. a frame clock
+ * tick callback to obtain smooth position regardless of
+ * [property@Clapper.Player:position-update-interval].
+ *
  * Returns: the position of the player.
  */
 gdouble
 clapper_player_get_position (ClapperPlayer *self)
 {
-  gdouble position;
+  GstClock *clock = NULL;
+  GstClockTime clock_time = 0;
+  gdouble position, speed = 0;
 
   g_return_val_if_fail (CLAPPER_IS_PLAYER (self), 0);
 
   GST_OBJECT_LOCK (self);
   position = self->position;
+  if (self->position_clock) {
+    clock = gst_object_ref (self->position_clock);
+    clock_time = self->position_clock_time;
+    speed = self->speed;
+  }
   GST_OBJECT_UNLOCK (self);
 
+  if (clock) {
+    GstClockTime now = gst_clock_get_time (clock);
+
+    if (now > clock_time)
+      position += speed * ((gdouble) (now - clock_time) / GST_SECOND);
+
+    gst_object_unref (clock);
+  }
+
   return position;
 }
 
@@ -1264,31 +1850,94 @@ clapper_player_get_state (ClapperPlayer *self)
 }
 
 /**
- * clapper_player_set_mute:
+ * clapper_player_get_snapshot:
  * @player: a #ClapperPlayer
- * @mute: %TRUE if player should be muted, %FALSE otherwise.
+ * @snapshot: (out caller-allocates): a #ClapperPlayerSnapshot to fill
  *
- * Set the mute state of the player.
+ * Fill @snapshot with current player state in a single call.
+ *
+ * Unlike calling multiple getters, this returns values that are all
+ * consistent with each other and usually does not take player lock, making
+ * it suited for frequent reading from any thread. During playback,
+ * position is interpolated since its last update.
+ *
+ * Note that interpolation uses system monotonic time, while
+ * [method@Clapper.Player.get_position] uses pipeline clock (which might
+ * be e.g. an audio device clock). These can drift apart slightly between
+ * position updates, so the two values are not guaranteed to be equal.
+ *
+ * Since: 0.12
  */
 void
-clapper_player_set_mute (ClapperPlayer *self, gboolean mute)
+clapper_player_get_snapshot (ClapperPlayer *self, ClapperPlayerSnapshot *snapshot)
 {
-  GValue value = G_VALUE_INIT;
+  gint64 position_time = 0;
+  guint tries;
+  gint seq;
 
   g_return_if_fail (CLAPPER_IS_PLAYER (self));
+  g_return_if_fail (snapshot != NULL);
 
-  g_value_init (&value, G_TYPE_BOOLEAN);
-  g_value_set_boolean (&value, mute);
+  for (tries = 0; tries < SNAPSHOT_READ_TRIES; ++tries) {
+    /* Let writer finish */
+    if ((seq = g_atomic_int_get (&self->snapshot_seq)) & 1) {
+      g_thread_yield ();
+      continue;
+    }
 
-  clapper_playbin_bus_post_set_prop (self->bus, GST_OBJECT_CAST (self->playbin), "mute", &value);
-}
+    *snapshot = self->snapshot;
+    position_time = self->snapshot_position_time;
 
-/**
- * clapper_player_get_mute:
- * @player: a #ClapperPlayer
- *
- * Get the mute state of the player.
- *
+    /* Compare-and-exchange acts as full memory barrier,
+     * so copy above cannot be reordered past it */
+    if (g_atomic_int_compare_and_exchange (&self->snapshot_seq, seq, seq))
+      break;
+  }
+
+  /* Writer keeps interfering (or was preempted mid-write), so wait
+   * for it on object lock, as all writes are done while holding it */
+  if (tries == SNAPSHOT_READ_TRIES) {
+    GST_OBJECT_LOCK (self);
+    *snapshot = self->snapshot;
+    position_time = self->snapshot_position_time;
+    GST_OBJECT_UNLOCK (self);
+  }
+
+  if (position_time > 0 && snapshot->state == CLAPPER_PLAYER_STATE_PLAYING) {
+    snapshot->position += snapshot->speed
+        * ((gdouble) (g_get_monotonic_time () - position_time) / G_USEC_PER_SEC);
+
+    if (snapshot->duration > 0 && snapshot->position > snapshot->duration)
+      snapshot->position = snapshot->duration;
+  }
+}
+
+/**
+ * clapper_player_set_mute:
+ * @player: a #ClapperPlayer
+ * @mute: %TRUE if player should be muted, %FALSE otherwise.
+ *
+ * Set the mute state of the player.
+ */
+void
+clapper_player_set_mute (ClapperPlayer *self, gboolean mute)
+{
+  GValue value = G_VALUE_INIT;
+
+  g_return_if_fail (CLAPPER_IS_PLAYER (self));
+
+  g_value_init (&value, G_TYPE_BOOLEAN);
+  g_value_set_boolean (&value, mute);
+
+  clapper_playbin_bus_post_set_prop (self->bus, GST_OBJECT_CAST (self->playbin), "mute", &value);
+}
+
+/**
+ * clapper_player_get_mute:
+ * @player: a #ClapperPlayer
+ *
+ * Get the mute state of the player.
+ *
  * Returns: %TRUE if player is muted, %FALSE otherwise.
  */
 gboolean
@@ -1740,7 +2389,8 @@ clapper_player_get_download_dir (ClapperPlayer *self)
  * Set whether player should attempt progressive download buffering.
  *
  * For this to actually work a [property@Clapper.Player:download-dir]
- * must also be set.
+ * must also be set or [property@Clapper.Player:media-cache-enabled]
+ * turned on.
  *
  * Since: 0.8
  */
@@ -1776,6 +2426,124 @@ clapper_player_get_download_enabled (ClapperPlayer *self)
   return enabled;
 }
 
+/**
+ * clapper_player_set_media_cache_enabled:
+ * @player: a #ClapperPlayer
+ * @enabled: whether enabled
+ *
+ * Set whether player should keep progressively downloaded media
+ * in a managed cache and reuse it when the same item is played again.
+ *
+ * Cached media is addressed by [property@Clapper.MediaItem:uri], so items
+ * which URI had to be resolved by an extractor will also skip extraction
+ * when played from cache. Once total size of cached media exceeds
+ * [property@Clapper.Player:media-cache-max-size], least recently played
+ * entries are removed.
+ *
+ * For downloads to happen [property@Clapper.Player:download-enabled]
+ * must also be set. When media cache is enabled, it is used instead of
+ * [property@Clapper.Player:download-dir].
+ *
+ * Since: 0.12
+ */
+void
+clapper_player_set_media_cache_enabled (ClapperPlayer *self, gboolean enabled)
+{
+  gboolean changed;
+
+  g_return_if_fail (CLAPPER_IS_PLAYER (self));
+
+  GST_OBJECT_LOCK (self);
+  if ((changed = self->media_cache_enabled != enabled))
+    self->media_cache_enabled = enabled;
+  GST_OBJECT_UNLOCK (self);
+
+  if (changed) {
+    GST_INFO_OBJECT (self, "Media cache enabled: %s", (enabled) ? "yes" : "no");
+    clapper_app_bus_post_prop_notify (self->app_bus,
+        GST_OBJECT_CAST (self), param_specs[PROP_MEDIA_CACHE_ENABLED]);
+  }
+}
+
+/**
+ * clapper_player_get_media_cache_enabled:
+ * @player: a #ClapperPlayer
+ *
+ * Get whether managed media cache is enabled.
+ *
+ * Returns: %TRUE if enabled, %FALSE otherwise.
+ *
+ * Since: 0.12
+ */
+gboolean
+clapper_player_get_media_cache_enabled (ClapperPlayer *self)
+{
+  gboolean enabled;
+
+  g_return_val_if_fail (CLAPPER_IS_PLAYER (self), FALSE);
+
+  GST_OBJECT_LOCK (self);
+  enabled = self->media_cache_enabled;
+  GST_OBJECT_UNLOCK (self);
+
+  return enabled;
+}
+
+/**
+ * clapper_player_set_media_cache_max_size:
+ * @player: a #ClapperPlayer
+ * @size: size in bytes
+ *
+ * Set total size (in bytes) up to which cached media is kept.
+ *
+ * Limit is enforced each time a download completes, so the
+ * newest download is always kept even if it alone exceeds @size.
+ *
+ * Since: 0.12
+ */
+void
+clapper_player_set_media_cache_max_size (ClapperPlayer *self, guint64 size)
+{
+  gboolean changed;
+
+  g_return_if_fail (CLAPPER_IS_PLAYER (self));
+
+  GST_OBJECT_LOCK (self);
+  if ((changed = self->media_cache_max_size != size))
+    self->media_cache_max_size = size;
+  GST_OBJECT_UNLOCK (self);
+
+  if (changed) {
+    GST_INFO_OBJECT (self, "Set media cache max size: %" G_GUINT64_FORMAT, size);
+    clapper_app_bus_post_prop_notify (self->app_bus,
+        GST_OBJECT_CAST (self), param_specs[PROP_MEDIA_CACHE_MAX_SIZE]);
+  }
+}
+
+/**
+ * clapper_player_get_media_cache_max_size:
+ * @player: a #ClapperPlayer
+ *
+ * Get total size (in bytes) up to which cached media is kept.
+ *
+ * Returns: max media cache size.
+ *
+ * Since: 0.12
+ */
+guint64
+clapper_player_get_media_cache_max_size (ClapperPlayer *self)
+{
+  guint64 size;
+
+  g_return_val_if_fail (CLAPPER_IS_PLAYER (self), DEFAULT_MEDIA_CACHE_MAX_SIZE);
+
+  GST_OBJECT_LOCK (self);
+  size = self->media_cache_max_size;
+  GST_OBJECT_UNLOCK (self);
+
+  return size;
+}
+
 static void
 _set_adaptive_bitrate (ClapperPlayer *self, guint *internal_ptr,
     const gchar *prop_name, guint bitrate, GParamSpec *pspec)
@@ -1817,6 +2585,9 @@ _set_adaptive_bitrate (ClapperPlayer *self, guint *internal_ptr,
  * Set initial bitrate to select when starting adaptive
  * streaming such as DASH or HLS.
  *
+ * Once set, it is used instead of bandwidth estimate that
+ * player keeps for recently streamed hosts.
+ *
  * Since: 0.8
  */
 void
@@ -1824,6 +2595,10 @@ clapper_player_set_adaptive_start_bitrate (ClapperPlayer *self, guint bitrate)
 {
   g_return_if_fail (CLAPPER_IS_PLAYER (self));
 
+  GST_OBJECT_LOCK (self);
+  self->start_bitrate_set = TRUE;
+  GST_OBJECT_UNLOCK (self);
+
   _set_adaptive_bitrate (self, &self->start_bitrate,
       "start-bitrate", bitrate, param_specs[PROP_ADAPTIVE_START_BITRATE]);
 }
@@ -2102,6 +2877,542 @@ clapper_player_get_subtitle_font_desc (ClapperPlayer *self)
   return font_desc;
 }
 
+/**
+ * clapper_player_set_position_update_interval:
+ * @player: a #ClapperPlayer
+ * @interval: update interval in milliseconds or 0 for automatic
+ *
+ * Set how often [property@Clapper.Player:position] should be updated
+ * during playback.
+ *
+ * Updates are aligned to multiples of @interval, so applications that
+ * only display whole seconds can set it to `1000` to be notified right
+ * after each second passes while avoiding needless wakeups.
+ *
+ * When nothing observes position changes (no position notify handlers,
+ * features or reactables), player updates it at most once per second,
+ * while [method@Clapper.Player.get_position] still interpolates it.
+ *
+ * Since: 0.12
+ */
+void
+clapper_player_set_position_update_interval (ClapperPlayer *self, guint interval)
+{
+  gboolean changed;
+
+  g_return_if_fail (CLAPPER_IS_PLAYER (self));
+
+  GST_OBJECT_LOCK (self);
+  if ((changed = self->position_update_interval != interval))
+    self->position_update_interval = interval;
+  GST_OBJECT_UNLOCK (self);
+
+  if (changed) {
+    clapper_app_bus_post_prop_notify (self->app_bus,
+        GST_OBJECT_CAST (self), param_specs[PROP_POSITION_UPDATE_INTERVAL]);
+  }
+}
+
+/**
+ * clapper_player_get_position_update_interval:
+ * @player: a #ClapperPlayer
+ *
+ * Get interval in which position is updated during playback.
+ *
+ * Returns: update interval in milliseconds, 0 when automatic.
+ *
+ * Since: 0.12
+ */
+guint
+clapper_player_get_position_update_interval (ClapperPlayer *self)
+{
+  guint interval;
+
+  g_return_val_if_fail (CLAPPER_IS_PLAYER (self), DEFAULT_POSITION_UPDATE_INTERVAL);
+
+  GST_OBJECT_LOCK (self);
+  interval = self->position_update_interval;
+  GST_OBJECT_UNLOCK (self);
+
+  return interval;
+}
+
+/**
+ * clapper_player_set_scrubbing:
+ * @player: a #ClapperPlayer
+ * @scrubbing: %TRUE when user starts scrubbing, %FALSE when done
+ *
+ * Set whether user is currently scrubbing through media (e.g. dragging
+ * a seek bar) and rapidly requesting seeks to different positions.
+ *
+ * While scrubbing, player keeps at most one seek operation in progress,
+ * replacing any queued seek request with the latest position, and uses
+ * fast key unit seeking, so the displayed frame follows user input.
+ * When scrubbing ends, player does one accurate seek to the last
+ * requested position (unless it was requested with
+ * [enum@Clapper.PlayerSeekMethod.FAST] method).
+ *
+ * Since: 0.12
+ */
+static gboolean
+_set_scrubbing (ClapperPlayer *self, gboolean scrubbing,
+    gdouble position, ClapperPlayerSeekMethod method)
+{
+  gboolean changed;
+
+  GST_OBJECT_LOCK (self);
+  if ((changed = self->scrubbing != scrubbing))
+    self->scrubbing = scrubbing;
+  GST_OBJECT_UNLOCK (self);
+
+  if (changed) {
+    clapper_playbin_bus_post_scrub (self->bus, scrubbing, position, method);
+    clapper_app_bus_post_prop_notify (self->app_bus,
+        GST_OBJECT_CAST (self), param_specs[PROP_SCRUBBING]);
+  }
+
+  return changed;
+}
+
+void
+clapper_player_set_scrubbing (ClapperPlayer *self, gboolean scrubbing)
+{
+  g_return_if_fail (CLAPPER_IS_PLAYER (self));
+
+  _set_scrubbing (self, scrubbing, -1, CLAPPER_PLAYER_SEEK_METHOD_NORMAL);
+}
+
+/**
+ * clapper_player_finish_scrubbing:
+ * @player: a #ClapperPlayer
+ * @position: a decimal number with final position to seek to (in seconds)
+ * @method: a #ClapperPlayerSeekMethod
+ *
+ * Finish scrubbing with a single seek to given @position using @method.
+ *
+ * Unlike setting [property@Clapper.Player:scrubbing] to %FALSE, this does
+ * not seek again to the last position requested while scrubbing. Use it
+ * when final target or seek method differs from the ones used for preview
+ * (e.g. user dropped seek bar handle at a chapter marker).
+ *
+ * If player was not scrubbing, this behaves like [method@Clapper.Player.seek_custom].
+ *
+ * Since: 0.12
+ */
+void
+clapper_player_finish_scrubbing (ClapperPlayer *self, gdouble position, ClapperPlayerSeekMethod method)
+{
+  g_return_if_fail (CLAPPER_IS_PLAYER (self));
+  g_return_if_fail (position >= 0);
+
+  if (!_set_scrubbing (self, FALSE, position, method))
+    clapper_playbin_bus_post_seek (self->bus, position, method);
+}
+
+/**
+ * clapper_player_get_scrubbing:
+ * @player: a #ClapperPlayer
+ *
+ * Get whether player is in scrubbing mode.
+ *
+ * Returns: %TRUE if scrubbing, %FALSE otherwise.
+ *
+ * Since: 0.12
+ */
+gboolean
+clapper_player_get_scrubbing (ClapperPlayer *self)
+{
+  gboolean scrubbing;
+
+  g_return_val_if_fail (CLAPPER_IS_PLAYER (self), DEFAULT_SCRUBBING);
+
+  GST_OBJECT_LOCK (self);
+  scrubbing = self->scrubbing;
+  GST_OBJECT_UNLOCK (self);
+
+  return scrubbing;
+}
+
+/**
+ * clapper_player_get_seek_latency:
+ * @player: a #ClapperPlayer
+ *
+ * Get time it took to complete the last seek operation, counted
+ * from the moment seek was started until new position was prerolled.
+ *
+ * Returns: latency of the last seek in seconds, 0 if none was done yet.
+ *
+ * Since: 0.12
+ */
+gdouble
+clapper_player_get_seek_latency (ClapperPlayer *self)
+{
+  gdouble latency;
+
+  g_return_val_if_fail (CLAPPER_IS_PLAYER (self), 0);
+
+  GST_OBJECT_LOCK (self);
+  latency = self->seek_latency;
+  GST_OBJECT_UNLOCK (self);
+
+  return latency;
+}
+
+/**
+ * clapper_player_set_buffering_profile:
+ * @player: a #ClapperPlayer
+ * @profile: a #ClapperBufferingProfile
+ *
+ * Set buffering profile, which controls how much data player tries to
+ * keep buffered ahead of playback position when streaming from network.
+ *
+ * Selecting any profile other than [enum@Clapper.BufferingProfile.CUSTOM]
+ * also sets [property@Clapper.Player:buffering-low-watermark] and
+ * [property@Clapper.Player:buffering-high-watermark] to values of that
+ * profile. Setting any watermark directly switches to custom profile.
+ *
+ * Buffering profile is applied to adaptive streaming demuxers and
+ * to buffering of the next played media item (through `playbin`
+ * "buffer-duration" and `urisourcebin` watermark properties).
+ *
+ * Since: 0.12
+ */
+void
+clapper_player_set_buffering_profile (ClapperPlayer *self, ClapperBufferingProfile profile)
+{
+  gboolean changed;
+
+  g_return_if_fail (CLAPPER_IS_PLAYER (self));
+  g_return_if_fail (profile <= CLAPPER_BUFFERING_PROFILE_CUSTOM);
+
+  GST_OBJECT_LOCK (self);
+  if ((changed = self->buffering_profile != profile)) {
+    self->buffering_profile = profile;
+
+    if (profile != CLAPPER_BUFFERING_PROFILE_CUSTOM) {
+      self->buffering_low_watermark = buffering_presets[profile][0];
+      self->buffering_high_watermark = buffering_presets[profile][1];
+    }
+  }
+  GST_OBJECT_UNLOCK (self);
+
+  if (changed) {
+    GST_INFO_OBJECT (self, "Set buffering profile: %i", profile);
+
+    clapper_app_bus_post_prop_notify (self->app_bus,
+        GST_OBJECT_CAST (self), param_specs[PROP_BUFFERING_PROFILE]);
+
+    if (profile != CLAPPER_BUFFERING_PROFILE_CUSTOM) {
+      clapper_app_bus_post_prop_notify (self->app_bus,
+          GST_OBJECT_CAST (self), param_specs[PROP_BUFFERING_LOW_WATERMARK]);
+      clapper_app_bus_post_prop_notify (self->app_bus,
+          GST_OBJECT_CAST (self), param_specs[PROP_BUFFERING_HIGH_WATERMARK]);
+    }
+  }
+}
+
+/**
+ * clapper_player_get_buffering_profile:
+ * @player: a #ClapperPlayer
+ *
+ * Get currently used buffering profile.
+ *
+ * Returns: a #ClapperBufferingProfile.
+ *
+ * Since: 0.12
+ */
+ClapperBufferingProfile
+clapper_player_get_buffering_profile (ClapperPlayer *self)
+{
+  ClapperBufferingProfile profile;
+
+  g_return_val_if_fail (CLAPPER_IS_PLAYER (self), DEFAULT_BUFFERING_PROFILE);
+
+  GST_OBJECT_LOCK (self);
+  profile = self->buffering_profile;
+  GST_OBJECT_UNLOCK (self);
+
+  return profile;
+}
+
+static void
+_set_buffering_watermark (ClapperPlayer *self, gboolean is_low, gdouble watermark)
+{
+  gdouble *internal_ptr, *other_ptr;
+  GParamSpec *pspec, *other_pspec;
+  gboolean changed, other_changed = FALSE, profile_changed = FALSE;
+
+  if (is_low) {
+    internal_ptr = &self->buffering_low_watermark;
+    other_ptr = &self->buffering_high_watermark;
+    pspec = param_specs[PROP_BUFFERING_LOW_WATERMARK];
+    other_pspec = param_specs[PROP_BUFFERING_HIGH_WATERMARK];
+  } else {
+    internal_ptr = &self->buffering_high_watermark;
+    other_ptr = &self->buffering_low_watermark;
+    pspec = param_specs[PROP_BUFFERING_HIGH_WATERMARK];
+    other_pspec = param_specs[PROP_BUFFERING_LOW_WATERMARK];
+  }
+
+  GST_OBJECT_LOCK (self);
+  if ((changed = !G_APPROX_VALUE (*internal_ptr, watermark, FLT_EPSILON))) {
+    *internal_ptr = watermark;
+
+    /* Keep low <= high, moving the other watermark along */
+    if ((is_low && *other_ptr < watermark) || (!is_low && *other_ptr > watermark)) {
+      *other_ptr = watermark;
+      other_changed = TRUE;
+    }
+
+    if ((profile_changed = self->buffering_profile != CLAPPER_BUFFERING_PROFILE_CUSTOM))
+      self->buffering_profile = CLAPPER_BUFFERING_PROFILE_CUSTOM;
+  }
+  GST_OBJECT_UNLOCK (self);
+
+  if (changed) {
+    GST_INFO_OBJECT (self, "Set %s: %.2lf", pspec->name, watermark);
+
+    clapper_app_bus_post_prop_notify (self->app_bus, GST_OBJECT_CAST (self), pspec);
+
+    if (other_changed)
+      clapper_app_bus_post_prop_notify (self->app_bus, GST_OBJECT_CAST (self), other_pspec);
+
+    if (profile_changed) {
+      clapper_app_bus_post_prop_notify (self->app_bus,
+          GST_OBJECT_CAST (self), param_specs[PROP_BUFFERING_PROFILE]);
+    }
+  }
+}
+
+/**
+ * clapper_player_set_buffering_low_watermark:
+ * @player: a #ClapperPlayer
+ * @watermark: amount of buffered data in seconds
+ *
+ * Set amount of buffered data (in seconds) below which playback
+ * pauses to buffer more, switching to custom buffering profile.
+ *
+ * If @watermark is above [property@Clapper.Player:buffering-high-watermark],
+ * high watermark is raised to the same value.
+ *
+ * Since: 0.12
+ */
+void
+clapper_player_set_buffering_low_watermark (ClapperPlayer *self, gdouble watermark)
+{
+  g_return_if_fail (CLAPPER_IS_PLAYER (self));
+  g_return_if_fail (watermark >= 0);
+
+  _set_buffering_watermark (self, TRUE, watermark);
+}
+
+/**
+ * clapper_player_get_buffering_low_watermark:
+ * @player: a #ClapperPlayer
+ *
+ * Get low buffering watermark in seconds.
+ *
+ * Returns: low buffering watermark.
+ *
+ * Since: 0.12
+ */
+gdouble
+clapper_player_get_buffering_low_watermark (ClapperPlayer *self)
+{
+  gdouble watermark;
+
+  g_return_val_if_fail (CLAPPER_IS_PLAYER (self), 0);
+
+  GST_OBJECT_LOCK (self);
+  watermark = self->buffering_low_watermark;
+  GST_OBJECT_UNLOCK (self);
+
+  return watermark;
+}
+
+/**
+ * clapper_player_set_buffering_high_watermark:
+ * @player: a #ClapperPlayer
+ * @watermark: amount of buffered data in seconds
+ *
+ * Set amount of data (in seconds) that player tries to keep
+ * buffered ahead, switching to custom buffering profile.
+ *
+ * If @watermark is below [property@Clapper.Player:buffering-low-watermark],
+ * low watermark is lowered to the same value.
+ *
+ * Since: 0.12
+ */
+void
+clapper_player_set_buffering_high_watermark (ClapperPlayer *self, gdouble watermark)
+{
+  g_return_if_fail (CLAPPER_IS_PLAYER (self));
+  g_return_if_fail (watermark >= 0);
+
+  _set_buffering_watermark (self, FALSE, watermark);
+}
+
+/**
+ * clapper_player_get_buffering_high_watermark:
+ * @player: a #ClapperPlayer
+ *
+ * Get high buffering watermark in seconds.
+ *
+ * Returns: high buffering watermark.
+ *
+ * Since: 0.12
+ */
+gdouble
+clapper_player_get_buffering_high_watermark (ClapperPlayer *self)
+{
+  gdouble watermark;
+
+  g_return_val_if_fail (CLAPPER_IS_PLAYER (self), 0);
+
+  GST_OBJECT_LOCK (self);
+  watermark = self->buffering_high_watermark;
+  GST_OBJECT_UNLOCK (self);
+
+  return watermark;
+}
+
+/**
+ * clapper_player_set_adaptive_buffering:
+ * @player: a #ClapperPlayer
+ * @enabled: whether enabled
+ *
+ * Set whether player should adjust buffering watermarks
+ * of current profile based on observed rebuffering.
+ *
+ * When enabled, each time playback stalls to rebuffer, watermarks are
+ * widened (up to four times their configured values). After playback
+ * of an item went on for a while without any stalls, they are
+ * gradually narrowed back.
+ *
+ * Since: 0.12
+ */
+void
+clapper_player_set_adaptive_buffering (ClapperPlayer *self, gboolean enabled)
+{
+  gboolean changed;
+
+  g_return_if_fail (CLAPPER_IS_PLAYER (self));
+
+  GST_OBJECT_LOCK (self);
+  if ((changed = self->adaptive_buffering != enabled)) {
+    self->adaptive_buffering = enabled;
+    self->buffering_scale = 1.0;
+  }
+  GST_OBJECT_UNLOCK (self);
+
+  if (changed) {
+    clapper_app_bus_post_prop_notify (self->app_bus,
+        GST_OBJECT_CAST (self), param_specs[PROP_ADAPTIVE_BUFFERING]);
+  }
+}
+
+/**
+ * clapper_player_get_adaptive_buffering:
+ * @player: a #ClapperPlayer
+ *
+ * Get whether adaptive buffering is enabled.
+ *
+ * Returns: %TRUE if enabled, %FALSE otherwise.
+ *
+ * Since: 0.12
+ */
+gboolean
+clapper_player_get_adaptive_buffering (ClapperPlayer *self)
+{
+  gboolean enabled;
+
+  g_return_val_if_fail (CLAPPER_IS_PLAYER (self), DEFAULT_ADAPTIVE_BUFFERING);
+
+  GST_OBJECT_LOCK (self);
+  enabled = self->adaptive_buffering;
+  GST_OBJECT_UNLOCK (self);
+
+  return enabled;
+}
+
+/**
+ * clapper_player_get_startup_percentile:
+ * @player: a #ClapperPlayer
+ * @phase: a #ClapperStartupPhase
+ * @percentile: a percentile to get (from 0 to 100)
+ *
+ * Get startup time (in seconds) of given @phase, aggregated from
+ * all media items started by @player so far.
+ *
+ * Times are collected into logarithmic buckets (four per each doubling of
+ * time), so returned value is an upper bound of the bucket that holds
+ * requested @percentile. For example, to check how long it usually takes
+ * until video starts showing and how bad it gets at worst:
+ *
+ * ```c
+ * gdouble p50 = clapper_player_get_startup_percentile (player, CLAPPER_STARTUP_PHASE_FIRST_FRAME, 50);
+ * gdouble p95 = clapper_player_get_startup_percentile (player, CLAPPER_STARTUP_PHASE_FIRST_FRAME, 95);
+ * ```
+ *
+ * Returns: startup time of @phase in seconds or -1 if it was never reached.
+ *
+ * Since: 0.12
+ */
+gdouble
+clapper_player_get_startup_percentile (ClapperPlayer *self,
+    ClapperStartupPhase phase, gdouble percentile)
+{
+  gdouble time;
+
+  g_return_val_if_fail (CLAPPER_IS_PLAYER (self), -1);
+  g_return_val_if_fail (phase < CLAPPER_STARTUP_N_PHASES, -1);
+  g_return_val_if_fail (percentile >= 0 && percentile <= 100, -1);
+
+  GST_OBJECT_LOCK (self);
+  time = clapper_startup_histogram_get_percentile (self->startup_histogram, phase, percentile);
+  GST_OBJECT_UNLOCK (self);
+
+  return time;
+}
+
+/**
+ * clapper_player_get_playback_stats:
+ * @player: a #ClapperPlayer
+ *
+ * Get a snapshot of current playback health statistics, such as number
+ * of dropped frames, audio underruns or time spent rebuffering.
+ *
+ * This is cheap to call, so it can be polled periodically,
+ * as statistics are gathered while playing anyway.
+ *
+ * Returns: (transfer full): a #ClapperPlaybackStats snapshot.
+ *
+ * Since: 0.12
+ */
+ClapperPlaybackStats *
+clapper_player_get_playback_stats (ClapperPlayer *self)
+{
+  ClapperPlaybackStatsCounters counters;
+  ClapperPlaybackStats *stats;
+  GstElement *video_sink = NULL;
+
+  g_return_val_if_fail (CLAPPER_IS_PLAYER (self), NULL);
+
+  GST_OBJECT_LOCK (self);
+  counters = self->stats_counters;
+  if (self->stats_video_sink)
+    video_sink = gst_object_ref (self->stats_video_sink);
+  GST_OBJECT_UNLOCK (self);
+
+  clapper_app_bus_get_notify_counts (self->app_bus,
+      &counters.notifies_posted, &counters.notifies_coalesced);
+
+  stats = clapper_playback_stats_new (&counters, video_sink);
+  gst_clear_object (&video_sink);
+
+  return stats;
+}
+
 /**
  * clapper_player_play:
  * @player: a #ClapperPlayer
@@ -2370,6 +3681,7 @@ clapper_player_thread_stop (ClapperThreadedObject *threaded_object)
   GST_TRACE_OBJECT (threaded_object, "Player thread stop");
 
   clapper_player_remove_tick_source (self);
+  clapper_preloader_stop (self->preloader);
 
   gst_bus_set_flushing (self->bus, TRUE);
   gst_bus_remove_watch (self->bus);
@@ -2412,6 +3724,12 @@ clapper_player_init (ClapperPlayer *self)
     gst_object_set_parent (GST_OBJECT_CAST (self->reactables_manager), GST_OBJECT_CAST (self));
   }
 
+  self->preloader = clapper_preloader_new ();
+  gst_object_set_parent (GST_OBJECT_CAST (self->preloader), GST_OBJECT_CAST (self));
+
+  self->startup_histogram = clapper_startup_histogram_new ();
+  clapper_playback_stats_counters_reset (&self->stats_counters);
+
   self->position_query = gst_query_new_position (GST_FORMAT_TIME);
 
   self->current_state = GST_STATE_NULL;
@@ -2426,7 +3744,24 @@ clapper_player_init (ClapperPlayer *self)
   self->audio_enabled = DEFAULT_AUDIO_ENABLED;
   self->subtitles_enabled = DEFAULT_SUBTITLES_ENABLED;
   self->download_enabled = DEFAULT_DOWNLOAD_ENABLED;
+  self->media_cache_enabled = DEFAULT_MEDIA_CACHE_ENABLED;
+  self->media_cache_max_size = DEFAULT_MEDIA_CACHE_MAX_SIZE;
   self->start_bitrate = DEFAULT_ADAPTIVE_START_BITRATE;
+  self->position_update_interval = DEFAULT_POSITION_UPDATE_INTERVAL;
+  self->scrubbing = DEFAULT_SCRUBBING;
+  self->buffering_profile = DEFAULT_BUFFERING_PROFILE;
+  self->buffering_low_watermark = buffering_presets[DEFAULT_BUFFERING_PROFILE][0];
+  self->buffering_high_watermark = buffering_presets[DEFAULT_BUFFERING_PROFILE][1];
+  self->adaptive_buffering = DEFAULT_ADAPTIVE_BUFFERING;
+  self->buffering_scale = 1.0;
+  self->scrub_position = -1;
+  self->pending_seek_position = -1;
+  self->position_clock_time = GST_CLOCK_TIME_NONE;
+
+  self->snapshot.speed = self->speed;
+  self->snapshot.volume = self->volume;
+  self->snapshot.mute = self->mute;
+  self->snapshot.state = self->state;
 }
 
 static void
@@ -2486,14 +3821,22 @@ clapper_player_finalize (GObject *object)
   gst_object_unparent (GST_OBJECT_CAST (self->enhancer_proxies));
   gst_object_unref (self->enhancer_proxies);
 
+  gst_object_unparent (GST_OBJECT_CAST (self->preloader));
+  gst_object_unref (self->preloader);
+
   gst_query_unref (self->position_query);
 
   gst_clear_object (&self->collection);
   gst_clear_object (&self->features_manager);
   gst_clear_object (&self->pending_item);
   gst_clear_object (&self->played_item);
+  gst_clear_object (&self->startup_report);
+  gst_clear_object (&self->stats_video_sink);
+
+  clapper_startup_histogram_free (self->startup_histogram);
 
   g_free (self->download_dir);
+  g_free (self->adaptive_host);
 
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
@@ -2571,6 +3914,12 @@ clapper_player_get_property (GObject *object, guint prop_id,
     case PROP_DOWNLOAD_ENABLED:
       g_value_set_boolean (value, clapper_player_get_download_enabled (self));
       break;
+    case PROP_MEDIA_CACHE_ENABLED:
+      g_value_set_boolean (value, clapper_player_get_media_cache_enabled (self));
+      break;
+    case PROP_MEDIA_CACHE_MAX_SIZE:
+      g_value_set_uint64 (value, clapper_player_get_media_cache_max_size (self));
+      break;
     case PROP_ADAPTIVE_START_BITRATE:
       g_value_set_uint (value, clapper_player_get_adaptive_start_bitrate (self));
       break;
@@ -2592,6 +3941,27 @@ clapper_player_get_property (GObject *object, guint prop_id,
     case PROP_SUBTITLE_FONT_DESC:
       g_value_take_string (value, clapper_player_get_subtitle_font_desc (self));
       break;
+    case PROP_POSITION_UPDATE_INTERVAL:
+      g_value_set_uint (value, clapper_player_get_position_update_interval (self));
+      break;
+    case PROP_SCRUBBING:
+      g_value_set_boolean (value, clapper_player_get_scrubbing (self));
+      break;
+    case PROP_SEEK_LATENCY:
+      g_value_set_double (value, clapper_player_get_seek_latency (self));
+      break;
+    case PROP_BUFFERING_PROFILE:
+      g_value_set_enum (value, clapper_player_get_buffering_profile (self));
+      break;
+    case PROP_BUFFERING_LOW_WATERMARK:
+      g_value_set_double (value, clapper_player_get_buffering_low_watermark (self));
+      break;
+    case PROP_BUFFERING_HIGH_WATERMARK:
+      g_value_set_double (value, clapper_player_get_buffering_high_watermark (self));
+      break;
+    case PROP_ADAPTIVE_BUFFERING:
+      g_value_set_boolean (value, clapper_player_get_adaptive_buffering (self));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -2644,6 +4014,12 @@ clapper_player_set_property (GObject *object, guint prop_id,
     case PROP_DOWNLOAD_ENABLED:
       clapper_player_set_download_enabled (self, g_value_get_boolean (value));
       break;
+    case PROP_MEDIA_CACHE_ENABLED:
+      clapper_player_set_media_cache_enabled (self, g_value_get_boolean (value));
+      break;
+    case PROP_MEDIA_CACHE_MAX_SIZE:
+      clapper_player_set_media_cache_max_size (self, g_value_get_uint64 (value));
+      break;
     case PROP_ADAPTIVE_START_BITRATE:
       clapper_player_set_adaptive_start_bitrate (self, g_value_get_uint (value));
       break;
@@ -2662,6 +4038,24 @@ clapper_player_set_property (GObject *object, guint prop_id,
     case PROP_SUBTITLE_FONT_DESC:
       clapper_player_set_subtitle_font_desc (self, g_value_get_string (value));
       break;
+    case PROP_POSITION_UPDATE_INTERVAL:
+      clapper_player_set_position_update_interval (self, g_value_get_uint (value));
+      break;
+    case PROP_SCRUBBING:
+      clapper_player_set_scrubbing (self, g_value_get_boolean (value));
+      break;
+    case PROP_BUFFERING_PROFILE:
+      clapper_player_set_buffering_profile (self, g_value_get_enum (value));
+      break;
+    case PROP_BUFFERING_LOW_WATERMARK:
+      clapper_player_set_buffering_low_watermark (self, g_value_get_double (value));
+      break;
+    case PROP_BUFFERING_HIGH_WATERMARK:
+      clapper_player_set_buffering_high_watermark (self, g_value_get_double (value));
+      break;
+    case PROP_ADAPTIVE_BUFFERING:
+      clapper_player_set_adaptive_buffering (self, g_value_get_boolean (value));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -2918,6 +4312,29 @@ clapper_player_class_init (ClapperPlayerClass *klass)
       NULL, NULL, DEFAULT_DOWNLOAD_ENABLED,
       G_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY | G_PARAM_STATIC_STRINGS);
 
+  /**
+   * ClapperPlayer:media-cache-enabled:
+   *
+   * Whether to keep downloaded media in a managed cache
+   * and play it from there when played again.
+   *
+   * Since: 0.12
+   */
+  param_specs[PROP_MEDIA_CACHE_ENABLED] = g_param_spec_boolean ("media-cache-enabled",
+      NULL, NULL, DEFAULT_MEDIA_CACHE_ENABLED,
+      G_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY | G_PARAM_STATIC_STRINGS);
+
+  /**
+   * ClapperPlayer:media-cache-max-size:
+   *
+   * Total size (in bytes) up to which cached media is kept.
+   *
+   * Since: 0.12
+   */
+  param_specs[PROP_MEDIA_CACHE_MAX_SIZE] = g_param_spec_uint64 ("media-cache-max-size",
+      NULL, NULL, 0, G_MAXUINT64, DEFAULT_MEDIA_CACHE_MAX_SIZE,
+      G_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY | G_PARAM_STATIC_STRINGS);
+
   /**
    * ClapperPlayer:adaptive-start-bitrate:
    *
@@ -2927,6 +4344,12 @@ clapper_player_class_init (ClapperPlayerClass *klass)
    * If value is lower than the lowest available bitrate in streaming
    * manifest, then lowest possible bitrate will be selected.
    *
+   * When left unset, player starts with bitrate based on bandwidth it
+   * measured for given host before (also in previous sessions), so that
+   * the quality does not have to ramp up each time, and this value is
+   * only used for hosts that were not streamed from recently. Once set,
+   * it is always used instead of such estimate.
+   *
    * Since: 0.8
    */
   param_specs[PROP_ADAPTIVE_START_BITRATE] = g_param_spec_uint ("adaptive-start-bitrate",
@@ -3011,6 +4434,84 @@ clapper_player_class_init (ClapperPlayerClass *klass)
       NULL, NULL, NULL,
       G_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY | G_PARAM_STATIC_STRINGS);
 
+  /**
+   * ClapperPlayer:position-update-interval:
+   *
+   * Interval in milliseconds in which position is updated during
+   * playback, 0 to pick it automatically.
+   *
+   * Since: 0.12
+   */
+  param_specs[PROP_POSITION_UPDATE_INTERVAL] = g_param_spec_uint ("position-update-interval",
+      NULL, NULL, 0, G_MAXUINT, DEFAULT_POSITION_UPDATE_INTERVAL,
+      G_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY | G_PARAM_STATIC_STRINGS);
+
+  /**
+   * ClapperPlayer:scrubbing:
+   *
+   * Whether user is scrubbing through media with rapid seek requests.
+   *
+   * Since: 0.12
+   */
+  param_specs[PROP_SCRUBBING] = g_param_spec_boolean ("scrubbing",
+      NULL, NULL, DEFAULT_SCRUBBING,
+      G_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY | G_PARAM_STATIC_STRINGS);
+
+  /**
+   * ClapperPlayer:seek-latency:
+   *
+   * Time in seconds it took to complete the last seek operation.
+   *
+   * Since: 0.12
+   */
+  param_specs[PROP_SEEK_LATENCY] = g_param_spec_double ("seek-latency",
+      NULL, NULL, 0, G_MAXDOUBLE, 0,
+      G_PARAM_READABLE | G_PARAM_EXPLICIT_NOTIFY | G_PARAM_STATIC_STRINGS);
+
+  /**
+   * ClapperPlayer:buffering-profile:
+   *
+   * Profile of buffering used for network streams.
+   *
+   * Since: 0.12
+   */
+  param_specs[PROP_BUFFERING_PROFILE] = g_param_spec_enum ("buffering-profile",
+      NULL, NULL, CLAPPER_TYPE_BUFFERING_PROFILE, DEFAULT_BUFFERING_PROFILE,
+      G_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY | G_PARAM_STATIC_STRINGS);
+
+  /**
+   * ClapperPlayer:buffering-low-watermark:
+   *
+   * Amount of buffered data in seconds below which playback pauses to buffer.
+   *
+   * Since: 0.12
+   */
+  param_specs[PROP_BUFFERING_LOW_WATERMARK] = g_param_spec_double ("buffering-low-watermark",
+      NULL, NULL, 0, G_MAXDOUBLE, buffering_presets[DEFAULT_BUFFERING_PROFILE][0],
+      G_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY | G_PARAM_STATIC_STRINGS);
+
+  /**
+   * ClapperPlayer:buffering-high-watermark:
+   *
+   * Amount of data in seconds that player tries to keep buffered ahead.
+   *
+   * Since: 0.12
+   */
+  param_specs[PROP_BUFFERING_HIGH_WATERMARK] = g_param_spec_double ("buffering-high-watermark",
+      NULL, NULL, 0, G_MAXDOUBLE, buffering_presets[DEFAULT_BUFFERING_PROFILE][1],
+      G_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY | G_PARAM_STATIC_STRINGS);
+
+  /**
+   * ClapperPlayer:adaptive-buffering:
+   *
+   * Whether to adjust buffering watermarks based on observed rebuffering.
+   *
+   * Since: 0.12
+   */
+  param_specs[PROP_ADAPTIVE_BUFFERING] = g_param_spec_boolean ("adaptive-buffering",
+      NULL, NULL, DEFAULT_ADAPTIVE_BUFFERING,
+      G_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY | G_PARAM_STATIC_STRINGS);
+
   /**
    * ClapperPlayer::seek-done:
    * @player: a #ClapperPlayer
@@ -3040,6 +4541,25 @@ clapper_player_class_init (ClapperPlayerClass *klass)
       G_TYPE_FROM_CLASS (klass), G_SIGNAL_RUN_LAST | G_SIGNAL_NO_RECURSE | G_SIGNAL_NO_HOOKS,
       0, NULL, NULL, NULL, G_TYPE_NONE, 2, CLAPPER_TYPE_MEDIA_ITEM, G_TYPE_STRING);
 
+  /**
+   * ClapperPlayer::startup-report:
+   * @player: a #ClapperPlayer
+   * @report: a #ClapperStartupReport
+   *
+   * Startup of a media item has finished. The @report describes
+   * how long it took to reach each [enum@Clapper.StartupPhase].
+   *
+   * This is emitted once for each selected item, after its pipeline
+   * prerolled (or first frame was shown for gapless playback). Items that
+   * were changed before that still get a report, with only the phases
+   * they managed to reach being set.
+   *
+   * Since: 0.12
+   */
+  signals[SIGNAL_STARTUP_REPORT] = g_signal_new ("startup-report",
+      G_TYPE_FROM_CLASS (klass), G_SIGNAL_RUN_LAST | G_SIGNAL_NO_RECURSE | G_SIGNAL_NO_HOOKS,
+      0, NULL, NULL, NULL, G_TYPE_NONE, 1, CLAPPER_TYPE_STARTUP_REPORT);
+
   /**
    * ClapperPlayer::missing-plugin:
    * @player: a #ClapperPlayer
@@ -3108,6 +4628,8 @@ clapper_player_class_init (ClapperPlayerClass *klass)
 
   g_object_class_install_properties (gobject_class, PROP_LAST, param_specs);
 
+  notify_signal_id = g_signal_lookup ("notify", G_TYPE_OBJECT);
+
   threaded_object->thread_start = clapper_player_thread_start;
   threaded_object->thread_stop = clapper_player_thread_stop;
 }
@@ -32,6 +32,7 @@
 #include <clapper/clapper-stream-list.h>
 #include <clapper/clapper-enhancer-proxy-list.h>
 #include <clapper/clapper-feature.h>
+#include <clapper/clapper-playback-stats.h>
 #include <clapper/clapper-enums.h>
 
 G_BEGIN_DECLS
@@ -42,6 +43,37 @@ G_BEGIN_DECLS
 CLAPPER_API
 G_DECLARE_FINAL_TYPE (ClapperPlayer, clapper_player, CLAPPER, PLAYER, ClapperThreadedObject)
 
+typedef struct _ClapperPlayerSnapshot ClapperPlayerSnapshot;
+
+/**
+ * ClapperPlayerSnapshot:
+ * @position: playback position in seconds
+ * @duration: duration of the played item in seconds
+ * @state: a #ClapperPlayerState
+ * @speed: playback speed
+ * @volume: playback volume
+ * @mute: whether playback is muted
+ * @item_id: ID of the played item or 0 if none
+ *
+ * A consistent view of the most commonly read player state,
+ * filled by [method@Clapper.Player.get_snapshot].
+ *
+ * Since: 0.12
+ */
+struct _ClapperPlayerSnapshot
+{
+  gdouble position;
+  gdouble duration;
+  ClapperPlayerState state;
+  gdouble speed;
+  gdouble volume;
+  gboolean mute;
+  guint item_id;
+
+  /*< private >*/
+  gpointer _padding[4];
+};
+
 CLAPPER_API
 ClapperPlayer * clapper_player_new (void);
 
@@ -72,6 +104,9 @@ gdouble clapper_player_get_position (ClapperPlayer *player);
 CLAPPER_API
 ClapperPlayerState clapper_player_get_state (ClapperPlayer *player);
 
+CLAPPER_API
+void clapper_player_get_snapshot (ClapperPlayer *player, ClapperPlayerSnapshot *snapshot);
+
 CLAPPER_API
 void clapper_player_set_mute (ClapperPlayer *player, gboolean mute);
 
@@ -150,6 +185,18 @@ void clapper_player_set_download_enabled (ClapperPlayer *player, gboolean enable
 CLAPPER_API
 gboolean clapper_player_get_download_enabled (ClapperPlayer *player);
 
+CLAPPER_API
+void clapper_player_set_media_cache_enabled (ClapperPlayer *player, gboolean enabled);
+
+CLAPPER_API
+gboolean clapper_player_get_media_cache_enabled (ClapperPlayer *player);
+
+CLAPPER_API
+void clapper_player_set_media_cache_max_size (ClapperPlayer *player, guint64 size);
+
+CLAPPER_API
+guint64 clapper_player_get_media_cache_max_size (ClapperPlayer *player);
+
 CLAPPER_API
 void clapper_player_set_adaptive_start_bitrate (ClapperPlayer *player, guint bitrate);
 
@@ -189,6 +236,54 @@ void clapper_player_set_subtitle_font_desc (ClapperPlayer *player, const gchar *
 CLAPPER_API
 gchar * clapper_player_get_subtitle_font_desc (ClapperPlayer *player);
 
+CLAPPER_API
+void clapper_player_set_position_update_interval (ClapperPlayer *player, guint interval);
+
+CLAPPER_API
+guint clapper_player_get_position_update_interval (ClapperPlayer *player);
+
+CLAPPER_API
+void clapper_player_set_scrubbing (ClapperPlayer *player, gboolean scrubbing);
+
+CLAPPER_API
+gboolean clapper_player_get_scrubbing (ClapperPlayer *player);
+
+CLAPPER_API
+void clapper_player_finish_scrubbing (ClapperPlayer *player, gdouble position, ClapperPlayerSeekMethod method);
+
+CLAPPER_API
+gdouble clapper_player_get_seek_latency (ClapperPlayer *player);
+
+CLAPPER_API
+void clapper_player_set_buffering_profile (ClapperPlayer *player, ClapperBufferingProfile profile);
+
+CLAPPER_API
+ClapperBufferingProfile clapper_player_get_buffering_profile (ClapperPlayer *player);
+
+CLAPPER_API
+void clapper_player_set_buffering_low_watermark (ClapperPlayer *player, gdouble watermark);
+
+CLAPPER_API
+gdouble clapper_player_get_buffering_low_watermark (ClapperPlayer *player);
+
+CLAPPER_API
+void clapper_player_set_buffering_high_watermark (ClapperPlayer *player, gdouble watermark);
+
+CLAPPER_API
+gdouble clapper_player_get_buffering_high_watermark (ClapperPlayer *player);
+
+CLAPPER_API
+void clapper_player_set_adaptive_buffering (ClapperPlayer *player, gboolean enabled);
+
+CLAPPER_API
+gboolean clapper_player_get_adaptive_buffering (ClapperPlayer *player);
+
+CLAPPER_API
+gdouble clapper_player_get_startup_percentile (ClapperPlayer *player, ClapperStartupPhase phase, gdouble percentile);
+
+CLAPPER_API
+ClapperPlaybackStats * clapper_player_get_playback_stats (ClapperPlayer *player);
+
 CLAPPER_API
 void clapper_player_play (ClapperPlayer *player);
 
@@ -0,0 +1,45 @@
+/* Clapper Playback Library
+ * Copyright (C) 2025 Rafał Dzięgiel <rafostar.github@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <glib.h>
+#include <gst/gst.h>
+
+#include "clapper-media-item.h"
+
+G_BEGIN_DECLS
+
+#define CLAPPER_TYPE_PRELOADER (clapper_preloader_get_type())
+#define CLAPPER_PRELOADER_CAST(obj) ((ClapperPreloader *)(obj))
+
+G_DECLARE_FINAL_TYPE (ClapperPreloader, clapper_preloader, CLAPPER, PRELOADER, GstObject)
+
+G_GNUC_INTERNAL
+ClapperPreloader * clapper_preloader_new (void);
+
+G_GNUC_INTERNAL
+void clapper_preloader_schedule_refresh (ClapperPreloader *preloader);
+
+G_GNUC_INTERNAL
+void clapper_preloader_stop (ClapperPreloader *preloader);
+
+G_GNUC_INTERNAL
+gint64 clapper_preloader_take_warmup_request_latency (ClapperPreloader *preloader, ClapperMediaItem *item);
+
+G_END_DECLS
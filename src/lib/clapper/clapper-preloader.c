@@ -0,0 +1,772 @@
+/* Clapper Playback Library
+ * Copyright (C) 2025 Rafał Dzięgiel <rafostar.github@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Preloader fetches the beginning of upcoming queue items in the background.
+ * Only a source element is started for each of them, without any demuxing
+ * or decoding, so no decoders (including hardware ones) are taken and only
+ * a small amount of data is transferred. Starting the source runs extraction
+ * (storing its results in cache), brings local files into page cache and
+ * opens connections within the shared HTTP session. Fetched data itself is
+ * discarded right away. Works on player thread only.
+ *
+ * No ready pipeline is swapped into player, when queue progresses to
+ * a preloaded item, playbin still opens, demuxes and decodes it. What
+ * is saved is only the time spent waiting for source (extraction,
+ * disk reads, connection setup) before that.
+ *
+ * When the next item is not preloaded, it can be warmed up instead. This
+ * is the same kind of fetch, but only for plain network URIs, with
+ * a configurable size (headers only by default) and done shortly before
+ * current item ends, so server does not close connection for being idle.
+ */
+
+#include "clapper-preloader-private.h"
+#include "clapper-player-private.h"
+#include "clapper-queue-private.h"
+#include "clapper-media-item-private.h"
+#include "clapper-http-context-private.h"
+#include "clapper-media-cache-private.h"
+#include "clapper-utils-private.h"
+
+/* Amount of data fetched from the beginning of each preloaded item */
+#define PRELOAD_PREFETCH_SIZE (512 * 1024)
+
+/* Rough cost of source element with its buffers, counted
+ * against preload fetch limit together with fetched data */
+#define PRELOAD_BASE_COST (256 * 1024)
+
+#define PRELOAD_COST (PRELOAD_BASE_COST + PRELOAD_PREFETCH_SIZE)
+
+#define MAX_FAILED_IDS 64
+
+/* Seconds before the end of current item to warm up the next one */
+#define WARMUP_LEAD_TIME 10
+
+#define GST_CAT_DEFAULT clapper_preloader_debug
+GST_DEBUG_CATEGORY_STATIC (GST_CAT_DEFAULT);
+
+typedef struct
+{
+  ClapperPreloader *preloader; // not owned, outlives entries
+  guint item_id;
+  gboolean is_warmup;
+  guint64 prefetch_size;
+  GstElement *pipeline; // NULL once done
+  gboolean reusable; // response is read till its end
+  gboolean failed;
+} ClapperPrefetchEntry;
+
+/* Owned by probe, as streaming thread might outlive entry */
+typedef struct
+{
+  guint64 prefetch_size;
+  guint64 received;
+  gint64 start_time;
+  gboolean finished;
+} ClapperPrefetchProbeData;
+
+struct _ClapperPreloader
+{
+  GstObject parent;
+
+  GPtrArray *entries;
+  GHashTable *failed_ids;
+  gint stopped; // atomic
+
+  ClapperPrefetchEntry *warmup;
+  GSource *warmup_source; // refresh at warm-up time
+
+  /* Warm-up request of the item, with object lock. This is what the warm-up
+   * took, not what it saved, as the latter cannot be measured. */
+  guint warmed_id;
+  gint64 warmed_latency; // first byte latency of warm-up request, -1 when none
+
+  gint n_entries; // atomic, for checks from other threads
+  gint refresh_scheduled; // atomic
+};
+
+#define parent_class clapper_preloader_parent_class
+G_DEFINE_TYPE (ClapperPreloader, clapper_preloader, GST_TYPE_OBJECT);
+
+static void
+_pipeline_shutdown_func (GstElement *pipeline, gpointer user_data G_GNUC_UNUSED)
+{
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+}
+
+static void
+_prefetch_shutdown (ClapperPrefetchEntry *entry)
+{
+  GstBus *bus;
+
+  if (!entry->pipeline)
+    return;
+
+  bus = gst_pipeline_get_bus (GST_PIPELINE_CAST (entry->pipeline));
+  gst_bus_set_flushing (bus, TRUE);
+  gst_bus_remove_watch (bus);
+  gst_object_unref (bus);
+
+  /* Shutting down might block, so do that outside of player thread */
+  gst_element_call_async (entry->pipeline,
+      (GstElementCallAsyncFunc) _pipeline_shutdown_func, NULL, NULL);
+
+  gst_clear_object (&entry->pipeline);
+}
+
+static void
+_prefetch_free (ClapperPrefetchEntry *entry)
+{
+  GST_DEBUG ("Removing %s of item: %u",
+      (entry->is_warmup) ? "warm-up" : "preload", entry->item_id);
+
+  _prefetch_shutdown (entry);
+  g_free (entry);
+}
+
+static GstPadProbeReturn
+_prefetch_probe_cb (GstPad *pad, GstPadProbeInfo *info, ClapperPrefetchProbeData *data)
+{
+  GstElement *src;
+  gint64 latency;
+
+  if (data->finished)
+    return (info->type & GST_PAD_PROBE_TYPE_BUFFER) ? GST_PAD_PROBE_DROP : GST_PAD_PROBE_OK;
+
+  if (info->type & GST_PAD_PROBE_TYPE_BUFFER) {
+    gboolean first = (data->received == 0);
+
+    data->received += gst_buffer_get_size (GST_PAD_PROBE_INFO_BUFFER (info));
+    data->finished = (data->received >= data->prefetch_size);
+
+    /* Data is not needed by anything, so it is dropped right away */
+    if (!first && !data->finished)
+      return GST_PAD_PROBE_DROP;
+
+    /* First byte is what player would have waited for */
+    latency = (first) ? g_get_monotonic_time () - data->start_time : -1;
+  } else if (GST_EVENT_TYPE (GST_PAD_PROBE_INFO_EVENT (info)) == GST_EVENT_EOS) {
+    /* Response without body (headers only) or very short media */
+    latency = (data->received == 0) ? g_get_monotonic_time () - data->start_time : -1;
+    data->finished = TRUE;
+  } else {
+    return GST_PAD_PROBE_OK;
+  }
+
+  src = gst_pad_get_parent_element (pad);
+  gst_element_post_message (src, gst_message_new_application (GST_OBJECT_CAST (src),
+      gst_structure_new ("ClapperPrefetchProgress",
+          "latency", G_TYPE_INT64, latency,
+          "finished", G_TYPE_BOOLEAN, data->finished, NULL)));
+  gst_object_unref (src);
+
+  return (info->type & GST_PAD_PROBE_TYPE_BUFFER) ? GST_PAD_PROBE_DROP : GST_PAD_PROBE_OK;
+}
+
+/*
+ * Connection goes back to session pool only when response is read till
+ * its end. With a ranged request this means that server must have honored
+ * the range or sent no more than requested, otherwise reading stops early
+ * and connection is closed together with the source.
+ */
+static gboolean
+_prefetch_check_headers (ClapperPrefetchEntry *entry, const GstStructure *structure)
+{
+  const GValue *value;
+  const gchar *length_str;
+  guint64 length;
+  guint status = 0;
+
+  /* Response to HEAD request has no body */
+  if (entry->prefetch_size == 0)
+    return TRUE;
+
+  gst_structure_get_uint (structure, "http-status-code", &status);
+
+  if (status == 206)
+    return TRUE;
+
+  if ((value = gst_structure_get_value (structure, "response-headers"))
+      && G_VALUE_HOLDS (value, GST_TYPE_STRUCTURE)
+      && (length_str = clapper_utils_find_http_header (gst_value_get_structure (value), "Content-Length"))
+      && g_ascii_string_to_unsigned (length_str, 10, 0, G_MAXUINT64, &length, NULL))
+    return (length <= entry->prefetch_size);
+
+  return FALSE;
+}
+
+static gboolean
+_prefetch_bus_message_cb (GstBus *bus G_GNUC_UNUSED, GstMessage *msg, ClapperPrefetchEntry *entry)
+{
+  switch (GST_MESSAGE_TYPE (msg)) {
+    case GST_MESSAGE_ELEMENT:{
+      const GstStructure *structure = gst_message_get_structure (msg);
+
+      if (!gst_structure_has_name (structure, "http-headers"))
+        break;
+
+      /* Confirms that previously downloaded copy can still be played */
+      clapper_media_cache_handle_http_headers (structure);
+
+      /* Reading more of the response would not make its connection reusable,
+       * only waste bandwidth. Host is still resolved and TLS session cached. */
+      if (!(entry->reusable = _prefetch_check_headers (entry, structure))) {
+        GST_DEBUG ("Server did not honor range request of item: %u,"
+            " connection will not be reused", entry->item_id);
+        _prefetch_shutdown (entry);
+      }
+      break;
+    }
+    case GST_MESSAGE_APPLICATION:{
+      const GstStructure *structure = gst_message_get_structure (msg);
+      gint64 latency = -1;
+      gboolean finished = FALSE;
+
+      if (!gst_structure_has_name (structure, "ClapperPrefetchProgress"))
+        break;
+
+      gst_structure_get_int64 (structure, "latency", &latency);
+      gst_structure_get_boolean (structure, "finished", &finished);
+
+      if (latency >= 0) {
+        GST_INFO ("Started %s of item: %u, first byte latency: %" G_GINT64_FORMAT " ms",
+            (entry->is_warmup) ? "warm-up" : "preload", entry->item_id, latency / 1000);
+
+        /* Headers come before data, so it is already known
+         * whether playback can reuse warmed up connection */
+        if (entry->is_warmup && entry->reusable) {
+          ClapperPreloader *self = entry->preloader;
+
+          GST_OBJECT_LOCK (self);
+          self->warmed_id = entry->item_id;
+          self->warmed_latency = latency;
+          GST_OBJECT_UNLOCK (self);
+        }
+      }
+
+      /* Whole response was read (requested range or short body, checked
+       * with headers), so its connection can return to session pool.
+       * Entry is kept, so the same item is not fetched again. */
+      if (finished)
+        _prefetch_shutdown (entry);
+      break;
+    }
+    case GST_MESSAGE_HAVE_CONTEXT:{
+      GstContext *context;
+
+      gst_message_parse_have_context (msg, &context);
+      clapper_http_context_offer (context);
+      gst_context_unref (context);
+      break;
+    }
+    case GST_MESSAGE_ERROR:{
+      GError *error = NULL;
+
+      gst_message_parse_error (msg, &error, NULL);
+      GST_DEBUG ("%s of item: %u failed: %s",
+          (entry->is_warmup) ? "Warm-up" : "Preload", entry->item_id, error->message);
+      g_error_free (error);
+
+      _prefetch_shutdown (entry);
+
+      if (!entry->is_warmup) {
+        entry->failed = TRUE;
+        clapper_preloader_schedule_refresh (entry->preloader);
+      }
+      break;
+    }
+    default:
+      break;
+  }
+
+  return G_SOURCE_CONTINUE;
+}
+
+static inline gboolean
+_has_property (GstElement *element, const gchar *name)
+{
+  return (g_object_class_find_property (G_OBJECT_GET_CLASS (element), name) != NULL);
+}
+
+/*
+ * Starts a source for @uri and reads @prefetch_size bytes from it.
+ * When zero, only response headers are requested if source supports that.
+ */
+static ClapperPrefetchEntry *
+_prefetch_new (ClapperPreloader *self, guint item_id, const gchar *uri,
+    guint64 prefetch_size, gboolean is_warmup)
+{
+  ClapperPrefetchEntry *entry;
+  ClapperPrefetchProbeData *data;
+  GstElement *src, *sink;
+  GstContext *context;
+  GError *error = NULL;
+  GstPad *pad;
+  GstBus *bus;
+
+  if (!(src = gst_element_make_from_uri (GST_URI_SRC, uri, NULL, &error))) {
+    GST_DEBUG_OBJECT (self, "No source for item: %u, reason: %s",
+        item_id, (error) ? error->message : "unknown");
+    g_clear_error (&error);
+
+    return NULL;
+  }
+
+  if (G_UNLIKELY (!(sink = gst_element_factory_make ("fakesink", NULL)))) {
+    gst_object_unref (src);
+    return NULL;
+  }
+
+  GST_DEBUG_OBJECT (self, "Starting %s of item: %u",
+      (is_warmup) ? "warm-up" : "preload", item_id);
+
+  entry = g_new0 (ClapperPrefetchEntry, 1);
+  entry->preloader = self;
+  entry->item_id = item_id;
+  entry->is_warmup = is_warmup;
+  entry->prefetch_size = prefetch_size;
+
+  /* Not placed within player, so elements inside do not act on it */
+  entry->pipeline = gst_object_ref_sink (gst_pipeline_new (NULL));
+
+  if (_has_property (src, "keep-alive"))
+    g_object_set (src, "keep-alive", TRUE, NULL);
+
+  if (prefetch_size > 0) {
+    /* Ask only for what will be read, so response can be
+     * fully consumed and its connection reused */
+    if (_has_property (src, "extra-headers")) {
+      GstStructure *headers;
+      gchar *range;
+
+      range = g_strdup_printf ("bytes=0-%" G_GUINT64_FORMAT, prefetch_size - 1);
+      headers = gst_structure_new ("extra-headers", "Range", G_TYPE_STRING, range, NULL);
+      g_object_set (src, "extra-headers", headers, NULL);
+
+      gst_structure_free (headers);
+      g_free (range);
+    }
+  } else if (_has_property (src, "method")) {
+    g_object_set (src, "method", "HEAD", NULL);
+  }
+
+  /* Connection needs to be opened within session that player will use */
+  if ((context = clapper_http_context_get ())) {
+    gst_element_set_context (src, context);
+    gst_context_unref (context);
+  }
+
+  g_object_set (sink, "sync", FALSE, NULL);
+
+  gst_bin_add_many (GST_BIN_CAST (entry->pipeline), src, sink, NULL);
+  gst_element_link (src, sink);
+
+  data = g_new0 (ClapperPrefetchProbeData, 1);
+  data->prefetch_size = prefetch_size;
+  data->start_time = g_get_monotonic_time ();
+
+  pad = gst_element_get_static_pad (src, "src");
+  gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_BUFFER | GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM,
+      (GstPadProbeCallback) _prefetch_probe_cb, data, g_free);
+  gst_object_unref (pad);
+
+  /* Watch is attached to player thread context */
+  bus = gst_pipeline_get_bus (GST_PIPELINE_CAST (entry->pipeline));
+  gst_bus_add_watch (bus, (GstBusFunc) _prefetch_bus_message_cb, entry);
+  gst_object_unref (bus);
+
+  if (gst_element_set_state (entry->pipeline, GST_STATE_PLAYING) == GST_STATE_CHANGE_FAILURE) {
+    _prefetch_free (entry);
+
+    return NULL;
+  }
+
+  return entry;
+}
+
+static inline gboolean
+_warmup_flags_have_mode (ClapperQueueWarmupFlags flags, ClapperQueueProgressionMode mode)
+{
+  switch (mode) {
+    case CLAPPER_QUEUE_PROGRESSION_NONE:
+      return (flags & CLAPPER_QUEUE_WARMUP_PROGRESSION_NONE) != 0;
+    case CLAPPER_QUEUE_PROGRESSION_CONSECUTIVE:
+      return (flags & CLAPPER_QUEUE_WARMUP_PROGRESSION_CONSECUTIVE) != 0;
+    case CLAPPER_QUEUE_PROGRESSION_CAROUSEL:
+      return (flags & CLAPPER_QUEUE_WARMUP_PROGRESSION_CAROUSEL) != 0;
+    default:
+      return FALSE;
+  }
+}
+
+static gboolean
+_warmup_timeout_cb (ClapperPreloader *self)
+{
+  g_clear_pointer (&self->warmup_source, g_source_unref);
+  clapper_preloader_schedule_refresh (self);
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+_clear_warmup_source (ClapperPreloader *self)
+{
+  if (self->warmup_source) {
+    g_source_destroy (self->warmup_source);
+    g_clear_pointer (&self->warmup_source, g_source_unref);
+  }
+}
+
+/*
+ * Returns time (in seconds) until next item should be warmed up.
+ * Live and unknown duration media has no known end, so it is now.
+ */
+static gdouble
+_get_time_until_warmup (ClapperPlayer *player)
+{
+  ClapperMediaItem *current_item;
+  gdouble duration = 0, speed;
+
+  if ((current_item = clapper_queue_get_current_item (player->queue))) {
+    duration = clapper_media_item_get_duration (current_item);
+    gst_object_unref (current_item);
+  }
+
+  if (duration <= 0)
+    return 0;
+
+  speed = clapper_player_get_speed (player);
+
+  return (duration - clapper_player_get_position (player)) / MAX (speed, 0.01) - WARMUP_LEAD_TIME;
+}
+
+static void
+_refresh_warmup (ClapperPreloader *self, const ClapperQueueUpcoming *next,
+    guint prefetch_size, gdouble delay)
+{
+  _clear_warmup_source (self);
+
+  if (self->warmup && next && self->warmup->item_id == next->id)
+    return;
+
+  g_clear_pointer (&self->warmup, _prefetch_free);
+
+  if (!next)
+    return;
+
+  /* Refreshed on each seek and state change, so remaining time stays
+   * correct, but timeout also rechecks it when the time comes */
+  if (delay > 0) {
+    ClapperPlayer *player;
+
+    if (!(player = CLAPPER_PLAYER_CAST (gst_object_get_parent (GST_OBJECT_CAST (self)))))
+      return;
+
+    GST_LOG_OBJECT (self, "Warm-up of item: %u in %.1lfs", next->id, delay);
+
+    self->warmup_source = g_timeout_source_new ((guint) (delay * 1000) + 1);
+    g_source_set_priority (self->warmup_source, G_PRIORITY_LOW);
+    g_source_set_callback (self->warmup_source, (GSourceFunc) _warmup_timeout_cb,
+        gst_object_ref (self), (GDestroyNotify) gst_object_unref);
+    g_source_attach (self->warmup_source,
+        clapper_threaded_object_get_context (CLAPPER_THREADED_OBJECT_CAST (player)));
+
+    gst_object_unref (player);
+    return;
+  }
+
+  /* Only plain network URIs, others need
+   * extraction first (or are not remote) */
+  if (!gst_uri_has_protocol (next->uri, "http") && !gst_uri_has_protocol (next->uri, "https"))
+    return;
+
+  self->warmup = _prefetch_new (self, next->id, next->uri,
+      (guint64) prefetch_size * 1024, TRUE);
+}
+
+static gboolean
+_find_entry_for_id (GPtrArray *entries, guint item_id, guint *index)
+{
+  guint i;
+
+  for (i = 0; i < entries->len; ++i) {
+    ClapperPrefetchEntry *entry = g_ptr_array_index (entries, i);
+
+    if (entry->item_id == item_id) {
+      if (index)
+        *index = i;
+
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+static inline void
+_mark_failed (ClapperPreloader *self, guint item_id)
+{
+  if (g_hash_table_size (self->failed_ids) >= MAX_FAILED_IDS)
+    g_hash_table_remove_all (self->failed_ids);
+
+  g_hash_table_add (self->failed_ids, GUINT_TO_POINTER (item_id));
+}
+
+static void
+_refresh (ClapperPreloader *self)
+{
+  ClapperPlayer *player;
+  const ClapperQueueUpcoming *warmup_next = NULL;
+  GArray *upcoming = NULL;
+  GPtrArray *entries;
+  ClapperPlayerState state;
+  guint64 limit, total = 0;
+  guint i, max_items, prefetch_size;
+  gdouble warmup_delay = 0;
+  gboolean warmup;
+
+  if (!(player = CLAPPER_PLAYER_CAST (gst_object_get_parent (GST_OBJECT_CAST (self)))))
+    return;
+
+  max_items = clapper_queue_get_preload_items (player->queue);
+  limit = (guint64) clapper_queue_get_preload_fetch_limit (player->queue) * 1024 * 1024;
+  warmup = _warmup_flags_have_mode (clapper_queue_get_warmup_flags (player->queue),
+      clapper_queue_get_progression_mode (player->queue));
+  prefetch_size = clapper_queue_get_warmup_prefetch_size (player->queue);
+  state = clapper_player_get_state (player);
+
+  if (max_items > 0 || warmup) {
+    /* Do not compete with current item while it is starting,
+     * state change will trigger another refresh */
+    if (state != CLAPPER_PLAYER_STATE_PLAYING && state != CLAPPER_PLAYER_STATE_PAUSED) {
+      gst_object_unref (player);
+      return;
+    }
+    upcoming = clapper_queue_get_upcoming (player->queue, MAX (max_items, 1));
+
+    if (warmup)
+      warmup_delay = _get_time_until_warmup (player);
+  }
+
+  gst_object_unref (player);
+
+  entries = g_ptr_array_new ();
+
+  /* Items are sorted from the nearest one, so whenever limit
+   * is reached, the rest of them is not worth preloading */
+  for (i = 0; upcoming && i < upcoming->len && i < max_items; ++i) {
+    const ClapperQueueUpcoming *next = &g_array_index (upcoming, ClapperQueueUpcoming, i);
+    ClapperPrefetchEntry *entry = NULL;
+    guint index;
+
+    if (_find_entry_for_id (self->entries, next->id, &index))
+      entry = g_ptr_array_steal_index (self->entries, index);
+
+    if (entry && entry->failed) {
+      _mark_failed (self, next->id);
+      _prefetch_free (entry);
+      continue;
+    }
+    if (total + PRELOAD_COST > limit) {
+      GST_DEBUG_OBJECT (self, "Preload limit reached");
+      g_clear_pointer (&entry, _prefetch_free);
+      break;
+    }
+    if (!entry) {
+      if (g_hash_table_contains (self->failed_ids, GUINT_TO_POINTER (next->id)))
+        continue;
+      if (!(entry = _prefetch_new (self, next->id, next->uri, PRELOAD_PREFETCH_SIZE, FALSE))) {
+        _mark_failed (self, next->id);
+        continue;
+      }
+    }
+
+    total += PRELOAD_COST;
+    g_ptr_array_add (entries, entry);
+  }
+
+  /* Remove preloads of items that are no longer upcoming */
+  for (i = 0; i < self->entries->len; ++i)
+    _prefetch_free (g_ptr_array_index (self->entries, i));
+
+  g_ptr_array_unref (self->entries);
+  self->entries = entries;
+
+  GST_DEBUG_OBJECT (self, "Preloaded items: %u, estimated cost: %" G_GUINT64_FORMAT " KiB",
+      entries->len, total / 1024);
+
+  /* Preloaded item is already as warm as it can be */
+  if (warmup && upcoming && upcoming->len > 0) {
+    warmup_next = &g_array_index (upcoming, ClapperQueueUpcoming, 0);
+
+    if (_find_entry_for_id (entries, warmup_next->id, NULL))
+      warmup_next = NULL;
+  }
+
+  _refresh_warmup (self, warmup_next, prefetch_size, warmup_delay);
+
+  g_atomic_int_set (&self->n_entries, entries->len + ((self->warmup) ? 1 : 0));
+
+  if (upcoming)
+    g_array_unref (upcoming);
+}
+
+static gboolean
+_refresh_cb (ClapperPreloader *self)
+{
+  g_atomic_int_set (&self->refresh_scheduled, FALSE);
+
+  if (!g_atomic_int_get (&self->stopped))
+    _refresh (self);
+
+  return G_SOURCE_REMOVE;
+}
+
+/*
+ * clapper_preloader_new:
+ *
+ * Returns: (transfer full): a new #ClapperPreloader instance.
+ */
+ClapperPreloader *
+clapper_preloader_new (void)
+{
+  ClapperPreloader *preloader;
+
+  preloader = g_object_new (CLAPPER_TYPE_PRELOADER, NULL);
+  gst_object_ref_sink (preloader);
+
+  return preloader;
+}
+
+/*
+ * clapper_preloader_schedule_refresh:
+ * @preloader: a #ClapperPreloader
+ *
+ * Schedule update of preloaded items on player thread.
+ * Can be called from any thread.
+ */
+void
+clapper_preloader_schedule_refresh (ClapperPreloader *self)
+{
+  ClapperPlayer *player;
+  GSource *source;
+
+  if (g_atomic_int_get (&self->stopped))
+    return;
+
+  if (!(player = CLAPPER_PLAYER_CAST (gst_object_get_parent (GST_OBJECT_CAST (self)))))
+    return;
+
+  /* Nothing to do when disabled and there is nothing to clear */
+  if ((clapper_queue_get_preload_items (player->queue) == 0
+      && clapper_queue_get_warmup_flags (player->queue) == CLAPPER_QUEUE_WARMUP_DISABLED
+      && g_atomic_int_get (&self->n_entries) == 0)
+      || !g_atomic_int_compare_and_exchange (&self->refresh_scheduled, FALSE, TRUE)) {
+    gst_object_unref (player);
+    return;
+  }
+
+  /* Low priority, so playback related work is always done first */
+  source = g_idle_source_new ();
+  g_source_set_priority (source, G_PRIORITY_LOW);
+  g_source_set_callback (source, (GSourceFunc) _refresh_cb,
+      gst_object_ref (self), (GDestroyNotify) gst_object_unref);
+  g_source_attach (source, clapper_threaded_object_get_context (CLAPPER_THREADED_OBJECT_CAST (player)));
+  g_source_unref (source);
+
+  gst_object_unref (player);
+}
+
+/*
+ * clapper_preloader_stop:
+ * @preloader: a #ClapperPreloader
+ *
+ * Remove all preloads. Must be called from player thread.
+ */
+void
+clapper_preloader_stop (ClapperPreloader *self)
+{
+  guint i;
+
+  g_atomic_int_set (&self->stopped, TRUE);
+
+  for (i = 0; i < self->entries->len; ++i)
+    _prefetch_free (g_ptr_array_index (self->entries, i));
+
+  g_ptr_array_set_size (self->entries, 0);
+  _clear_warmup_source (self);
+  g_clear_pointer (&self->warmup, _prefetch_free);
+  g_atomic_int_set (&self->n_entries, 0);
+}
+
+/*
+ * clapper_preloader_take_warmup_request_latency:
+ * @preloader: a #ClapperPreloader
+ * @item: a #ClapperMediaItem that is about to be played
+ *
+ * Can be called from any thread.
+ *
+ * Returns: first byte latency (usec) of request that warmed up @item or zero.
+ */
+gint64
+clapper_preloader_take_warmup_request_latency (ClapperPreloader *self, ClapperMediaItem *item)
+{
+  gint64 latency = 0;
+
+  GST_OBJECT_LOCK (self);
+  if (self->warmed_latency >= 0 && self->warmed_id == clapper_media_item_get_id (item)) {
+    latency = self->warmed_latency;
+    self->warmed_latency = -1;
+  }
+  GST_OBJECT_UNLOCK (self);
+
+  return latency;
+}
+
+static void
+clapper_preloader_init (ClapperPreloader *self)
+{
+  self->entries = g_ptr_array_new ();
+  self->failed_ids = g_hash_table_new (g_direct_hash, g_direct_equal);
+  self->warmed_latency = -1;
+}
+
+static void
+clapper_preloader_finalize (GObject *object)
+{
+  ClapperPreloader *self = CLAPPER_PRELOADER_CAST (object);
+
+  GST_TRACE_OBJECT (self, "Finalize");
+
+  g_ptr_array_unref (self->entries);
+  g_hash_table_unref (self->failed_ids);
+
+  G_OBJECT_CLASS (parent_class)->finalize (object);
+}
+
+static void
+clapper_preloader_class_init (ClapperPreloaderClass *klass)
+{
+  GObjectClass *gobject_class = (GObjectClass *) klass;
+
+  GST_DEBUG_CATEGORY_INIT (GST_CAT_DEFAULT, "clapperpreloader", 0,
+      "Clapper Preloader");
+
+  gobject_class->finalize = clapper_preloader_finalize;
+}
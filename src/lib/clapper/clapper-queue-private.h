@@ -28,6 +28,13 @@
 
 G_BEGIN_DECLS
 
+/* Upcoming queue entry, described without materializing it */
+typedef struct
+{
+  guint id;
+  gchar *uri;
+} ClapperQueueUpcoming;
+
 ClapperQueue * clapper_queue_new (void);
 
 void clapper_queue_handle_played_item_changed (ClapperQueue *queue, ClapperMediaItem *played_item, ClapperAppBus *app_bus);
@@ -38,4 +45,8 @@ void clapper_queue_handle_about_to_finish (ClapperQueue *queue, ClapperPlayer *p
 
 gboolean clapper_queue_handle_eos (ClapperQueue *queue, ClapperPlayer *player);
 
+GArray * clapper_queue_get_upcoming (ClapperQueue *queue, guint max_items);
+
+ClapperMediaItem * clapper_queue_peek_materialized_item (ClapperQueue *queue, guint index);
+
 G_END_DECLS
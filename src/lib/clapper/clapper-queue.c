@@ -30,6 +30,7 @@
 #include "clapper-playbin-bus-private.h"
 #include "clapper-reactables-manager-private.h"
 #include "clapper-features-manager-private.h"
+#include "clapper-cache-private.h"
 
 #define CLAPPER_QUEUE_GET_REC_LOCK(obj) (&CLAPPER_QUEUE_CAST(obj)->rec_lock)
 #define CLAPPER_QUEUE_REC_LOCK(obj) g_rec_mutex_lock (CLAPPER_QUEUE_GET_REC_LOCK(obj))
@@ -38,10 +39,34 @@
 #define DEFAULT_PROGRESSION_MODE CLAPPER_QUEUE_PROGRESSION_NONE
 #define DEFAULT_GAPLESS FALSE
 #define DEFAULT_INSTANT FALSE
+#define DEFAULT_MAX_MATERIALIZED 128
+#define DEFAULT_PRELOAD_ITEMS 0
+#define DEFAULT_PRELOAD_FETCH_LIMIT 256
+#define DEFAULT_WARMUP_FLAGS CLAPPER_QUEUE_WARMUP_DISABLED
+#define DEFAULT_WARMUP_PREFETCH_SIZE 0
+
+#define CLAPPER_QUEUE_SNAPSHOT_ID "queue-snapshot"
 
 #define GST_CAT_DEFAULT clapper_queue_debug
 GST_DEBUG_CATEGORY_STATIC (GST_CAT_DEFAULT);
 
+/* Compact queue entry that does not have media item created yet */
+typedef struct
+{
+  gchar *uri; // interned GRefString
+  gchar *title; // interned GRefString or NULL
+  gdouble duration;
+  guint id;
+  gboolean used;
+
+  /* What was learned about media item before its
+   * eviction, NULL if it was never materialized */
+  GBytes *state;
+
+  /* Last media item created for entry, if still alive */
+  GWeakRef item_ref;
+} ClapperQueueRecord;
+
 struct _ClapperQueue
 {
   GstObject parent;
@@ -52,9 +77,32 @@ struct _ClapperQueue
   ClapperMediaItem *current_item;
   guint current_index;
 
+  /* Lookup tables kept in sync with items array. Indexes
+   * stored in "item_indexes" are valid only below "stale_index",
+   * the rest is refreshed lazily on the next lookup */
+  GHashTable *item_indexes;
+  GHashTable *id_items;
+  guint stale_index;
+
+  /* Lazy entries, kept in sync with items array (NULL for regular
+   * items). Slot in items array stays NULL until lazy entry is
+   * materialized. Record strings are interned refcounted ones, so
+   * entries sharing URI or title keep a single copy of them. */
+  GPtrArray *records;
+  GHashTable *id_records;
+  GQueue materialized;
+
+  /* Position to start next selected item from (restored snapshot) */
+  gdouble start_position;
+
   ClapperQueueProgressionMode progression_mode;
   gboolean gapless;
   gboolean instant;
+  guint max_materialized;
+  guint preload_items;
+  guint preload_fetch_limit;
+  ClapperQueueWarmupFlags warmup_flags;
+  guint warmup_prefetch_size;
 
   /* Avoid scenario when "gapless" prop is changed
    * between "about-to-finish" and "EOS" */
@@ -70,9 +118,16 @@ enum
   PROP_PROGRESSION_MODE,
   PROP_GAPLESS,
   PROP_INSTANT,
+  PROP_MAX_MATERIALIZED,
+  PROP_PRELOAD_ITEMS,
+  PROP_PRELOAD_FETCH_LIMIT,
+  PROP_WARMUP_FLAGS,
+  PROP_WARMUP_PREFETCH_SIZE,
   PROP_LAST
 };
 
+static ClapperMediaItem * _get_item_unlocked (ClapperQueue *self, guint index);
+
 static GType
 clapper_queue_list_model_get_item_type (GListModel *model)
 {
@@ -101,7 +156,7 @@ clapper_queue_list_model_get_item (GListModel *model, guint index)
   CLAPPER_QUEUE_REC_LOCK (self);
   if (G_LIKELY (index < self->items->len)) {
     GST_LOG_OBJECT (self, "Reading queue item: %u", index);
-    item = g_object_ref (g_ptr_array_index (self->items, index));
+    item = g_object_ref (_get_item_unlocked (self, index));
   }
   CLAPPER_QUEUE_REC_UNLOCK (self);
 
@@ -122,6 +177,313 @@ G_DEFINE_TYPE_WITH_CODE (ClapperQueue, clapper_queue, GST_TYPE_OBJECT,
 
 static GParamSpec *param_specs[PROP_LAST] = { NULL, };
 
+static inline void
+_mark_stale_from_unlocked (ClapperQueue *self, guint index)
+{
+  if (index < self->stale_index)
+    self->stale_index = index;
+}
+
+static void
+_index_item_unlocked (ClapperQueue *self, ClapperMediaItem *item, guint index)
+{
+  g_hash_table_insert (self->item_indexes, item, GUINT_TO_POINTER (index));
+  g_hash_table_insert (self->id_items,
+      GUINT_TO_POINTER (clapper_media_item_get_id (item)), item);
+}
+
+static void
+_unindex_item_unlocked (ClapperQueue *self, ClapperMediaItem *item)
+{
+  g_hash_table_remove (self->item_indexes, item);
+  g_hash_table_remove (self->id_items,
+      GUINT_TO_POINTER (clapper_media_item_get_id (item)));
+}
+
+static void
+_index_record_unlocked (ClapperQueue *self, ClapperQueueRecord *record, guint index)
+{
+  g_hash_table_insert (self->item_indexes, record, GUINT_TO_POINTER (index));
+  g_hash_table_insert (self->id_records, GUINT_TO_POINTER (record->id), record);
+}
+
+static void
+_unindex_record_unlocked (ClapperQueue *self, ClapperQueueRecord *record)
+{
+  g_hash_table_remove (self->item_indexes, record);
+  g_hash_table_remove (self->id_records, GUINT_TO_POINTER (record->id));
+}
+
+/*
+ * Replacement for g_ptr_array_find() on the items array. Uses hash table
+ * to check membership and refreshes stale indexes in one pass only when
+ * items were inserted/removed before looked up one since last refresh.
+ *
+ * Entry can be either a media item or a lazy record.
+ */
+static gboolean
+_find_entry_unlocked (ClapperQueue *self, gconstpointer entry, guint *index)
+{
+  gpointer value;
+  guint found_index;
+
+  if (!g_hash_table_lookup_extended (self->item_indexes, entry, NULL, &value))
+    return FALSE;
+
+  found_index = GPOINTER_TO_UINT (value);
+
+  if (found_index >= self->stale_index) {
+    guint i;
+
+    GST_LOG_OBJECT (self, "Refreshing item indexes from: %u", self->stale_index);
+
+    for (i = self->stale_index; i < self->items->len; ++i) {
+      ClapperMediaItem *tmp_item = g_ptr_array_index (self->items, i);
+      ClapperQueueRecord *tmp_record = g_ptr_array_index (self->records, i);
+
+      if (tmp_item)
+        g_hash_table_insert (self->item_indexes, tmp_item, GUINT_TO_POINTER (i));
+      if (tmp_record)
+        g_hash_table_insert (self->item_indexes, tmp_record, GUINT_TO_POINTER (i));
+
+      if (entry == tmp_item || entry == tmp_record)
+        found_index = i;
+    }
+    self->stale_index = G_MAXUINT;
+  }
+
+  if (index)
+    *index = found_index;
+
+  return TRUE;
+}
+
+/*
+ * Find media item in queue. Evicted media item of a lazy entry that
+ * is still referenced elsewhere is found too and materialized again.
+ */
+static gboolean
+_find_item_unlocked (ClapperQueue *self, ClapperMediaItem *item, guint *index)
+{
+  ClapperQueueRecord *record;
+  ClapperMediaItem *record_item;
+  guint found_index = 0;
+  gboolean found;
+
+  if (_find_entry_unlocked (self, item, index))
+    return TRUE;
+
+  if (!clapper_media_item_is_lazy (item)
+      || !(record = g_hash_table_lookup (self->id_records,
+      GUINT_TO_POINTER (clapper_media_item_get_id (item)))))
+    return FALSE;
+
+  record_item = g_weak_ref_get (&record->item_ref);
+  found = (record_item == item && _find_entry_unlocked (self, record, &found_index));
+  gst_clear_object (&record_item);
+
+  if (found) {
+    _get_item_unlocked (self, found_index);
+
+    if (index)
+      *index = found_index;
+  }
+
+  return found;
+}
+
+static void
+_record_free (ClapperQueueRecord *record)
+{
+  if (!record) // Regular item
+    return;
+
+  g_weak_ref_clear (&record->item_ref);
+  g_clear_pointer (&record->state, g_bytes_unref);
+
+  g_ref_string_release (record->uri);
+  g_clear_pointer (&record->title, g_ref_string_release);
+
+  g_free (record);
+}
+
+static void
+_item_remove_func (ClapperMediaItem *item)
+{
+  if (!item) // Lazy entry that was not materialized
+    return;
+
+  gst_object_unparent (GST_OBJECT_CAST (item));
+  gst_object_unref (item);
+}
+
+/*
+ * Index of item that will be played after current one, so it should
+ * stay materialized. Shuffle picks next item only when switching to it,
+ * after which player holds it as current one.
+ */
+static guint
+_get_next_index_unlocked (ClapperQueue *self)
+{
+  guint n_items = self->items->len;
+
+  if (self->current_index == CLAPPER_QUEUE_INVALID_POSITION)
+    return CLAPPER_QUEUE_INVALID_POSITION;
+
+  switch (clapper_queue_get_progression_mode (self)) {
+    case CLAPPER_QUEUE_PROGRESSION_CONSECUTIVE:
+      if (self->current_index + 1 < n_items)
+        return self->current_index + 1;
+      break;
+    case CLAPPER_QUEUE_PROGRESSION_CAROUSEL:
+      return (self->current_index + 1) % n_items;
+    default:
+      break;
+  }
+
+  return CLAPPER_QUEUE_INVALID_POSITION;
+}
+
+/*
+ * Drops oldest media items materialized from lazy records until no more
+ * than @max_kept of them remain. Current and next items are always kept.
+ *
+ * Items referenced outside of queue (queue itself holds two references,
+ * one in array and one from being a parent) are skipped when possible.
+ * Reference count is only a hint here, as it can change at any time. Evicted
+ * item that is still alive is not duplicated, but reused by its entry, while
+ * its state is kept in the entry for when it is not.
+ */
+static void
+_evict_materialized_unlocked (ClapperQueue *self, guint max_kept)
+{
+  GList *link;
+  guint next_index;
+
+  if (self->materialized.length <= max_kept)
+    return;
+
+  next_index = _get_next_index_unlocked (self);
+  link = self->materialized.head;
+
+  while (link && self->materialized.length > max_kept) {
+    ClapperMediaItem *item = link->data;
+    GList *next = link->next;
+    guint index = 0;
+
+    if (item != self->current_item
+        && g_atomic_int_get (&G_OBJECT (item)->ref_count) <= 2
+        && _find_entry_unlocked (self, item, &index)
+        && index != next_index) {
+      ClapperQueueRecord *record = g_ptr_array_index (self->records, index);
+      GByteArray *bytes = g_byte_array_new ();
+
+      /* Keep what was learned about item in the meantime */
+      clapper_media_item_store_to_cache (item, bytes);
+      g_clear_pointer (&record->state, g_bytes_unref);
+      record->state = g_byte_array_free_to_bytes (bytes);
+      record->used = clapper_media_item_get_used (item);
+
+      GST_LOG_OBJECT (self, "Evicting materialized item at: %u", index);
+
+      g_queue_delete_link (&self->materialized, link);
+      _unindex_item_unlocked (self, item);
+      g_ptr_array_index (self->items, index) = NULL;
+      _item_remove_func (item);
+    }
+
+    link = next;
+  }
+}
+
+/*
+ * Get media item at index without storing it in queue. For lazy
+ * entry, item is reused if still alive or created from entry state.
+ * Returns a new reference.
+ */
+static ClapperMediaItem *
+_peek_item_unlocked (ClapperQueue *self, guint index)
+{
+  ClapperMediaItem *item = g_ptr_array_index (self->items, index);
+  ClapperQueueRecord *record;
+
+  if (item)
+    return gst_object_ref (item);
+
+  record = g_ptr_array_index (self->records, index);
+
+  if (!(item = g_weak_ref_get (&record->item_ref))) {
+    if (record->state) {
+      item = clapper_media_item_new_lazy_from_cache (record->id,
+          record->title, record->state);
+    }
+    if (!item) {
+      item = clapper_media_item_new_lazy (record->uri, record->id,
+          record->title, record->duration);
+    }
+    g_weak_ref_set (&record->item_ref, item);
+  }
+
+  /* Entry could be (un)used by shuffle in the meantime */
+  clapper_media_item_set_used (item, record->used);
+
+  return item;
+}
+
+/*
+ * Get media item at index, creating it from lazy record when
+ * needed. Returned item is owned by the queue.
+ */
+static ClapperMediaItem *
+_get_item_unlocked (ClapperQueue *self, guint index)
+{
+  ClapperMediaItem *item = g_ptr_array_index (self->items, index);
+
+  if (G_UNLIKELY (item == NULL)) {
+    guint max_materialized;
+
+    GST_OBJECT_LOCK (self);
+    max_materialized = self->max_materialized;
+    GST_OBJECT_UNLOCK (self);
+
+    /* Make room for another one */
+    _evict_materialized_unlocked (self, max_materialized - 1);
+
+    item = _peek_item_unlocked (self, index); // reference owned by array
+    gst_object_set_parent (GST_OBJECT_CAST (item), GST_OBJECT_CAST (self));
+
+    g_ptr_array_index (self->items, index) = item;
+    _index_item_unlocked (self, item, index);
+    g_queue_push_tail (&self->materialized, item);
+
+    GST_LOG_OBJECT (self, "Materialized lazy item at: %u, now materialized: %u",
+        index, self->materialized.length);
+  }
+
+  return item;
+}
+
+static void
+_set_used_unlocked (ClapperQueue *self, guint index, gboolean used)
+{
+  ClapperMediaItem *item = g_ptr_array_index (self->items, index);
+
+  if (item)
+    clapper_media_item_set_used (item, used);
+  else
+    ((ClapperQueueRecord *) g_ptr_array_index (self->records, index))->used = used;
+}
+
+static gboolean
+_get_used_unlocked (ClapperQueue *self, guint index)
+{
+  ClapperMediaItem *item = g_ptr_array_index (self->items, index);
+
+  return (item)
+      ? clapper_media_item_get_used (item)
+      : ((ClapperQueueRecord *) g_ptr_array_index (self->records, index))->used;
+}
+
 static void
 _announce_model_update (ClapperQueue *self, guint index, guint removed, guint added,
     ClapperMediaItem *changed_item)
@@ -136,11 +498,26 @@ _announce_model_update (ClapperQueue *self, guint index, guint removed, guint ad
     if (player) {
       gboolean have_features = clapper_player_get_have_features (player);
 
-      if (added == 1) { // addition
-        if (player->reactables_manager)
-          clapper_reactables_manager_trigger_queue_item_added (player->reactables_manager, changed_item, index);
-        if (have_features)
-          clapper_features_manager_trigger_queue_item_added (player->features_manager, changed_item, index);
+      clapper_preloader_schedule_refresh (player->preloader);
+
+      if (removed == 0) { // addition (single or bulk)
+        guint i, end = index + added;
+
+        if (!player->reactables_manager && !have_features)
+          end = index;
+
+        /* Lazy entries are announced with short-lived items that are not
+         * stored in queue. If kept alive, entry will reuse them later. */
+        for (i = index; i < end; ++i) {
+          ClapperMediaItem *added_item = _peek_item_unlocked (self, i);
+
+          if (player->reactables_manager)
+            clapper_reactables_manager_trigger_queue_item_added (player->reactables_manager, added_item, i);
+          if (have_features)
+            clapper_features_manager_trigger_queue_item_added (player->features_manager, added_item, i);
+
+          gst_object_unref (added_item);
+        }
       } else if (removed == 1) { // removal
         if (player->reactables_manager)
           clapper_reactables_manager_trigger_queue_item_removed (player->reactables_manager, changed_item, index);
@@ -173,6 +550,7 @@ _announce_reposition (ClapperQueue *self, guint before, guint after)
   GST_DEBUG_OBJECT (self, "Announcing item reposition: %u -> %u", before, after);
 
   if ((player = clapper_player_get_from_ancestor (GST_OBJECT_CAST (self)))) {
+    clapper_preloader_schedule_refresh (player->preloader);
     if (player->reactables_manager)
       clapper_reactables_manager_trigger_queue_item_repositioned (player->reactables_manager, before, after);
     if (clapper_player_get_have_features (player))
@@ -233,7 +611,9 @@ _announce_current_item_and_index_change (ClapperQueue *self)
   GST_OBJECT_UNLOCK (self);
 
   clapper_playbin_bus_post_current_item_change (player->bus, self->current_item,
-      (instant) ? CLAPPER_QUEUE_ITEM_CHANGE_INSTANT : CLAPPER_QUEUE_ITEM_CHANGE_NORMAL);
+      (instant) ? CLAPPER_QUEUE_ITEM_CHANGE_INSTANT : CLAPPER_QUEUE_ITEM_CHANGE_NORMAL,
+      self->start_position);
+  self->start_position = 0;
 
   if (is_main_thread) {
     g_object_notify_by_pspec (G_OBJECT (self), param_specs[PROP_CURRENT_ITEM]);
@@ -270,16 +650,15 @@ _reset_shuffle_unlocked (ClapperQueue *self)
 {
   guint i;
 
-  for (i = 0; i < self->items->len; ++i) {
-    ClapperMediaItem *item = g_ptr_array_index (self->items, i);
-    clapper_media_item_set_used (item, FALSE);
-  }
+  for (i = 0; i < self->items->len; ++i)
+    _set_used_unlocked (self, i, FALSE);
 }
 
 static ClapperMediaItem *
 _get_next_item_unlocked (ClapperQueue *self, ClapperQueueProgressionMode mode)
 {
   ClapperMediaItem *next_item = NULL;
+  guint next_index = CLAPPER_QUEUE_INVALID_POSITION;
 
   GST_DEBUG_OBJECT (self, "Handling progression mode: %u", mode);
 
@@ -292,37 +671,35 @@ _get_next_item_unlocked (ClapperQueue *self, ClapperQueueProgressionMode mode)
     case CLAPPER_QUEUE_PROGRESSION_NONE:
       break;
     case CLAPPER_QUEUE_PROGRESSION_CAROUSEL:
-      next_item = g_ptr_array_index (self->items, 0);
+      next_index = 0;
       G_GNUC_FALLTHROUGH;
     case CLAPPER_QUEUE_PROGRESSION_CONSECUTIVE:
       if (self->current_index + 1 < self->items->len)
-        next_item = g_ptr_array_index (self->items, self->current_index + 1);
+        next_index = self->current_index + 1;
       break;
     case CLAPPER_QUEUE_PROGRESSION_REPEAT_ITEM:
       next_item = self->current_item;
       break;
     case CLAPPER_QUEUE_PROGRESSION_SHUFFLE:{
-      GList *unused = NULL;
+      GArray *unused = g_array_new (FALSE, FALSE, sizeof (guint));
       GRand *rand = g_rand_new ();
       guint i;
 
+      /* Work on indexes, so lazy entries are not materialized here */
       for (i = 0; i < self->items->len; ++i) {
-        ClapperMediaItem *item = g_ptr_array_index (self->items, i);
-
-        if (!clapper_media_item_get_used (item))
-          unused = g_list_append (unused, item);
+        if (!_get_used_unlocked (self, i))
+          g_array_append_val (unused, i);
       }
 
-      if (unused) {
-        next_item = g_list_nth_data (unused,
-            g_rand_int_range (rand, 0, g_list_length (unused)));
-        g_list_free (unused);
+      if (unused->len > 0) {
+        next_index = g_array_index (unused, guint,
+            g_rand_int_range (rand, 0, unused->len));
       } else {
         _reset_shuffle_unlocked (self);
-        next_item = g_ptr_array_index (self->items,
-            g_rand_int_range (rand, 0, self->items->len));
+        next_index = g_rand_int_range (rand, 0, self->items->len);
       }
 
+      g_array_unref (unused);
       g_rand_free (rand);
       break;
     }
@@ -331,24 +708,44 @@ _get_next_item_unlocked (ClapperQueue *self, ClapperQueueProgressionMode mode)
       break;
   }
 
+  if (next_index != CLAPPER_QUEUE_INVALID_POSITION)
+    next_item = _get_item_unlocked (self, next_index);
+
   if (next_item)
     gst_object_ref (next_item);
 
   return next_item;
 }
 
+/*
+ * Takes either media item or lazy record (then item is NULL)
+ * and inserts it into queue at given index.
+ */
 static void
-_take_item_unlocked (ClapperQueue *self, ClapperMediaItem *item, gint index)
+_take_entry_unlocked (ClapperQueue *self, ClapperMediaItem *item,
+    ClapperQueueRecord *record, gint index)
 {
   guint prev_length = self->items->len;
 
   g_ptr_array_insert (self->items, index, item);
-  gst_object_set_parent (GST_OBJECT_CAST (item), GST_OBJECT_CAST (self));
+  g_ptr_array_insert (self->records, index, record);
+
+  if (item)
+    gst_object_set_parent (GST_OBJECT_CAST (item), GST_OBJECT_CAST (self));
 
   /* In append we inserted at array length */
   if (index < 0)
     index = prev_length;
 
+  /* Appending does not shift indexes of other items */
+  if ((guint) index < prev_length)
+    _mark_stale_from_unlocked (self, index);
+
+  if (item)
+    _index_item_unlocked (self, item, index);
+  if (record)
+    _index_record_unlocked (self, record, index);
+
   _announce_model_update (self, index, 0, 1, item);
 
   /* If has selection and inserting before it */
@@ -356,7 +753,8 @@ _take_item_unlocked (ClapperQueue *self, ClapperMediaItem *item, gint index)
       && (guint) index <= self->current_index) {
     self->current_index++;
     _announce_current_index_change (self);
-  } else if (prev_length == 0 && _replace_current_item_unlocked (self, item, 0)) {
+  } else if (prev_length == 0
+      && _replace_current_item_unlocked (self, _get_item_unlocked (self, 0), 0)) {
     /* If queue was empty, auto select first item and announce it */
     _announce_current_item_and_index_change (self);
   } else if (self->current_index == prev_length - 1
@@ -366,13 +764,20 @@ _take_item_unlocked (ClapperQueue *self, ClapperMediaItem *item, gint index)
 
     /* In consecutive progression automatically select next item
      * if we were after EOS of last queue item */
-    if (after_eos && _replace_current_item_unlocked (self, item, index))
+    if (after_eos && _replace_current_item_unlocked (self,
+        _get_item_unlocked (self, index), index))
       _announce_current_item_and_index_change (self);
 
     gst_object_unref (player);
   }
 }
 
+static inline void
+_take_item_unlocked (ClapperQueue *self, ClapperMediaItem *item, gint index)
+{
+  _take_entry_unlocked (self, item, NULL, index);
+}
+
 /*
  * For gapless we need to manually replace current item in queue when it starts
  * playing and emit notify about change, this function will do that if necessary
@@ -389,7 +794,7 @@ clapper_queue_handle_played_item_changed (ClapperQueue *self, ClapperMediaItem *
   /* Item is often the same here (when selected from queue),
    * so compare pointers first to avoid iterating queue */
   if (played_item != self->current_item
-      && g_ptr_array_find (self->items, played_item, &index))
+      && _find_item_unlocked (self, played_item, &index))
     changed = _replace_current_item_unlocked (self, played_item, index);
 
   CLAPPER_QUEUE_REC_UNLOCK (self);
@@ -414,7 +819,7 @@ clapper_queue_handle_playlist (ClapperQueue *self, ClapperMediaItem *playlist_it
 
   /* If playlist item is still in the queue, insert
    * remaining items after it, otherwise append */
-  if (G_LIKELY (g_ptr_array_find (self->items, playlist_item, &index)))
+  if (G_LIKELY (_find_item_unlocked (self, playlist_item, &index)))
     index++;
   else
     index = self->items->len;
@@ -490,6 +895,108 @@ clapper_queue_handle_eos (ClapperQueue *self, ClapperPlayer *player)
   return handled_eos;
 }
 
+static void
+_upcoming_clear_func (ClapperQueueUpcoming *upcoming)
+{
+  g_free (upcoming->uri);
+}
+
+/*
+ * clapper_queue_get_upcoming:
+ * @queue: a #ClapperQueue
+ * @max_items: maximal number of entries to return
+ *
+ * Get IDs and playback URIs of entries that queue will progress to after
+ * current one, in order of progression. Shuffle and repeat modes have none.
+ * Lazy entries are described from their records, so they stay lazy.
+ *
+ * Must be called from player thread.
+ *
+ * Returns: (transfer full) (element-type ClapperQueueUpcoming): an array of upcoming entries.
+ */
+GArray *
+clapper_queue_get_upcoming (ClapperQueue *self, guint max_items)
+{
+  GArray *upcoming = g_array_new (FALSE, FALSE, sizeof (ClapperQueueUpcoming));
+  ClapperQueueProgressionMode progression_mode;
+  gboolean wrap = FALSE;
+  guint i, n_items;
+
+  g_array_set_clear_func (upcoming, (GDestroyNotify) _upcoming_clear_func);
+
+  progression_mode = clapper_queue_get_progression_mode (self);
+
+  switch (progression_mode) {
+    case CLAPPER_QUEUE_PROGRESSION_CAROUSEL:
+      wrap = TRUE;
+      break;
+    case CLAPPER_QUEUE_PROGRESSION_NONE:
+    case CLAPPER_QUEUE_PROGRESSION_CONSECUTIVE:
+      break;
+    default:
+      return upcoming;
+  }
+
+  CLAPPER_QUEUE_REC_LOCK (self);
+
+  if (self->current_index == CLAPPER_QUEUE_INVALID_POSITION)
+    goto finish;
+
+  n_items = self->items->len;
+
+  for (i = 1; i < n_items && upcoming->len < max_items; ++i) {
+    ClapperQueueUpcoming entry;
+    ClapperMediaItem *item;
+    guint index = self->current_index + i;
+
+    if (index >= n_items) {
+      if (!wrap)
+        break;
+      index -= n_items;
+    }
+
+    if ((item = g_ptr_array_index (self->items, index))) {
+      entry.id = clapper_media_item_get_id (item);
+      entry.uri = g_strdup (clapper_media_item_get_playback_uri (item));
+    } else {
+      ClapperQueueRecord *record = g_ptr_array_index (self->records, index);
+
+      entry.id = record->id;
+      entry.uri = g_strdup (record->uri);
+    }
+    g_array_append_val (upcoming, entry);
+  }
+
+finish:
+  CLAPPER_QUEUE_REC_UNLOCK (self);
+
+  return upcoming;
+}
+
+/*
+ * clapper_queue_peek_materialized_item:
+ * @queue: a #ClapperQueue
+ * @index: an item index
+ *
+ * Get media item at index only if queue already holds it. Unlike
+ * [method@Clapper.Queue.get_item], lazy entries are never materialized.
+ *
+ * Returns: (transfer full) (nullable): The #ClapperMediaItem at @index.
+ */
+ClapperMediaItem *
+clapper_queue_peek_materialized_item (ClapperQueue *self, guint index)
+{
+  ClapperMediaItem *item = NULL;
+
+  CLAPPER_QUEUE_REC_LOCK (self);
+  if (index < self->items->len
+      && (item = g_ptr_array_index (self->items, index)))
+    gst_object_ref (item);
+  CLAPPER_QUEUE_REC_UNLOCK (self);
+
+  return item;
+}
+
 /*
  * clapper_queue_new:
  *
@@ -542,7 +1049,7 @@ clapper_queue_insert_item (ClapperQueue *self, ClapperMediaItem *item, gint inde
 
   CLAPPER_QUEUE_REC_LOCK (self);
 
-  if (!g_ptr_array_find (self->items, item, NULL))
+  if (!_find_item_unlocked (self, item, NULL))
     _take_item_unlocked (self, gst_object_ref (item), index);
 
   CLAPPER_QUEUE_REC_UNLOCK (self);
@@ -575,11 +1082,11 @@ clapper_queue_insert_item_after (ClapperQueue *self, ClapperMediaItem *item,
 
   CLAPPER_QUEUE_REC_LOCK (self);
 
-  if (!g_ptr_array_find (self->items, item, NULL)) {
+  if (!_find_item_unlocked (self, item, NULL)) {
     guint index;
 
     if (after_item) {
-      if (g_ptr_array_find (self->items, after_item, &index))
+      if (_find_item_unlocked (self, after_item, &index))
         index++;
       else
         index = self->items->len; // Append if not found
@@ -593,6 +1100,66 @@ clapper_queue_insert_item_after (ClapperQueue *self, ClapperMediaItem *item,
   CLAPPER_QUEUE_REC_UNLOCK (self);
 }
 
+/**
+ * clapper_queue_add_lazy_item:
+ * @queue: a #ClapperQueue
+ * @uri: a media URI
+ * @title: (nullable): a title to show for this media
+ * @duration: media duration in seconds or 0 if unknown
+ *
+ * Add a lazy entry for media at @uri to the end of queue.
+ *
+ * Unlike with [method@Clapper.Queue.add_item], no #ClapperMediaItem is
+ * created here. Queue only keeps a compact record of given data and creates
+ * media item from it on demand, e.g. when it is read through [iface@Gio.ListModel]
+ * interface, selected or about to be played. Such media items are dropped again
+ * when there are more of them than [property@Clapper.Queue:max-materialized],
+ * keeping everything known about them so far (including their timeline).
+ * This allows holding huge amount of entries with little memory.
+ *
+ * Media item created from this entry will always have the same
+ * [property@Clapper.MediaItem:id] as returned here, so it can be
+ * used with [method@Clapper.Queue.get_item_by_id].
+ *
+ * Features and reactables are notified about added entry with a media
+ * item that queue does not keep. Entries are not discovered by
+ * [class@Clapper.Discoverer], as this would defeat their purpose.
+ *
+ * Returns: an ID of media item that represents this entry.
+ *
+ * Since: 0.12
+ */
+guint
+clapper_queue_add_lazy_item (ClapperQueue *self, const gchar *uri,
+    const gchar *title, gdouble duration)
+{
+  ClapperQueueRecord *record;
+  guint id;
+
+  g_return_val_if_fail (CLAPPER_IS_QUEUE (self), 0);
+  g_return_val_if_fail (uri != NULL, 0);
+
+  /* Record is owned by queue once added, so keep ID for returning */
+  id = clapper_media_item_reserve_id ();
+
+  record = g_new0 (ClapperQueueRecord, 1);
+  record->id = id;
+  record->uri = g_ref_string_new_intern (uri);
+  if (title)
+    record->title = g_ref_string_new_intern (title);
+  record->duration = duration;
+  g_weak_ref_init (&record->item_ref, NULL);
+
+  CLAPPER_QUEUE_REC_LOCK (self);
+
+  GST_LOG_OBJECT (self, "Adding lazy item, ID: %u", id);
+  _take_entry_unlocked (self, NULL, record, -1);
+
+  CLAPPER_QUEUE_REC_UNLOCK (self);
+
+  return id;
+}
+
 /**
  * clapper_queue_reposition_item:
  * @queue: a #ClapperQueue
@@ -617,7 +1184,7 @@ clapper_queue_reposition_item (ClapperQueue *self, ClapperMediaItem *item, gint
 
   CLAPPER_QUEUE_REC_LOCK (self);
 
-  if (g_ptr_array_find (self->items, item, &index_old)) {
+  if (_find_item_unlocked (self, item, &index_old)) {
     ClapperMediaItem *removed_item;
     guint index_new, start_index, end_index, n_changed;
 
@@ -630,6 +1197,9 @@ clapper_queue_reposition_item (ClapperQueue *self, ClapperMediaItem *item, gint
 
     removed_item = g_ptr_array_steal_index (self->items, index_old);
     g_ptr_array_insert (self->items, index_new, removed_item);
+    g_ptr_array_insert (self->records, index_new,
+        g_ptr_array_steal_index (self->records, index_old));
+    _mark_stale_from_unlocked (self, MIN (index_old, index_new));
 
     _announce_reposition (self, index_old, index_new);
 
@@ -678,7 +1248,7 @@ clapper_queue_remove_item (ClapperQueue *self, ClapperMediaItem *item)
 
   CLAPPER_QUEUE_REC_LOCK (self);
 
-  if (g_ptr_array_find (self->items, item, &index))
+  if (_find_item_unlocked (self, item, &index))
     clapper_queue_remove_index (self, index);
 
   CLAPPER_QUEUE_REC_UNLOCK (self);
@@ -718,6 +1288,8 @@ clapper_queue_steal_index (ClapperQueue *self, guint index)
   CLAPPER_QUEUE_REC_LOCK (self);
 
   if (index < self->items->len) {
+    ClapperQueueRecord *removed_record;
+
     if (index == self->current_index
         && _replace_current_item_unlocked (self, NULL, CLAPPER_QUEUE_INVALID_POSITION)) {
       _announce_current_item_and_index_change (self);
@@ -728,7 +1300,20 @@ clapper_queue_steal_index (ClapperQueue *self, guint index)
       _announce_current_index_change (self);
     }
 
+    /* Lazy entry needs to be materialized to be returned */
+    _get_item_unlocked (self, index);
+
     removed_item = g_ptr_array_steal_index (self->items, index);
+    removed_record = g_ptr_array_steal_index (self->records, index);
+    _unindex_item_unlocked (self, removed_item);
+    _mark_stale_from_unlocked (self, index);
+
+    if (removed_record) {
+      g_queue_remove (&self->materialized, removed_item);
+      _unindex_record_unlocked (self, removed_record);
+      _record_free (removed_record);
+    }
+
     gst_object_unparent (GST_OBJECT_CAST (removed_item));
 
     _announce_model_update (self, index, 1, 0, removed_item);
@@ -763,7 +1348,14 @@ clapper_queue_clear (ClapperQueue *self)
     if (_replace_current_item_unlocked (self, NULL, CLAPPER_QUEUE_INVALID_POSITION))
       _announce_current_item_and_index_change (self);
 
+    g_hash_table_remove_all (self->item_indexes);
+    g_hash_table_remove_all (self->id_items);
+    g_hash_table_remove_all (self->id_records);
+    self->stale_index = G_MAXUINT;
+
+    g_queue_clear (&self->materialized);
     g_ptr_array_remove_range (self->items, 0, n_items);
+    g_ptr_array_remove_range (self->records, 0, n_items);
     _announce_model_update (self, 0, n_items, 0, NULL);
   }
 
@@ -793,7 +1385,7 @@ clapper_queue_select_item (ClapperQueue *self, ClapperMediaItem *item)
   CLAPPER_QUEUE_REC_LOCK (self);
   if (!item)
     success = clapper_queue_select_index (self, CLAPPER_QUEUE_INVALID_POSITION);
-  else if (g_ptr_array_find (self->items, item, &index))
+  else if (_find_item_unlocked (self, item, &index))
     success = clapper_queue_select_index (self, index);
   CLAPPER_QUEUE_REC_UNLOCK (self);
 
@@ -821,7 +1413,7 @@ clapper_queue_select_index (ClapperQueue *self, guint index)
 
   CLAPPER_QUEUE_REC_LOCK (self);
   if (index != CLAPPER_QUEUE_INVALID_POSITION && index < self->items->len)
-    item = g_ptr_array_index (self->items, index);
+    item = _get_item_unlocked (self, index);
   if ((success = (index == CLAPPER_QUEUE_INVALID_POSITION
       || index < self->items->len))) {
     if (_replace_current_item_unlocked (self, item, index))
@@ -1011,17 +1603,56 @@ clapper_queue_find_item (ClapperQueue *self, ClapperMediaItem *item, guint *inde
   g_return_val_if_fail (CLAPPER_IS_MEDIA_ITEM (item), FALSE);
 
   CLAPPER_QUEUE_REC_LOCK (self);
-  found = g_ptr_array_find (self->items, item, index);
+  found = _find_item_unlocked (self, item, index);
   CLAPPER_QUEUE_REC_UNLOCK (self);
 
   return found;
 }
 
 /**
- * clapper_queue_get_n_items: (skip)
+ * clapper_queue_get_item_by_id:
  * @queue: a #ClapperQueue
+ * @id: a #ClapperMediaItem identifier
  *
- * Get the number of items in #ClapperQueue.
+ * Get the #ClapperMediaItem with given [property@Clapper.MediaItem:id]
+ * from the queue.
+ *
+ * Returns: (transfer full) (nullable): The #ClapperMediaItem with @id
+ *   or %NULL if no such item is in the queue.
+ *
+ * Since: 0.12
+ */
+ClapperMediaItem *
+clapper_queue_get_item_by_id (ClapperQueue *self, guint id)
+{
+  ClapperMediaItem *item;
+
+  g_return_val_if_fail (CLAPPER_IS_QUEUE (self), NULL);
+
+  CLAPPER_QUEUE_REC_LOCK (self);
+
+  if (!(item = g_hash_table_lookup (self->id_items, GUINT_TO_POINTER (id)))) {
+    ClapperQueueRecord *record;
+    guint index = 0;
+
+    /* Not materialized lazy entry */
+    if ((record = g_hash_table_lookup (self->id_records, GUINT_TO_POINTER (id)))
+        && _find_entry_unlocked (self, record, &index))
+      item = _get_item_unlocked (self, index);
+  }
+  if (item)
+    gst_object_ref (item);
+
+  CLAPPER_QUEUE_REC_UNLOCK (self);
+
+  return item;
+}
+
+/**
+ * clapper_queue_get_n_items: (skip)
+ * @queue: a #ClapperQueue
+ *
+ * Get the number of items in #ClapperQueue.
  *
  * This behaves the same as [method@Gio.ListModel.get_n_items], and is here
  * for code uniformity and convenience to avoid type casting by user.
@@ -1079,6 +1710,7 @@ clapper_queue_set_progression_mode (ClapperQueue *self, ClapperQueueProgressionM
 
     clapper_app_bus_post_prop_notify (player->app_bus,
         GST_OBJECT_CAST (self), param_specs[PROP_PROGRESSION_MODE]);
+    clapper_preloader_schedule_refresh (player->preloader);
     if (player->reactables_manager)
       clapper_reactables_manager_trigger_queue_progression_changed (player->reactables_manager, mode);
     if (clapper_player_get_have_features (player))
@@ -1230,11 +1862,565 @@ clapper_queue_get_instant (ClapperQueue *self)
   return instant;
 }
 
-static void
-_item_remove_func (ClapperMediaItem *item)
+/**
+ * clapper_queue_set_max_materialized:
+ * @queue: a #ClapperQueue
+ * @max_materialized: maximal number of kept media items created from lazy entries
+ *
+ * Set how many media items created from entries added with
+ * [method@Clapper.Queue.add_lazy_item] queue keeps around
+ * when they are no longer used.
+ *
+ * Lowering this value drops media items above new limit right away.
+ *
+ * Since: 0.12
+ */
+void
+clapper_queue_set_max_materialized (ClapperQueue *self, guint max_materialized)
 {
-  gst_object_unparent (GST_OBJECT_CAST (item));
-  gst_object_unref (item);
+  gboolean changed;
+
+  g_return_if_fail (CLAPPER_IS_QUEUE (self));
+  g_return_if_fail (max_materialized > 0);
+
+  GST_OBJECT_LOCK (self);
+  if ((changed = self->max_materialized != max_materialized))
+    self->max_materialized = max_materialized;
+  GST_OBJECT_UNLOCK (self);
+
+  if (changed) {
+    ClapperPlayer *player;
+
+    CLAPPER_QUEUE_REC_LOCK (self);
+    _evict_materialized_unlocked (self, max_materialized);
+    CLAPPER_QUEUE_REC_UNLOCK (self);
+
+    if (G_LIKELY ((player = clapper_player_get_from_ancestor (GST_OBJECT_CAST (self))))) {
+      clapper_app_bus_post_prop_notify (player->app_bus,
+          GST_OBJECT_CAST (self), param_specs[PROP_MAX_MATERIALIZED]);
+
+      gst_object_unref (player);
+    }
+  }
+}
+
+/**
+ * clapper_queue_get_max_materialized:
+ * @queue: a #ClapperQueue
+ *
+ * Get maximal number of kept media items created from lazy entries.
+ *
+ * Returns: maximal number of kept materialized media items.
+ *
+ * Since: 0.12
+ */
+guint
+clapper_queue_get_max_materialized (ClapperQueue *self)
+{
+  guint max_materialized;
+
+  g_return_val_if_fail (CLAPPER_IS_QUEUE (self), DEFAULT_MAX_MATERIALIZED);
+
+  GST_OBJECT_LOCK (self);
+  max_materialized = self->max_materialized;
+  GST_OBJECT_UNLOCK (self);
+
+  return max_materialized;
+}
+
+/**
+ * clapper_queue_set_preload_items:
+ * @queue: a #ClapperQueue
+ * @preload_items: maximal number of upcoming media items to preload
+ *
+ * Set how many of the upcoming media items (following current one
+ * according to [property@Clapper.Queue:progression-mode]) should be
+ * preloaded in the background.
+ *
+ * Preloading opens these media items and fetches a small amount of data
+ * from their beginning, without demuxing or decoding it. This runs
+ * extraction of their actual URIs (storing results in cache), brings local
+ * files into system cache and opens network connections for when queue
+ * progresses to them. Fetched data itself is discarded. Total amount of
+ * data fetched this way is bounded by [property@Clapper.Queue:preload-fetch-limit].
+ *
+ * Note that no ready to play pipeline is kept for preloaded items. When
+ * queue progresses to one of them, it is still opened, demuxed and decoded
+ * by player as usual, only with less waiting for its source.
+ *
+ * Lazy entries (see [method@Clapper.Queue.add_lazy_item]) are preloaded
+ * from their URIs, without creating media items for them.
+ *
+ * Set to 0 to disable preloading (default).
+ *
+ * Since: 0.12
+ */
+void
+clapper_queue_set_preload_items (ClapperQueue *self, guint preload_items)
+{
+  gboolean changed;
+
+  g_return_if_fail (CLAPPER_IS_QUEUE (self));
+
+  GST_OBJECT_LOCK (self);
+  if ((changed = self->preload_items != preload_items))
+    self->preload_items = preload_items;
+  GST_OBJECT_UNLOCK (self);
+
+  if (changed) {
+    ClapperPlayer *player = clapper_player_get_from_ancestor (GST_OBJECT_CAST (self));
+
+    clapper_app_bus_post_prop_notify (player->app_bus,
+        GST_OBJECT_CAST (self), param_specs[PROP_PRELOAD_ITEMS]);
+    clapper_preloader_schedule_refresh (player->preloader);
+
+    gst_object_unref (player);
+  }
+}
+
+/**
+ * clapper_queue_get_preload_items:
+ * @queue: a #ClapperQueue
+ *
+ * Get maximal number of upcoming media items to preload.
+ *
+ * Returns: maximal number of preloaded media items.
+ *
+ * Since: 0.12
+ */
+guint
+clapper_queue_get_preload_items (ClapperQueue *self)
+{
+  guint preload_items;
+
+  g_return_val_if_fail (CLAPPER_IS_QUEUE (self), DEFAULT_PRELOAD_ITEMS);
+
+  GST_OBJECT_LOCK (self);
+  preload_items = self->preload_items;
+  GST_OBJECT_UNLOCK (self);
+
+  return preload_items;
+}
+
+/**
+ * clapper_queue_set_preload_fetch_limit:
+ * @queue: a #ClapperQueue
+ * @limit: fetch limit in MiB
+ *
+ * Set approximate amount of data (in MiB) that can be fetched ahead
+ * when preloading upcoming media items. Each preloaded item is counted
+ * with the data fetched from its beginning and its source element buffers.
+ * When limit is reached, media items further in the queue are not preloaded.
+ *
+ * Since fetched data is discarded right away, this is not a limit of
+ * memory kept by preloads, but of bandwidth and I/O spent on them.
+ *
+ * Since: 0.12
+ */
+void
+clapper_queue_set_preload_fetch_limit (ClapperQueue *self, guint limit)
+{
+  gboolean changed;
+
+  g_return_if_fail (CLAPPER_IS_QUEUE (self));
+
+  GST_OBJECT_LOCK (self);
+  if ((changed = self->preload_fetch_limit != limit))
+    self->preload_fetch_limit = limit;
+  GST_OBJECT_UNLOCK (self);
+
+  if (changed) {
+    ClapperPlayer *player = clapper_player_get_from_ancestor (GST_OBJECT_CAST (self));
+
+    clapper_app_bus_post_prop_notify (player->app_bus,
+        GST_OBJECT_CAST (self), param_specs[PROP_PRELOAD_FETCH_LIMIT]);
+    clapper_preloader_schedule_refresh (player->preloader);
+
+    gst_object_unref (player);
+  }
+}
+
+/**
+ * clapper_queue_get_preload_fetch_limit:
+ * @queue: a #ClapperQueue
+ *
+ * Get limit (in MiB) of data fetched ahead for preloading upcoming media items.
+ *
+ * Returns: preload fetch limit in MiB.
+ *
+ * Since: 0.12
+ */
+guint
+clapper_queue_get_preload_fetch_limit (ClapperQueue *self)
+{
+  guint limit;
+
+  g_return_val_if_fail (CLAPPER_IS_QUEUE (self), DEFAULT_PRELOAD_FETCH_LIMIT);
+
+  GST_OBJECT_LOCK (self);
+  limit = self->preload_fetch_limit;
+  GST_OBJECT_UNLOCK (self);
+
+  return limit;
+}
+
+/**
+ * clapper_queue_set_warmup_flags:
+ * @queue: a #ClapperQueue
+ * @flags: a #ClapperQueueWarmupFlags
+ *
+ * Set in which progression modes connection to the next network
+ * media item should be warmed up while current one is playing.
+ *
+ * Warm-up makes a cheap request for the next item a few seconds before
+ * current one ends, so host name is resolved and a connection (including
+ * TLS handshake) is opened and kept alive for when the queue progresses
+ * to it. Unlike preloading (see [property@Clapper.Queue:preload-items]),
+ * it is done only for the next item and is skipped for items that are
+ * already preloaded.
+ *
+ * How long the warm-up request took to get its first response is reported
+ * with [method@Clapper.StartupReport.get_warmup_request_latency]. This is
+ * the wait that was moved out of item startup, not a measured saving, and
+ * it is only reported when the warmed up connection could be reused.
+ *
+ * Since: 0.12
+ */
+void
+clapper_queue_set_warmup_flags (ClapperQueue *self, ClapperQueueWarmupFlags flags)
+{
+  gboolean changed;
+
+  g_return_if_fail (CLAPPER_IS_QUEUE (self));
+
+  GST_OBJECT_LOCK (self);
+  if ((changed = self->warmup_flags != flags))
+    self->warmup_flags = flags;
+  GST_OBJECT_UNLOCK (self);
+
+  if (changed) {
+    ClapperPlayer *player = clapper_player_get_from_ancestor (GST_OBJECT_CAST (self));
+
+    clapper_app_bus_post_prop_notify (player->app_bus,
+        GST_OBJECT_CAST (self), param_specs[PROP_WARMUP_FLAGS]);
+    clapper_preloader_schedule_refresh (player->preloader);
+
+    gst_object_unref (player);
+  }
+}
+
+/**
+ * clapper_queue_get_warmup_flags:
+ * @queue: a #ClapperQueue
+ *
+ * Get in which progression modes connection to the next item is warmed up.
+ *
+ * Returns: currently set #ClapperQueueWarmupFlags.
+ *
+ * Since: 0.12
+ */
+ClapperQueueWarmupFlags
+clapper_queue_get_warmup_flags (ClapperQueue *self)
+{
+  ClapperQueueWarmupFlags flags;
+
+  g_return_val_if_fail (CLAPPER_IS_QUEUE (self), DEFAULT_WARMUP_FLAGS);
+
+  GST_OBJECT_LOCK (self);
+  flags = self->warmup_flags;
+  GST_OBJECT_UNLOCK (self);
+
+  return flags;
+}
+
+/**
+ * clapper_queue_set_warmup_prefetch_size:
+ * @queue: a #ClapperQueue
+ * @size: amount of data in KiB
+ *
+ * Set how much data (in KiB) from the beginning of the next media item
+ * should be requested during warm-up.
+ *
+ * When set to 0 (default), only headers are requested. Otherwise a ranged
+ * request is made, which also makes servers and CDNs bring the beginning
+ * of media into their caches. Fetched data itself is discarded.
+ *
+ * Since: 0.12
+ */
+void
+clapper_queue_set_warmup_prefetch_size (ClapperQueue *self, guint size)
+{
+  gboolean changed;
+
+  g_return_if_fail (CLAPPER_IS_QUEUE (self));
+
+  GST_OBJECT_LOCK (self);
+  if ((changed = self->warmup_prefetch_size != size))
+    self->warmup_prefetch_size = size;
+  GST_OBJECT_UNLOCK (self);
+
+  if (changed) {
+    ClapperPlayer *player = clapper_player_get_from_ancestor (GST_OBJECT_CAST (self));
+
+    clapper_app_bus_post_prop_notify (player->app_bus,
+        GST_OBJECT_CAST (self), param_specs[PROP_WARMUP_PREFETCH_SIZE]);
+
+    gst_object_unref (player);
+  }
+}
+
+/**
+ * clapper_queue_get_warmup_prefetch_size:
+ * @queue: a #ClapperQueue
+ *
+ * Get how much data (in KiB) is requested during warm-up.
+ *
+ * Returns: warm-up prefetch size in KiB.
+ *
+ * Since: 0.12
+ */
+guint
+clapper_queue_get_warmup_prefetch_size (ClapperQueue *self)
+{
+  guint size;
+
+  g_return_val_if_fail (CLAPPER_IS_QUEUE (self), DEFAULT_WARMUP_PREFETCH_SIZE);
+
+  GST_OBJECT_LOCK (self);
+  size = self->warmup_prefetch_size;
+  GST_OBJECT_UNLOCK (self);
+
+  return size;
+}
+
+/**
+ * clapper_queue_save_to_file:
+ * @queue: a #ClapperQueue
+ * @filename: (type filename): a path to file where snapshot should be written
+ * @error: return location for a #GError, or %NULL
+ *
+ * Save a snapshot of the queue into a compact binary file.
+ *
+ * Snapshot includes all media items with their URIs, tags, durations,
+ * cache locations and timeline markers, together with current index,
+ * [property@Clapper.Queue:progression-mode] and current playback position.
+ *
+ * Snapshot can be restored later with [method@Clapper.Queue.load_from_file].
+ * Note that the file format is tied to Clapper version that created it.
+ *
+ * Returns: %TRUE if snapshot was saved, %FALSE otherwise.
+ *
+ * Since: 0.12
+ */
+gboolean
+clapper_queue_save_to_file (ClapperQueue *self, const gchar *filename, GError **error)
+{
+  ClapperPlayer *player;
+  GByteArray *bytes;
+  gdouble position = 0;
+  guint i;
+  gboolean success;
+
+  g_return_val_if_fail (CLAPPER_IS_QUEUE (self), FALSE);
+  g_return_val_if_fail (filename != NULL, FALSE);
+  g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+
+  /* File is at user chosen path, so it does not depend on cache being enabled */
+  bytes = clapper_cache_create_data ();
+
+  GST_DEBUG_OBJECT (self, "Saving queue snapshot to file: \"%s\"", filename);
+
+  if ((player = clapper_player_get_from_ancestor (GST_OBJECT_CAST (self)))) {
+    position = clapper_player_get_position (player);
+    gst_object_unref (player);
+  }
+
+  clapper_cache_store_string (bytes, CLAPPER_QUEUE_SNAPSHOT_ID);
+  clapper_cache_store_int (bytes, (gint) clapper_queue_get_progression_mode (self));
+
+  CLAPPER_QUEUE_REC_LOCK (self);
+
+  clapper_cache_store_uint (bytes, self->current_index);
+  clapper_cache_store_double (bytes, (self->current_item) ? position : 0);
+  clapper_cache_store_uint (bytes, self->items->len);
+
+  for (i = 0; i < self->items->len; ++i) {
+    ClapperMediaItem *item = g_ptr_array_index (self->items, i);
+
+    if (item) {
+      clapper_media_item_store_to_cache (item, bytes);
+    } else {
+      ClapperQueueRecord *record = g_ptr_array_index (self->records, i);
+
+      if (record->state) {
+        gsize size;
+        gconstpointer state = g_bytes_get_data (record->state, &size);
+
+        g_byte_array_append (bytes, state, size);
+      } else {
+        clapper_media_item_store_lazy_to_cache (bytes, record->uri,
+            record->title, record->duration);
+      }
+    }
+  }
+
+  GST_DEBUG_OBJECT (self, "Stored %u items", self->items->len);
+
+  CLAPPER_QUEUE_REC_UNLOCK (self);
+
+  if ((success = clapper_cache_write (filename, bytes, error)))
+    GST_DEBUG_OBJECT (self, "Successfully saved queue snapshot");
+
+  g_byte_array_free (bytes, TRUE);
+
+  return success;
+}
+
+/**
+ * clapper_queue_load_from_file:
+ * @queue: a #ClapperQueue
+ * @filename: (type filename): a path to snapshot file
+ * @error: return location for a #GError, or %NULL
+ *
+ * Restore queue from a snapshot file saved with [method@Clapper.Queue.save_to_file].
+ *
+ * Current queue content is replaced with all media items from snapshot, which
+ * are inserted in a single operation. Restored items already have their tags and
+ * durations filled, so they do not need to be discovered again. Previously current
+ * item gets selected and its playback will start from the saved position.
+ *
+ * This function must be called from the main thread.
+ *
+ * Returns: %TRUE if snapshot was loaded, %FALSE otherwise.
+ *
+ * Since: 0.12
+ */
+gboolean
+clapper_queue_load_from_file (ClapperQueue *self, const gchar *filename, GError **error)
+{
+  GMappedFile *mapped_file;
+  GPtrArray *items;
+  GError *local_error = NULL;
+  ClapperQueueProgressionMode mode;
+  const gchar *data, *end;
+  guint i, n_items, current_index;
+  gdouble position;
+
+  g_return_val_if_fail (CLAPPER_IS_QUEUE (self), FALSE);
+  g_return_val_if_fail (filename != NULL, FALSE);
+  g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+
+  GST_DEBUG_OBJECT (self, "Loading queue snapshot from file: \"%s\"", filename);
+
+  if (!(mapped_file = clapper_cache_map_file (filename, &data, &local_error))) {
+    /* No error if version mismatch */
+    if (!local_error) {
+      local_error = g_error_new (G_FILE_ERROR, G_FILE_ERROR_FAILED,
+          "Queue snapshot is from different Clapper version");
+    }
+    g_propagate_error (error, local_error);
+
+    return FALSE;
+  }
+
+  end = g_mapped_file_get_contents (mapped_file) + g_mapped_file_get_length (mapped_file);
+
+  if (G_UNLIKELY (!clapper_cache_can_read_string (data, end)
+      || g_strcmp0 (clapper_cache_read_string (&data), CLAPPER_QUEUE_SNAPSHOT_ID) != 0)) {
+    g_set_error (error, G_FILE_ERROR, G_FILE_ERROR_FAILED,
+        "File is not a queue snapshot");
+    g_mapped_file_unref (mapped_file);
+
+    return FALSE;
+  }
+
+  if (G_UNLIKELY (!clapper_cache_can_read (data, end,
+      sizeof (gint) + 2 * sizeof (guint) + sizeof (gdouble)))) {
+    g_set_error (error, G_FILE_ERROR, G_FILE_ERROR_FAILED,
+        "Queue snapshot is truncated");
+    g_mapped_file_unref (mapped_file);
+
+    return FALSE;
+  }
+
+  mode = (ClapperQueueProgressionMode) clapper_cache_read_int (&data);
+  current_index = clapper_cache_read_uint (&data);
+  position = clapper_cache_read_double (&data);
+  n_items = clapper_cache_read_uint (&data);
+
+  /* Each stored item takes at least one byte, so a corrupted
+   * count cannot make us preallocate more than file size */
+  if (G_UNLIKELY (n_items > (gsize) (end - data))) {
+    g_set_error (error, G_FILE_ERROR, G_FILE_ERROR_FAILED,
+        "Queue snapshot is truncated");
+    g_mapped_file_unref (mapped_file);
+
+    return FALSE;
+  }
+
+  if (G_UNLIKELY ((guint) mode > CLAPPER_QUEUE_PROGRESSION_SHUFFLE)) {
+    GST_WARNING_OBJECT (self, "Invalid progression mode in snapshot: %i", mode);
+    mode = CLAPPER_QUEUE_PROGRESSION_NONE;
+  }
+
+  /* Create all items before taking queue lock */
+  items = g_ptr_array_new_full (n_items, (GDestroyNotify) gst_object_unref);
+  for (i = 0; i < n_items; ++i) {
+    ClapperMediaItem *item;
+
+    if (G_UNLIKELY ((item = clapper_media_item_new_from_cache (&data, end)) == NULL)) {
+      g_set_error (error, G_FILE_ERROR, G_FILE_ERROR_FAILED,
+          "Queue snapshot is corrupted at item %u", i);
+      g_ptr_array_unref (items);
+      g_mapped_file_unref (mapped_file);
+
+      return FALSE;
+    }
+    g_ptr_array_add (items, item);
+  }
+
+  g_mapped_file_unref (mapped_file);
+
+  GST_DEBUG_OBJECT (self, "Read %u items, current index: %u, position: %lf",
+      n_items, current_index, position);
+
+  clapper_queue_set_progression_mode (self, mode);
+
+  /* References are transferred to the queue below */
+  g_ptr_array_set_free_func (items, NULL);
+
+  CLAPPER_QUEUE_REC_LOCK (self);
+
+  clapper_queue_clear (self);
+
+  if (n_items > 0) {
+    for (i = 0; i < n_items; ++i) {
+      ClapperMediaItem *item = g_ptr_array_index (items, i);
+
+      g_ptr_array_add (self->items, item); // transfers reference
+      g_ptr_array_add (self->records, NULL);
+      gst_object_set_parent (GST_OBJECT_CAST (item), GST_OBJECT_CAST (self));
+      _index_item_unlocked (self, item, i);
+    }
+
+    _announce_model_update (self, 0, 0, n_items, NULL);
+
+    if (current_index < n_items) {
+      self->start_position = position;
+
+      if (_replace_current_item_unlocked (self,
+          g_ptr_array_index (self->items, current_index), current_index))
+        _announce_current_item_and_index_change (self);
+
+      self->start_position = 0;
+    }
+  }
+
+  CLAPPER_QUEUE_REC_UNLOCK (self);
+
+  g_ptr_array_free (items, TRUE);
+
+  return TRUE;
 }
 
 static void
@@ -1243,11 +2429,23 @@ clapper_queue_init (ClapperQueue *self)
   g_rec_mutex_init (&self->rec_lock);
 
   self->items = g_ptr_array_new_with_free_func ((GDestroyNotify) _item_remove_func);
+  self->item_indexes = g_hash_table_new (g_direct_hash, g_direct_equal);
+  self->id_items = g_hash_table_new (g_direct_hash, g_direct_equal);
+  self->stale_index = G_MAXUINT;
+
+  self->records = g_ptr_array_new_with_free_func ((GDestroyNotify) _record_free);
+  self->id_records = g_hash_table_new (g_direct_hash, g_direct_equal);
+  g_queue_init (&self->materialized);
 
   self->current_index = CLAPPER_QUEUE_INVALID_POSITION;
   self->progression_mode = DEFAULT_PROGRESSION_MODE;
   self->gapless = DEFAULT_GAPLESS;
   self->instant = DEFAULT_INSTANT;
+  self->max_materialized = DEFAULT_MAX_MATERIALIZED;
+  self->preload_items = DEFAULT_PRELOAD_ITEMS;
+  self->preload_fetch_limit = DEFAULT_PRELOAD_FETCH_LIMIT;
+  self->warmup_flags = DEFAULT_WARMUP_FLAGS;
+  self->warmup_prefetch_size = DEFAULT_WARMUP_PREFETCH_SIZE;
 }
 
 static void
@@ -1261,6 +2459,12 @@ clapper_queue_finalize (GObject *object)
 
   gst_clear_object (&self->current_item);
   g_ptr_array_unref (self->items);
+  g_hash_table_unref (self->item_indexes);
+  g_hash_table_unref (self->id_items);
+
+  g_queue_clear (&self->materialized);
+  g_ptr_array_unref (self->records);
+  g_hash_table_unref (self->id_records);
 
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
@@ -1290,6 +2494,21 @@ clapper_queue_get_property (GObject *object, guint prop_id,
     case PROP_INSTANT:
       g_value_set_boolean (value, clapper_queue_get_instant (self));
       break;
+    case PROP_MAX_MATERIALIZED:
+      g_value_set_uint (value, clapper_queue_get_max_materialized (self));
+      break;
+    case PROP_PRELOAD_ITEMS:
+      g_value_set_uint (value, clapper_queue_get_preload_items (self));
+      break;
+    case PROP_PRELOAD_FETCH_LIMIT:
+      g_value_set_uint (value, clapper_queue_get_preload_fetch_limit (self));
+      break;
+    case PROP_WARMUP_FLAGS:
+      g_value_set_flags (value, clapper_queue_get_warmup_flags (self));
+      break;
+    case PROP_WARMUP_PREFETCH_SIZE:
+      g_value_set_uint (value, clapper_queue_get_warmup_prefetch_size (self));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1315,6 +2534,21 @@ clapper_queue_set_property (GObject *object, guint prop_id,
     case PROP_INSTANT:
       clapper_queue_set_instant (self, g_value_get_boolean (value));
       break;
+    case PROP_MAX_MATERIALIZED:
+      clapper_queue_set_max_materialized (self, g_value_get_uint (value));
+      break;
+    case PROP_PRELOAD_ITEMS:
+      clapper_queue_set_preload_items (self, g_value_get_uint (value));
+      break;
+    case PROP_PRELOAD_FETCH_LIMIT:
+      clapper_queue_set_preload_fetch_limit (self, g_value_get_uint (value));
+      break;
+    case PROP_WARMUP_FLAGS:
+      clapper_queue_set_warmup_flags (self, g_value_get_flags (value));
+      break;
+    case PROP_WARMUP_PREFETCH_SIZE:
+      clapper_queue_set_warmup_prefetch_size (self, g_value_get_uint (value));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1387,5 +2621,64 @@ clapper_queue_class_init (ClapperQueueClass *klass)
       NULL, NULL, DEFAULT_INSTANT,
       G_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY | G_PARAM_STATIC_STRINGS);
 
+  /**
+   * ClapperQueue:max-materialized:
+   *
+   * Maximal number of media items created from lazy entries
+   * that queue keeps around when they are not used.
+   *
+   * Since: 0.12
+   */
+  param_specs[PROP_MAX_MATERIALIZED] = g_param_spec_uint ("max-materialized",
+      NULL, NULL, 1, G_MAXUINT, DEFAULT_MAX_MATERIALIZED,
+      G_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY | G_PARAM_STATIC_STRINGS);
+
+  /**
+   * ClapperQueue:preload-items:
+   *
+   * Maximal number of upcoming media items to preload.
+   *
+   * Since: 0.12
+   */
+  param_specs[PROP_PRELOAD_ITEMS] = g_param_spec_uint ("preload-items",
+      NULL, NULL, 0, G_MAXUINT, DEFAULT_PRELOAD_ITEMS,
+      G_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY | G_PARAM_STATIC_STRINGS);
+
+  /**
+   * ClapperQueue:preload-fetch-limit:
+   *
+   * Approximate limit (in MiB) of data fetched ahead for preloaded media items.
+   *
+   * This bounds fetched bytes, not memory of decoded state,
+   * as preloaded items are never demuxed or decoded.
+   *
+   * Since: 0.12
+   */
+  param_specs[PROP_PRELOAD_FETCH_LIMIT] = g_param_spec_uint ("preload-fetch-limit",
+      NULL, NULL, 0, G_MAXUINT, DEFAULT_PRELOAD_FETCH_LIMIT,
+      G_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY | G_PARAM_STATIC_STRINGS);
+
+  /**
+   * ClapperQueue:warmup-flags:
+   *
+   * Progression modes in which connection to the next item is warmed up.
+   *
+   * Since: 0.12
+   */
+  param_specs[PROP_WARMUP_FLAGS] = g_param_spec_flags ("warmup-flags",
+      NULL, NULL, CLAPPER_TYPE_QUEUE_WARMUP_FLAGS, DEFAULT_WARMUP_FLAGS,
+      G_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY | G_PARAM_STATIC_STRINGS);
+
+  /**
+   * ClapperQueue:warmup-prefetch-size:
+   *
+   * Amount of data (in KiB) requested from the beginning of next item during warm-up.
+   *
+   * Since: 0.12
+   */
+  param_specs[PROP_WARMUP_PREFETCH_SIZE] = g_param_spec_uint ("warmup-prefetch-size",
+      NULL, NULL, 0, G_MAXUINT, DEFAULT_WARMUP_PREFETCH_SIZE,
+      G_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY | G_PARAM_STATIC_STRINGS);
+
   g_object_class_install_properties (gobject_class, PROP_LAST, param_specs);
 }
@@ -54,6 +54,9 @@ void clapper_queue_insert_item (ClapperQueue *queue, ClapperMediaItem *item, gin
 CLAPPER_API
 void clapper_queue_insert_item_after (ClapperQueue *queue, ClapperMediaItem *item, ClapperMediaItem *after_item);
 
+CLAPPER_API
+guint clapper_queue_add_lazy_item (ClapperQueue *queue, const gchar *uri, const gchar *title, gdouble duration);
+
 CLAPPER_API
 void clapper_queue_reposition_item (ClapperQueue *queue, ClapperMediaItem *item, gint index);
 
@@ -96,6 +99,9 @@ gboolean clapper_queue_item_is_current (ClapperQueue *queue, ClapperMediaItem *i
 CLAPPER_API
 gboolean clapper_queue_find_item (ClapperQueue *queue, ClapperMediaItem *item, guint *index);
 
+CLAPPER_API
+ClapperMediaItem * clapper_queue_get_item_by_id (ClapperQueue *queue, guint id);
+
 CLAPPER_API
 guint clapper_queue_get_n_items (ClapperQueue *queue);
 
@@ -117,4 +123,40 @@ void clapper_queue_set_instant (ClapperQueue *queue, gboolean instant);
 CLAPPER_API
 gboolean clapper_queue_get_instant (ClapperQueue *queue);
 
+CLAPPER_API
+void clapper_queue_set_max_materialized (ClapperQueue *queue, guint max_materialized);
+
+CLAPPER_API
+guint clapper_queue_get_max_materialized (ClapperQueue *queue);
+
+CLAPPER_API
+void clapper_queue_set_preload_items (ClapperQueue *queue, guint preload_items);
+
+CLAPPER_API
+guint clapper_queue_get_preload_items (ClapperQueue *queue);
+
+CLAPPER_API
+void clapper_queue_set_preload_fetch_limit (ClapperQueue *queue, guint limit);
+
+CLAPPER_API
+guint clapper_queue_get_preload_fetch_limit (ClapperQueue *queue);
+
+CLAPPER_API
+void clapper_queue_set_warmup_flags (ClapperQueue *queue, ClapperQueueWarmupFlags flags);
+
+CLAPPER_API
+ClapperQueueWarmupFlags clapper_queue_get_warmup_flags (ClapperQueue *queue);
+
+CLAPPER_API
+void clapper_queue_set_warmup_prefetch_size (ClapperQueue *queue, guint size);
+
+CLAPPER_API
+guint clapper_queue_get_warmup_prefetch_size (ClapperQueue *queue);
+
+CLAPPER_API
+gboolean clapper_queue_save_to_file (ClapperQueue *queue, const gchar *filename, GError **error);
+
+CLAPPER_API
+gboolean clapper_queue_load_from_file (ClapperQueue *queue, const gchar *filename, GError **error);
+
 G_END_DECLS
@@ -38,6 +38,9 @@ void clapper_reactables_manager_initialize (void);
 G_GNUC_INTERNAL
 ClapperReactablesManager * clapper_reactables_manager_new (void);
 
+G_GNUC_INTERNAL
+gboolean clapper_reactables_manager_has_position_interest (ClapperReactablesManager *manager);
+
 G_GNUC_INTERNAL
 void clapper_reactables_manager_post_message (ClapperReactablesManager *manager, GstMessage *msg);
 
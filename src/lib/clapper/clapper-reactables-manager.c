@@ -45,6 +45,9 @@ struct _ClapperReactablesManager
   GPtrArray *array;
 
   gboolean prepare_called;
+
+  /* Union of event masks of prepared reactables (atomic) */
+  guint event_mask;
 };
 
 #define parent_class clapper_reactables_manager_parent_class
@@ -95,20 +98,30 @@ static ClapperBusQuark _quarks[] = {
 #define _EVENT(e) G_PASTE(CLAPPER_REACTABLES_MANAGER_EVENT_, e)
 #define _QUARK(q) (_quarks[CLAPPER_REACTABLES_MANAGER_QUARK_##q].quark)
 
-#define _BUS_POST_EVENT_SINGLE(event_id,lower,type,val) { \
-  GValue _value = G_VALUE_INIT;                           \
-  g_value_init (&_value, type);                           \
-  g_value_set_##lower (&_value, val);                     \
-  _bus_post_event (self, event_id, &_value, NULL); }
+#define _EVENT_BIT(e) (1u << _EVENT (e))
+#define _HAS_INTEREST(self,event_id) \
+  ((g_atomic_int_get (&self->event_mask) & (1u << (event_id))) != 0)
+
+#define _MASK_ADD_IF_SET(_iface,_vfunc,_event) \
+  if (_iface->_vfunc) mask |= _EVENT_BIT (_event)
+
+/* Values are only boxed for events that some reactable will handle */
+#define _BUS_POST_EVENT_SINGLE(event_id,lower,type,val) {  \
+  if (_HAS_INTEREST (self, event_id)) {                    \
+    GValue _value = G_VALUE_INIT;                          \
+    g_value_init (&_value, type);                          \
+    g_value_set_##lower (&_value, val);                    \
+    _bus_post_event (self, event_id, &_value, NULL); } }
 
 #define _BUS_POST_EVENT_DUAL(event_id,lower1,type1,val1,lower2,type2,val2) { \
-  GValue _value1 = G_VALUE_INIT;                                             \
-  GValue _value2 = G_VALUE_INIT;                                             \
-  g_value_init (&_value1, type1);                                            \
-  g_value_init (&_value2, type2);                                            \
-  g_value_set_##lower1 (&_value1, val1);                                     \
-  g_value_set_##lower2 (&_value2, val2);                                     \
-  _bus_post_event (self, event_id, &_value1, &_value2); }
+  if (_HAS_INTEREST (self, event_id)) {                                      \
+    GValue _value1 = G_VALUE_INIT;                                           \
+    GValue _value2 = G_VALUE_INIT;                                           \
+    g_value_init (&_value1, type1);                                          \
+    g_value_init (&_value2, type2);                                          \
+    g_value_set_##lower1 (&_value1, val1);                                   \
+    g_value_set_##lower2 (&_value2, val2);                                   \
+    _bus_post_event (self, event_id, &_value1, &_value2); } }
 
 void
 clapper_reactables_manager_initialize (void)
@@ -145,10 +158,33 @@ _settings_changed_cb (GSettings *settings, const gchar *key, ClapperReactableMan
   }
 }
 
+static guint
+_get_reactable_event_mask (ClapperReactable *reactable)
+{
+  ClapperReactableInterface *reactable_iface = CLAPPER_REACTABLE_GET_IFACE (reactable);
+  guint mask = 0;
+
+  _MASK_ADD_IF_SET (reactable_iface, state_changed, STATE_CHANGED);
+  _MASK_ADD_IF_SET (reactable_iface, position_changed, POSITION_CHANGED);
+  _MASK_ADD_IF_SET (reactable_iface, speed_changed, SPEED_CHANGED);
+  _MASK_ADD_IF_SET (reactable_iface, volume_changed, VOLUME_CHANGED);
+  _MASK_ADD_IF_SET (reactable_iface, mute_changed, MUTE_CHANGED);
+  _MASK_ADD_IF_SET (reactable_iface, played_item_changed, PLAYED_ITEM_CHANGED);
+  _MASK_ADD_IF_SET (reactable_iface, item_updated, ITEM_UPDATED);
+  _MASK_ADD_IF_SET (reactable_iface, queue_item_added, QUEUE_ITEM_ADDED);
+  _MASK_ADD_IF_SET (reactable_iface, queue_item_removed, QUEUE_ITEM_REMOVED);
+  _MASK_ADD_IF_SET (reactable_iface, queue_item_repositioned, QUEUE_ITEM_REPOSITIONED);
+  _MASK_ADD_IF_SET (reactable_iface, queue_cleared, QUEUE_CLEARED);
+  _MASK_ADD_IF_SET (reactable_iface, queue_progression_changed, QUEUE_PROGRESSION_CHANGED);
+
+  return mask;
+}
+
 static inline void
 clapper_reactables_manager_handle_prepare (ClapperReactablesManager *self)
 {
   ClapperPlayer *player;
+  guint event_mask = 0;
 
   GST_INFO_OBJECT (self, "Preparing reactable enhancers");
   player = CLAPPER_PLAYER_CAST (gst_object_get_parent (GST_OBJECT_CAST (self)));
@@ -192,6 +228,8 @@ clapper_reactables_manager_handle_prepare (ClapperReactablesManager *self)
           gst_structure_free (config);
         }
 
+        event_mask |= _get_reactable_event_mask (reactable);
+
         g_ptr_array_add (self->array, data);
         gst_object_set_parent (GST_OBJECT_CAST (data->reactable), GST_OBJECT_CAST (player));
       }
@@ -199,6 +237,12 @@ clapper_reactables_manager_handle_prepare (ClapperReactablesManager *self)
 
     GST_INFO_OBJECT (self, "Prepared %i reactable enhancers", self->array->len);
     gst_object_unref (player);
+
+    /* Until now all events were posted, as it was unknown what
+     * reactables will be interested in. From now on only post the
+     * ones that at least one of them can handle. */
+    GST_DEBUG_OBJECT (self, "Reactables event mask: 0x%x", event_mask);
+    g_atomic_int_set (&self->event_mask, event_mask);
   } else {
     GST_ERROR_OBJECT (self, "Could not prepare reactable enhancers!");
   }
@@ -363,7 +407,13 @@ static void
 _bus_post_event (ClapperReactablesManager *self, guint event_id,
     GValue *value, GValue *extra_value)
 {
-  GstStructure *structure = gst_structure_new_id (_QUARK (EVENT),
+  GstStructure *structure;
+
+  /* Checked again for events posted without values */
+  if (!_HAS_INTEREST (self, event_id))
+    return;
+
+  structure = gst_structure_new_id (_QUARK (EVENT),
       _QUARK (EVENT), G_TYPE_ENUM, event_id,
       NULL);
 
@@ -392,6 +442,12 @@ clapper_reactables_manager_new (void)
   return reactables_manager;
 }
 
+gboolean
+clapper_reactables_manager_has_position_interest (ClapperReactablesManager *self)
+{
+  return _HAS_INTEREST (self, _EVENT (POSITION_CHANGED));
+}
+
 void
 clapper_reactables_manager_post_message (ClapperReactablesManager *self, GstMessage *msg)
 {
@@ -541,6 +597,8 @@ clapper_reactables_manager_thread_stop (ClapperThreadedObject *threaded_object)
 static void
 clapper_reactables_manager_init (ClapperReactablesManager *self)
 {
+  /* Interested in everything until reactables are prepared */
+  self->event_mask = G_MAXUINT;
 }
 
 static void
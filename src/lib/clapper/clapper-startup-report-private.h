@@ -0,0 +1,59 @@
+/* Clapper Playback Library
+ * Copyright (C) 2025 Rafał Dzięgiel <rafostar.github@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <glib.h>
+
+#include "clapper-enums.h"
+#include "clapper-startup-report.h"
+
+G_BEGIN_DECLS
+
+#define CLAPPER_STARTUP_N_PHASES (CLAPPER_STARTUP_PHASE_FIRST_FRAME + 1)
+
+typedef struct _ClapperStartupHistogram ClapperStartupHistogram;
+
+G_GNUC_INTERNAL
+ClapperStartupReport * clapper_startup_report_new (ClapperMediaItem *item);
+
+G_GNUC_INTERNAL
+gboolean clapper_startup_report_mark_phase (ClapperStartupReport *report, ClapperStartupPhase phase, gint64 time);
+
+G_GNUC_INTERNAL
+void clapper_startup_report_restart (ClapperStartupReport *report, gint64 time);
+
+G_GNUC_INTERNAL
+void clapper_startup_report_set_harvest_cached (ClapperStartupReport *report, gboolean cached);
+
+G_GNUC_INTERNAL
+void clapper_startup_report_set_warmup_request_latency (ClapperStartupReport *report, gint64 latency);
+
+G_GNUC_INTERNAL
+ClapperStartupHistogram * clapper_startup_histogram_new (void);
+
+G_GNUC_INTERNAL
+void clapper_startup_histogram_add_report (ClapperStartupHistogram *histogram, ClapperStartupReport *report);
+
+G_GNUC_INTERNAL
+gdouble clapper_startup_histogram_get_percentile (ClapperStartupHistogram *histogram, ClapperStartupPhase phase, gdouble percentile);
+
+G_GNUC_INTERNAL
+void clapper_startup_histogram_free (ClapperStartupHistogram *histogram);
+
+G_END_DECLS
@@ -0,0 +1,361 @@
+/* Clapper Playback Library
+ * Copyright (C) 2025 Rafał Dzięgiel <rafostar.github@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * ClapperStartupReport:
+ *
+ * Timings of a media item startup.
+ *
+ * Each time [class@Clapper.Player] begins playback of a new media item, it
+ * records a moment at which each of the [enum@Clapper.StartupPhase] was reached.
+ * Once item is prerolled, player emits [signal@Clapper.Player::startup-report]
+ * with a report describing where the time was spent, so applications
+ * can tell whether slow start was caused by e.g. URI extraction,
+ * network or decoding.
+ *
+ * Reports received from the player are immutable. Aggregated
+ * timings from all reports can be obtained with
+ * [method@Clapper.Player.get_startup_percentile].
+ *
+ * Since: 0.12
+ */
+
+#include <math.h>
+
+#include "clapper-startup-report-private.h"
+#include "clapper-media-item.h"
+
+#define GST_CAT_DEFAULT clapper_startup_report_debug
+GST_DEBUG_CATEGORY_STATIC (GST_CAT_DEFAULT);
+
+/* Four buckets per doubling of milliseconds, up to around 4 minutes */
+#define HISTOGRAM_BUCKETS_PER_OCTAVE 4
+#define HISTOGRAM_N_BUCKETS 72
+
+struct _ClapperStartupReport
+{
+  GstObject parent;
+
+  ClapperMediaItem *item;
+
+  /* Monotonic time of each phase, zero when not reached */
+  gint64 times[CLAPPER_STARTUP_N_PHASES];
+  gboolean harvest_cached;
+  gint64 warmup_request_latency; // usec
+};
+
+struct _ClapperStartupHistogram
+{
+  guint buckets[CLAPPER_STARTUP_N_PHASES][HISTOGRAM_N_BUCKETS];
+  guint n_samples[CLAPPER_STARTUP_N_PHASES];
+};
+
+#define parent_class clapper_startup_report_parent_class
+G_DEFINE_TYPE (ClapperStartupReport, clapper_startup_report, GST_TYPE_OBJECT);
+
+ClapperStartupReport *
+clapper_startup_report_new (ClapperMediaItem *item)
+{
+  ClapperStartupReport *report;
+
+  report = g_object_new (CLAPPER_TYPE_STARTUP_REPORT, NULL);
+  gst_object_ref_sink (report);
+
+  report->item = (item) ? gst_object_ref (item) : NULL;
+  report->times[CLAPPER_STARTUP_PHASE_SELECTION] = g_get_monotonic_time ();
+
+  return report;
+}
+
+/*
+ * clapper_startup_report_mark_phase:
+ * @report: a #ClapperStartupReport
+ * @phase: a #ClapperStartupPhase
+ * @time: monotonic time at which @phase was reached
+ *
+ * Only the first time each phase is reached is recorded,
+ * so this can be safely called from any thread for
+ * events that can happen multiple times.
+ *
+ * Returns: whether @phase was newly marked.
+ */
+gboolean
+clapper_startup_report_mark_phase (ClapperStartupReport *self,
+    ClapperStartupPhase phase, gint64 time)
+{
+  gboolean marked;
+
+  GST_OBJECT_LOCK (self);
+  if ((marked = (self->times[phase] == 0)))
+    self->times[phase] = MAX (time, self->times[CLAPPER_STARTUP_PHASE_SELECTION]);
+  GST_OBJECT_UNLOCK (self);
+
+  if (marked) {
+    GST_DEBUG_OBJECT (self, "Reached phase %i after %.3lf seconds", phase,
+        (gdouble) (time - self->times[CLAPPER_STARTUP_PHASE_SELECTION]) / G_USEC_PER_SEC);
+  }
+
+  return marked;
+}
+
+/*
+ * Moves start of the report to given time. Phases reached
+ * before it are treated as reached right at the start.
+ */
+void
+clapper_startup_report_restart (ClapperStartupReport *self, gint64 time)
+{
+  guint i;
+
+  GST_OBJECT_LOCK (self);
+
+  self->times[CLAPPER_STARTUP_PHASE_SELECTION] = time;
+
+  for (i = CLAPPER_STARTUP_PHASE_SELECTION + 1; i < CLAPPER_STARTUP_N_PHASES; ++i) {
+    if (self->times[i] != 0 && self->times[i] < time)
+      self->times[i] = time;
+  }
+
+  GST_OBJECT_UNLOCK (self);
+}
+
+void
+clapper_startup_report_set_harvest_cached (ClapperStartupReport *self, gboolean cached)
+{
+  GST_OBJECT_LOCK (self);
+  self->harvest_cached = cached;
+  GST_OBJECT_UNLOCK (self);
+}
+
+void
+clapper_startup_report_set_warmup_request_latency (ClapperStartupReport *self, gint64 latency)
+{
+  GST_OBJECT_LOCK (self);
+  self->warmup_request_latency = latency;
+  GST_OBJECT_UNLOCK (self);
+}
+
+/**
+ * clapper_startup_report_get_media_item:
+ * @report: a #ClapperStartupReport
+ *
+ * Get the #ClapperMediaItem which startup is described by @report.
+ *
+ * Returns: (transfer none) (nullable): a #ClapperMediaItem.
+ *
+ * Since: 0.12
+ */
+ClapperMediaItem *
+clapper_startup_report_get_media_item (ClapperStartupReport *self)
+{
+  g_return_val_if_fail (CLAPPER_IS_STARTUP_REPORT (self), NULL);
+
+  return self->item;
+}
+
+/**
+ * clapper_startup_report_get_phase_time:
+ * @report: a #ClapperStartupReport
+ * @phase: a #ClapperStartupPhase
+ *
+ * Get time (in seconds) counted from media item selection
+ * until given startup @phase was reached.
+ *
+ * Not every phase is reached for every item. For example, extraction
+ * only happens for URIs handled by [iface@Clapper.Extractable] enhancers
+ * and first frame is only reported for video shown with `clappersink`.
+ *
+ * Returns: time of @phase in seconds or -1 if it was not reached.
+ *
+ * Since: 0.12
+ */
+gdouble
+clapper_startup_report_get_phase_time (ClapperStartupReport *self, ClapperStartupPhase phase)
+{
+  gdouble time = -1;
+
+  g_return_val_if_fail (CLAPPER_IS_STARTUP_REPORT (self), -1);
+  g_return_val_if_fail (phase < CLAPPER_STARTUP_N_PHASES, -1);
+
+  GST_OBJECT_LOCK (self);
+  if (self->times[phase] != 0) {
+    time = (gdouble) (self->times[phase]
+        - self->times[CLAPPER_STARTUP_PHASE_SELECTION]) / G_USEC_PER_SEC;
+  }
+  GST_OBJECT_UNLOCK (self);
+
+  return time;
+}
+
+/**
+ * clapper_startup_report_get_harvest_cached:
+ * @report: a #ClapperStartupReport
+ *
+ * Get whether extraction result was restored from cache
+ * instead of running the [iface@Clapper.Extractable] enhancer.
+ *
+ * This is only meaningful when [enum@Clapper.StartupPhase.EXTRACTION_END]
+ * phase was reached.
+ *
+ * Returns: %TRUE if harvest came from cache, %FALSE otherwise.
+ *
+ * Since: 0.12
+ */
+gboolean
+clapper_startup_report_get_harvest_cached (ClapperStartupReport *self)
+{
+  gboolean cached;
+
+  g_return_val_if_fail (CLAPPER_IS_STARTUP_REPORT (self), FALSE);
+
+  GST_OBJECT_LOCK (self);
+  cached = self->harvest_cached;
+  GST_OBJECT_UNLOCK (self);
+
+  return cached;
+}
+
+/**
+ * clapper_startup_report_get_warmup_request_latency:
+ * @report: a #ClapperStartupReport
+ *
+ * Get first byte latency (in seconds) of a request made to warm up
+ * connection to media item while previous one was still playing.
+ *
+ * This is the time it took to resolve host name, connect and receive
+ * the first response of a request made without an open connection.
+ * It is not a measurement of how much startup got faster, but rather
+ * tells how long of a wait warm-up took out of it, when the actual
+ * playback request could reuse the connection.
+ * See [property@Clapper.Queue:warmup-flags].
+ *
+ * Returns: first byte latency of warm-up request or 0 if item was not warmed up.
+ *
+ * Since: 0.12
+ */
+gdouble
+clapper_startup_report_get_warmup_request_latency (ClapperStartupReport *self)
+{
+  gint64 latency;
+
+  g_return_val_if_fail (CLAPPER_IS_STARTUP_REPORT (self), 0);
+
+  GST_OBJECT_LOCK (self);
+  latency = self->warmup_request_latency;
+  GST_OBJECT_UNLOCK (self);
+
+  return (gdouble) latency / G_USEC_PER_SEC;
+}
+
+ClapperStartupHistogram *
+clapper_startup_histogram_new (void)
+{
+  return g_new0 (ClapperStartupHistogram, 1);
+}
+
+static inline guint
+_histogram_bucket_for_time (gdouble seconds)
+{
+  gdouble index = floor (HISTOGRAM_BUCKETS_PER_OCTAVE * log2 (1.0 + seconds * 1000));
+
+  return (guint) CLAMP (index, 0, HISTOGRAM_N_BUCKETS - 1);
+}
+
+static inline gdouble
+_histogram_bucket_upper_time (guint bucket)
+{
+  return (exp2 ((gdouble) (bucket + 1) / HISTOGRAM_BUCKETS_PER_OCTAVE) - 1.0) / 1000;
+}
+
+void
+clapper_startup_histogram_add_report (ClapperStartupHistogram *histogram,
+    ClapperStartupReport *report)
+{
+  guint i;
+
+  /* Selection is always at zero, so only count it */
+  histogram->n_samples[CLAPPER_STARTUP_PHASE_SELECTION]++;
+
+  for (i = CLAPPER_STARTUP_PHASE_SELECTION + 1; i < CLAPPER_STARTUP_N_PHASES; ++i) {
+    gdouble time = clapper_startup_report_get_phase_time (report, i);
+
+    if (time < 0)
+      continue;
+
+    histogram->buckets[i][_histogram_bucket_for_time (time)]++;
+    histogram->n_samples[i]++;
+  }
+}
+
+/* Returns upper bound (in seconds) of the bucket holding given percentile */
+gdouble
+clapper_startup_histogram_get_percentile (ClapperStartupHistogram *histogram,
+    ClapperStartupPhase phase, gdouble percentile)
+{
+  guint i, rank, n_seen = 0;
+
+  if (histogram->n_samples[phase] == 0)
+    return -1;
+
+  if (phase == CLAPPER_STARTUP_PHASE_SELECTION)
+    return 0;
+
+  rank = (guint) ceil (percentile / 100.0 * histogram->n_samples[phase]);
+  rank = CLAMP (rank, 1, histogram->n_samples[phase]);
+
+  for (i = 0; i < HISTOGRAM_N_BUCKETS; ++i) {
+    if ((n_seen += histogram->buckets[phase][i]) >= rank)
+      return _histogram_bucket_upper_time (i);
+  }
+
+  return _histogram_bucket_upper_time (HISTOGRAM_N_BUCKETS - 1);
+}
+
+void
+clapper_startup_histogram_free (ClapperStartupHistogram *histogram)
+{
+  g_free (histogram);
+}
+
+static void
+clapper_startup_report_init (ClapperStartupReport *self)
+{
+}
+
+static void
+clapper_startup_report_finalize (GObject *object)
+{
+  ClapperStartupReport *self = CLAPPER_STARTUP_REPORT_CAST (object);
+
+  GST_TRACE_OBJECT (self, "Finalize");
+
+  gst_clear_object (&self->item);
+
+  G_OBJECT_CLASS (parent_class)->finalize (object);
+}
+
+static void
+clapper_startup_report_class_init (ClapperStartupReportClass *klass)
+{
+  GObjectClass *gobject_class = (GObjectClass *) klass;
+
+  GST_DEBUG_CATEGORY_INIT (GST_CAT_DEFAULT, "clapperstartupreport", 0,
+      "Clapper Startup Report");
+
+  gobject_class->finalize = clapper_startup_report_finalize;
+}
@@ -0,0 +1,53 @@
+/* Clapper Playback Library
+ * Copyright (C) 2025 Rafał Dzięgiel <rafostar.github@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#if !defined(__CLAPPER_INSIDE__) && !defined(CLAPPER_COMPILATION)
+#error "Only <clapper/clapper.h> can be included directly."
+#endif
+
+#include <glib.h>
+#include <glib-object.h>
+#include <gst/gst.h>
+
+#include <clapper/clapper-visibility.h>
+#include <clapper/clapper-enums.h>
+#include <clapper/clapper-media-item.h>
+
+G_BEGIN_DECLS
+
+#define CLAPPER_TYPE_STARTUP_REPORT (clapper_startup_report_get_type())
+#define CLAPPER_STARTUP_REPORT_CAST(obj) ((ClapperStartupReport *)(obj))
+
+CLAPPER_API
+G_DECLARE_FINAL_TYPE (ClapperStartupReport, clapper_startup_report, CLAPPER, STARTUP_REPORT, GstObject)
+
+CLAPPER_API
+ClapperMediaItem * clapper_startup_report_get_media_item (ClapperStartupReport *report);
+
+CLAPPER_API
+gdouble clapper_startup_report_get_phase_time (ClapperStartupReport *report, ClapperStartupPhase phase);
+
+CLAPPER_API
+gboolean clapper_startup_report_get_harvest_cached (ClapperStartupReport *report);
+
+CLAPPER_API
+gdouble clapper_startup_report_get_warmup_request_latency (ClapperStartupReport *report);
+
+G_END_DECLS
@@ -20,9 +20,16 @@
  * ClapperThreadedObject:
  *
  * A base class for creating objects that work within a separate thread.
+ *
+ * By default each object spawns its own thread. When `CLAPPER_EXECUTOR_THREADS`
+ * environment variable is set to a number of threads (or `auto` to match CPU cores),
+ * objects are instead multiplexed onto a shared pool of threads. Each object still
+ * has its own [struct@GLib.MainContext] which is only ever iterated from one
+ * thread at a time, so its events remain serialized.
  */
 
-#include "clapper-threaded-object.h"
+#include "clapper-threaded-object-private.h"
+#include "clapper-executor-private.h"
 
 #define GST_CAT_DEFAULT clapper_threaded_object_debug
 GST_DEBUG_CATEGORY_STATIC (GST_CAT_DEFAULT);
@@ -36,12 +43,48 @@ struct _ClapperThreadedObjectPrivate
   GThread *thread;
   GMainContext *context;
   GMainLoop *loop;
+  GSource *executor_source;
   gboolean started;
+  gboolean stopping; // deferred stop scheduled on dispose
 };
 
 #define parent_class clapper_threaded_object_parent_class
 G_DEFINE_TYPE_WITH_PRIVATE (ClapperThreadedObject, clapper_threaded_object, GST_TYPE_OBJECT)
 
+static GQuark dedicated_thread_quark = 0;
+
+/*
+ * clapper_threaded_object_class_set_dedicated_thread:
+ * @klass: a #ClapperThreadedObjectClass
+ *
+ * Make objects of this class (and subclasses) always spawn their own
+ * thread, even when shared executor is enabled. Meant for classes
+ * that block their thread for a long time, which would otherwise
+ * stall every other object sharing the same executor thread.
+ */
+void
+clapper_threaded_object_class_set_dedicated_thread (ClapperThreadedObjectClass *klass)
+{
+  g_type_set_qdata (G_OBJECT_CLASS_TYPE (klass),
+      dedicated_thread_quark, GINT_TO_POINTER (TRUE));
+}
+
+static gboolean
+_use_executor (ClapperThreadedObject *self)
+{
+  GType type;
+
+  if (!clapper_executor_is_enabled ())
+    return FALSE;
+
+  for (type = G_OBJECT_TYPE (self); type != CLAPPER_TYPE_THREADED_OBJECT; type = g_type_parent (type)) {
+    if (g_type_get_qdata (type, dedicated_thread_quark))
+      return FALSE;
+  }
+
+  return TRUE;
+}
+
 /**
  * clapper_threaded_object_get_context:
  * @threaded_object: a #ClapperThreadedObject
@@ -113,6 +156,90 @@ clapper_threaded_object_main (ClapperThreadedObject *self)
   return NULL;
 }
 
+/* Must be called with object context pushed as thread default */
+static void
+executor_start (ClapperThreadedObject *self)
+{
+  ClapperThreadedObjectClass *threaded_object_class = CLAPPER_THREADED_OBJECT_GET_CLASS (self);
+
+  GST_TRACE_OBJECT (self, "%s executor thread: %p",
+      G_OBJECT_CLASS_NAME (threaded_object_class), g_thread_self ());
+
+  if (threaded_object_class->thread_start)
+    threaded_object_class->thread_start (self);
+}
+
+static gboolean
+executor_start_cb (ClapperThreadedObject *self)
+{
+  ClapperThreadedObjectPrivate *priv = clapper_threaded_object_get_instance_private (self);
+
+  executor_start (self);
+
+  g_mutex_lock (&priv->lock);
+  priv->started = TRUE;
+  g_cond_signal (&priv->cond);
+  g_mutex_unlock (&priv->lock);
+
+  return G_SOURCE_REMOVE;
+}
+
+/* Must be called from executor thread that runs this object context */
+static void
+executor_stop (ClapperThreadedObject *self)
+{
+  ClapperThreadedObjectPrivate *priv = clapper_threaded_object_get_instance_private (self);
+  ClapperThreadedObjectClass *threaded_object_class = CLAPPER_THREADED_OBJECT_GET_CLASS (self);
+
+  if (threaded_object_class->thread_stop)
+    threaded_object_class->thread_stop (self);
+
+  clapper_executor_detach_context (priv->executor_source);
+}
+
+static gboolean
+executor_stop_cb (ClapperThreadedObject *self)
+{
+  ClapperThreadedObjectPrivate *priv = clapper_threaded_object_get_instance_private (self);
+
+  executor_stop (self);
+
+  g_mutex_lock (&priv->lock);
+  priv->started = FALSE;
+  g_cond_signal (&priv->cond);
+  g_mutex_unlock (&priv->lock);
+
+  return G_SOURCE_REMOVE;
+}
+
+static gboolean
+executor_deferred_stop_cb (ClapperThreadedObject *self)
+{
+  ClapperThreadedObjectPrivate *priv = clapper_threaded_object_get_instance_private (self);
+
+  executor_stop (self);
+
+  g_mutex_lock (&priv->lock);
+  priv->started = FALSE;
+  g_mutex_unlock (&priv->lock);
+
+  /* Drop reference taken on dispose, disposing object again */
+  gst_object_unref (self);
+
+  return G_SOURCE_REMOVE;
+}
+
+static inline void
+_invoke_on_context (GMainContext *context, GSourceFunc func, gpointer data)
+{
+  GSource *source = g_idle_source_new ();
+
+  g_source_set_priority (source, G_PRIORITY_HIGH);
+  g_source_set_callback (source, func, data, NULL);
+  g_source_attach (source, context);
+  g_source_unref (source);
+}
+
 static void
 clapper_threaded_object_init (ClapperThreadedObject *self)
 {
@@ -132,8 +259,25 @@ clapper_threaded_object_constructed (GObject *object)
 
   g_mutex_lock (&priv->lock);
 
-  priv->thread = g_thread_new (GST_OBJECT_NAME (object),
-      (GThreadFunc) clapper_threaded_object_main, self);
+  if (_use_executor (self)) {
+    priv->context = g_main_context_new ();
+
+    /* When created from within executor, context will be attached to the
+     * current thread, so waiting for it to start would deadlock */
+    if (clapper_executor_is_executor_thread ()) {
+      g_main_context_push_thread_default (priv->context);
+      executor_start (self);
+      g_main_context_pop_thread_default (priv->context);
+      priv->started = TRUE;
+    } else {
+      _invoke_on_context (priv->context, (GSourceFunc) executor_start_cb, self);
+    }
+
+    priv->executor_source = clapper_executor_attach_context (priv->context);
+  } else {
+    priv->thread = g_thread_new (GST_OBJECT_NAME (object),
+        (GThreadFunc) clapper_threaded_object_main, self);
+  }
   while (!priv->started)
     g_cond_wait (&priv->cond, &priv->lock);
 
@@ -150,7 +294,40 @@ clapper_threaded_object_dispose (GObject *object)
 
   g_mutex_lock (&priv->lock);
 
-  if (priv->loop) {
+  if (priv->executor_source) {
+    if (!priv->started) {
+      /* Already stopped (deferred stop below) */
+    } else if (clapper_executor_is_executor_thread ()
+        && g_main_context_acquire (priv->context)) {
+      /* When disposed from within executor thread that runs (or can run)
+       * this object context, stop right away, as waiting would deadlock */
+      g_main_context_push_thread_default (priv->context);
+      executor_stop (self);
+      g_main_context_pop_thread_default (priv->context);
+      g_main_context_release (priv->context);
+      priv->started = FALSE;
+    } else if (clapper_executor_is_executor_thread ()) {
+      /* Object runs on another executor thread, which might be waiting
+       * for this one right now, so waiting here could deadlock. Keep object
+       * alive until its thread stops it instead, then it is disposed again. */
+      if (!priv->stopping) {
+        priv->stopping = TRUE;
+        gst_object_ref (self);
+        _invoke_on_context (priv->context, (GSourceFunc) executor_deferred_stop_cb, self);
+      }
+      g_mutex_unlock (&priv->lock);
+
+      G_OBJECT_CLASS (parent_class)->dispose (object);
+      return;
+    } else {
+      _invoke_on_context (priv->context, (GSourceFunc) executor_stop_cb, self);
+      while (priv->started)
+        g_cond_wait (&priv->cond, &priv->lock);
+    }
+
+    g_clear_pointer (&priv->executor_source, g_source_unref);
+    g_clear_pointer (&priv->context, g_main_context_unref);
+  } else if (priv->loop) {
     g_main_loop_quit (priv->loop);
 
     if (G_LIKELY (priv->thread != g_thread_self ()))
@@ -186,6 +363,8 @@ clapper_threaded_object_class_init (ClapperThreadedObjectClass *klass)
   GST_DEBUG_CATEGORY_INIT (GST_CAT_DEFAULT, "clapperthreadedobject", 0,
       "Clapper Threaded Object");
 
+  dedicated_thread_quark = g_quark_from_static_string ("clapper-dedicated-thread");
+
   gobject_class->constructed = clapper_threaded_object_constructed;
   gobject_class->dispose = clapper_threaded_object_dispose;
   gobject_class->finalize = clapper_threaded_object_finalize;
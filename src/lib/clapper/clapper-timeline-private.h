@@ -34,4 +34,10 @@ gboolean clapper_timeline_set_toc (ClapperTimeline *timeline, GstToc *toc, gbool
 G_GNUC_INTERNAL
 void clapper_timeline_refresh (ClapperTimeline *timeline);
 
+G_GNUC_INTERNAL
+void clapper_timeline_store_to_cache (ClapperTimeline *timeline, GByteArray *bytes);
+
+G_GNUC_INTERNAL
+gboolean clapper_timeline_fill_from_cache (ClapperTimeline *timeline, const gchar **data, const gchar *end);
+
 G_END_DECLS
@@ -27,6 +27,7 @@
 #include "clapper-enums.h"
 #include "clapper-timeline-private.h"
 #include "clapper-marker-private.h"
+#include "clapper-cache-private.h"
 #include "clapper-player-private.h"
 #include "clapper-reactables-manager-private.h"
 #include "clapper-features-manager-private.h"
@@ -486,6 +487,102 @@ clapper_timeline_refresh (ClapperTimeline *self)
   clapper_timeline_post_item_updated (self);
 }
 
+void
+clapper_timeline_store_to_cache (ClapperTimeline *self, GByteArray *bytes)
+{
+  GSequenceIter *iter;
+
+  GST_OBJECT_LOCK (self);
+
+  clapper_cache_store_uint (bytes, g_sequence_get_length (self->markers_seq));
+
+  iter = g_sequence_get_begin_iter (self->markers_seq);
+  while (!g_sequence_iter_is_end (iter)) {
+    ClapperMarker *marker = CLAPPER_MARKER_CAST (g_sequence_get (iter));
+
+    clapper_cache_store_int (bytes, (gint) clapper_marker_get_marker_type (marker));
+    clapper_cache_store_string (bytes, clapper_marker_get_title (marker));
+    clapper_cache_store_double (bytes, clapper_marker_get_start (marker));
+    clapper_cache_store_double (bytes, clapper_marker_get_end (marker));
+    clapper_cache_store_boolean (bytes, clapper_marker_is_internal (marker));
+
+    iter = g_sequence_iter_next (iter);
+  }
+
+  GST_OBJECT_UNLOCK (self);
+}
+
+/*
+ * Only used with newly created timelines, so no signals are emitted.
+ * Returns %FALSE if data is truncated or malformed.
+ */
+gboolean
+clapper_timeline_fill_from_cache (ClapperTimeline *self, const gchar **data, const gchar *end)
+{
+  GEnumClass *enum_class;
+  guint i, n_markers;
+  gboolean success = TRUE;
+
+  if (!clapper_cache_can_read (*data, end, sizeof (guint)))
+    return FALSE;
+
+  n_markers = clapper_cache_read_uint (data);
+
+  enum_class = g_type_class_ref (CLAPPER_TYPE_MARKER_TYPE);
+
+  GST_OBJECT_LOCK (self);
+
+  for (i = 0; i < n_markers; ++i) {
+    ClapperMarker *marker;
+    ClapperMarkerType marker_type;
+    const gchar *title;
+    gdouble start, stop;
+    gboolean is_internal;
+
+    if (!clapper_cache_can_read (*data, end, sizeof (gint))) {
+      success = FALSE;
+      break;
+    }
+    marker_type = (ClapperMarkerType) clapper_cache_read_int (data);
+
+    if (!clapper_cache_can_read_string (*data, end)) {
+      success = FALSE;
+      break;
+    }
+    title = clapper_cache_read_string (data);
+
+    if (!clapper_cache_can_read (*data, end, 2 * sizeof (gdouble) + sizeof (gboolean))
+        || !g_enum_get_value (enum_class, marker_type)) {
+      success = FALSE;
+      break;
+    }
+    start = clapper_cache_read_double (data);
+    stop = clapper_cache_read_double (data);
+    is_internal = clapper_cache_read_boolean (data);
+
+    marker = (is_internal)
+        ? clapper_marker_new_internal (marker_type, title, start, stop)
+        : clapper_marker_new (marker_type, title, start, stop);
+
+    /* Stored markers are already sorted */
+    g_sequence_append (self->markers_seq, marker);
+    gst_object_set_parent (GST_OBJECT_CAST (marker), GST_OBJECT_CAST (self));
+  }
+
+  GST_OBJECT_UNLOCK (self);
+
+  g_type_class_unref (enum_class);
+
+  if (G_UNLIKELY (!success)) {
+    GST_WARNING_OBJECT (self, "Timeline data in cache is truncated or malformed");
+    return FALSE;
+  }
+
+  GST_DEBUG_OBJECT (self, "Filled timeline from cache with %u markers", n_markers);
+
+  return TRUE;
+}
+
 static void
 _marker_remove_func (ClapperMarker *marker)
 {
@@ -58,6 +58,9 @@ void clapper_utils_prop_notify_on_main_sync (GObject *object, GParamSpec *pspec)
 G_GNUC_INTERNAL
 gchar * clapper_utils_title_from_uri (const gchar *uri);
 
+G_GNUC_INTERNAL
+const gchar * clapper_utils_find_http_header (const GstStructure *headers, const gchar *name);
+
 G_GNUC_INTERNAL
 gboolean clapper_utils_set_value_for_enhancer (GValue *value, GParamSpec *pspec, GSettings *settings, GVariant *variant);
 
@@ -286,6 +286,26 @@ clapper_utils_title_from_uri (const gchar *uri)
   return title;
 }
 
+/*
+ * Finds value of HTTP header in "request-headers" or "response-headers"
+ * structure of a "http-headers" message. Names are as sent by server,
+ * so their case varies.
+ */
+const gchar *
+clapper_utils_find_http_header (const GstStructure *headers, const gchar *name)
+{
+  guint i, n_fields = gst_structure_n_fields (headers);
+
+  for (i = 0; i < n_fields; ++i) {
+    const gchar *field = gst_structure_nth_field_name (headers, i);
+
+    if (g_ascii_strcasecmp (field, name) == 0)
+      return gst_structure_get_string (headers, field);
+  }
+
+  return NULL;
+}
+
 gboolean
 clapper_utils_set_value_for_enhancer (GValue *value, GParamSpec *pspec, GSettings *settings, GVariant *variant)
 {
@@ -33,8 +33,10 @@
 #include <clapper/clapper-harvest.h>
 #include <clapper/clapper-marker.h>
 #include <clapper/clapper-media-item.h>
+#include <clapper/clapper-playback-stats.h>
 #include <clapper/clapper-player.h>
 #include <clapper/clapper-queue.h>
+#include <clapper/clapper-startup-report.h>
 #include <clapper/clapper-stream.h>
 #include <clapper/clapper-stream-list.h>
 #include <clapper/clapper-subtitle-stream.h>
@@ -34,45 +34,115 @@
  * Depending on your application, you can select an optimal
  * [enum@Clapper.DiscovererDiscoveryMode] that best suits your needs.
  *
+ * Items are discovered in parallel by multiple workers, each one using
+ * its own #GstDiscoverer instance. Their amount can be adjusted with
+ * [property@Clapper.Discoverer:n-workers] property.
+ *
+ * Results of local files discovery are cached on disk, so when the same
+ * unmodified file is added to the queue again, its media item is filled
+ * right away without running discovery.
+ *
+ * By default items are discovered in the order they were added to the queue,
+ * except the one that is going to be played next, which always goes first.
+ * Applications presenting queue can use [method@Clapper.Discoverer.prioritize_range]
+ * to have items that are currently visible to the user discovered sooner.
+ *
+ * For large local libraries (e.g. music), [property@Clapper.Discoverer:lightweight]
+ * can be enabled to only parse containers of local files for tags and duration
+ * without decoding them. Throughput of both ways on given media can be compared
+ * with [method@Clapper.Discoverer.get_stats].
+ *
  * Use [const@Clapper.HAVE_DISCOVERER] macro to check if Clapper API
  * was compiled with this feature.
  *
  * Deprecated: 0.10: Use Media Scanner from `clapper-enhancers` repo instead.
  */
 
+#include "config.h"
+
+#include <glib/gstdio.h>
 #include <gst/gst.h>
 #include <gst/tag/tag.h>
 #include <gst/pbutils/pbutils.h>
 
 #include "clapper-discoverer.h"
-#include "clapper-queue.h"
+#include "clapper-player.h"
+#include "clapper-queue-private.h"
 #include "clapper-media-item-private.h"
+#include "clapper-cache-private.h"
 #include "../shared/clapper-shared-utils-private.h"
 
 #define DEFAULT_DISCOVERY_MODE CLAPPER_DISCOVERER_DISCOVERY_NONCURRENT
+#define DEFAULT_N_WORKERS 0
+#define DEFAULT_LIGHTWEIGHT FALSE
+
+#define PROBE_TIMEOUT (5 * GST_SECOND)
+
+/* Limits of discovery cache, checked once per process */
+#define CACHE_MAX_AGE (30 * 24 * 60 * 60) // seconds since last use
+#define CACHE_MAX_SIZE (8 * 1024 * 1024)
 
 #define GST_CAT_DEFAULT clapper_discoverer_debug
 GST_DEBUG_CATEGORY_STATIC (GST_CAT_DEFAULT);
 
+typedef struct
+{
+  ClapperDiscoverer *discoverer;
+  GstDiscoverer *gst_discoverer;
+
+  /* Can be NULL while busy if removed during discovery */
+  ClapperMediaItem *discovered_item;
+
+  /* Set while lightweight probe is running */
+  GCancellable *probe_cancellable;
+
+  gboolean running;
+  gboolean busy;
+  gint64 start_time;
+} ClapperDiscovererWorker;
+
+typedef struct
+{
+  gchar *uri;
+  GstTagList *tags;
+  GstClockTime duration;
+} ClapperDiscovererProbe;
+
 struct _ClapperDiscoverer
 {
   ClapperFeature parent;
 
-  GstDiscoverer *discoverer;
+  GPtrArray *workers;
+  guint n_busy;
 
-  GPtrArray *pending_items;
-  ClapperMediaItem *discovered_item;
+  /* Items in order of addition, with their links for fast removal */
+  GQueue pending_items;
+  GHashTable *pending_links;
+
+  /* Protected by object lock */
+  guint priority_position;
+  guint priority_n_items;
 
-  gboolean running;
   GSource *timeout_source;
 
   ClapperDiscovererDiscoveryMode discovery_mode;
+  guint n_workers;
+  gboolean lightweight;
+
+  /* Stats, protected by object lock */
+  guint n_discovered;
+  gint64 total_latency;
+  gint64 max_latency;
+  gint64 busy_time;
+  gint64 busy_since;
 };
 
 enum
 {
   PROP_0,
   PROP_DISCOVERY_MODE,
+  PROP_N_WORKERS,
+  PROP_LIGHTWEIGHT,
   PROP_LAST
 };
 
@@ -90,110 +160,776 @@ _clear_timeout_source (ClapperDiscoverer *self)
   }
 }
 
+static inline void
+_push_pending (ClapperDiscoverer *self, ClapperMediaItem *item)
+{
+  if (g_hash_table_contains (self->pending_links, item))
+    return;
+
+  g_queue_push_tail (&self->pending_items, gst_object_ref (item));
+  g_hash_table_insert (self->pending_links, item, self->pending_items.tail);
+}
+
+/* Removes item from pending ones, returning reference it held */
+static inline gboolean
+_steal_pending (ClapperDiscoverer *self, ClapperMediaItem *item)
+{
+  GList *link;
+
+  if (!(link = g_hash_table_lookup (self->pending_links, item)))
+    return FALSE;
+
+  g_hash_table_remove (self->pending_links, item);
+  g_queue_delete_link (&self->pending_items, link);
+
+  return TRUE;
+}
+
+static void
+_clear_pending (ClapperDiscoverer *self)
+{
+  g_hash_table_remove_all (self->pending_links);
+  g_queue_clear_full (&self->pending_items, gst_object_unref);
+}
+
+/*
+ * Checks if queue item at given position is pending and if
+ * so, takes it. Returns (transfer full) item or %NULL.
+ */
+static ClapperMediaItem *
+_take_pending_at_position (ClapperDiscoverer *self, ClapperQueue *queue, guint position)
+{
+  ClapperMediaItem *item;
+
+  /* Lazy items are never pending, so do not materialize them here */
+  if (!(item = clapper_queue_peek_materialized_item (queue, position)))
+    return NULL;
+
+  if (_steal_pending (self, item)) {
+    GST_LOG_OBJECT (self, "Taking prioritized item at position: %u", position);
+
+    /* Drop reference from queue read, keeping the one from pending */
+    gst_object_unref (item);
+    return item;
+  }
+
+  gst_object_unref (item);
+
+  return NULL;
+}
+
+/*
+ * Takes (transfer full) pending item to discover next. Item that
+ * will be played next goes first, then ones in prioritized range,
+ * then remaining ones in order they were added.
+ */
+static ClapperMediaItem *
+_take_next_pending (ClapperDiscoverer *self)
+{
+  ClapperPlayer *player;
+  ClapperMediaItem *item = NULL;
+
+  if (self->pending_items.length == 0)
+    return NULL;
+
+  if ((player = CLAPPER_PLAYER_CAST (gst_object_get_parent (GST_OBJECT_CAST (self))))) {
+    ClapperQueue *queue = clapper_player_get_queue (player);
+    guint i, current_index, position, n_items;
+
+    current_index = clapper_queue_get_current_index (queue);
+
+    if (current_index != CLAPPER_QUEUE_INVALID_POSITION)
+      item = _take_pending_at_position (self, queue, current_index + 1);
+
+    GST_OBJECT_LOCK (self);
+    position = self->priority_position;
+    n_items = self->priority_n_items;
+    GST_OBJECT_UNLOCK (self);
+
+    for (i = 0; !item && i < n_items; ++i)
+      item = _take_pending_at_position (self, queue, position + i);
+
+    gst_object_unref (player);
+  }
+
+  if (!item) {
+    item = g_queue_pop_head (&self->pending_items);
+    g_hash_table_remove (self->pending_links, item);
+  }
+
+  return item;
+}
+
 static inline void
 _unqueue_discovery (ClapperDiscoverer *self, ClapperMediaItem *item)
 {
-  guint index = 0;
+  guint i;
 
   /* Removing item that is being discovered */
-  if (item == self->discovered_item) {
-    GST_DEBUG_OBJECT (self, "Ignoring discovery of current item %" GST_PTR_FORMAT, item);
-    gst_clear_object (&self->discovered_item);
-  } else if (g_ptr_array_find (self->pending_items, item, &index)) {
+  for (i = 0; i < self->workers->len; ++i) {
+    ClapperDiscovererWorker *worker = g_ptr_array_index (self->workers, i);
+
+    if (item == worker->discovered_item) {
+      GST_DEBUG_OBJECT (self, "Ignoring discovery of current item %" GST_PTR_FORMAT, item);
+      gst_clear_object (&worker->discovered_item);
+      return;
+    }
+  }
+
+  if (_steal_pending (self, item)) {
     GST_DEBUG_OBJECT (self, "Removing discovery of pending item %" GST_PTR_FORMAT, item);
-    g_ptr_array_remove_index (self->pending_items, index);
+    gst_object_unref (item);
+  }
+}
+
+static inline gboolean
+_item_has_tags (ClapperMediaItem *item)
+{
+  GstTagList *tags = clapper_media_item_get_tags (item);
+  gboolean empty_tags = gst_tag_list_is_empty (tags);
+
+  gst_tag_list_unref (tags);
+
+  return !empty_tags;
+}
+
+/*
+ * Discovery results of local files are cached under their inode number,
+ * so they stay valid even when file is renamed. File size and modification
+ * time are stored within cache and have to match in order to use it.
+ */
+static gchar *
+_build_cache_filename (const gchar *uri, GStatBuf *stat_buf)
+{
+  gchar *location, *filename = NULL;
+
+  if (!g_str_has_prefix (uri, "file://")
+      || !(location = g_filename_from_uri (uri, NULL, NULL)))
+    return NULL;
+
+  /* No inode numbers on some platforms */
+  if (g_stat (location, stat_buf) == 0 && stat_buf->st_ino != 0) {
+    gchar name[48];
+
+    g_snprintf (name, sizeof (name), "%" G_GUINT64_FORMAT "-%" G_GUINT64_FORMAT ".bin",
+        (guint64) stat_buf->st_dev, (guint64) stat_buf->st_ino);
+    filename = g_build_filename (g_get_user_cache_dir (), CLAPPER_API_NAME,
+        "discoverer", name, NULL);
+  }
+
+  g_free (location);
+
+  return filename;
+}
+
+static gboolean
+_fill_from_cache (ClapperDiscoverer *self, ClapperMediaItem *item)
+{
+  GMappedFile *mapped_file;
+  GStatBuf stat_buf;
+  GstTagList *tags = NULL;
+  GError *error = NULL;
+  gchar *filename;
+  const gchar *data, *end, *tags_str;
+  gdouble duration;
+  gboolean success = FALSE;
+
+  if (clapper_cache_is_disabled ()
+      || !(filename = _build_cache_filename (clapper_media_item_get_uri (item), &stat_buf)))
+    return FALSE;
+
+  if (!(mapped_file = clapper_cache_open (filename, &data, &error))) {
+    if (error) {
+      if (error->domain != G_FILE_ERROR || error->code != G_FILE_ERROR_NOENT)
+        GST_ERROR_OBJECT (self, "Could not use cached discovery, reason: %s", error->message);
+
+      g_error_free (error);
+    }
+    g_free (filename);
+
+    return FALSE;
+  }
+
+  end = g_mapped_file_get_contents (mapped_file) + g_mapped_file_get_length (mapped_file);
+
+  if (!clapper_cache_can_read (data, end, 2 * sizeof (gint64))
+      || clapper_cache_read_int64 (&data) != (gint64) stat_buf.st_size
+      || clapper_cache_read_int64 (&data) != (gint64) stat_buf.st_mtime) {
+    GST_DEBUG_OBJECT (self, "Cached discovery of %" GST_PTR_FORMAT " is outdated", item);
+    goto finish;
+  }
+
+  if (!clapper_cache_can_read_string (data, end))
+    goto finish;
+  tags_str = clapper_cache_read_string (&data);
+
+  if (!clapper_cache_can_read (data, end, sizeof (gdouble)))
+    goto finish;
+  duration = clapper_cache_read_double (&data);
+
+  if (tags_str)
+    tags = gst_tag_list_new_from_string (tags_str);
+
+  GST_DEBUG_OBJECT (self, "Filling %" GST_PTR_FORMAT " from cached discovery", item);
+  clapper_media_item_update_from_discovery (item, tags, duration);
+
+  gst_clear_tag_list (&tags);
+  success = TRUE;
+
+  /* Modification time of cache file marks its last use */
+  g_utime (filename, NULL);
+
+finish:
+  g_mapped_file_unref (mapped_file);
+  g_free (filename);
+
+  return success;
+}
+
+typedef struct
+{
+  gchar *filename;
+  gint64 mtime;
+  gint64 size;
+} ClapperDiscovererCacheEntry;
+
+static void
+_cache_entry_clear (ClapperDiscovererCacheEntry *entry)
+{
+  g_free (entry->filename);
+}
+
+static gint
+_compare_cache_entries (const ClapperDiscovererCacheEntry *a, const ClapperDiscovererCacheEntry *b)
+{
+  return (a->mtime > b->mtime) - (a->mtime < b->mtime);
+}
+
+/*
+ * Removes cache entries that were not used for a long time,
+ * then least recently used ones until cache fits size limit.
+ */
+static gpointer
+_prune_cache_thread_func (gchar *dirname)
+{
+  GDir *dir;
+  GArray *entries;
+  const gchar *name;
+  gint64 now, total_size = 0;
+  guint i;
+
+  if (!(dir = g_dir_open (dirname, 0, NULL))) {
+    g_free (dirname);
+    return NULL;
+  }
+
+  entries = g_array_new (FALSE, FALSE, sizeof (ClapperDiscovererCacheEntry));
+  g_array_set_clear_func (entries, (GDestroyNotify) _cache_entry_clear);
+
+  now = g_get_real_time () / G_USEC_PER_SEC;
+
+  while ((name = g_dir_read_name (dir))) {
+    ClapperDiscovererCacheEntry entry;
+    GStatBuf stat_buf;
+
+    if (!g_str_has_suffix (name, ".bin"))
+      continue;
+
+    entry.filename = g_build_filename (dirname, name, NULL);
+
+    if (g_stat (entry.filename, &stat_buf) != 0) {
+      g_free (entry.filename);
+      continue;
+    }
+
+    if (now - (gint64) stat_buf.st_mtime > CACHE_MAX_AGE) {
+      GST_LOG ("Removing expired cache entry: %s", name);
+      g_remove (entry.filename);
+      g_free (entry.filename);
+      continue;
+    }
+
+    entry.mtime = (gint64) stat_buf.st_mtime;
+    entry.size = (gint64) stat_buf.st_size;
+    total_size += entry.size;
+
+    g_array_append_val (entries, entry);
+  }
+  g_dir_close (dir);
+
+  if (total_size > CACHE_MAX_SIZE) {
+    g_array_sort (entries, (GCompareFunc) _compare_cache_entries);
+
+    for (i = 0; i < entries->len && total_size > CACHE_MAX_SIZE; ++i) {
+      ClapperDiscovererCacheEntry *entry = &g_array_index (entries, ClapperDiscovererCacheEntry, i);
+
+      GST_LOG ("Removing least recently used cache entry: %s", entry->filename);
+      g_remove (entry->filename);
+      total_size -= entry->size;
+    }
+  }
+
+  GST_DEBUG ("Discovery cache pruned, size: %" G_GINT64_FORMAT, total_size);
+
+  g_array_unref (entries);
+  g_free (dirname);
+
+  return NULL;
+}
+
+static void
+_prune_cache_once (const gchar *filename)
+{
+  static gsize pruned = 0;
+
+  if (g_once_init_enter (&pruned)) {
+    g_thread_unref (g_thread_new ("ClapperCachePrune",
+        (GThreadFunc) _prune_cache_thread_func, g_path_get_dirname (filename)));
+    g_once_init_leave (&pruned, 1);
+  }
+}
+
+/*
+ * Stores discovery results as given by discovery,
+ * not tags that item got from elsewhere.
+ */
+static void
+_store_to_cache (ClapperDiscoverer *self, ClapperMediaItem *item,
+    const GstTagList *tags, gdouble duration)
+{
+  GByteArray *bytes;
+  GStatBuf stat_buf;
+  GError *error = NULL;
+  gchar *filename, *tags_str = NULL;
+
+  if (clapper_cache_is_disabled ()
+      || !(filename = _build_cache_filename (clapper_media_item_get_uri (item), &stat_buf)))
+    return;
+
+  bytes = clapper_cache_create ();
+
+  clapper_cache_store_int64 (bytes, (gint64) stat_buf.st_size);
+  clapper_cache_store_int64 (bytes, (gint64) stat_buf.st_mtime);
+
+  if (tags && !gst_tag_list_is_empty (tags))
+    tags_str = gst_tag_list_to_string (tags);
+
+  clapper_cache_store_string (bytes, tags_str);
+  g_free (tags_str);
+
+  clapper_cache_store_double (bytes, duration);
+
+  if (clapper_cache_write (filename, bytes, &error)) {
+    GST_DEBUG_OBJECT (self, "Stored discovery of %" GST_PTR_FORMAT " in cache", item);
+  } else if (error) {
+    GST_ERROR_OBJECT (self, "Could not cache discovery, reason: %s", error->message);
+    g_error_free (error);
+  }
+
+  _prune_cache_once (filename);
+
+  g_free (filename);
+  g_byte_array_free (bytes, TRUE);
+}
+
+/*
+ * Collects tags of all containers within discovered media. Each
+ * next container replaces values of the same tags, just like it
+ * would if its tags were inserted into media item one by one.
+ */
+static GstTagList *
+_parse_discoverer_info (GstDiscovererInfo *info, gdouble *duration)
+{
+  GstDiscovererStreamInfo *sinfo;
+  GstTagList *tags = NULL;
+  GstClockTime val;
+
+  for (sinfo = gst_discoverer_info_get_stream_info (info);
+      sinfo != NULL;
+      sinfo = gst_discoverer_stream_info_get_next (sinfo)) {
+    if (GST_IS_DISCOVERER_CONTAINER_INFO (sinfo)) {
+      GstDiscovererContainerInfo *cinfo = (GstDiscovererContainerInfo *) sinfo;
+      const GstTagList *ctags;
+
+      if ((ctags = gst_discoverer_container_info_get_tags (cinfo))) {
+        GstTagList *merged = gst_tag_list_merge (tags, ctags, GST_TAG_MERGE_REPLACE);
+
+        gst_clear_tag_list (&tags);
+        tags = merged;
+      }
+    }
+    gst_discoverer_stream_info_unref (sinfo);
+  }
+
+  val = gst_discoverer_info_get_duration (info);
+
+  if (G_UNLIKELY (val == GST_CLOCK_TIME_NONE))
+    val = 0;
+
+  *duration = (gdouble) val / GST_SECOND;
+
+  return tags;
+}
+
+static void
+_worker_set_busy (ClapperDiscovererWorker *worker, gboolean busy)
+{
+  ClapperDiscoverer *self = worker->discoverer;
+  gint64 now;
+
+  if (worker->busy == busy)
+    return;
+
+  worker->busy = busy;
+  now = g_get_monotonic_time ();
+
+  GST_OBJECT_LOCK (self);
+
+  if (busy) {
+    worker->start_time = now;
+
+    if (self->n_busy++ == 0)
+      self->busy_since = now;
+  } else if (--self->n_busy == 0) {
+    self->busy_time += now - self->busy_since;
+    self->busy_since = 0;
   }
+
+  GST_OBJECT_UNLOCK (self);
 }
 
 static inline void
-_start_discovery (ClapperDiscoverer *self)
+_start_discovery (ClapperDiscovererWorker *worker)
 {
-  if (!self->running) {
-    gst_discoverer_start (self->discoverer);
-    self->running = TRUE;
-    GST_INFO_OBJECT (self, "Discoverer started");
+  if (!worker->running) {
+    gst_discoverer_start (worker->gst_discoverer);
+    worker->running = TRUE;
+    GST_INFO_OBJECT (worker->discoverer, "Discoverer worker %p started", worker);
   }
 }
 
 static inline void
-_stop_discovery (ClapperDiscoverer *self)
+_stop_discovery (ClapperDiscovererWorker *worker)
 {
-  if (self->running) {
-    gst_discoverer_stop (self->discoverer);
-    self->running = FALSE;
-    GST_INFO_OBJECT (self, "Discoverer stopped");
+  /* Probe result will be ignored */
+  if (worker->probe_cancellable) {
+    g_cancellable_cancel (worker->probe_cancellable);
+    g_clear_object (&worker->probe_cancellable);
   }
+
+  if (worker->running) {
+    gst_discoverer_stop (worker->gst_discoverer);
+    worker->running = FALSE;
+    GST_INFO_OBJECT (worker->discoverer, "Discoverer worker %p stopped", worker);
+  }
+
+  /* Stopping cancels discovery without emitting any signal */
+  gst_clear_object (&worker->discovered_item);
+  _worker_set_busy (worker, FALSE);
 }
 
 static void
-_run_discovery (ClapperDiscoverer *self)
+_probe_free (ClapperDiscovererProbe *probe)
 {
-  ClapperMediaItem *item;
-  ClapperQueue *queue;
-  ClapperDiscovererDiscoveryMode discovery_mode;
-  GstTagList *tags;
-  const gchar *uri;
-  gboolean empty_tags, success = FALSE;
+  g_free (probe->uri);
+  gst_clear_tag_list (&probe->tags);
+  g_free (probe);
+}
 
-  if (self->pending_items->len == 0) {
-    GST_DEBUG_OBJECT (self, "No more pending items");
+static void
+_probe_pad_added_cb (GstElement *parsebin G_GNUC_UNUSED, GstPad *pad, GstBin *pipeline)
+{
+  GstElement *sink = gst_element_factory_make ("fakesink", NULL);
+  GstPad *sink_pad;
+
+  gst_bin_add (pipeline, sink);
+  gst_element_sync_state_with_parent (sink);
+
+  sink_pad = gst_element_get_static_pad (sink, "sink");
+  gst_pad_link (pad, sink_pad);
+  gst_object_unref (sink_pad);
+}
+
+/*
+ * Lightweight alternative to GstDiscoverer. Parses container up to
+ * preroll without plugging any decoders, collecting global tags
+ * on the way and querying duration once prerolled.
+ */
+static void
+_probe_thread_func (GTask *task, gpointer source_object G_GNUC_UNUSED,
+    ClapperDiscovererProbe *probe, GCancellable *cancellable)
+{
+  GstElement *pipeline, *src, *parsebin;
+  GstBus *bus;
+  GstMessage *msg;
+  gint64 duration = -1;
+  gboolean done = FALSE, prerolled = FALSE;
+
+  if (!(src = gst_element_make_from_uri (GST_URI_SRC, probe->uri, NULL, NULL))) {
+    g_task_return_boolean (task, FALSE);
+    return;
+  }
+  if (!(parsebin = gst_element_factory_make ("parsebin", NULL))) {
+    gst_object_unref (src);
+    g_task_return_boolean (task, FALSE);
     return;
   }
 
-  item = g_ptr_array_steal_index (self->pending_items, 0);
+  pipeline = gst_pipeline_new (NULL);
+  gst_bin_add_many (GST_BIN_CAST (pipeline), src, parsebin, NULL);
 
-  GST_DEBUG_OBJECT (self, "Investigating discovery of %" GST_PTR_FORMAT, item);
+  g_signal_connect (parsebin, "pad-added",
+      G_CALLBACK (_probe_pad_added_cb), pipeline);
 
-  queue = CLAPPER_QUEUE_CAST (gst_object_get_parent (GST_OBJECT_CAST (item)));
+  if (!gst_element_link (src, parsebin)
+      || gst_element_set_state (pipeline, GST_STATE_PAUSED) == GST_STATE_CHANGE_FAILURE) {
+    gst_object_unref (pipeline);
+    g_task_return_boolean (task, FALSE);
+    return;
+  }
 
-  if (G_UNLIKELY (queue == NULL)) {
-    GST_DEBUG_OBJECT (self, "Queued item %" GST_PTR_FORMAT
-        " does not appear to be in queue anymore", item);
-    goto finish;
+  bus = gst_element_get_bus (pipeline);
+
+  while (!done && !g_cancellable_is_cancelled (cancellable)
+      && (msg = gst_bus_timed_pop_filtered (bus, PROBE_TIMEOUT,
+      GST_MESSAGE_ASYNC_DONE | GST_MESSAGE_TAG | GST_MESSAGE_ERROR | GST_MESSAGE_EOS))) {
+    switch (GST_MESSAGE_TYPE (msg)) {
+      case GST_MESSAGE_TAG:{
+        GstTagList *tags = NULL;
+
+        gst_message_parse_tag (msg, &tags);
+
+        /* Only global ones, same as container tags of discoverer */
+        if (gst_tag_list_get_scope (tags) == GST_TAG_SCOPE_GLOBAL) {
+          GstTagList *merged = gst_tag_list_merge (probe->tags, tags, GST_TAG_MERGE_KEEP);
+
+          gst_clear_tag_list (&probe->tags);
+          probe->tags = merged;
+        }
+        gst_tag_list_unref (tags);
+        break;
+      }
+      case GST_MESSAGE_ASYNC_DONE:
+        prerolled = TRUE;
+        G_GNUC_FALLTHROUGH;
+      default:
+        done = TRUE;
+        break;
+    }
+    gst_message_unref (msg);
   }
 
-  discovery_mode = clapper_discoverer_get_discovery_mode (self);
+  if (prerolled && gst_element_query_duration (pipeline, GST_FORMAT_TIME, &duration))
+    probe->duration = (GstClockTime) duration;
 
-  if (discovery_mode == CLAPPER_DISCOVERER_DISCOVERY_NONCURRENT
-      && clapper_queue_item_is_current (queue, item)) {
-    GST_DEBUG_OBJECT (self, "Queued %" GST_PTR_FORMAT
-        " is current item, ignoring discovery", item);
-    goto finish;
-  }
+  gst_element_set_state (pipeline, GST_STATE_NULL);
 
-  tags = clapper_media_item_get_tags (item);
-  empty_tags = gst_tag_list_is_empty (tags);
-  gst_tag_list_unref (tags);
+  gst_object_unref (bus);
+  gst_object_unref (pipeline);
 
-  if (!empty_tags) {
-    GST_DEBUG_OBJECT (self, "Queued %" GST_PTR_FORMAT
-        " already has tags, ignoring discovery", item);
-    goto finish;
+  /* Without duration, fallback to full discovery */
+  g_task_return_boolean (task, GST_CLOCK_TIME_IS_VALID (probe->duration));
+}
+
+static void _discovered_cb (GstDiscoverer *discoverer, GstDiscovererInfo *info,
+    GError *error, ClapperDiscovererWorker *worker);
+static void _finished_cb (GstDiscoverer *discoverer, ClapperDiscovererWorker *worker);
+static void _probe_finished_cb (ClapperDiscoverer *self, GAsyncResult *res, ClapperDiscovererWorker *worker);
+
+static ClapperDiscovererWorker *
+_worker_new (ClapperDiscoverer *self)
+{
+  ClapperDiscovererWorker *worker;
+  GstDiscoverer *gst_discoverer;
+  GError *error = NULL;
+
+  gst_discoverer = gst_discoverer_new (15 * GST_SECOND, &error);
+
+  if (G_UNLIKELY (error != NULL)) {
+    GST_ERROR_OBJECT (self, "Could not create worker, reason: %s", error->message);
+    g_error_free (error);
+
+    return NULL;
   }
 
-  uri = clapper_media_item_get_uri (item);
-  GST_DEBUG_OBJECT (self, "Starting discovery of %"
-      GST_PTR_FORMAT "(%s)", item, uri);
+  GST_TRACE_OBJECT (self, "Created new GstDiscoverer: %" GST_PTR_FORMAT, gst_discoverer);
+
+  /* FIXME: Caching in GStreamer is broken. Does not save container tags, such as media title.
+   * Disable it until completely fixed upsteam. Once fixed change to %TRUE. */
+  g_object_set (gst_discoverer, "use-cache", FALSE, NULL);
+
+  worker = g_new0 (ClapperDiscovererWorker, 1);
+  worker->discoverer = self;
+  worker->gst_discoverer = gst_discoverer;
+
+  g_signal_connect (gst_discoverer, "discovered",
+      G_CALLBACK (_discovered_cb), worker);
+  g_signal_connect (gst_discoverer, "finished",
+      G_CALLBACK (_finished_cb), worker);
+
+  GST_DEBUG_OBJECT (self, "Created discoverer worker %p", worker);
+
+  return worker;
+}
+
+static void
+_worker_free (ClapperDiscovererWorker *worker)
+{
+  _stop_discovery (worker);
+
+  g_signal_handlers_disconnect_by_data (worker->gst_discoverer, worker);
+  g_object_unref (worker->gst_discoverer);
+
+  g_free (worker);
+}
+
+static inline guint
+_get_effective_n_workers (ClapperDiscoverer *self)
+{
+  guint n_workers = clapper_discoverer_get_n_workers (self);
+
+  return (n_workers > 0) ? n_workers : (guint) g_get_num_processors ();
+}
+
+static gboolean
+_worker_start_full_discovery (ClapperDiscovererWorker *worker, ClapperMediaItem *item)
+{
+  ClapperDiscoverer *self = worker->discoverer;
+  const gchar *uri = clapper_media_item_get_uri (item);
 
   /* Need to start first, then append URI */
-  _start_discovery (self);
+  _start_discovery (worker);
 
-  if ((success = gst_discoverer_discover_uri_async (self->discoverer, uri))) {
-    gst_object_replace ((GstObject **) &self->discovered_item, GST_OBJECT_CAST (item));
-    GST_DEBUG_OBJECT (self, "Running discovery of %"
-        GST_PTR_FORMAT "(%s)", self->discovered_item, uri);
-  } else {
+  if (!gst_discoverer_discover_uri_async (worker->gst_discoverer, uri)) {
     GST_ERROR_OBJECT (self, "Could not run discovery of %"
         GST_PTR_FORMAT "(%s)", item, uri);
+    return FALSE;
   }
 
-finish:
-  gst_clear_object (&item);
-  gst_clear_object (&queue);
+  gst_object_replace ((GstObject **) &worker->discovered_item, GST_OBJECT_CAST (item));
+  _worker_set_busy (worker, TRUE);
 
-  /* Continue until we run out of pending items */
-  if (!success)
-    _run_discovery (self);
+  GST_DEBUG_OBJECT (self, "Running discovery of %"
+      GST_PTR_FORMAT "(%s) on worker %p", item, uri, worker);
+
+  return TRUE;
+}
+
+static gboolean
+_worker_start_probe (ClapperDiscovererWorker *worker, ClapperMediaItem *item)
+{
+  ClapperDiscoverer *self = worker->discoverer;
+  ClapperDiscovererProbe *probe;
+  GTask *task;
+
+  probe = g_new0 (ClapperDiscovererProbe, 1);
+  probe->uri = g_strdup (clapper_media_item_get_uri (item));
+  probe->duration = GST_CLOCK_TIME_NONE;
+
+  worker->probe_cancellable = g_cancellable_new ();
+
+  task = g_task_new (self, worker->probe_cancellable,
+      (GAsyncReadyCallback) _probe_finished_cb, worker);
+  g_task_set_task_data (task, probe, (GDestroyNotify) _probe_free);
+  g_task_run_in_thread (task, (GTaskThreadFunc) _probe_thread_func);
+  g_object_unref (task);
+
+  gst_object_replace ((GstObject **) &worker->discovered_item, GST_OBJECT_CAST (item));
+  _worker_set_busy (worker, TRUE);
+
+  GST_DEBUG_OBJECT (self, "Running probe of %"
+      GST_PTR_FORMAT "(%s) on worker %p", item, probe->uri, worker);
+
+  return TRUE;
+}
+
+/*
+ * Takes pending items until discovery of one of them
+ * starts on given worker or there are no more of them.
+ */
+static void
+_worker_discover_next (ClapperDiscovererWorker *worker)
+{
+  ClapperDiscoverer *self = worker->discoverer;
+  ClapperDiscovererDiscoveryMode discovery_mode = clapper_discoverer_get_discovery_mode (self);
+  gboolean lightweight = clapper_discoverer_get_lightweight (self);
+  gboolean success = FALSE;
+
+  while (!success && self->pending_items.length > 0) {
+    ClapperMediaItem *item;
+    ClapperQueue *queue;
+    const gchar *uri;
+
+    item = _take_next_pending (self);
+
+    GST_DEBUG_OBJECT (self, "Investigating discovery of %" GST_PTR_FORMAT, item);
+
+    queue = CLAPPER_QUEUE_CAST (gst_object_get_parent (GST_OBJECT_CAST (item)));
+
+    if (G_UNLIKELY (queue == NULL)) {
+      GST_DEBUG_OBJECT (self, "Queued item %" GST_PTR_FORMAT
+          " does not appear to be in queue anymore", item);
+      goto next;
+    }
+
+    if (discovery_mode == CLAPPER_DISCOVERER_DISCOVERY_NONCURRENT
+        && clapper_queue_item_is_current (queue, item)) {
+      GST_DEBUG_OBJECT (self, "Queued %" GST_PTR_FORMAT
+          " is current item, ignoring discovery", item);
+      goto next;
+    }
+
+    if (_item_has_tags (item)) {
+      GST_DEBUG_OBJECT (self, "Queued %" GST_PTR_FORMAT
+          " already has tags, ignoring discovery", item);
+      goto next;
+    }
+
+    uri = clapper_media_item_get_uri (item);
+    GST_DEBUG_OBJECT (self, "Starting discovery of %"
+        GST_PTR_FORMAT "(%s)", item, uri);
+
+    if (lightweight && g_str_has_prefix (uri, "file://"))
+      success = _worker_start_probe (worker, item);
+    else
+      success = _worker_start_full_discovery (worker, item);
+
+next:
+    gst_clear_object (&item);
+    gst_clear_object (&queue);
+  }
+}
+
+static void
+_run_discovery (ClapperDiscoverer *self)
+{
+  guint i, n_workers;
+
+  if (self->pending_items.length == 0) {
+    GST_DEBUG_OBJECT (self, "No more pending items");
+    return;
+  }
+
+  n_workers = _get_effective_n_workers (self);
+
+  /* Fill all idle workers, creating new ones when needed */
+  for (i = 0; i < n_workers && self->pending_items.length > 0; ++i) {
+    ClapperDiscovererWorker *worker;
+
+    if (i < self->workers->len) {
+      worker = g_ptr_array_index (self->workers, i);
+    } else if ((worker = _worker_new (self))) {
+      g_ptr_array_add (self->workers, worker);
+    } else {
+      break;
+    }
+
+    if (!worker->busy)
+      _worker_discover_next (worker);
+  }
+
+  GST_LOG_OBJECT (self, "Busy workers: %u, pending items: %u",
+      self->n_busy, self->pending_items.length);
 }
 
 static gboolean
@@ -207,45 +943,120 @@ _run_discovery_delayed_cb (ClapperDiscoverer *self)
   return G_SOURCE_REMOVE;
 }
 
+static void
+_worker_finish_item (ClapperDiscovererWorker *worker)
+{
+  ClapperDiscoverer *self = worker->discoverer;
+  gint64 latency = g_get_monotonic_time () - worker->start_time;
+
+  /* Clear so its NULL when replaced later */
+  gst_clear_object (&worker->discovered_item);
+
+  GST_OBJECT_LOCK (self);
+  self->n_discovered++;
+  self->total_latency += latency;
+  self->max_latency = MAX (self->max_latency, latency);
+  GST_OBJECT_UNLOCK (self);
+
+  _worker_set_busy (worker, FALSE);
+
+  /* Try to discover next item */
+  _run_discovery (self);
+}
+
 static void
 _discovered_cb (GstDiscoverer *discoverer G_GNUC_UNUSED,
-    GstDiscovererInfo *info, GError *error, ClapperDiscoverer *self)
+    GstDiscovererInfo *info, GError *error, ClapperDiscovererWorker *worker)
 {
+  ClapperDiscoverer *self = worker->discoverer;
+  gint64 latency = g_get_monotonic_time () - worker->start_time;
+
   /* Can be NULL if removed while discovery of it was running */
-  if (self->discovered_item) {
-    const gchar *uri = clapper_media_item_get_uri (self->discovered_item);
+  if (worker->discovered_item) {
+    const gchar *uri = clapper_media_item_get_uri (worker->discovered_item);
 
     if (G_LIKELY (error == NULL)) {
-      GST_DEBUG_OBJECT (self, "Finished discovery of %"
-          GST_PTR_FORMAT "(%s)", self->discovered_item, uri);
-      clapper_media_item_update_from_discoverer_info (self->discovered_item, info);
+      GstTagList *tags;
+      gdouble duration = 0;
+
+      GST_DEBUG_OBJECT (self, "Finished discovery of %" GST_PTR_FORMAT
+          "(%s), took: %" G_GINT64_FORMAT "us", worker->discovered_item, uri, latency);
+
+      tags = _parse_discoverer_info (info, &duration);
+      clapper_media_item_update_from_discovery (worker->discovered_item, tags, duration);
+      _store_to_cache (self, worker->discovered_item, tags, duration);
+
+      gst_clear_tag_list (&tags);
     } else {
       GST_ERROR_OBJECT (self, "Discovery of %" GST_PTR_FORMAT
-          "(%s) failed, reason: %s", self->discovered_item, uri, error->message);
+          "(%s) failed, reason: %s", worker->discovered_item, uri, error->message);
     }
+  }
+
+  _worker_finish_item (worker);
+}
+
+static void
+_probe_finished_cb (ClapperDiscoverer *self, GAsyncResult *res, ClapperDiscovererWorker *worker)
+{
+  GTask *task = G_TASK (res);
+  ClapperDiscovererProbe *probe;
+  gboolean success;
+
+  /* Worker was stopped (and possibly freed) in the meantime */
+  if (g_cancellable_is_cancelled (g_task_get_cancellable (task)))
+    return;
+
+  g_clear_object (&worker->probe_cancellable);
+
+  probe = g_task_get_task_data (task);
+  success = g_task_propagate_boolean (task, NULL);
+
+  /* Can be NULL if removed while probe of it was running */
+  if (worker->discovered_item) {
+    if (success) {
+      gdouble duration = (gdouble) probe->duration / GST_SECOND;
+
+      GST_DEBUG_OBJECT (self, "Finished probe of %" GST_PTR_FORMAT
+          "(%s)", worker->discovered_item, probe->uri);
+      clapper_media_item_update_from_discovery (worker->discovered_item, probe->tags, duration);
+      _store_to_cache (self, worker->discovered_item, probe->tags, duration);
+    } else {
+      GST_DEBUG_OBJECT (self, "Probe of %" GST_PTR_FORMAT "(%s) was not enough,"
+          " falling back to full discovery", worker->discovered_item, probe->uri);
 
-    /* Clear so its NULL when replaced later */
-    gst_clear_object (&self->discovered_item);
+      /* Worker stays busy with the same item */
+      if (_worker_start_full_discovery (worker, worker->discovered_item))
+        return;
+    }
   }
 
-  /* Try to discover next item */
-  _run_discovery (self);
+  _worker_finish_item (worker);
 }
 
 static void
-_finished_cb (GstDiscoverer *discoverer G_GNUC_UNUSED, ClapperDiscoverer *self)
+_finished_cb (GstDiscoverer *discoverer G_GNUC_UNUSED, ClapperDiscovererWorker *worker)
 {
-  if (G_LIKELY (self->pending_items->len == 0)) {
-    GST_DEBUG_OBJECT (self, "Finished discovery of all items");
-  } else {
-    /* This should never happen, but if it does, then clear
-     * pending items array so we can somewhat recover */
-    GST_ERROR_OBJECT (self, "Discovery stopped, but still had %u pending items!",
-        self->pending_items->len);
-    g_ptr_array_remove_range (self->pending_items, 0, self->pending_items->len);
+  ClapperDiscoverer *self = worker->discoverer;
+
+  GST_DEBUG_OBJECT (self, "Worker %p has nothing more to discover", worker);
+
+  /* Worker might have moved onto probing next item already */
+  if (worker->probe_cancellable) {
+    gst_discoverer_stop (worker->gst_discoverer);
+    worker->running = FALSE;
+    return;
   }
 
-  _stop_discovery (self);
+  _stop_discovery (worker);
+
+  if (G_LIKELY (self->pending_items.length == 0)) {
+    if (self->n_busy == 0)
+      GST_DEBUG_OBJECT (self, "Finished discovery of all items");
+  } else {
+    /* Items added while other workers were busy */
+    _run_discovery (self);
+  }
 }
 
 static void
@@ -264,10 +1075,22 @@ clapper_discoverer_queue_item_added (ClapperFeature *feature, ClapperMediaItem *
 
   GST_DEBUG_OBJECT (self, "Queue item added %" GST_PTR_FORMAT, item);
 
-  g_ptr_array_add (self->pending_items, gst_object_ref (item));
+  /* Lazy queue entries are meant to stay cheap, so holding
+   * and discovering all of them is not an option */
+  if (clapper_media_item_is_lazy (item)) {
+    GST_DEBUG_OBJECT (self, "Skipping lazy queue entry");
+    return;
+  }
+
+  /* Local files discovered before can be filled right away */
+  if (!_item_has_tags (item) && _fill_from_cache (self, item))
+    return;
+
+  _push_pending (self, item);
 
-  /* Already running, nothing more to do */
-  if (self->running)
+  /* Already running, item will be taken by
+   * the first worker that finishes its discovery */
+  if (self->n_busy > 0)
     return;
 
   /* Need to always clear timeout here, as mode may
@@ -306,44 +1129,32 @@ static void
 clapper_discoverer_queue_cleared (ClapperFeature *feature)
 {
   ClapperDiscoverer *self = CLAPPER_DISCOVERER_CAST (feature);
+  guint i;
 
   GST_DEBUG_OBJECT (self, "Discarding discovery of all pending items");
 
-  if (self->pending_items->len > 0)
-    g_ptr_array_remove_range (self->pending_items, 0, self->pending_items->len);
-
-  gst_clear_object (&self->discovered_item);
+  _clear_pending (self);
 
-  _stop_discovery (self);
+  for (i = 0; i < self->workers->len; ++i)
+    _stop_discovery (g_ptr_array_index (self->workers, i));
 }
 
 static gboolean
 clapper_discoverer_prepare (ClapperFeature *feature)
 {
   ClapperDiscoverer *self = CLAPPER_DISCOVERER_CAST (feature);
-  GError *error = NULL;
+  ClapperDiscovererWorker *worker;
 
   GST_DEBUG_OBJECT (self, "Prepare");
 
-  self->discoverer = gst_discoverer_new (15 * GST_SECOND, &error);
-
-  if (G_UNLIKELY (error != NULL)) {
-    GST_ERROR_OBJECT (self, "Could not prepare, reason: %s", error->message);
-    g_error_free (error);
-
+  /* Create first worker upfront to check if discovery is possible,
+   * the remaining ones are created when there are items for them */
+  if (!(worker = _worker_new (self))) {
+    GST_ERROR_OBJECT (self, "Could not prepare");
     return FALSE;
   }
 
-  GST_TRACE_OBJECT (self, "Created new GstDiscoverer: %" GST_PTR_FORMAT, self->discoverer);
-
-  /* FIXME: Caching in GStreamer is broken. Does not save container tags, such as media title.
-   * Disable it until completely fixed upsteam. Once fixed change to %TRUE. */
-  g_object_set (self->discoverer, "use-cache", FALSE, NULL);
-
-  g_signal_connect (self->discoverer, "discovered",
-      G_CALLBACK (_discovered_cb), self);
-  g_signal_connect (self->discoverer, "finished",
-      G_CALLBACK (_finished_cb), self);
+  g_ptr_array_add (self->workers, worker);
 
   return TRUE;
 }
@@ -360,7 +1171,8 @@ clapper_discoverer_unprepare (ClapperFeature *feature)
   /* Do what we also do when queue is cleared */
   clapper_discoverer_queue_cleared (feature);
 
-  gst_clear_object (&self->discoverer);
+  if (self->workers->len > 0)
+    g_ptr_array_remove_range (self->workers, 0, self->workers->len);
 
   return TRUE;
 }
@@ -432,12 +1244,249 @@ clapper_discoverer_get_discovery_mode (ClapperDiscoverer *self)
   return mode;
 }
 
+/**
+ * clapper_discoverer_set_n_workers:
+ * @discoverer: a #ClapperDiscoverer
+ * @n_workers: number of parallel discoveries or 0 to use number of processors
+ *
+ * Set the maximal number of items that @discoverer can discover in parallel.
+ *
+ * Each worker uses its own #GstDiscoverer, so more workers speed up
+ * discovery of many items at the cost of higher resources usage.
+ *
+ * Since: 0.12
+ *
+ * Deprecated: 0.12: Use Media Scanner from `clapper-enhancers` repo instead.
+ */
+void
+clapper_discoverer_set_n_workers (ClapperDiscoverer *self, guint n_workers)
+{
+  gboolean changed;
+
+  g_return_if_fail (CLAPPER_IS_DISCOVERER (self));
+
+  GST_OBJECT_LOCK (self);
+  if ((changed = self->n_workers != n_workers))
+    self->n_workers = n_workers;
+  GST_OBJECT_UNLOCK (self);
+
+  if (changed)
+    g_object_notify_by_pspec (G_OBJECT (self), param_specs[PROP_N_WORKERS]);
+}
+
+/**
+ * clapper_discoverer_get_n_workers:
+ * @discoverer: a #ClapperDiscoverer
+ *
+ * Get the maximal number of items that @discoverer can discover in parallel.
+ *
+ * Returns: number of workers, 0 when using number of processors.
+ *
+ * Since: 0.12
+ *
+ * Deprecated: 0.12: Use Media Scanner from `clapper-enhancers` repo instead.
+ */
+guint
+clapper_discoverer_get_n_workers (ClapperDiscoverer *self)
+{
+  guint n_workers;
+
+  g_return_val_if_fail (CLAPPER_IS_DISCOVERER (self), DEFAULT_N_WORKERS);
+
+  GST_OBJECT_LOCK (self);
+  n_workers = self->n_workers;
+  GST_OBJECT_UNLOCK (self);
+
+  return n_workers;
+}
+
+/**
+ * clapper_discoverer_set_lightweight:
+ * @discoverer: a #ClapperDiscoverer
+ * @lightweight: whether to probe local files without decoding them
+ *
+ * Set whether @discoverer should use lightweight probing of local files.
+ *
+ * When enabled, local files are only parsed up to the point where their
+ * tags and duration are known, without plugging any decoders. This is
+ * much cheaper than a full discovery and thus suited for large local
+ * libraries. Items for which duration could not be determined this way
+ * still fall back to a full discovery.
+ *
+ * Since: 0.12
+ *
+ * Deprecated: 0.12: Use Media Scanner from `clapper-enhancers` repo instead.
+ */
+void
+clapper_discoverer_set_lightweight (ClapperDiscoverer *self, gboolean lightweight)
+{
+  gboolean changed;
+
+  g_return_if_fail (CLAPPER_IS_DISCOVERER (self));
+
+  GST_OBJECT_LOCK (self);
+  if ((changed = self->lightweight != lightweight))
+    self->lightweight = lightweight;
+  GST_OBJECT_UNLOCK (self);
+
+  if (changed)
+    g_object_notify_by_pspec (G_OBJECT (self), param_specs[PROP_LIGHTWEIGHT]);
+}
+
+/**
+ * clapper_discoverer_get_lightweight:
+ * @discoverer: a #ClapperDiscoverer
+ *
+ * Get whether @discoverer uses lightweight probing of local files.
+ *
+ * Returns: %TRUE if lightweight probing is enabled, %FALSE otherwise.
+ *
+ * Since: 0.12
+ *
+ * Deprecated: 0.12: Use Media Scanner from `clapper-enhancers` repo instead.
+ */
+gboolean
+clapper_discoverer_get_lightweight (ClapperDiscoverer *self)
+{
+  gboolean lightweight;
+
+  g_return_val_if_fail (CLAPPER_IS_DISCOVERER (self), DEFAULT_LIGHTWEIGHT);
+
+  GST_OBJECT_LOCK (self);
+  lightweight = self->lightweight;
+  GST_OBJECT_UNLOCK (self);
+
+  return lightweight;
+}
+
+/**
+ * clapper_discoverer_prioritize_range:
+ * @discoverer: a #ClapperDiscoverer
+ * @position: position of the first queue item in range
+ * @n_items: number of items in range or 0 to remove prioritization
+ *
+ * Make @discoverer discover not yet discovered items within given range
+ * of player queue positions before other pending ones.
+ *
+ * This is meant to be used by UI displaying the queue to pass range of
+ * items that are currently visible to the user, so it is called often
+ * and only replaces previously set range. Item that is going to be
+ * played next is always discovered first regardless of it.
+ *
+ * This function can be called from any thread.
+ *
+ * Since: 0.12
+ *
+ * Deprecated: 0.12: Use Media Scanner from `clapper-enhancers` repo instead.
+ */
+void
+clapper_discoverer_prioritize_range (ClapperDiscoverer *self, guint position, guint n_items)
+{
+  g_return_if_fail (CLAPPER_IS_DISCOVERER (self));
+
+  GST_OBJECT_LOCK (self);
+  self->priority_position = position;
+  self->priority_n_items = n_items;
+  GST_OBJECT_UNLOCK (self);
+
+  GST_LOG_OBJECT (self, "Prioritized range: %u-%u", position, position + n_items);
+}
+
+/**
+ * clapper_discoverer_get_stats:
+ * @discoverer: a #ClapperDiscoverer
+ * @n_discovered: (out) (optional): return location for number of processed items
+ * @items_per_second: (out) (optional): return location for discovery throughput
+ * @mean_latency: (out) (optional): return location for mean time in seconds
+ *   that discovery of a single item took
+ * @max_latency: (out) (optional): return location for the longest time in
+ *   seconds that discovery of a single item took
+ *
+ * Get statistics of discoveries performed by @discoverer since its
+ * creation or last [method@Clapper.Discoverer.reset_stats] call.
+ *
+ * Throughput is measured only over time when at least one
+ * worker was busy, so idle periods do not lower it.
+ *
+ * This function can be called from any thread.
+ *
+ * Since: 0.12
+ *
+ * Deprecated: 0.12: Use Media Scanner from `clapper-enhancers` repo instead.
+ */
+void
+clapper_discoverer_get_stats (ClapperDiscoverer *self, guint *n_discovered,
+    gdouble *items_per_second, gdouble *mean_latency, gdouble *max_latency)
+{
+  gint64 busy_time;
+  guint discovered;
+
+  g_return_if_fail (CLAPPER_IS_DISCOVERER (self));
+
+  GST_OBJECT_LOCK (self);
+
+  discovered = self->n_discovered;
+  busy_time = self->busy_time;
+  if (self->busy_since > 0)
+    busy_time += g_get_monotonic_time () - self->busy_since;
+
+  if (n_discovered)
+    *n_discovered = discovered;
+  if (items_per_second) {
+    *items_per_second = (busy_time > 0)
+        ? (gdouble) discovered * G_USEC_PER_SEC / busy_time
+        : 0;
+  }
+  if (mean_latency) {
+    *mean_latency = (discovered > 0)
+        ? (gdouble) self->total_latency / discovered / G_USEC_PER_SEC
+        : 0;
+  }
+  if (max_latency)
+    *max_latency = (gdouble) self->max_latency / G_USEC_PER_SEC;
+
+  GST_OBJECT_UNLOCK (self);
+}
+
+/**
+ * clapper_discoverer_reset_stats:
+ * @discoverer: a #ClapperDiscoverer
+ *
+ * Reset statistics of discoveries performed by @discoverer.
+ *
+ * Since: 0.12
+ *
+ * Deprecated: 0.12: Use Media Scanner from `clapper-enhancers` repo instead.
+ */
+void
+clapper_discoverer_reset_stats (ClapperDiscoverer *self)
+{
+  g_return_if_fail (CLAPPER_IS_DISCOVERER (self));
+
+  GST_OBJECT_LOCK (self);
+
+  self->n_discovered = 0;
+  self->total_latency = 0;
+  self->max_latency = 0;
+  self->busy_time = 0;
+
+  /* Keep counting from now if still running */
+  if (self->busy_since > 0)
+    self->busy_since = g_get_monotonic_time ();
+
+  GST_OBJECT_UNLOCK (self);
+}
+
 static void
 clapper_discoverer_init (ClapperDiscoverer *self)
 {
-  self->pending_items = g_ptr_array_new_with_free_func ((GDestroyNotify) gst_object_unref);
+  self->workers = g_ptr_array_new_with_free_func ((GDestroyNotify) _worker_free);
+  g_queue_init (&self->pending_items);
+  self->pending_links = g_hash_table_new (g_direct_hash, g_direct_equal);
 
   self->discovery_mode = DEFAULT_DISCOVERY_MODE;
+  self->n_workers = DEFAULT_N_WORKERS;
+  self->lightweight = DEFAULT_LIGHTWEIGHT;
 }
 
 static void
@@ -445,7 +1494,9 @@ clapper_discoverer_finalize (GObject *object)
 {
   ClapperDiscoverer *self = CLAPPER_DISCOVERER_CAST (object);
 
-  g_ptr_array_unref (self->pending_items);
+  g_ptr_array_unref (self->workers);
+  _clear_pending (self);
+  g_hash_table_unref (self->pending_links);
 
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
@@ -460,6 +1511,12 @@ clapper_discoverer_set_property (GObject *object, guint prop_id,
     case PROP_DISCOVERY_MODE:
       clapper_discoverer_set_discovery_mode (self, g_value_get_enum (value));
       break;
+    case PROP_N_WORKERS:
+      clapper_discoverer_set_n_workers (self, g_value_get_uint (value));
+      break;
+    case PROP_LIGHTWEIGHT:
+      clapper_discoverer_set_lightweight (self, g_value_get_boolean (value));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -476,6 +1533,12 @@ clapper_discoverer_get_property (GObject *object, guint prop_id,
     case PROP_DISCOVERY_MODE:
       g_value_set_enum (value, clapper_discoverer_get_discovery_mode (self));
       break;
+    case PROP_N_WORKERS:
+      g_value_set_uint (value, clapper_discoverer_get_n_workers (self));
+      break;
+    case PROP_LIGHTWEIGHT:
+      g_value_set_boolean (value, clapper_discoverer_get_lightweight (self));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -513,5 +1576,31 @@ clapper_discoverer_class_init (ClapperDiscovererClass *klass)
       NULL, NULL, CLAPPER_TYPE_DISCOVERER_DISCOVERY_MODE, DEFAULT_DISCOVERY_MODE,
       G_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY | G_PARAM_STATIC_STRINGS);
 
+  /**
+   * ClapperDiscoverer:n-workers:
+   *
+   * Maximal number of parallel discoveries, 0 to use number of processors.
+   *
+   * Since: 0.12
+   *
+   * Deprecated: 0.12: Use Media Scanner from `clapper-enhancers` repo instead.
+   */
+  param_specs[PROP_N_WORKERS] = g_param_spec_uint ("n-workers",
+      NULL, NULL, 0, G_MAXUINT, DEFAULT_N_WORKERS,
+      G_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY | G_PARAM_STATIC_STRINGS);
+
+  /**
+   * ClapperDiscoverer:lightweight:
+   *
+   * Probe local files for tags and duration without decoding them.
+   *
+   * Since: 0.12
+   *
+   * Deprecated: 0.12: Use Media Scanner from `clapper-enhancers` repo instead.
+   */
+  param_specs[PROP_LIGHTWEIGHT] = g_param_spec_boolean ("lightweight",
+      NULL, NULL, DEFAULT_LIGHTWEIGHT,
+      G_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY | G_PARAM_STATIC_STRINGS);
+
   g_object_class_install_properties (gobject_class, PROP_LAST, param_specs);
 }
@@ -45,4 +45,25 @@ void clapper_discoverer_set_discovery_mode (ClapperDiscoverer *discoverer, Clapp
 CLAPPER_DEPRECATED
 ClapperDiscovererDiscoveryMode clapper_discoverer_get_discovery_mode (ClapperDiscoverer *discoverer);
 
+CLAPPER_DEPRECATED
+void clapper_discoverer_set_n_workers (ClapperDiscoverer *discoverer, guint n_workers);
+
+CLAPPER_DEPRECATED
+guint clapper_discoverer_get_n_workers (ClapperDiscoverer *discoverer);
+
+CLAPPER_DEPRECATED
+void clapper_discoverer_set_lightweight (ClapperDiscoverer *discoverer, gboolean lightweight);
+
+CLAPPER_DEPRECATED
+gboolean clapper_discoverer_get_lightweight (ClapperDiscoverer *discoverer);
+
+CLAPPER_DEPRECATED
+void clapper_discoverer_prioritize_range (ClapperDiscoverer *discoverer, guint position, guint n_items);
+
+CLAPPER_DEPRECATED
+void clapper_discoverer_get_stats (ClapperDiscoverer *discoverer, guint *n_discovered, gdouble *items_per_second, gdouble *mean_latency, gdouble *max_latency);
+
+CLAPPER_DEPRECATED
+void clapper_discoverer_reset_stats (ClapperDiscoverer *discoverer);
+
 G_END_DECLS
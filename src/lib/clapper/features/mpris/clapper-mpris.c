@@ -62,6 +62,7 @@ typedef struct
 {
   gchar *id;
   ClapperMediaItem *item;
+  guint index;
 } ClapperMprisTrack;
 
 struct _ClapperMpris
@@ -84,6 +85,10 @@ struct _ClapperMpris
   GPtrArray *tracks;
   ClapperMprisTrack *current_track;
 
+  /* Lookup of tracks by their D-Bus path and media item ID */
+  GHashTable *tracks_by_id;
+  GHashTable *tracks_by_item;
+
   ClapperQueueProgressionMode default_mode;
   ClapperQueueProgressionMode non_shuffle_mode;
 
@@ -112,6 +117,70 @@ G_DEFINE_TYPE (ClapperMpris, clapper_mpris, CLAPPER_TYPE_FEATURE);
 static const gchar *const empty_tracklist[] = { NULL, };
 static GParamSpec *param_specs[PROP_LAST] = { NULL, };
 
+/* Player skeleton that reads position on demand. MPRIS clients
+ * query it when needed and are only notified about seeks. */
+typedef struct
+{
+  ClapperMprisMediaPlayer2PlayerSkeleton parent;
+
+  ClapperMpris *mpris; // not owned
+} ClapperMprisPlayerSkeleton;
+
+typedef struct
+{
+  ClapperMprisMediaPlayer2PlayerSkeletonClass parent_class;
+} ClapperMprisPlayerSkeletonClass;
+
+static GType clapper_mpris_player_skeleton_get_type (void);
+G_DEFINE_TYPE (ClapperMprisPlayerSkeleton, clapper_mpris_player_skeleton,
+    CLAPPER_MPRIS_TYPE_MEDIA_PLAYER2_PLAYER_SKELETON);
+
+static void
+clapper_mpris_player_skeleton_get_property (GObject *object, guint prop_id,
+    GValue *value, GParamSpec *pspec)
+{
+  ClapperMprisPlayerSkeleton *self = (ClapperMprisPlayerSkeleton *) object;
+
+  if (CLAPPER_MPRIS_COMPARE (pspec->name, "position")) {
+    ClapperPlayer *player;
+    gint64 position = 0;
+
+    CLAPPER_MPRIS_DO_WITH_PLAYER (self->mpris, &player, {
+      position = CLAPPER_MPRIS_SECONDS_TO_USECONDS (clapper_player_get_position (player));
+    });
+    g_value_set_int64 (value, position);
+
+    return;
+  }
+
+  G_OBJECT_CLASS (clapper_mpris_player_skeleton_parent_class)->get_property (
+      object, prop_id, value, pspec);
+}
+
+static void
+clapper_mpris_player_skeleton_init (ClapperMprisPlayerSkeleton *self G_GNUC_UNUSED)
+{
+}
+
+static void
+clapper_mpris_player_skeleton_class_init (ClapperMprisPlayerSkeletonClass *klass)
+{
+  GObjectClass *gobject_class = (GObjectClass *) klass;
+
+  gobject_class->get_property = clapper_mpris_player_skeleton_get_property;
+}
+
+static ClapperMprisMediaPlayer2Player *
+clapper_mpris_player_skeleton_new (ClapperMpris *mpris)
+{
+  ClapperMprisPlayerSkeleton *skeleton;
+
+  skeleton = g_object_new (clapper_mpris_player_skeleton_get_type (), NULL);
+  skeleton->mpris = mpris;
+
+  return CLAPPER_MPRIS_MEDIA_PLAYER2_PLAYER (skeleton);
+}
+
 static ClapperMprisTrack *
 clapper_mpris_track_new (ClapperMediaItem *item)
 {
@@ -141,6 +210,34 @@ clapper_mpris_track_free (ClapperMprisTrack *track)
   g_free (track);
 }
 
+static void
+_mpris_index_track (ClapperMpris *self, ClapperMprisTrack *track)
+{
+  g_hash_table_insert (self->tracks_by_id, track->id, track);
+  g_hash_table_insert (self->tracks_by_item,
+      GUINT_TO_POINTER (clapper_media_item_get_id (track->item)), track);
+}
+
+static void
+_mpris_unindex_track (ClapperMpris *self, ClapperMprisTrack *track)
+{
+  g_hash_table_remove (self->tracks_by_id, track->id);
+  g_hash_table_remove (self->tracks_by_item,
+      GUINT_TO_POINTER (clapper_media_item_get_id (track->item)));
+}
+
+/* Updates stored positions of tracks after array was altered at index */
+static void
+_mpris_update_track_indexes (ClapperMpris *self, guint from)
+{
+  guint i;
+
+  for (i = from; i < self->tracks->len; ++i) {
+    ClapperMprisTrack *track = (ClapperMprisTrack *) g_ptr_array_index (self->tracks, i);
+    track->index = i;
+  }
+}
+
 static inline void
 _mpris_read_initial_tracks (ClapperMpris *self, ClapperQueue *queue)
 {
@@ -155,7 +252,9 @@ _mpris_read_initial_tracks (ClapperMpris *self, ClapperQueue *queue)
     if (track->item == current_item)
       self->current_track = track;
 
+    track->index = self->tracks->len;
     g_ptr_array_add (self->tracks, track);
+    _mpris_index_track (self, track);
 
     gst_object_unref (item);
     i++;
@@ -164,42 +263,35 @@ _mpris_read_initial_tracks (ClapperMpris *self, ClapperQueue *queue)
   gst_clear_object (&current_item);
 }
 
+/* Items are matched by ID, as lazy queue entries might
+ * be represented by a different item instance over time */
 static gboolean
 _mpris_find_track_by_item (ClapperMpris *self, ClapperMediaItem *search_item, guint *index)
 {
-  guint i;
-
-  for (i = 0; i < self->tracks->len; ++i) {
-    ClapperMprisTrack *track = (ClapperMprisTrack *) g_ptr_array_index (self->tracks, i);
+  ClapperMprisTrack *track;
 
-    if (search_item == track->item) {
-      if (index)
-        *index = i;
+  if (!(track = g_hash_table_lookup (self->tracks_by_item,
+      GUINT_TO_POINTER (clapper_media_item_get_id (search_item)))))
+    return FALSE;
 
-      return TRUE;
-    }
-  }
+  if (index)
+    *index = track->index;
 
-  return FALSE;
+  return TRUE;
 }
 
 static gboolean
 _mpris_find_track_by_id (ClapperMpris *self, const gchar *search_id, guint *index)
 {
-  guint i;
-
-  for (i = 0; i < self->tracks->len; ++i) {
-    ClapperMprisTrack *track = (ClapperMprisTrack *) g_ptr_array_index (self->tracks, i);
+  ClapperMprisTrack *track;
 
-    if (CLAPPER_MPRIS_COMPARE (track->id, search_id)) {
-      if (index)
-        *index = i;
+  if (!(track = g_hash_table_lookup (self->tracks_by_id, search_id)))
+    return FALSE;
 
-      return TRUE;
-    }
-  }
+  if (index)
+    *index = track->index;
 
-  return FALSE;
+  return TRUE;
 }
 
 static GVariant *
@@ -510,16 +602,6 @@ clapper_mpris_state_changed (ClapperFeature *feature, ClapperPlayerState state)
   clapper_mpris_media_player2_player_set_playback_status (self->player_skeleton, status_str);
 }
 
-static void
-clapper_mpris_position_changed (ClapperFeature *feature, gdouble position)
-{
-  ClapperMpris *self = CLAPPER_MPRIS_CAST (feature);
-
-  GST_LOG_OBJECT (self, "Position changed to: %lf", position);
-  clapper_mpris_media_player2_player_set_position (self->player_skeleton,
-      CLAPPER_MPRIS_SECONDS_TO_USECONDS (position));
-}
-
 static void
 clapper_mpris_speed_changed (ClapperFeature *feature, gdouble speed)
 {
@@ -602,6 +684,8 @@ clapper_mpris_queue_item_added (ClapperFeature *feature, ClapperMediaItem *item,
 
   track = clapper_mpris_track_new (item);
   g_ptr_array_insert (self->tracks, index, track);
+  _mpris_update_track_indexes (self, index);
+  _mpris_index_track (self, track);
 
   clapper_mpris_refresh_track_list (self);
   clapper_mpris_refresh_can_go_next_previous (self);
@@ -622,6 +706,8 @@ clapper_mpris_queue_item_removed (ClapperFeature *feature, ClapperMediaItem *ite
   GST_DEBUG_OBJECT (self, "Queue item removed");
 
   track = (ClapperMprisTrack *) g_ptr_array_steal_index (self->tracks, index);
+  _mpris_update_track_indexes (self, index);
+  _mpris_unindex_track (self, track);
 
   if (track == self->current_track) {
     self->current_track = NULL;
@@ -645,6 +731,7 @@ clapper_mpris_queue_item_repositioned (ClapperFeature *feature, guint before, gu
 
   track = (ClapperMprisTrack *) g_ptr_array_steal_index (self->tracks, before);
   g_ptr_array_insert (self->tracks, after, track);
+  _mpris_update_track_indexes (self, MIN (before, after));
 
   clapper_mpris_refresh_track_list (self);
   clapper_mpris_refresh_can_go_next_previous (self);
@@ -656,6 +743,9 @@ clapper_mpris_queue_cleared (ClapperFeature *feature)
   ClapperMpris *self = CLAPPER_MPRIS_CAST (feature);
   guint n_items = self->tracks->len;
 
+  g_hash_table_remove_all (self->tracks_by_id);
+  g_hash_table_remove_all (self->tracks_by_item);
+
   if (n_items > 0)
     g_ptr_array_remove_range (self->tracks, 0, n_items);
 
@@ -874,6 +964,7 @@ _handle_seek_cb (ClapperMprisMediaPlayer2Player *player_skeleton,
 
     if (seek_position <= 0) {
       clapper_player_seek (player, 0);
+      clapper_mpris_media_player2_player_emit_seeked (player_skeleton, 0);
     } else {
       gdouble duration = clapper_media_item_get_duration (self->current_track->item);
 
@@ -882,6 +973,8 @@ _handle_seek_cb (ClapperMprisMediaPlayer2Player *player_skeleton,
         clapper_queue_select_next_item (queue);
       } else {
         clapper_player_seek (player, seek_position);
+        clapper_mpris_media_player2_player_emit_seeked (player_skeleton,
+            CLAPPER_MPRIS_SECONDS_TO_USECONDS (seek_position));
       }
     }
   });
@@ -910,8 +1003,10 @@ _handle_set_position_cb (ClapperMprisMediaPlayer2Player *player_skeleton,
     duration = clapper_media_item_get_duration (self->current_track->item);
     position_dbl = CLAPPER_MPRIS_USECONDS_TO_SECONDS (position);
 
-    if (position_dbl <= duration)
+    if (position_dbl <= duration) {
       clapper_player_seek (player, position_dbl);
+      clapper_mpris_media_player2_player_emit_seeked (player_skeleton, position);
+    }
   });
 
 finish:
@@ -1223,7 +1318,6 @@ _name_acquired_cb (GDBusConnection *connection, const gchar *name, ClapperMpris
 
     /* Trigger update with current values */
     clapper_mpris_state_changed (CLAPPER_FEATURE (self), clapper_player_get_state (player));
-    clapper_mpris_position_changed (CLAPPER_FEATURE (self), clapper_player_get_position (player));
     clapper_mpris_speed_changed (CLAPPER_FEATURE (self), clapper_player_get_speed (player));
     clapper_mpris_volume_changed (CLAPPER_FEATURE (self), clapper_player_get_volume (player));
     clapper_mpris_queue_progression_changed (CLAPPER_FEATURE (self), clapper_queue_get_progression_mode (queue));
@@ -1466,10 +1560,12 @@ static void
 clapper_mpris_init (ClapperMpris *self)
 {
   self->base_skeleton = clapper_mpris_media_player2_skeleton_new ();
-  self->player_skeleton = clapper_mpris_media_player2_player_skeleton_new ();
+  self->player_skeleton = clapper_mpris_player_skeleton_new (self);
   self->tracks_skeleton = clapper_mpris_media_player2_track_list_skeleton_new ();
 
   self->tracks = g_ptr_array_new_with_free_func ((GDestroyNotify) clapper_mpris_track_free);
+  self->tracks_by_id = g_hash_table_new (g_str_hash, g_str_equal);
+  self->tracks_by_item = g_hash_table_new (g_direct_hash, g_direct_equal);
 
   g_atomic_int_set (&self->queue_controllable, (gint) DEFAULT_QUEUE_CONTROLLABLE);
 
@@ -1520,6 +1616,8 @@ clapper_mpris_finalize (GObject *object)
   g_object_unref (self->tracks_skeleton);
 
   self->current_track = NULL;
+  g_hash_table_unref (self->tracks_by_id);
+  g_hash_table_unref (self->tracks_by_item);
   g_ptr_array_unref (self->tracks);
 
   g_free (self->own_name);
@@ -1603,7 +1701,6 @@ clapper_mpris_class_init (ClapperMprisClass *klass)
   feature_class->unprepare = clapper_mpris_unprepare;
   feature_class->property_changed = clapper_mpris_property_changed;
   feature_class->state_changed = clapper_mpris_state_changed;
-  feature_class->position_changed = clapper_mpris_position_changed;
   feature_class->speed_changed = clapper_mpris_speed_changed;
   feature_class->volume_changed = clapper_mpris_volume_changed;
   feature_class->played_item_changed = clapper_mpris_played_item_changed;
@@ -132,6 +132,7 @@ clapper_server_json_build_complete (ClapperServer *server, ClapperMediaItem *pla
     guint played_index, GPtrArray *items)
 {
   ClapperPlayer *player;
+  ClapperPlayerSnapshot snapshot;
   gchar *data = NULL;
 
   player = CLAPPER_PLAYER_CAST (gst_object_get_parent (GST_OBJECT_CAST (server)));
@@ -139,8 +140,10 @@ clapper_server_json_build_complete (ClapperServer *server, ClapperMediaItem *pla
   if (G_UNLIKELY (player == NULL))
     return NULL;
 
+  clapper_player_get_snapshot (player, &snapshot);
+
   CLAPPER_SERVER_JSON_BUILD (&data, {
-    switch (clapper_player_get_state (player)) {
+    switch (snapshot.state) {
       case CLAPPER_PLAYER_STATE_PLAYING:
         _ADD_KEY_VAL_STRING ("state", CLAPPER_SERVER_PLAYER_STATE_PLAYING);
         break;
@@ -158,10 +161,10 @@ clapper_server_json_build_complete (ClapperServer *server, ClapperMediaItem *pla
         break;
     }
 
-    _ADD_KEY_VAL_UINT ("position", clapper_player_get_position (player));
-    _ADD_KEY_VAL_DOUBLE ("speed", clapper_player_get_speed (player));
-    _ADD_KEY_VAL_DOUBLE ("volume", clapper_player_get_volume (player));
-    _ADD_KEY_VAL_BOOLEAN ("mute", clapper_player_get_mute (player));
+    _ADD_KEY_VAL_UINT ("position", snapshot.position);
+    _ADD_KEY_VAL_DOUBLE ("speed", snapshot.speed);
+    _ADD_KEY_VAL_DOUBLE ("volume", snapshot.volume);
+    _ADD_KEY_VAL_BOOLEAN ("mute", snapshot.mute);
 
     _ADD_NAMED_OBJECT ("queue", {
       ClapperQueue *queue = clapper_player_get_queue (player);
@@ -389,18 +389,13 @@ _ws_connection_message_cb (SoupWebsocketConnection *connection,
       guint after_id;
       if (clapper_server_get_queue_controllable (self)
           && clapper_server_actions_parse_insert (text, &uri, &after_id)) {
-        ClapperMediaItem *item, *after_item = NULL;
-        guint i;
-        for (i = 0; i < self->items->len; ++i) {
-          ClapperMediaItem *tmp_after_item = (ClapperMediaItem *) g_ptr_array_index (self->items, i);
-          if (after_id == clapper_media_item_get_id (tmp_after_item)) {
-            after_item = tmp_after_item;
-            break;
-          }
-        }
+        ClapperQueue *queue = clapper_player_get_queue (player);
+        ClapperMediaItem *item, *after_item;
+        after_item = clapper_queue_get_item_by_id (queue, after_id);
         item = clapper_media_item_new (uri);
-        clapper_utils_queue_insert_on_main_sync (clapper_player_get_queue (player), item, after_item);
+        clapper_utils_queue_insert_on_main_sync (queue, item, after_item);
         gst_object_unref (item);
+        gst_clear_object (&after_item);
         g_free (uri);
       }
       break;
@@ -409,13 +404,11 @@ _ws_connection_message_cb (SoupWebsocketConnection *connection,
       guint id;
       if (clapper_server_get_queue_controllable (self)
           && clapper_server_actions_parse_select (text, &id)) {
-        guint i;
-        for (i = 0; i < self->items->len; ++i) {
-          ClapperMediaItem *item = (ClapperMediaItem *) g_ptr_array_index (self->items, i);
-          if (id == clapper_media_item_get_id (item)) {
-            clapper_queue_select_item (clapper_player_get_queue (player), item);
-            break;
-          }
+        ClapperQueue *queue = clapper_player_get_queue (player);
+        ClapperMediaItem *item;
+        if ((item = clapper_queue_get_item_by_id (queue, id))) {
+          clapper_queue_select_item (queue, item);
+          gst_object_unref (item);
         }
       }
       break;
@@ -424,13 +417,11 @@ _ws_connection_message_cb (SoupWebsocketConnection *connection,
       guint id;
       if (clapper_server_get_queue_controllable (self)
           && clapper_server_actions_parse_remove (text, &id)) {
-        guint i;
-        for (i = 0; i < self->items->len; ++i) {
-          ClapperMediaItem *item = (ClapperMediaItem *) g_ptr_array_index (self->items, i);
-          if (id == clapper_media_item_get_id (item)) {
-            clapper_utils_queue_remove_on_main_sync (clapper_player_get_queue (player), item);
-            break;
-          }
+        ClapperQueue *queue = clapper_player_get_queue (player);
+        ClapperMediaItem *item;
+        if ((item = clapper_queue_get_item_by_id (queue, id))) {
+          clapper_utils_queue_remove_on_main_sync (queue, item);
+          gst_object_unref (item);
         }
       }
       break;
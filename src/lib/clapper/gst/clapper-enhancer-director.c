@@ -29,6 +29,7 @@
 #include "../clapper-harvest-private.h"
 #include "../clapper-media-item.h"
 #include "../clapper-utils.h"
+#include "../clapper-threaded-object-private.h"
 #include "../../shared/clapper-shared-utils-private.h"
 
 #include "../clapper-functionalities-availability.h"
@@ -558,4 +559,8 @@ clapper_enhancer_director_class_init (ClapperEnhancerDirectorClass *klass)
 
   threaded_object->thread_start = clapper_enhancer_director_thread_start;
   threaded_object->thread_stop = clapper_enhancer_director_thread_stop;
+
+  /* Extraction blocks director thread for as long as it takes, so
+   * it must never share one with players through executor */
+  clapper_threaded_object_class_set_dedicated_thread (threaded_object);
 }
@@ -460,6 +460,19 @@ _push_events (ClapperExtractableSrc *self, GstTagList *tags, GstToc *toc,
   GST_DEBUG_OBJECT (self, "Pushed all events");
 }
 
+/* Lets player trace how long extraction took, timestamp is
+ * included, since bus messages are handled asynchronously */
+static inline void
+_post_extraction_msg (ClapperExtractableSrc *self, const gchar *name, gboolean cached)
+{
+  GstStructure *structure = gst_structure_new (name,
+      "timestamp", G_TYPE_INT64, g_get_monotonic_time (),
+      "cached", G_TYPE_BOOLEAN, cached, NULL);
+
+  gst_element_post_message (GST_ELEMENT_CAST (self),
+      gst_message_new_element (GST_OBJECT_CAST (self), structure));
+}
+
 static GstFlowReturn
 clapper_extractable_src_create (GstPushSrc *push_src, GstBuffer **outbuf)
 {
@@ -504,6 +517,8 @@ clapper_extractable_src_create (GstPushSrc *push_src, GstBuffer **outbuf)
   filtered_proxies = _filter_extractables_for_uri (self, proxies, guri);
   gst_object_unref (proxies);
 
+  _post_extraction_msg (self, "ClapperExtractionStarted", FALSE);
+
   harvest = clapper_enhancer_director_extract (self->director,
       filtered_proxies, guri, cancellable, &error);
 
@@ -519,6 +534,9 @@ clapper_extractable_src_create (GstPushSrc *push_src, GstBuffer **outbuf)
     return GST_FLOW_ERROR;
   }
 
+  _post_extraction_msg (self, "ClapperExtractionFinished",
+      clapper_harvest_is_from_cache (harvest));
+
   unpacked = clapper_harvest_unpack (harvest, outbuf, &self->buf_size,
       &caps, &tags, &toc, &headers);
   gst_object_unref (harvest);
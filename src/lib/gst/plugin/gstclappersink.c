@@ -650,6 +650,11 @@ gst_clapper_sink_event (GstBaseSink *bsink, GstEvent *event)
   GstVideoOrientationMethod orientation;
 
   switch (GST_EVENT_TYPE (event)) {
+    case GST_EVENT_STREAM_START:
+      GST_CLAPPER_SINK_LOCK (self);
+      self->first_frame_pending = TRUE;
+      GST_CLAPPER_SINK_UNLOCK (self);
+      break;
     case GST_EVENT_TAG:
       gst_event_parse_tag (event, &taglist);
 
@@ -797,6 +802,7 @@ static GstFlowReturn
 gst_clapper_sink_show_frame (GstVideoSink *vsink, GstBuffer *buffer)
 {
   GstClapperSink *self = GST_CLAPPER_SINK_CAST (vsink);
+  gboolean first_frame;
 
   GST_TRACE ("Got %" GST_PTR_FORMAT, buffer);
   GST_CLAPPER_SINK_LOCK (self);
@@ -812,8 +818,20 @@ gst_clapper_sink_show_frame (GstVideoSink *vsink, GstBuffer *buffer)
   gst_clapper_importer_set_buffer (self->importer, buffer);
   gst_clapper_paintable_queue_draw (self->paintable);
 
+  first_frame = self->first_frame_pending;
+  self->first_frame_pending = FALSE;
+
   GST_CLAPPER_SINK_UNLOCK (self);
 
+  /* Allows apps to measure time until new stream shows up */
+  if (first_frame) {
+    GST_DEBUG_OBJECT (self, "Showing first frame of stream");
+    gst_element_post_message (GST_ELEMENT_CAST (self),
+        gst_message_new_element (GST_OBJECT_CAST (self),
+            gst_structure_new ("ClapperSinkFirstFrame",
+                "timestamp", G_TYPE_INT64, g_get_monotonic_time (), NULL)));
+  }
+
   return GST_FLOW_OK;
 }
 
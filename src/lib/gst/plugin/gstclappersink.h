@@ -50,6 +50,7 @@ struct _GstClapperSink
   GstClapperImporter *importer;
   GstVideoInfo v_info;
   GstVideoOrientationMethod stream_orientation;
+  gboolean first_frame_pending;
 
   GtkWidget *widget;
   GtkWindow *window;
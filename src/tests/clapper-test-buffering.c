@@ -0,0 +1,297 @@
+/* Clapper Playback Library
+ * Copyright (C) 2025 Rafał Dzięgiel <rafostar.github@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Checks that buffering profile reaches elements that actually
+ * do the buffering, by reading their settings back from within
+ * the pipeline once source of played item is started.
+ */
+
+#include <string.h>
+#include <glib.h>
+#include <gst/gst.h>
+#include <gst/base/gstbasesrc.h>
+#include <clapper/clapper.h>
+
+#define TEST_URI_SCHEME "claptest"
+#define WAIT_TIMEOUT (10 * G_USEC_PER_SEC)
+
+typedef struct
+{
+  gint64 playbin_buffer_duration;
+  gint playbin_buffer_size;
+  gint64 urisourcebin_buffer_duration;
+  gdouble urisourcebin_low_watermark;
+  gdouble urisourcebin_high_watermark;
+} TestBufferingValues;
+
+static TestBufferingValues read_values;
+static gint have_values = FALSE;
+
+/* Source for test URIs, which reads values from bins it was placed in */
+
+#define TEST_TYPE_SRC (test_src_get_type ())
+G_DECLARE_FINAL_TYPE (TestSrc, test_src, TEST, SRC, GstBaseSrc)
+
+struct _TestSrc
+{
+  GstBaseSrc parent;
+
+  gchar *uri;
+};
+
+static void test_src_uri_handler_init (gpointer g_iface, gpointer iface_data);
+
+G_DEFINE_TYPE_WITH_CODE (TestSrc, test_src, GST_TYPE_BASE_SRC,
+    G_IMPLEMENT_INTERFACE (GST_TYPE_URI_HANDLER, test_src_uri_handler_init))
+
+static GstURIType
+test_src_uri_get_type (GType type G_GNUC_UNUSED)
+{
+  return GST_URI_SRC;
+}
+
+static const gchar *const *
+test_src_uri_get_protocols (GType type G_GNUC_UNUSED)
+{
+  static const gchar *protocols[] = { TEST_URI_SCHEME, NULL };
+
+  return protocols;
+}
+
+static gchar *
+test_src_uri_get_uri (GstURIHandler *handler)
+{
+  TestSrc *self = TEST_SRC (handler);
+  gchar *uri;
+
+  GST_OBJECT_LOCK (self);
+  uri = g_strdup (self->uri);
+  GST_OBJECT_UNLOCK (self);
+
+  return uri;
+}
+
+static gboolean
+test_src_uri_set_uri (GstURIHandler *handler, const gchar *uri, GError **error G_GNUC_UNUSED)
+{
+  TestSrc *self = TEST_SRC (handler);
+
+  GST_OBJECT_LOCK (self);
+  g_set_str (&self->uri, uri);
+  GST_OBJECT_UNLOCK (self);
+
+  return TRUE;
+}
+
+static void
+test_src_uri_handler_init (gpointer g_iface, gpointer iface_data G_GNUC_UNUSED)
+{
+  GstURIHandlerInterface *iface = (GstURIHandlerInterface *) g_iface;
+
+  iface->get_type = test_src_uri_get_type;
+  iface->get_protocols = test_src_uri_get_protocols;
+  iface->get_uri = test_src_uri_get_uri;
+  iface->set_uri = test_src_uri_set_uri;
+}
+
+static GstElement *
+_find_ancestor (GstElement *element, const gchar *factory_name)
+{
+  GstObject *parent = gst_object_get_parent (GST_OBJECT_CAST (element));
+
+  while (parent) {
+    GstObject *next;
+
+    if (GST_IS_ELEMENT (parent)) {
+      GstElementFactory *factory = gst_element_get_factory (GST_ELEMENT_CAST (parent));
+
+      if (factory && strcmp (GST_OBJECT_NAME (factory), factory_name) == 0)
+        return GST_ELEMENT_CAST (parent);
+    }
+
+    next = gst_object_get_parent (parent);
+    gst_object_unref (parent);
+    parent = next;
+  }
+
+  return NULL;
+}
+
+static gboolean
+test_src_start (GstBaseSrc *base_src)
+{
+  GstElement *urisourcebin, *playbin;
+
+  /* Values are set before source is created, so they are final now */
+  urisourcebin = _find_ancestor (GST_ELEMENT_CAST (base_src), "urisourcebin");
+  playbin = _find_ancestor (GST_ELEMENT_CAST (base_src), "playbin3");
+
+  if (urisourcebin && playbin && !g_atomic_int_get (&have_values)) {
+    g_object_get (playbin,
+        "buffer-duration", &read_values.playbin_buffer_duration,
+        "buffer-size", &read_values.playbin_buffer_size,
+        NULL);
+    g_object_get (urisourcebin,
+        "buffer-duration", &read_values.urisourcebin_buffer_duration,
+        "low-watermark", &read_values.urisourcebin_low_watermark,
+        "high-watermark", &read_values.urisourcebin_high_watermark,
+        NULL);
+
+    g_atomic_int_set (&have_values, TRUE);
+  }
+
+  gst_clear_object (&urisourcebin);
+  gst_clear_object (&playbin);
+
+  return TRUE;
+}
+
+static GstFlowReturn
+test_src_create (GstBaseSrc *base_src G_GNUC_UNUSED, guint64 offset G_GNUC_UNUSED,
+    guint size G_GNUC_UNUSED, GstBuffer **buf G_GNUC_UNUSED)
+{
+  return GST_FLOW_EOS;
+}
+
+static void
+test_src_init (TestSrc *self G_GNUC_UNUSED)
+{
+}
+
+static void
+test_src_finalize (GObject *object)
+{
+  TestSrc *self = TEST_SRC (object);
+
+  g_free (self->uri);
+
+  G_OBJECT_CLASS (test_src_parent_class)->finalize (object);
+}
+
+static void
+test_src_class_init (TestSrcClass *klass)
+{
+  GObjectClass *gobject_class = (GObjectClass *) klass;
+  GstElementClass *gstelement_class = (GstElementClass *) klass;
+  GstBaseSrcClass *gstbasesrc_class = (GstBaseSrcClass *) klass;
+  static GstStaticPadTemplate src_template = GST_STATIC_PAD_TEMPLATE ("src",
+      GST_PAD_SRC, GST_PAD_ALWAYS, GST_STATIC_CAPS_ANY);
+
+  gobject_class->finalize = test_src_finalize;
+
+  gstbasesrc_class->start = test_src_start;
+  gstbasesrc_class->create = test_src_create;
+
+  gst_element_class_add_static_pad_template (gstelement_class, &src_template);
+  gst_element_class_set_static_metadata (gstelement_class, "Test Source",
+      "Source", "Source for buffering test", "Rafał Dzięgiel <rafostar.github@gmail.com>");
+}
+
+static gboolean
+_plugin_init (GstPlugin *plugin)
+{
+  return gst_element_register (plugin, "claptestsrc", GST_RANK_PRIMARY, TEST_TYPE_SRC);
+}
+
+static gboolean
+_read_values (ClapperBufferingProfile profile)
+{
+  ClapperPlayer *player;
+  ClapperQueue *queue;
+  ClapperMediaItem *item;
+  gint64 deadline;
+
+  g_atomic_int_set (&have_values, FALSE);
+
+  player = clapper_player_new ();
+  queue = clapper_player_get_queue (player);
+
+  clapper_player_set_buffering_profile (player, profile);
+
+  item = clapper_media_item_new (TEST_URI_SCHEME "://item");
+  clapper_queue_add_item (queue, item);
+  clapper_queue_select_item (queue, item);
+  gst_object_unref (item);
+
+  clapper_player_pause (player);
+
+  deadline = g_get_monotonic_time () + WAIT_TIMEOUT;
+  while (!g_atomic_int_get (&have_values) && g_get_monotonic_time () < deadline) {
+    if (!g_main_context_iteration (NULL, FALSE))
+      g_usleep (1000);
+  }
+
+  clapper_player_stop (player);
+  gst_object_unref (player);
+
+  return g_atomic_int_get (&have_values);
+}
+
+static void
+test_default_profile (void)
+{
+  g_assert_true (_read_values (CLAPPER_BUFFERING_PROFILE_DEFAULT));
+
+  /* Element defaults are kept */
+  g_assert_cmpint (read_values.playbin_buffer_duration, ==, -1);
+  g_assert_cmpint (read_values.playbin_buffer_size, ==, -1);
+  g_assert_cmpint (read_values.urisourcebin_buffer_duration, ==, -1);
+}
+
+static void
+test_prefetch_profile (void)
+{
+  ClapperPlayer *player;
+  gdouble low, high;
+
+  player = clapper_player_new ();
+  clapper_player_set_buffering_profile (player, CLAPPER_BUFFERING_PROFILE_PREFETCH);
+  low = clapper_player_get_buffering_low_watermark (player);
+  high = clapper_player_get_buffering_high_watermark (player);
+  gst_object_unref (player);
+
+  g_assert_true (_read_values (CLAPPER_BUFFERING_PROFILE_PREFETCH));
+
+  g_assert_cmpint (read_values.playbin_buffer_duration, ==, (gint64) (high * GST_SECOND));
+  g_assert_cmpint (read_values.playbin_buffer_size, ==, 0);
+  g_assert_cmpint (read_values.urisourcebin_buffer_duration, ==, (gint64) (high * GST_SECOND));
+  g_assert_cmpfloat_with_epsilon (read_values.urisourcebin_low_watermark, low / high, 0.001);
+  g_assert_cmpfloat_with_epsilon (read_values.urisourcebin_high_watermark, 1.0, 0.001);
+}
+
+gint
+main (gint argc, gchar **argv)
+{
+  g_test_init (&argc, &argv, NULL);
+
+  /* Player defaults to playbin3, but this can be overridden globally,
+   * and urisourcebin is not used otherwise */
+  g_setenv ("USE_PLAYBIN3", "1", TRUE);
+
+  clapper_init (NULL, NULL);
+
+  gst_plugin_register_static (GST_VERSION_MAJOR, GST_VERSION_MINOR,
+      "claptest", "Clapper test elements", _plugin_init,
+      "0.0", "LGPL", "clapper-test", "clapper-test", "https://github.com/Rafostar/clapper");
+
+  g_test_add_func ("/buffering/default-profile", test_default_profile);
+  g_test_add_func ("/buffering/prefetch-profile", test_prefetch_profile);
+
+  return g_test_run ();
+}
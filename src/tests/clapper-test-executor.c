@@ -0,0 +1,376 @@
+/* Clapper Playback Library
+ * Copyright (C) 2025 Rafał Dzięgiel <rafostar.github@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Checks multiplexing of threaded objects onto shared executor
+ * threads, objects that opt out of it and their teardown paths.
+ */
+
+#include <glib.h>
+#include <gst/gst.h>
+
+#include "clapper-threaded-object-private.h"
+#include "clapper-executor-private.h"
+
+#define N_WORKERS 2
+#define N_OBJECTS 8
+#define N_EVENTS 100
+#define WAIT_TIMEOUT (5 * G_USEC_PER_SEC)
+
+static gint n_started = 0;
+static gint n_stopped = 0;
+static gint n_finalized = 0;
+
+/* Regular object, multiplexed onto executor */
+
+#define TEST_TYPE_OBJECT (test_object_get_type ())
+G_DECLARE_FINAL_TYPE (TestObject, test_object, TEST, OBJECT, ClapperThreadedObject)
+
+struct _TestObject
+{
+  ClapperThreadedObject parent;
+
+  GThread *thread;
+  gboolean on_executor;
+  gint n_events; // only touched from object thread
+  gint n_out_of_order;
+  gint done;
+
+  TestObject *peer;
+  gint *n_arrived;
+};
+
+G_DEFINE_TYPE (TestObject, test_object, CLAPPER_TYPE_THREADED_OBJECT)
+
+static void
+test_object_thread_start (ClapperThreadedObject *threaded_object G_GNUC_UNUSED)
+{
+  g_atomic_int_inc (&n_started);
+}
+
+static void
+test_object_thread_stop (ClapperThreadedObject *threaded_object G_GNUC_UNUSED)
+{
+  g_atomic_int_inc (&n_stopped);
+}
+
+static void
+test_object_init (TestObject *self G_GNUC_UNUSED)
+{
+}
+
+static void
+test_object_finalize (GObject *object)
+{
+  g_atomic_int_inc (&n_finalized);
+
+  G_OBJECT_CLASS (test_object_parent_class)->finalize (object);
+}
+
+static void
+test_object_class_init (TestObjectClass *klass)
+{
+  GObjectClass *gobject_class = (GObjectClass *) klass;
+  ClapperThreadedObjectClass *threaded_object = (ClapperThreadedObjectClass *) klass;
+
+  gobject_class->finalize = test_object_finalize;
+
+  threaded_object->thread_start = test_object_thread_start;
+  threaded_object->thread_stop = test_object_thread_stop;
+}
+
+/* Object that blocks its thread, so it opts out of executor */
+
+#define TEST_TYPE_BLOCKING_OBJECT (test_blocking_object_get_type ())
+G_DECLARE_FINAL_TYPE (TestBlockingObject, test_blocking_object, TEST, BLOCKING_OBJECT, ClapperThreadedObject)
+
+struct _TestBlockingObject
+{
+  ClapperThreadedObject parent;
+};
+
+G_DEFINE_TYPE (TestBlockingObject, test_blocking_object, CLAPPER_TYPE_THREADED_OBJECT)
+
+static void
+test_blocking_object_init (TestBlockingObject *self G_GNUC_UNUSED)
+{
+}
+
+static void
+test_blocking_object_class_init (TestBlockingObjectClass *klass)
+{
+  clapper_threaded_object_class_set_dedicated_thread ((ClapperThreadedObjectClass *) klass);
+}
+
+static gboolean
+_wait_for_value (gint *atomic, gint value)
+{
+  gint64 deadline = g_get_monotonic_time () + WAIT_TIMEOUT;
+
+  while (g_atomic_int_get (atomic) != value) {
+    if (g_get_monotonic_time () >= deadline)
+      return FALSE;
+
+    g_usleep (1000);
+  }
+
+  return TRUE;
+}
+
+static void
+_invoke (ClapperThreadedObject *threaded_object, GSourceFunc func, gpointer data)
+{
+  g_main_context_invoke_full (clapper_threaded_object_get_context (threaded_object),
+      G_PRIORITY_DEFAULT, func, data, NULL);
+}
+
+static gboolean
+_record_thread_cb (TestObject *self)
+{
+  self->thread = g_thread_self ();
+  self->on_executor = clapper_executor_is_executor_thread ();
+  g_atomic_int_set (&self->done, TRUE);
+
+  return G_SOURCE_REMOVE;
+}
+
+typedef struct
+{
+  TestObject *object;
+  gint value;
+} TestEvent;
+
+static gboolean
+_event_cb (TestEvent *event)
+{
+  TestObject *self = event->object;
+
+  if (event->value != self->n_events)
+    self->n_out_of_order++;
+
+  if (++self->n_events == N_EVENTS)
+    g_atomic_int_set (&self->done, TRUE);
+
+  g_free (event);
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+test_multiplexing (void)
+{
+  TestObject *objects[N_OBJECTS];
+  GPtrArray *threads = g_ptr_array_new ();
+  gint i, j, n_finalized_before = g_atomic_int_get (&n_finalized);
+
+  for (i = 0; i < N_OBJECTS; ++i) {
+    objects[i] = g_object_new (TEST_TYPE_OBJECT, NULL);
+    gst_object_ref_sink (objects[i]);
+
+    _invoke (CLAPPER_THREADED_OBJECT_CAST (objects[i]), (GSourceFunc) _record_thread_cb, objects[i]);
+  }
+
+  for (i = 0; i < N_OBJECTS; ++i) {
+    g_assert_true (_wait_for_value (&objects[i]->done, TRUE));
+    g_assert_true (objects[i]->on_executor);
+
+    if (!g_ptr_array_find (threads, objects[i]->thread, NULL))
+      g_ptr_array_add (threads, objects[i]->thread);
+  }
+
+  /* All objects share a pool of threads */
+  g_assert_cmpuint (threads->len, <=, N_WORKERS);
+
+  /* Events of each object are still dispatched serially and in order */
+  for (i = 0; i < N_OBJECTS; ++i) {
+    g_atomic_int_set (&objects[i]->done, FALSE);
+
+    for (j = 0; j < N_EVENTS; ++j) {
+      TestEvent *event = g_new (TestEvent, 1);
+
+      event->object = objects[i];
+      event->value = j;
+
+      _invoke (CLAPPER_THREADED_OBJECT_CAST (objects[i]), (GSourceFunc) _event_cb, event);
+    }
+  }
+
+  for (i = 0; i < N_OBJECTS; ++i) {
+    g_assert_true (_wait_for_value (&objects[i]->done, TRUE));
+    g_assert_cmpint (objects[i]->n_out_of_order, ==, 0);
+
+    gst_object_unref (objects[i]);
+  }
+
+  g_assert_cmpint (g_atomic_int_get (&n_finalized) - n_finalized_before, ==, N_OBJECTS);
+
+  g_ptr_array_unref (threads);
+}
+
+static gboolean
+_check_dedicated_cb (gint *on_executor)
+{
+  g_atomic_int_set (on_executor, clapper_executor_is_executor_thread () ? 1 : 0);
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+test_dedicated_thread (void)
+{
+  TestBlockingObject *object;
+  gint on_executor = -1;
+
+  object = g_object_new (TEST_TYPE_BLOCKING_OBJECT, NULL);
+  gst_object_ref_sink (object);
+
+  _invoke (CLAPPER_THREADED_OBJECT_CAST (object), (GSourceFunc) _check_dedicated_cb, &on_executor);
+
+  g_assert_true (_wait_for_value (&on_executor, 0));
+
+  gst_object_unref (object);
+}
+
+static void
+test_teardown_from_other_thread (void)
+{
+  TestObject *object;
+  gint n_stopped_before = g_atomic_int_get (&n_stopped);
+  gint n_finalized_before = g_atomic_int_get (&n_finalized);
+
+  object = g_object_new (TEST_TYPE_OBJECT, NULL);
+  gst_object_ref_sink (object);
+
+  /* Waits for executor thread to stop object */
+  gst_object_unref (object);
+
+  g_assert_cmpint (g_atomic_int_get (&n_stopped) - n_stopped_before, ==, 1);
+  g_assert_cmpint (g_atomic_int_get (&n_finalized) - n_finalized_before, ==, 1);
+}
+
+static gboolean
+_unref_self_cb (TestObject *self)
+{
+  gst_object_unref (self);
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+test_teardown_from_own_thread (void)
+{
+  TestObject *object;
+  gint n_stopped_before = g_atomic_int_get (&n_stopped);
+  gint n_finalized_before = g_atomic_int_get (&n_finalized);
+
+  object = g_object_new (TEST_TYPE_OBJECT, NULL);
+  gst_object_ref_sink (object);
+
+  /* Last reference is dropped from within object own context */
+  _invoke (CLAPPER_THREADED_OBJECT_CAST (object), (GSourceFunc) _unref_self_cb, object);
+
+  g_assert_true (_wait_for_value (&n_finalized, n_finalized_before + 1));
+  g_assert_cmpint (g_atomic_int_get (&n_stopped) - n_stopped_before, ==, 1);
+}
+
+static gboolean
+_unref_peer_cb (TestObject *self)
+{
+  gint64 deadline = g_get_monotonic_time () + WAIT_TIMEOUT;
+
+  /* Make both executor threads dispose their peers at the same time */
+  g_atomic_int_inc (self->n_arrived);
+  while (g_atomic_int_get (self->n_arrived) < 2 && g_get_monotonic_time () < deadline)
+    g_thread_yield ();
+
+  gst_object_unref (self->peer);
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+test_teardown_across_executor_threads (void)
+{
+  TestObject *objects[N_OBJECTS];
+  TestObject *a, *b = NULL;
+  gint i, n_arrived = 0;
+  gint n_stopped_before, n_finalized_before;
+
+  /* Objects are spread over threads, find two that do not share one */
+  for (i = 0; i < N_OBJECTS; ++i) {
+    objects[i] = g_object_new (TEST_TYPE_OBJECT, NULL);
+    gst_object_ref_sink (objects[i]);
+
+    _invoke (CLAPPER_THREADED_OBJECT_CAST (objects[i]), (GSourceFunc) _record_thread_cb, objects[i]);
+  }
+  for (i = 0; i < N_OBJECTS; ++i)
+    g_assert_true (_wait_for_value (&objects[i]->done, TRUE));
+
+  a = objects[0];
+  objects[0] = NULL;
+
+  for (i = 1; i < N_OBJECTS && !b; ++i) {
+    if (objects[i]->thread != a->thread) {
+      b = objects[i];
+      objects[i] = NULL;
+    }
+  }
+  g_assert_nonnull (b);
+
+  for (i = 0; i < N_OBJECTS; ++i)
+    gst_clear_object (&objects[i]);
+
+  n_stopped_before = g_atomic_int_get (&n_stopped);
+  n_finalized_before = g_atomic_int_get (&n_finalized);
+
+  /* Each one now holds the only reference of the other */
+  a->peer = b;
+  a->n_arrived = &n_arrived;
+  b->peer = a;
+  b->n_arrived = &n_arrived;
+
+  _invoke (CLAPPER_THREADED_OBJECT_CAST (a), (GSourceFunc) _unref_peer_cb, a);
+  _invoke (CLAPPER_THREADED_OBJECT_CAST (b), (GSourceFunc) _unref_peer_cb, b);
+
+  /* Would time out if threads waited for each other */
+  g_assert_true (_wait_for_value (&n_finalized, n_finalized_before + 2));
+  g_assert_cmpint (g_atomic_int_get (&n_stopped) - n_stopped_before, ==, 2);
+}
+
+gint
+main (gint argc, gchar **argv)
+{
+  gchar *n_workers_str;
+
+  g_test_init (&argc, &argv, NULL);
+
+  n_workers_str = g_strdup_printf ("%u", N_WORKERS);
+  g_setenv ("CLAPPER_EXECUTOR_THREADS", n_workers_str, TRUE);
+  g_free (n_workers_str);
+
+  gst_init (NULL, NULL);
+  clapper_executor_initialize ();
+
+  g_test_add_func ("/executor/multiplexing", test_multiplexing);
+  g_test_add_func ("/executor/dedicated-thread", test_dedicated_thread);
+  g_test_add_func ("/executor/teardown-from-other-thread", test_teardown_from_other_thread);
+  g_test_add_func ("/executor/teardown-from-own-thread", test_teardown_from_own_thread);
+  g_test_add_func ("/executor/teardown-across-executor-threads", test_teardown_across_executor_threads);
+
+  return g_test_run ();
+}